@@ -37,6 +37,8 @@
 
 #include <QSettings>
 #include <QSysInfo>
+#include <QTimer>
+#include <QScrollBar>
 
 #include "ui_aboutdialog.h"
 #include "ui_muistiinpanot.h"
@@ -72,6 +74,8 @@ AloitusSivu::AloitusSivu() :
 
     connect( kp(), SIGNAL(tietokantaVaihtui()), this, SLOT(kirjanpitoVaihtui()));
     connect( kp(), SIGNAL( perusAsetusMuuttui()), this, SLOT(kirjanpitoVaihtui()));
+    // Tallennus tai poisto vanhentaa kaikkien kausien summat
+    connect( kp(), &Kirjanpito::kirjanpitoaMuokattu, this, [this] { summaMuisti_.clear(); });
 
 
     paivitaTiedostoLista();
@@ -91,6 +95,31 @@ void AloitusSivu::siirrySivulle()
         sivulla = true;
     }
 
+    if( kp()->asetukset()->onko("Nimi") && kp()->asetukset()->onko("EkaTositeKirjattu"))
+    {
+        // Muistissa olevat summat kelpaavat, ellei vientejä ole sen jälkeen muokattu
+        Tilikausi tilikausi = kp()->tilikaudet()->tilikausiIndeksilla( ui->tilikausiCombo->currentIndex() );
+        QString muokattu = viimeisinMuokkaus();
+
+        if( summaMuisti_.value( tilikausi.alkaa() ).muokattu != muokattu || !summaMuisti_.contains(tilikausi.alkaa()))
+        {
+            KaudenSummat uudet;
+            uudet.muokattu = muokattu;
+            summaMuisti_.insert( tilikausi.alkaa(), uudet);
+        }
+
+        if( summaMuisti_.value( tilikausi.alkaa()).osat.count() < SUMMAOSIA && !laskenta_)
+        {
+            laskenta_ = true;
+            QTimer::singleShot(0, this, &AloitusSivu::laskeSeuraava);
+        }
+    }
+
+    naytaSivu();
+}
+
+void AloitusSivu::naytaSivu()
+{
     // Päivitetään aloitussivua
     if( kp()->asetukset()->onko("Nimi"))
     {
@@ -105,7 +134,10 @@ void AloitusSivu::siirrySivulle()
         else
             txt.append("<p><img src=qrc:/pic/aboutpossu.png></p>");
 
+        // Summien täydentyessä sivu pidetään samassa kohdassa
+        int vieritys = ui->selain->verticalScrollBar()->value();
         ui->selain->setHtml(txt);
+        ui->selain->verticalScrollBar()->setValue(vieritys);
     }
     else
     {
@@ -131,6 +163,7 @@ bool AloitusSivu::poistuSivulta(int /* minne */)
 void AloitusSivu::kirjanpitoVaihtui()
 {
     bool avoinna = kp()->asetukset()->onko("Nimi");
+    summaMuisti_.clear();
 
     ui->nimiLabel->setVisible(avoinna);
     ui->tilikausiCombo->setVisible(avoinna);
@@ -494,43 +527,102 @@ QString AloitusSivu::summat()
     QString txt;
 
     Tilikausi tilikausi = kp()->tilikaudet()->tilikausiIndeksilla( ui->tilikausiCombo->currentIndex() );
+    KaudenSummat kausisummat = summaMuisti_.value( tilikausi.alkaa() );
+    const QStringList& osat = kausisummat.osat;
+
+    // Vielä laskematta olevien osien tilalla näytetään odotusteksti
+    QString odota = tr("<tr><td colspan=%1 class=odota>Lasketaan...</td></tr>");
 
     txt.append(tr("<p><h2 class=kausi>Tilikausi %1 - %2 </h1>").arg(tilikausi.alkaa().toString("dd.MM.yyyy"))
              .arg(tilikausi.paattyy().toString("dd.MM.yyyy")));
 
     txt.append("<table width=100%>");
 
-    QSqlQuery kysely;
+    // Rahavarat, saatavat, velat, tulot ja menot
+    for(int i=0; i < 5; i++)
+        txt.append( i < osat.count() ? osat.at(i) : odota.arg(2) );
+
+    // Yli/alijäämä
+    if( osat.count() > 4 )
+        txt.append( tr("<tr class=kokosumma><td>Yli/alijäämä</td><td class=euro> %L1 €</td></tr></table>").arg(( (1.0 * (kausisummat.tulot - kausisummat.menot) ) / 100), 0,'f',2 )) ;
 
-    // Rahavara-tilien saldot
-    txt.append( summa(tr("Rahavarat"), R"(tili.tyyppi LIKE "AR%")", tilikausi, false  ).first );
+    txt.append("</table><p>&nbsp;</p><table width=100%>");
+
+    // Kohdennukset
+    txt.append("<tr><td class=otsikko>Kohdennukset</td><th>Tuloa</th><th>Menoa</th><th>Yli/alijäämä</th></tr>");
+    txt.append( osat.count() > 5 ? osat.at(5) : odota.arg(4) );
+    txt.append("</table>");
 
-    txt.append( summa(tr("Saatavat"), R"((tili.tyyppi="AS" OR tili.tyyppi="AO" or tili.tyyppi="AL" or tili.tyyppi="ALM" or tili.tyyppi="AV"))", tilikausi, false  ).first );
+    return txt;
 
-    txt.append( summa(tr("Velat"), R"((tili.tyyppi="BS" OR tili.tyyppi="BO" or tili.tyyppi="BL" or tili.tyyppi="BLM" or tili.tyyppi="BV"))", tilikausi, true  ).first );
+}
 
+QString AloitusSivu::viimeisinMuokkaus() const
+{
+    // Kumpikin haetaan hakemistosta
+    QSqlQuery kysely("SELECT (SELECT MAX(muokattu) FROM vienti), (SELECT MAX(id) FROM vienti)");
+    if( kysely.next())
+        return QString("%1/%2").arg( kysely.value(0).toString() ).arg( kysely.value(1).toInt());
+    return QString();
+}
 
-    // Sitten tulot
-    QPair<QString,qlonglong> tulopari = summa( tr("Tulot"), R"(tili.tyyppi LIKE "C%")", tilikausi, true, true);
-    txt.append(tulopari.first);
-    qlonglong ylijaama = tulopari.second;
+void AloitusSivu::laskeSeuraava()
+{
+    laskenta_ = false;
+    if( !sivulla || !kp()->asetukset()->onko("Nimi"))
+        return;
 
+    Tilikausi tilikausi = kp()->tilikaudet()->tilikausiIndeksilla( ui->tilikausiCombo->currentIndex() );
+    if( !summaMuisti_.contains( tilikausi.alkaa()))
+        return;
 
-    // ja menot
-    QPair<QString,qlonglong> menopari = summa( tr("Menot"), R"(tili.tyyppi LIKE "D%")", tilikausi, false, true);
-    txt.append(menopari.first);
-    ylijaama -= menopari.second;
+    KaudenSummat& kausisummat = summaMuisti_[ tilikausi.alkaa() ];
+    int osa = kausisummat.osat.count();
+    if( osa >= SUMMAOSIA )
+        return;
 
+    kausisummat.osat.append( laskeOsa(osa, tilikausi, kausisummat) );
+    bool kesken = kausisummat.osat.count() < SUMMAOSIA;
 
+    naytaSivu();
 
-    // Yli/alijäämä
-    txt.append( tr("<tr class=kokosumma><td>Yli/alijäämä</td><td class=euro> %L1 €</td></tr></table>").arg(( (1.0 * ylijaama ) / 100), 0,'f',2 )) ;
+    if( kesken )
+    {
+        laskenta_ = true;
+        QTimer::singleShot(0, this, &AloitusSivu::laskeSeuraava);
+    }
+}
 
-    txt.append("</table><p>&nbsp;</p><table width=100%>");
+QString AloitusSivu::laskeOsa(int osa, const Tilikausi &tilikausi, KaudenSummat &summat)
+{
+    switch (osa)
+    {
+    case 0:
+        // Rahavara-tilien saldot
+        return summa(tr("Rahavarat"), R"(tili.tyyppi LIKE "AR%")", tilikausi, false  ).first;
+    case 1:
+        return summa(tr("Saatavat"), R"((tili.tyyppi="AS" OR tili.tyyppi="AO" or tili.tyyppi="AL" or tili.tyyppi="ALM" or tili.tyyppi="AV"))", tilikausi, false  ).first;
+    case 2:
+        return summa(tr("Velat"), R"((tili.tyyppi="BS" OR tili.tyyppi="BO" or tili.tyyppi="BL" or tili.tyyppi="BLM" or tili.tyyppi="BV"))", tilikausi, true  ).first;
+    case 3:
+    {
+        // Sitten tulot
+        QPair<QString,qlonglong> tulopari = summa( tr("Tulot"), R"(tili.tyyppi LIKE "C%")", tilikausi, true, true);
+        summat.tulot = tulopari.second;
+        return tulopari.first;
+    }
+    case 4:
+    {
+        // ja menot
+        QPair<QString,qlonglong> menopari = summa( tr("Menot"), R"(tili.tyyppi LIKE "D%")", tilikausi, false, true);
+        summat.menot = menopari.second;
+        return menopari.first;
+    }
+    }
 
     // Kohdennukset
-    txt.append("<tr><td class=otsikko>Kohdennukset</td><th>Tuloa</th><th>Menoa</th><th>Yli/alijäämä</th></tr>");
-
+    QString txt;
+    QSqlQuery kysely;
     kysely.exec( QString("select kohdennus.nimi, sum(kreditsnt), sum(debetsnt) from vienti, kohdennus, tili "
                          " where pvm between '%1' and '%2' and vienti.tili=tili.id and vienti.kohdennus=kohdennus.id and tili.ysiluku >= 300000000 "
                          " group by kohdennus.id order by kohdennus.id")
@@ -545,11 +637,7 @@ QString AloitusSivu::summat()
                    .arg( (1.0 * kysely.value(2).toInt() ) / 100,0,'f',2 )
                    .arg( (1.0 * (kysely.value(1).toInt() - kysely.value(2).toInt())) / 100,0,'f',2 ));
     }
-    txt.append("</table>");
-
-
     return txt;
-
 }
 
 QPair<QString, qlonglong> AloitusSivu::summa(const QString &otsikko, const QString &tyyppikysely, const Tilikausi &tilikausi, bool kreditplus, bool vali)
@@ -25,6 +25,7 @@
 
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
+#include <QHash>
 
 #include "db/tilikausi.h"
 #include "kitupiikkisivu.h"
@@ -72,14 +73,50 @@ public slots:
 
     static QDate buildDate();
 
+protected slots:
+    /**
+     * @brief Laskee seuraavan puuttuvan osan valitun tilikauden summista
+     *
+     * Summat lasketaan osa kerrallaan tapahtumasilmukan lomassa, jotta
+     * sivu tulee näkyviin heti ja täydentyy laskennan edetessä.
+     */
+    void laskeSeuraava();
+
 signals:
     void selaus(int tilinumero, Tilikausi tilikausi);
     void ktpkasky(QString kasky);
 
 protected:
+    /**
+     * @brief Tilikauden etusivun summat
+     *
+     * Osat ovat taulukon html-rivejä järjestyksessä rahavarat, saatavat, velat,
+     * tulot, menot ja kohdennukset. Muistiin tallennetut summat ovat voimassa,
+     * kunnes kirjanpitoa muokataan.
+     */
+    struct KaudenSummat
+    {
+        QString muokattu;
+        QStringList osat;
+        qlonglong tulot = 0;
+        qlonglong menot = 0;
+    };
+
+    enum { SUMMAOSIA = 6 };
+
+    void naytaSivu();
     QString vinkit();
     QString summat();
 
+    /**
+     * @brief Tunniste viimeisimmälle muokkaukselle
+     *
+     * Muodostetaan vientien viimeisimmästä muokkausajasta ja suurimmasta id:stä
+     */
+    QString viimeisinMuokkaus() const;
+
+    QString laskeOsa(int osa, const Tilikausi& tilikausi, KaudenSummat &summat);
+
     QPair<QString,qlonglong> summa(const QString& otsikko, const QString& tyyppikysely, const Tilikausi& tilikausi, bool kreditplus = false, bool vali=false);
 
     void saldot();
@@ -95,6 +132,9 @@ protected:
 protected:
     Ui::Aloitus *ui;
     bool sivulla = false;
+
+    QHash<QDate,KaudenSummat> summaMuisti_;     // Tilikauden alkupäivä -> summat
+    bool laskenta_ = false;
 };
 
 #endif // ALOITUSSIVU_H
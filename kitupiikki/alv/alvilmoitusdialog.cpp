@@ -28,6 +28,7 @@
 
 #include "kirjaus/ehdotusmodel.h"
 #include "db/kirjanpito.h"
+#include "db/alvkooste.h"
 
 #include "raportti/alverittely.h"
 
@@ -99,12 +100,15 @@ bool AlvIlmoitusDialog::alvIlmoitus(QDate alkupvm, QDate loppupvm)
     EhdotusModel ehdotus;
     QSqlQuery query( *kp()->tietokanta() );
 
+    // Kauden summat haetaan kuukausittaisesta alv-koosteesta
+    const QString lahde = AlvKooste::lahde(alkupvm, loppupvm);
+
     // 1) Bruttojen oikaisut
     // Korjattu 6.3.2018 #81 since 0.6
 
-    query.exec(  QString("select alvkoodi,alvprosentti,sum(debetsnt) as debetit, sum(kreditsnt) as kreditit, tili from vienti where pvm between \"%3\" and \"%4\" and (alvkoodi=%1 or alvkoodi=%2) group by alvkoodi,tili,alvprosentti")
+    query.exec(  QString("select alvkoodi,alvprosentti,sum(debetsnt) as debetit, sum(kreditsnt) as kreditit, tili from %3 as v where (alvkoodi=%1 or alvkoodi=%2) group by alvkoodi,tili,alvprosentti")
                  .arg(AlvKoodi::MYYNNIT_BRUTTO).arg(AlvKoodi::OSTOT_BRUTTO)
-                 .arg(alkupvm.toString(Qt::ISODate)).arg(loppupvm.toString(Qt::ISODate)));
+                 .arg(lahde));
 
     while( query.next() && query.value("alvprosentti").toInt())
     {
@@ -179,9 +183,9 @@ bool AlvIlmoitusDialog::alvIlmoitus(QDate alkupvm, QDate loppupvm)
 
     // 1B) Voittomarginaaliverotus
     MarginaaliLaskelma marginaali(alkupvm, loppupvm);
-    query.exec( QString("select tili, alvprosentti, sum(kreditsnt) as plus, sum(debetsnt) as minus from vienti "
-                        "where alvkoodi=%1 and pvm between \"%2\" and \"%3\" group by tili,alvprosentti")
-                .arg(AlvKoodi::MYYNNIT_MARGINAALI).arg(alkupvm.toString(Qt::ISODate)).arg(loppupvm.toString(Qt::ISODate)));
+    query.exec( QString("select tili, alvprosentti, sum(kreditsnt) as plus, sum(debetsnt) as minus from %2 as v "
+                        "where alvkoodi=%1 group by tili,alvprosentti")
+                .arg(AlvKoodi::MYYNNIT_MARGINAALI).arg(lahde));
 
     while( query.next())
     {
@@ -219,8 +223,8 @@ bool AlvIlmoitusDialog::alvIlmoitus(QDate alkupvm, QDate loppupvm)
 
 
     // 2) Nettokirjausten koonti
-    query.exec( QString("select alvprosentti, sum(debetsnt) as debetit, sum(kreditsnt) as kreditit from vienti where pvm between \"%1\" and \"%2\" and (alvkoodi=%3 or alvkoodi=%4) group by alvprosentti")
-                .arg(alkupvm.toString(Qt::ISODate)).arg(loppupvm.toString(Qt::ISODate))
+    query.exec( QString("select alvprosentti, sum(debetsnt) as debetit, sum(kreditsnt) as kreditit from %1 as v where (alvkoodi=%2 or alvkoodi=%3) group by alvprosentti")
+                .arg(lahde)
                 .arg(AlvKoodi::ALVKIRJAUS + AlvKoodi::MYYNNIT_NETTO).arg(AlvKoodi::ALVKIRJAUS + AlvKoodi::MAKSUPERUSTEINEN_MYYNTI) );
 
     while( query.next())
@@ -232,8 +236,9 @@ bool AlvIlmoitusDialog::alvIlmoitus(QDate alkupvm, QDate loppupvm)
 
 
     // Muut kirjaukset tauluihin
-    query.exec( QString("select alvkoodi, sum(debetsnt) as debetit, sum(kreditsnt) as kreditit from vienti where pvm between \"%1\" and \"%2\" group by alvkoodi")
-                .arg(alkupvm.toString(Qt::ISODate)).arg(loppupvm.toString(Qt::ISODate)) );
+    // Ilman alv-koodia olevat viennit eivät vaikuta laskelmaan
+    query.exec( QString("select alvkoodi, sum(debetsnt) as debetit, sum(kreditsnt) as kreditit from %1 as v group by alvkoodi")
+                .arg(lahde) );
 
     QMap<int,qlonglong> kooditaulu;
 
@@ -398,15 +403,15 @@ bool AlvIlmoitusDialog::alvIlmoitus(QDate alkupvm, QDate loppupvm)
 
 
         QSqlQuery kysely;
+        const QString vuodenLahde = AlvKooste::lahde(laskelmaMista, loppupvm);
+
         // Liikevaihtoon ei lasketa verotonta myyntiä eikä palveluiden yhteisömyyntiä
         kysely.exec(  QString("SELECT SUM(kreditsnt), SUM(debetsnt) "
-                                   "FROM vienti, tili WHERE "
-                                   "pvm BETWEEN \"%1\" AND \"%2\" "
-                                   "AND vienti.tili=tili.id AND "
-                                   "tili.tyyppi = \"CL\" AND vienti.alvkoodi > 0 AND vienti.alvkoodi <> 13 AND "
-                                   "vienti.alvkoodi <> 15")
-                           .arg(laskelmaMista.toString(Qt::ISODate))
-                           .arg(loppupvm.toString(Qt::ISODate)));
+                                   "FROM %1 AS v, tili WHERE "
+                                   "v.tili=tili.id AND "
+                                   "tili.tyyppi = \"CL\" AND v.alvkoodi > 0 AND v.alvkoodi <> 13 AND "
+                                   "v.alvkoodi <> 15")
+                           .arg(vuodenLahde));
         if( kysely.next())
             liikevaihto += kysely.value(0).toLongLong() - kysely.value(1).toLongLong();
 
@@ -414,22 +419,18 @@ bool AlvIlmoitusDialog::alvIlmoitus(QDate alkupvm, QDate loppupvm)
         liikevaihto -= bruttoveroayhtSnt;
 
         kysely.exec(  QString("SELECT SUM(kreditsnt), SUM(debetsnt) "
-                                   "FROM vienti WHERE "
-                                   "pvm BETWEEN \"%1\" AND \"%2\" "
-                                   "AND (alvkoodi = 111 OR alvkoodi = 127 OR alvkoodi = 118) ")
-                           .arg(laskelmaMista.toString(Qt::ISODate))
-                           .arg(loppupvm.toString(Qt::ISODate)) );
+                                   "FROM %1 AS v WHERE "
+                                   "(alvkoodi = 111 OR alvkoodi = 127 OR alvkoodi = 118) ")
+                           .arg(vuodenLahde) );
 
         if( kysely.next())
             vero += kysely.value(0).toLongLong() - kysely.value(1).toLongLong();
 
         // Verosta vähennetään vielä vähennetyt
         kysely.exec(  QString("SELECT SUM(kreditsnt), SUM(debetsnt) "
-                                   "FROM vienti WHERE "
-                                   "pvm BETWEEN \"%1\" AND \"%2\" "
-                                   "AND alvkoodi > 200 AND alvkoodi < 300 ")
-                           .arg(laskelmaMista.toString(Qt::ISODate))
-                           .arg(loppupvm.toString(Qt::ISODate)) );
+                                   "FROM %1 AS v WHERE "
+                                   "alvkoodi > 200 AND alvkoodi < 300 ")
+                           .arg(vuodenLahde) );
 
         if( kysely.next())
             vero -= kysely.value(1).toLongLong() - kysely.value(0).toLongLong();
@@ -461,7 +462,9 @@ bool AlvIlmoitusDialog::alvIlmoitus(QDate alkupvm, QDate loppupvm)
 
     }
     ui->huojennusCheck->setVisible( huojennus && kp()->asetukset()->onko("AlvHuojennusTili") );
-    ui->saatavaCheck->setVisible( kp()->tilit()->tiliTyypilla(TiliLaji::VEROSAATAVA).saldoPaivalle(loppupvm) );
+    // Verosaatavan saldo tarvitaan sekä valintaan että kirjaukseen
+    const qlonglong verosaatava = kp()->tilit()->tiliTyypilla(TiliLaji::VEROSAATAVA).saldoPaivalle(loppupvm);
+    ui->saatavaCheck->setVisible( verosaatava );
 
 
     ui->ilmoitusBrowser->setHtml( kirjoittaja->html() + "<hr>" + AlvErittely::kirjoitaRaporti(alkupvm, loppupvm).html());
@@ -516,9 +519,9 @@ bool AlvIlmoitusDialog::alvIlmoitus(QDate alkupvm, QDate loppupvm)
             model.json()->set("Huojennus", huojennus);
             model.json()->set("MaksettavaAlv", maksettavavero - huojennus);
         }
-        if(  kp()->tilit()->tiliTyypilla(TiliLaji::VEROSAATAVA).saldoPaivalle(loppupvm) && ui->saatavaCheck->isChecked())
+        if(  verosaatava && ui->saatavaCheck->isChecked())
         {
-            qlonglong saatavasta = kp()->tilit()->tiliTyypilla(TiliLaji::VEROSAATAVA).saldoPaivalle(loppupvm);
+            qlonglong saatavasta = verosaatava;
             if( saatavasta > maksettavavero)
                 saatavasta = maksettavavero;
             VientiRivi saatavastaDebet;
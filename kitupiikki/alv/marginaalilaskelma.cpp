@@ -17,6 +17,7 @@
 #include "marginaalilaskelma.h"
 #include "db/kirjanpito.h"
 #include "db/verotyyppimodel.h"
+#include "db/alvkooste.h"
 
 #include <QSqlQuery>
 #include <QMap>
@@ -71,9 +72,9 @@ MarginaaliLaskelma::MarginaaliLaskelma(const QDate &alkaa, const QDate &loppuu)
     // 2) Haetaan myynnit
     QMap<int,qlonglong> myynnit;
 
-    query.exec( QString("select alvprosentti, sum(kreditsnt) as plus, sum(debetsnt) as minus from vienti "
-                        "where alvkoodi=%1 and pvm between \"%2\" and \"%3\" group by alvprosentti ")
-                .arg(AlvKoodi::MYYNNIT_MARGINAALI).arg(alkaa.toString(Qt::ISODate)).arg(loppuu.toString(Qt::ISODate)));
+    query.exec( QString("select alvprosentti, sum(kreditsnt) as plus, sum(debetsnt) as minus from %2 as v "
+                        "where alvkoodi=%1 group by alvprosentti ")
+                .arg(AlvKoodi::MYYNNIT_MARGINAALI).arg(AlvKooste::lahde(alkaa, loppuu)));
     while( query.next())
     {
         kannat.insert( query.value("alvprosentti").toInt());
@@ -83,9 +84,9 @@ MarginaaliLaskelma::MarginaaliLaskelma(const QDate &alkaa, const QDate &loppuu)
     // 3) Haetaan ostot
     QMap<int,qlonglong> ostot;
 
-    query.exec( QString("select alvprosentti, sum(kreditsnt) as minus, sum(debetsnt) as plus from vienti "
-                        "where alvkoodi=%1 and pvm between \"%2\" and \"%3\" group by alvprosentti ")
-                .arg(AlvKoodi::OSTOT_MARGINAALI ).arg(alkaa.toString(Qt::ISODate)).arg(loppuu.toString(Qt::ISODate)));
+    query.exec( QString("select alvprosentti, sum(kreditsnt) as minus, sum(debetsnt) as plus from %2 as v "
+                        "where alvkoodi=%1 group by alvprosentti ")
+                .arg(AlvKoodi::OSTOT_MARGINAALI ).arg(AlvKooste::lahde(alkaa, loppuu)));
     while( query.next())
     {
         kannat.insert( query.value("alvprosentti").toInt());
@@ -23,6 +23,7 @@
 #include <QSqlQuery>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QCryptographicHash>
 
 #include <fstream>
 #include <iostream>
@@ -42,12 +43,11 @@
 #include "tilinpaattaja.h"
 
 #include "tararkisto.h"
+#include "ziparkisto.h"
 #include "naytin/naytinikkuna.h"
 
 #include "budjettidlg.h"
 
-#include <zip.h>
-
 ArkistoSivu::ArkistoSivu()
 {
     ui = new Ui::TilikausiMaaritykset;
@@ -112,7 +112,7 @@ void ArkistoSivu::arkisto()
         QString arkistotiedosto = kp()->arkistopolku() + "/" + kausi.arkistoHakemistoNimi() + "/index.html";
 
         // Tehdään arkisto, jos se on päivittämisen tarpeessa
-        if( !kausi.arkistoitu().isValid() || kausi.arkistoitu() < kausi.viimeinenPaivitys() || !QFile::exists(arkistotiedosto))
+        if( !onkoArkistoAjantasalla(kausi) )
         {
             teeArkisto(kausi);
         }
@@ -136,40 +136,20 @@ void ArkistoSivu::vieArkisto()
         return;
 
     Tilikausi kausi = kp()->tilikaudet()->tilikausiIndeksilla( ui->view->currentIndex().row() );
-    QString arkistotiedosto = kp()->arkistopolku() + "/" + kausi.arkistoHakemistoNimi() + "/index.html";
-
-    // Tehdään arkisto, jos se on päivittämisen tarpeessa
-    if( !kausi.arkistoitu().isValid() || kausi.arkistoitu() < kausi.viimeinenPaivitys() || !QFile::exists(arkistotiedosto))
-    {
-        teeArkisto(kausi);
-    }
-
+    QString arkistopohja = QDir::root().absoluteFilePath( QString("%1-%2").arg( kp()->tiedostopolku().replace(QRegularExpression(".kitupiikki$"),""), kausi.arkistoHakemistoNimi()) );
 
     if( dlgUi.hakemistoRadio->isChecked())
     {
-
-
-        QDir mista( kp()->arkistopolku() + "/" + kausi.arkistoHakemistoNimi() );
-        QStringList tiedostot = mista.entryList(QDir::Files);
         QString hakemistoon = QFileDialog::getExistingDirectory(this, tr("Valitse hakemisto, jonne arkisto kopioidaan"),
                                                                 QDir::rootPath());
-        if( !hakemistoon.isEmpty())
+        if( hakemistoon.isEmpty())
+            return;
+
+        HakemistoKohde kohde( hakemistoon );
+        if( !vieKohteeseen(kausi, &kohde))
         {
-            QDir minne(hakemistoon);
-
-            QProgressDialog odota(tr("Kopioidaan arkistoa"), tr("Peruuta"),0, tiedostot.count(),this);
-            int kopioitu = 0;
-            for( const QString& tiedosto : tiedostot)
-            {
-                if( odota.wasCanceled())
-                    break;
-                if( !QFile::copy( mista.absoluteFilePath(tiedosto), minne.absoluteFilePath(tiedosto) ) )
-                {
-                    QMessageBox::critical(this, tr("Kopiointi ei onnistu"), tr("Tiedoston %1 kopiointi ei onnistunut.\n Kopiointi on keskeytetty.").arg(tiedosto));
-                    return;
-                }
-                odota.setValue(++kopioitu);
-            }
+            QMessageBox::critical(this, tr("Kopiointi ei onnistu"), tr("Arkiston kopiointi hakemistoon %1 ei onnistunut.").arg(hakemistoon));
+            return;
         }
         QMessageBox::information(this, tr("Arkiston kopiointi valmis"), tr("Arkisto on kopioitu hakemistoon %1.\n"
                                                                            "Avaa selaimella hakemistossa oleva index.html-tiedosto.").arg(hakemistoon));
@@ -177,61 +157,43 @@ void ArkistoSivu::vieArkisto()
     }
     else if( dlgUi.zipButton->isChecked())
     {
-        if( !teeZip(kausi))
+        QString arkisto = QFileDialog::getSaveFileName(this, tr("Vie arkisto"), arkistopohja + ".zip", tr("Zip-arkisto (*.zip)") );
+        if( arkisto.isEmpty())
+            return;
+
+        ZipArkisto zip( arkisto );
+        if( !zip.aloita() || !vieKohteeseen(kausi, &zip))
+        {
+            QFile::remove( arkisto );
             QMessageBox::critical(this, tr("Arkiston viennissä virhe"),
                                   tr("Arkiston vienti epäonnistui.") );
-
-
+            return;
+        }
+        QMessageBox::information(this, tr("Arkiston vienti valmis"),
+                             tr("Arkisto viety tiedostoon %1").arg(arkisto));
     }
     else if( dlgUi.tarRadio->isChecked())
     {
-        // Muodostetaan tar-arkisto
-        // Tässä käytetään Pierre Lindenbaumin Tar-luokkaa http://plindenbaum.blogspot.fi/2010/08/creating-tar-file-in-c.html
-
-        QDir mista( kp()->arkistopolku() + "/" + kausi.arkistoHakemistoNimi() );
-        QStringList tiedostot = mista.entryList(QDir::Files);
-        QString arkistotiedosto = QDir::root().absoluteFilePath( QString("%1-%2.tar").arg( kp()->tiedostopolku().replace(QRegularExpression(".kitupiikki$"),""), kausi.arkistoHakemistoNimi()) );
-        QString arkisto = QFileDialog::getSaveFileName(this, tr("Vie arkisto"), arkistotiedosto, tr("Tar-arkisto (*.tar)") );
-
+        QString arkisto = QFileDialog::getSaveFileName(this, tr("Vie arkisto"), arkistopohja + ".tar", tr("Tar-arkisto (*.tar)") );
+        if( arkisto.isEmpty() )
+            return;
 
-        if( !arkisto.isEmpty() )
+        TarArkisto tar( arkisto );
+        if( !tar.aloita())
         {
-            TarArkisto tar( arkisto );
-            if( !tar.aloita())
-            {
-                QMessageBox::critical(this, tr("Arkiston vienti epäonnistui"),
-                                      tr("Tiedostoon %1 kirjoittaminen epäonnistui").arg(arkisto));
-                return;
-            }
-
-            QProgressDialog odota(tr("Kopioidaan arkistoa"), tr("Peruuta"),0, tiedostot.count(),this);
-            int kopioitu = 0;
-
-            for( const QString& tiedosto : tiedostot)
-            {
-                if( odota.wasCanceled())
-                    break;
-
-                if( !tar.lisaaTiedosto( mista.absoluteFilePath(tiedosto) ) )
-                {
-                    tar.lopeta();
-
-                    QFile::remove( arkisto );
-
-                    QMessageBox::critical(this, tr("Arkiston viennissä virhe"),
-                                          tr("Arkiston vienti epäonnistui kopioitaessa tiedostoa %1")
-                                          .arg(tiedosto));
-                    return;
-                }
-
-                odota.setValue(++kopioitu);
-            }
-
-            QMessageBox::information(this, tr("Arkisto vienti valmis"),
-                                 tr("Arkisto viety tiedostoon %1").arg(arkisto));
-
+            QMessageBox::critical(this, tr("Arkiston vienti epäonnistui"),
+                                  tr("Tiedostoon %1 kirjoittaminen epäonnistui").arg(arkisto));
+            return;
         }
-
+        if( !vieKohteeseen(kausi, &tar))
+        {
+            QFile::remove( arkisto );
+            QMessageBox::critical(this, tr("Arkiston viennissä virhe"),
+                                  tr("Arkiston vienti epäonnistui.") );
+            return;
+        }
+        QMessageBox::information(this, tr("Arkisto vienti valmis"),
+                             tr("Arkisto viety tiedostoon %1").arg(arkisto));
     }
 
 }
@@ -299,15 +261,7 @@ void ArkistoSivu::teeArkisto(Tilikausi kausi)
     odota.setMinimumDuration(250);
 
     QString sha = Arkistoija::arkistoi(kausi);
-
-    // Merkitsee arkistoiduksi
-
-    kp()->tilikaudet()->json(kausi)->set("Arkisto", QDateTime::currentDateTime().toString(Qt::ISODate) );
-    kp()->tilikaudet()->json(kausi)->set("ArkistoSHA", sha);
-    kp()->tilikaudet()->tallennaJSON();
-
-    QModelIndex indeksi = kp()->tilikaudet()->index( kp()->tilikaudet()->indeksiPaivalle(kausi.paattyy()) , TilikausiModel::ARKISTOITU );
-    emit kp()->tilikaudet()->dataChanged( indeksi, indeksi );
+    merkitseArkistoiduksi( kausi, sha );
 
     odota.setValue(100);
 
@@ -386,47 +340,68 @@ void ArkistoSivu::budjetti()
     dlg->lataa( ui->view->currentIndex().data(TilikausiModel::LyhenneRooli).toString() );
 }
 
-bool ArkistoSivu::teeZip(const Tilikausi &kausi)
+bool ArkistoSivu::vieKohteeseen(Tilikausi kausi, ArkistonKohde *kohde)
 {
     QDir mista( kp()->arkistopolku() + "/" + kausi.arkistoHakemistoNimi() );
-    QStringList tiedostot = mista.entryList(QDir::Files);
-
-    QString arkistotiedosto = QDir::root().absoluteFilePath( QString("%1-%2.zip").arg( kp()->tiedostopolku().replace(QRegularExpression(".kitupiikki$"),""), kausi.arkistoHakemistoNimi()) );
-    QString arkisto = QFileDialog::getSaveFileName(this, tr("Vie arkisto"), arkistotiedosto, tr("Zip-arkisto (*.zip)") );
 
-
-    if( !arkisto.isEmpty() )
+    if( !onkoArkistoAjantasalla(kausi) )
     {
-        int virhekoodi = 0;
-        zip_t* paketti = zip_open( arkisto.toStdString().c_str(), ZIP_CREATE | ZIP_TRUNCATE, &virhekoodi );
+        // Vanhentunut arkisto muodostetaan suoraan kohteeseen ilman välivaihetta levyllä
+        QProgressDialog odota(tr("Muodostetaan arkistoa"), QString(), 0, 100, this);
+        odota.setMinimumDuration(250);
 
-        if( !paketti)
+        QString sha = Arkistoija::arkistoi( kausi, kohde );
+        if( !kohde->valmis())
             return false;
 
-        QProgressDialog odota(tr("Kopioidaan arkistoa"), tr("Peruuta"),0, tiedostot.count(),this);
-        int kopioitu = 0;
-
-        for( const QString& tiedosto : tiedostot)
-        {
-            if( odota.wasCanceled())
-                return false;
+        merkitseArkistoiduksi( kausi, sha );
+        odota.setValue(100);
+        return true;
+    }
 
-            QFileInfo info( mista.absoluteFilePath(tiedosto)) ;
+    // Ajantasainen arkisto kopioidaan sellaisenaan, jotta tiivisteet säilyvät
+    QStringList tiedostot = mista.entryList(QDir::Files);
+    QStringList pakattavat = QStringList() << "html" << "css" << "js" << "sha256";
 
-            zip_source_t* lahde = zip_source_file(paketti, info.absoluteFilePath().toStdString().c_str(),
-                                                  0,-1);
-            if( !lahde)
-                return false;
-            if( zip_file_add(paketti, info.fileName().toStdString().c_str(),
-                             lahde, 0) < 0)
-                return false;
+    QProgressDialog odota(tr("Kopioidaan arkistoa"), tr("Peruuta"),0, tiedostot.count(),this);
+    int kopioitu = 0;
 
-            odota.setValue(++kopioitu);
+    for( const QString& tiedosto : tiedostot)
+    {
+        QFile luettava( mista.absoluteFilePath(tiedosto));
+        if( odota.wasCanceled() || !luettava.open(QIODevice::ReadOnly) ||
+            !kohde->kirjoita( tiedosto, luettava.readAll(), pakattavat.contains( QFileInfo(tiedosto).suffix())))
+        {
+            kohde->valmis();
+            return false;
         }
-        zip_close(paketti);
 
-        QMessageBox::information(this, tr("Arkiston vienti valmis"),
-                             tr("Arkisto viety tiedostoon %1").arg(arkisto));
+        odota.setValue(++kopioitu);
     }
-    return true;
+    return kohde->valmis();
+}
+
+bool ArkistoSivu::onkoArkistoAjantasalla(Tilikausi kausi)
+{
+    QDir hakemisto( kp()->arkistopolku() + "/" + kausi.arkistoHakemistoNimi() );
+
+    if( !kausi.arkistoitu().isValid() || kausi.arkistoitu() < kausi.viimeinenPaivitys() || !hakemisto.exists("index.html"))
+        return false;
+
+    // Viennissä muodostettu arkisto ei päivitä hakemistoa, joten hakemiston
+    // tiivisteiden on vastattava viimeksi talletettua tiivistettä
+    QFile tiivisteet( hakemisto.absoluteFilePath("arkisto.sha256") );
+    return tiivisteet.open(QIODevice::ReadOnly) &&
+            QCryptographicHash::hash( tiivisteet.readAll(), QCryptographicHash::Sha256).toHex() ==
+            kp()->tilikaudet()->json(kausi)->str("ArkistoSHA").toLatin1();
+}
+
+void ArkistoSivu::merkitseArkistoiduksi(const Tilikausi &kausi, const QString &sha)
+{
+    kp()->tilikaudet()->json(kausi)->set("Arkisto", QDateTime::currentDateTime().toString(Qt::ISODate) );
+    kp()->tilikaudet()->json(kausi)->set("ArkistoSHA", sha);
+    kp()->tilikaudet()->tallennaJSON();
+
+    QModelIndex indeksi = kp()->tilikaudet()->index( kp()->tilikaudet()->indeksiPaivalle(kausi.paattyy()) , TilikausiModel::ARKISTOITU );
+    emit kp()->tilikaudet()->dataChanged( indeksi, indeksi );
 }
@@ -36,6 +36,8 @@
  * tilinpäätöstä
  *
  */
+class ArkistonKohde;
+
 class ArkistoSivu : public KitupiikkiSivu
 {
     Q_OBJECT
@@ -62,7 +64,27 @@ public slots:
 private:
     Ui::TilikausiMaaritykset *ui;
 
-    bool teeZip(const Tilikausi& kausi);
+    /**
+     * @brief Vie arkiston kohteeseen
+     *
+     * Arkistohakemistossa jo oleva ajantasainen arkisto kopioidaan
+     * sellaisenaan. Vanhentunut arkisto muodostetaan Arkistoijalla suoraan
+     * kohteeseen, ja sen tiiviste ja arkistointiaika talletetaan
+     * tilikaudelle. Arkistohakemistoa ei tällöin päivitetä.
+     *
+     * @return tosi, jos vienti onnistui
+     */
+    bool vieKohteeseen(Tilikausi kausi, ArkistonKohde* kohde);
+
+    /**
+     * @brief Onko arkistohakemistossa tilikauden viimeisin arkisto
+     */
+    bool onkoArkistoAjantasalla(Tilikausi kausi);
+
+    /**
+     * @brief Tallettaa tilikaudelle arkiston tiivisteen ja arkistointiajan
+     */
+    void merkitseArkistoiduksi(const Tilikausi& kausi, const QString& sha);
 };
 
 #endif // ARKISTO_H
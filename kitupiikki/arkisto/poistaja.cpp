@@ -15,10 +15,9 @@
    along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <cmath>
-
 #include "poistaja.h"
 #include "ui_poistaja.h"
+#include "poistolaskenta.h"
 
 #include "kirjaus/ehdotusmodel.h"
 #include "raportti/raportinkirjoittaja.h"
@@ -49,6 +48,58 @@ bool Poistaja::teeSumuPoistot(Tilikausi kausi)
     return poistoDlg.sumupoistaja(kausi);
 }
 
+QHash<int, QList<QPair<int, qlonglong> > > Poistaja::kohdennusSaldot(QSqlDatabase &tietokanta, const QStringList &tiliIdt, const QDate &paattyy)
+{
+    QHash<int, QList<QPair<int,qlonglong>>> saldot;
+    if( tiliIdt.isEmpty())
+        return saldot;
+
+    QSqlQuery kysely( tietokanta );
+    kysely.setForwardOnly(true);
+    kysely.exec( QString("SELECT tili, kohdennus, SUM(debetsnt), SUM(kreditsnt) FROM vienti WHERE "
+                         "tili IN (%1) AND pvm < '%2' GROUP BY tili, kohdennus ORDER BY tili, kohdennus")
+                 .arg(tiliIdt.join(',')).arg(paattyy.toString(Qt::ISODate)));
+    while( kysely.next())
+        saldot[ kysely.value(0).toInt() ].append( qMakePair( kysely.value(1).toInt(),
+                                                  kysely.value(2).toLongLong() - kysely.value(3).toLongLong() ));
+    return saldot;
+}
+
+QHash<int, QList<Poistaja::PoistoEra> > Poistaja::tasaeraErat(QSqlDatabase &tietokanta, const QStringList &tiliIdt, const QDate &paattyy)
+{
+    QHash<int, QList<PoistoEra>> erat;
+    if( tiliIdt.isEmpty())
+        return erat;
+
+    QSqlQuery kysely( tietokanta );
+    kysely.setForwardOnly(true);
+
+    QHash<int,qlonglong> eraSaldot;
+    kysely.exec( QString("SELECT eraid, SUM(debetsnt), SUM(kreditsnt) FROM vienti WHERE tili IN (%1) "
+                         "AND eraid IS NOT NULL AND pvm <= '%2' GROUP BY eraid")
+                 .arg(tiliIdt.join(',')).arg(paattyy.toString(Qt::ISODate)));
+    while( kysely.next())
+        eraSaldot.insert( kysely.value(0).toInt(), kysely.value(1).toLongLong() - kysely.value(2).toLongLong());
+
+    kysely.exec( QString("SELECT id, tili, pvm, selite, debetsnt, kreditsnt, json, kohdennus FROM vienti "
+                         "WHERE tili IN (%1) AND eraid=id ORDER BY tili, pvm").arg(tiliIdt.join(',')));
+    while( kysely.next())
+    {
+        PoistoEra era;
+        era.eraId = kysely.value("id").toInt();
+        era.saldo = eraSaldot.value( era.eraId );
+        if( !era.saldo )
+            continue;
+        era.pvm = kysely.value("pvm").toDate();
+        era.selite = kysely.value("selite").toString();
+        era.alkuSnt = kysely.value("debetsnt").toLongLong() - kysely.value("kreditsnt").toLongLong();
+        era.poistoKk = JsonKentta( kysely.value("json").toByteArray() ).luku("Tasaerapoisto");
+        era.kohdennus = kysely.value("kohdennus").toInt();
+        erat[ kysely.value("tili").toInt() ].append(era);
+    }
+    return erat;
+}
+
 bool Poistaja::sumupoistaja(Tilikausi kausi)
 {
     EhdotusModel ehdotus;
@@ -74,13 +125,35 @@ bool Poistaja::sumupoistaja(Tilikausi kausi)
     kirjoittaja.lisaaOtsake(otsikko);
 
 
+    // Poistettavien tilien saldot haetaan kerralla
+    QList<int> poistettavat;
+    QStringList kohdennetut;
+    QStringList tasaeratilit;
     for( int i=0; i < kp()->tilit()->rowCount(QModelIndex()); i++)
     {
         Tili tili = kp()->tilit()->tiliIndeksilla(i);
         if( !tili.onko(TiliLaji::POISTETTAVA))
             continue;
+        poistettavat.append( tili.id() );
+        if( tili.onko(TiliLaji::MENOJAANNOSPOISTO) && tili.json()->luku("Kohdennukset"))
+            kohdennetut.append( QString::number(tili.id()) );
+        else if( tili.onko(TiliLaji::TASAERAPOISTO))
+            tasaeratilit.append( QString::number(tili.id()));
+    }
+    QHash<int,qlonglong> saldot = kp()->tilit()->saldot( kausi.paattyy(), poistettavat );
 
-        qlonglong saldo = tili.saldoPaivalle( kausi.paattyy());
+    // Kohdennuksilla käsiteltävien tilien kohdennuskohtaiset saldot ja
+    // tasaeräpoistettavien tilien avoimet erät alkuperäisine vienteineen
+    QHash<int, QList<QPair<int,qlonglong>>> kohdennusSaldot = Poistaja::kohdennusSaldot( *kp()->tietokanta(), kohdennetut, kausi.paattyy());
+    QHash<int, QList<PoistoEra>> erat = tasaeraErat( *kp()->tietokanta(), tasaeratilit, kausi.paattyy());
+
+    for( int i=0; i < kp()->tilit()->rowCount(QModelIndex()); i++)
+    {
+        Tili tili = kp()->tilit()->tiliIndeksilla(i);
+        if( !tili.onko(TiliLaji::POISTETTAVA))
+            continue;
+
+        qlonglong saldo = saldot.value( tili.id() );
 
         if( !saldo)
             continue;
@@ -98,7 +171,7 @@ bool Poistaja::sumupoistaja(Tilikausi kausi)
             //  Menojäännöspoistossa poistetaan määrätty prosenttimäärä siihen asti olevasta saldosta
 
             int poistoprosentti = tili.json()->luku("Menojaannospoisto");
-            qlonglong poisto = std::round( saldo * poistoprosentti / 100.0 );
+            qlonglong poisto = PoistoLaskenta::menojaannospoisto(saldo, poistoprosentti);
             qlonglong jalkeen = saldo - poisto;
 
             RaporttiRivi rr;
@@ -117,14 +190,11 @@ bool Poistaja::sumupoistaja(Tilikausi kausi)
 
             if( tili.json()->luku("Kohdennukset"))
             {
-                QSqlQuery kohkysely( QString("SELECT kohdennus, SUM(debetsnt), SUM(kreditsnt) FROM vienti WHERE "
-                                             "tili=%1 AND pvm < '%2' GROUP BY kohdennus ORDER BY kohdennus" )
-                                     .arg(tili.id()).arg(kausi.paattyy().toString(Qt::ISODate)) );
-                while( kohkysely.next())
+                for( const auto& kohdennusSaldo : kohdennusSaldot.value( tili.id()))
                 {
-                    Kohdennus kohdennus = kp()->kohdennukset()->kohdennus(kohkysely.value(0).toInt());
-                    qlonglong kohdsaldo = kohkysely.value(1).toLongLong() - kohkysely.value(2).toLongLong();
-                    qlonglong kohdpoisto = std::round( kohdsaldo * poistoprosentti / 100.0 );
+                    Kohdennus kohdennus = kp()->kohdennukset()->kohdennus( kohdennusSaldo.first );
+                    qlonglong kohdsaldo = kohdennusSaldo.second;
+                    qlonglong kohdpoisto = PoistoLaskenta::menojaannospoisto(kohdsaldo, poistoprosentti);
                     qlonglong kohdjalkeen = kohdsaldo - kohdpoisto;
 
                     RaporttiRivi kr;
@@ -201,55 +271,24 @@ bool Poistaja::sumupoistaja(Tilikausi kausi)
             tiliRivi.lihavoi();
             kirjoittaja.lisaaRivi(tiliRivi);
 
-            EranValintaModel emodel;
-            emodel.lataa(tili, false, kausi.paattyy());
-            for(int eI=1; eI < emodel.rowCount(QModelIndex()); eI++)
+            for( const PoistoEra& era : erat.value( tili.id()))
             {
-                QModelIndex eInd = emodel.index(eI, 0);
-
-                int eranId = eInd.data(EranValintaModel::EraIdRooli).toInt();
-                int eraSaldo = eInd.data(EranValintaModel::SaldoRooli).toInt();
-                QDate eranPvm = eInd.data(EranValintaModel::PvmRooli).toDate();
-
-                int alkuSnt = 0;
-                int poistoKk = 0;
-
-                QSqlQuery alkuKysely;
-                alkuKysely.exec(QString("SELECT debetsnt, kreditsnt, json, kohdennus FROM vienti WHERE id=%1").arg(eranId) );
-                if( alkuKysely.next())
-                {
-                    alkuSnt = alkuKysely.value("debetsnt").toInt() - alkuKysely.value("kreditsnt").toInt();
-                    JsonKentta json( alkuKysely.value("json").toByteArray());
-                    poistoKk = json.luku("Tasaerapoisto");
-                }
-
-                if( !poistoKk)
+                if( !era.poistoKk)
                     continue;
 
-                // Montako kuukautta on kulunut hankinnasta
-                int kuukauttaKulunut = kausi.paattyy().year() * 12 + kausi.paattyy().month() -
-                                       eranPvm.year() * 12 - eranPvm.month() + 1;
-
-
-
-                // Laskennallinen poisto: Paljonko tähän asti voitaisiin poistaa
-                int laskennallinenPoisto = alkuSnt * kuukauttaKulunut / poistoKk ;
-                if( laskennallinenPoisto > alkuSnt)
-                    laskennallinenPoisto = alkuSnt; // Poistetaan vain se, mitä on jäljellä ...
-
-
-                int eraPoisto = laskennallinenPoisto - alkuSnt + eraSaldo;
+                qlonglong eraPoisto = PoistoLaskenta::tasaerapoisto( era.alkuSnt, era.saldo, era.poistoKk,
+                                                                     era.pvm, kausi.paattyy());
 
                 RaporttiRivi rr;
-                rr.lisaa( eranPvm );
-                rr.lisaa( eInd.data(EranValintaModel::SeliteRooli).toString());
-                rr.lisaa( eraSaldo );
-                if( poistoKk % 12)      // Poistoaika
-                    rr.lisaa( tr( "%1 v %2 kk").arg(poistoKk / 12).arg(poistoKk % 12), 1, true);
+                rr.lisaa( era.pvm );
+                rr.lisaa( era.selite );
+                rr.lisaa( era.saldo );
+                if( era.poistoKk % 12)      // Poistoaika
+                    rr.lisaa( tr( "%1 v %2 kk").arg(era.poistoKk / 12).arg(era.poistoKk % 12), 1, true);
                 else
-                    rr.lisaa( tr("%1 v").arg(poistoKk / 12), 1, true);
+                    rr.lisaa( tr("%1 v").arg(era.poistoKk / 12), 1, true);
                 rr.lisaa( eraPoisto);
-                rr.lisaa( eraSaldo - eraPoisto );
+                rr.lisaa( era.saldo - eraPoisto );
 
                 kirjoittaja.lisaaRivi(rr);
 
@@ -259,10 +298,10 @@ bool Poistaja::sumupoistaja(Tilikausi kausi)
                 vienti.pvm = kausi.paattyy();
                 vienti.tili = tili;
                 vienti.kreditSnt = eraPoisto;
-                vienti.eraId = eInd.data(EranValintaModel::EraIdRooli).toInt();
-                vienti.selite = tr("Tasaeräpoisto %1 ").arg( eInd.data(EranValintaModel::SeliteRooli).toString() );
+                vienti.eraId = era.eraId;
+                vienti.selite = tr("Tasaeräpoisto %1 ").arg( era.selite );
                 // #123: Kohdennetaan poisto kirjauksen kohdennuksen mukaan
-                vienti.kohdennus = kp()->kohdennukset()->kohdennus( alkuKysely.value("kohdennus").toInt() );
+                vienti.kohdennus = kp()->kohdennukset()->kohdennus( era.kohdennus );
                 ehdotus.lisaaVienti(vienti);
 
                 VientiRivi poistotilille;
@@ -272,7 +311,7 @@ bool Poistaja::sumupoistaja(Tilikausi kausi)
                 poistotilille.selite = tr("Tasaeräpoisto %3 tilillä %1 %2")
                         .arg(tili.numero())
                         .arg(tili.nimi())
-                        .arg( eInd.data(EranValintaModel::SeliteRooli).toString());
+                        .arg( era.selite );
                 ehdotus.lisaaVienti(poistotilille);
 
             }
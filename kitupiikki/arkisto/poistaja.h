@@ -19,6 +19,7 @@
 #define POISTAJA_H
 
 #include <QDialog>
+#include <QSqlDatabase>
 
 #include "db/kirjanpito.h"
 
@@ -58,6 +59,45 @@ public:
      */
     bool static onkoPoistoja(const Tilikausi &kausi);
 
+    /**
+     * @brief Tasaeräpoistettava tase-erä alkuperäisen vientinsä tiedoilla
+     */
+    struct PoistoEra
+    {
+        int eraId = 0;
+        QDate pvm;
+        QString selite;
+        qlonglong saldo = 0;
+        qlonglong alkuSnt = 0;
+        int poistoKk = 0;
+        int kohdennus = 0;
+    };
+
+    /**
+     * @brief Menojäännöspoistettavien tilien saldot kohdennuksittain
+     *
+     * Kaikkien tilien saldot haetaan yhdellä ryhmitellyllä kyselyllä.
+     *
+     * @param tiliIdt Kohdennuksilla käsiteltävien tilien id:t
+     * @param paattyy Tilikauden päättymispäivä, jota edeltävät viennit lasketaan
+     * @return Tilin id:n mukaan kohdennuksen id ja saldo kohdennuksen mukaan järjestettynä
+     */
+    static QHash<int, QList<QPair<int,qlonglong>>> kohdennusSaldot(QSqlDatabase& tietokanta, const QStringList& tiliIdt,
+                                                                   const QDate& paattyy);
+
+    /**
+     * @brief Tasaeräpoistettavien tilien avoimet erät
+     *
+     * Erien saldot ja alkuperäiset viennit haetaan kahdella kyselyllä
+     * kaikille tileille kerralla.
+     *
+     * @param tiliIdt Tasaeräpoistettavien tilien id:t
+     * @param paattyy Tilikauden päättymispäivä
+     * @return Tilin id:n mukaan erät päivämääräjärjestyksessä
+     */
+    static QHash<int, QList<PoistoEra>> tasaeraErat(QSqlDatabase& tietokanta, const QStringList& tiliIdt,
+                                                    const QDate& paattyy);
+
 private:
     bool sumupoistaja(Tilikausi kausi);
 
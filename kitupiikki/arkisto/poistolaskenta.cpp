@@ -0,0 +1,43 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "poistolaskenta.h"
+
+#include <cmath>
+
+qlonglong PoistoLaskenta::menojaannospoisto(qlonglong saldo, int prosentti)
+{
+    return std::llround( saldo * prosentti / 100.0 );
+}
+
+qlonglong PoistoLaskenta::tasaerapoisto(qlonglong alkuSnt, qlonglong eraSaldo, int poistoKk,
+                                        const QDate &hankittu, const QDate &paattyy)
+{
+    if( !poistoKk )
+        return 0;
+
+    // Montako kuukautta on kulunut hankinnasta
+    int kuukauttaKulunut = paattyy.year() * 12 + paattyy.month() -
+                           hankittu.year() * 12 - hankittu.month() + 1;
+
+    // Laskennallinen poisto: Paljonko tähän asti voitaisiin poistaa
+    qlonglong laskennallinenPoisto = alkuSnt * kuukauttaKulunut / poistoKk ;
+    if( laskennallinenPoisto > alkuSnt)
+        laskennallinenPoisto = alkuSnt; // Poistetaan vain se, mitä on jäljellä ...
+
+    return laskennallinenPoisto - alkuSnt + eraSaldo;
+}
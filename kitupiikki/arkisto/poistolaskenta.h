@@ -0,0 +1,57 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef POISTOLASKENTA_H
+#define POISTOLASKENTA_H
+
+#include <QDate>
+
+/**
+ * @brief Suunnitelman mukaisten poistojen laskukaavat
+ *
+ * Laskenta on erotettu tietokannasta, jotta Poistaja voi hakea
+ * kaikkien tilien tiedot kerralla ja laskea poistot muistissa.
+ */
+namespace PoistoLaskenta {
+
+/**
+ * @brief Menojäännöspoiston määrä
+ * @param saldo Poistettavan tilin (tai kohdennuksen) saldo
+ * @param prosentti Poistoprosentti
+ * @return Poisto sentteinä
+ */
+qlonglong menojaannospoisto(qlonglong saldo, int prosentti);
+
+/**
+ * @brief Tasaeräpoiston määrä tilikaudella
+ *
+ * Tasaeräpoistossa erästä poistetaan joka kuukausi yhtä suuri osuus,
+ * kunnes koko hankintameno on poistettu.
+ *
+ * @param alkuSnt Erän hankintameno
+ * @param eraSaldo Erän saldo ennen poistoa
+ * @param poistoKk Poistoaika kuukausina
+ * @param hankittu Erän hankintapäivä
+ * @param paattyy Tilikauden päättymispäivä
+ * @return Poisto sentteinä
+ */
+qlonglong tasaerapoisto(qlonglong alkuSnt, qlonglong eraSaldo, int poistoKk,
+                        const QDate& hankittu, const QDate& paattyy);
+
+}
+
+#endif // POISTOLASKENTA_H
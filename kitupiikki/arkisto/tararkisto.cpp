@@ -56,16 +56,84 @@ bool TarArkisto::lisaaTiedosto(const QString &polku)
         return false;
     }
 
+    write( otsake( info.fileName().toLocal8Bit(), info.size(),
+                   info.fileTime(QFileDevice::FileModificationTime).toSecsSinceEpoch()) );
+
+    // Sitten vielä kirjoitetaan tiedosto paloittain
+    while( !in.atEnd() )
+        write( in.read( 64 * 1024 ) );
+
+    taytaTietue( info.size() );
+
+    return true;
+
+}
+
+void TarArkisto::lopeta()
+{
+    // Kirjoitetaan kaksi tyhjää blokkia
+    QByteArray blokki(512, '\0');
+    write( blokki );
+    write( blokki );
+
+    close();
+}
+
+bool TarArkisto::valmis()
+{
+    if( isOpen() )
+        lopeta();
+    return onnistui_;
+}
+
+bool TarArkisto::aloitaOsa(const QString &nimi, bool /* pakattava */)
+{
+    // Kokoa ei vielä tiedetä, joten otsakkeen paikalle varataan tyhjä
+    // tietue, joka kirjoitetaan tiedoston valmistuttua
+    osanNimi_ = nimi.toUtf8();
+    osanAlku_ = pos();
+    osanKoko_ = 0;
+
+    if( write( QByteArray(512, '\0')) != 512)
+        onnistui_ = false;
+    return onnistui_;
+}
+
+bool TarArkisto::kirjoitaOsa(const char *data, qint64 pituus)
+{
+    if( write(data, pituus) != pituus )
+    {
+        onnistui_ = false;
+        return false;
+    }
+    osanKoko_ += pituus;
+    return true;
+}
+
+bool TarArkisto::lopetaOsa()
+{
+    taytaTietue( osanKoko_ );
+
+    qint64 loppu = pos();
+    seek( osanAlku_ );
+    if( write( otsake( osanNimi_, osanKoko_, QDateTime::currentSecsSinceEpoch() )) != 512 )
+        onnistui_ = false;
+    seek( loppu );
+
+    return onnistui_;
+}
+
+QByteArray TarArkisto::otsake(const QByteArray &tiedostonnimi, qint64 koko, qint64 muokattu)
+{
     QByteArray otsake(512, '\0');
-    QByteArray tiedostonnimi = info.fileName().toLocal8Bit();
 
-    otsake.replace(0, tiedostonnimi.length(), tiedostonnimi);
+    otsake.replace(0, qMin(tiedostonnimi.length(), 100), tiedostonnimi.left(100));
     otsake.replace(100, QByteArray("000644 ").size() , QByteArray("000644 "));
 
-    QByteArray koko = QString("%1 ").arg( info.size(), 11, 8, QChar('0') ).toLocal8Bit();
-    otsake.replace( 124, koko.size(), koko );
+    QByteArray kokoteksti = QString("%1 ").arg( koko, 11, 8, QChar('0') ).toLocal8Bit();
+    otsake.replace( 124, kokoteksti.size(), kokoteksti );
 
-    QByteArray mtime = QString("%1 ").arg( info.fileTime(QFileDevice::FileModificationTime).toSecsSinceEpoch() , 11, 8, QChar('0') ).toLocal8Bit();
+    QByteArray mtime = QString("%1 ").arg( muokattu , 11, 8, QChar('0') ).toLocal8Bit();
 
     otsake.replace( 136, mtime.size(), mtime);
     otsake.replace( 156, QByteArray("0").size(), QByteArray("0"));
@@ -79,35 +147,19 @@ bool TarArkisto::lisaaTiedosto(const QString &polku)
     otsake.replace( 0x151, QByteArray("000000 ").size(), QByteArray("000000 "));
 
     quint32 tarkastussumma = 32 * 8;
-    // Tarkastussumman laskenta
+    // Tarkastussumman laskenta (tavut etumerkittöminä)
     for( int i=0; i < otsake.size(); i++)
-        tarkastussumma += otsake.at(i);
+        tarkastussumma += static_cast<quint8>( otsake.at(i) );
 
     QByteArray tarkaste = QString("%1 ").arg( tarkastussumma, 6, 8, QChar('0') ).toLocal8Bit();
     otsake.replace(148, tarkaste.length(), tarkaste);
 
-    // Nyt otsake on valmis kirjoitettavaksi
-    write( otsake );
-
-    // Sitten vielä kirjoitetaan tiedosto
-    write( in.readAll() );
-
-    // Ja lopuksi täytetään viimeinen tietue
-    int jaannos = 512 - info.size() % 512;
-    QByteArray tyhja( jaannos, '\0');
-    write( tyhja );
-
-
-    return true;
-
+    return otsake;
 }
 
-void TarArkisto::lopeta()
+void TarArkisto::taytaTietue(qint64 koko)
 {
-    // Kirjoitetaan kaksi tyhjää blokkia
-    QByteArray blokki(512, '\0');
-    write( blokki );
-    write( blokki );
-
-    close();
+    int jaannos = static_cast<int>( (512 - koko % 512) % 512 );
+    if( jaannos )
+        write( QByteArray( jaannos, '\0') );
 }
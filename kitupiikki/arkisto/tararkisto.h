@@ -21,10 +21,15 @@
 #include <QFile>
 #include <QByteArray>
 
+#include "arkistoija/arkistonkohde.h"
+
 /**
  * @brief Tar-arkiston muodostaminen
+ *
+ * Arkistoon voi lisätä levyllä olevia tiedostoja tai kirjoittaa sitä
+ * ArkistonKohde-rajapinnan kautta suoraan arkistoijasta.
  */
-class TarArkisto : protected QFile
+class TarArkisto : protected QFile, public ArkistonKohde
 {
 public:
     TarArkisto(const QString& polku);
@@ -49,7 +54,27 @@ public:
      */
     void lopeta();
 
+    bool valmis() override;
+
 protected:
+    bool aloitaOsa(const QString& nimi, bool pakattava) override;
+    bool kirjoitaOsa(const char* data, qint64 pituus) override;
+    bool lopetaOsa() override;
+
+    /**
+     * @brief Muodostaa tiedoston 512 tavun otsaketietueen
+     */
+    static QByteArray otsake(const QByteArray& tiedostonnimi, qint64 koko, qint64 muokattu);
+
+    /**
+     * @brief Täyttää viimeisen tietueen loppuun
+     */
+    void taytaTietue(qint64 koko);
+
+    QByteArray osanNimi_;
+    qint64 osanAlku_ = 0;
+    qint64 osanKoko_ = 0;
+    bool onnistui_ = true;
 
 };
 
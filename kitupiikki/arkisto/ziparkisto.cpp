@@ -0,0 +1,306 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <QDataStream>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <zlib.h>
+
+#include "ziparkisto.h"
+
+namespace {
+    const quint16 UTF8NIMET = 0x0800;
+    const quint16 VERSIO = 20;
+    const quint16 TALLENNETTU = 0;
+    const quint16 DEFLATE = 8;
+    const int PUSKURI = 64 * 1024;
+    // Zip64-laajennusta ei tueta, joten sijainnit ja koot ovat 32-bittisiä
+    const qint64 ZIPRAJA = 0xffffffffLL;
+    const int TIETUERAJA = 0xffff;
+}
+
+ZipArkisto::ZipArkisto(const QString &polku) :
+    QFile( polku )
+{
+    QDateTime nyt = QDateTime::currentDateTime();
+    aika_ = static_cast<quint16>( (nyt.time().hour() << 11) | (nyt.time().minute() << 5) | (nyt.time().second() / 2) );
+    paiva_ = static_cast<quint16>( ((nyt.date().year() - 1980) << 9) | (nyt.date().month() << 5) | nyt.date().day() );
+}
+
+ZipArkisto::~ZipArkisto()
+{
+    if( isOpen())
+        valmis();
+}
+
+bool ZipArkisto::aloita()
+{
+    return open( QIODevice::WriteOnly);
+}
+
+bool ZipArkisto::kirjoita(const QString &nimi, const QByteArray &data, bool pakattava)
+{
+    // Pakkaaminen tehdään taustalla, ja valmiit kirjoitetaan tiedostoon
+    // samassa järjestyksessä kuin ne on lisätty. Jonon pituutta rajoitetaan,
+    // jottei koko arkisto päädy muistiin.
+    Odottava odottava;
+    odottava.nimi = nimi.toUtf8();
+    odottava.tulos = QtConcurrent::run( &ZipArkisto::valmistele, data, pakattava );
+    jono_.enqueue( odottava );
+
+    if( jono_.count() > 2 * QThread::idealThreadCount() )
+        jono_.head().tulos.waitForFinished();
+
+    kirjoitaValmiit();
+    return onnistui_;
+}
+
+bool ZipArkisto::valmis()
+{
+    kirjoitaValmiit(true);
+
+    // Keskushakemisto
+    QByteArray hakemisto;
+    QDataStream out( &hakemisto, QIODevice::WriteOnly);
+    out.setByteOrder( QDataStream::LittleEndian );
+
+    for( const Tietue& tietue : tietueet_)
+    {
+        out << quint32(0x02014b50) << quint16( 0x0300 | VERSIO) << VERSIO << UTF8NIMET
+            << tietue.menetelma << aika_ << paiva_
+            << tietue.crc << tietue.pakattuKoko << tietue.koko
+            << quint16( tietue.nimi.length() ) << quint16(0) << quint16(0)
+            << quint16(0) << quint16(0) << ( quint32(0100644) << 16 )
+            << tietue.sijainti;
+        out.writeRawData( tietue.nimi.constData(), tietue.nimi.length());
+    }
+
+    qint64 hakemistonAlku = pos();
+    quint32 hakemistonKoko = static_cast<quint32>( hakemisto.size() );
+
+    // Keskushakemiston loppu
+    out << quint32(0x06054b50) << quint16(0) << quint16(0)
+        << quint16( tietueet_.count()) << quint16( tietueet_.count())
+        << hakemistonKoko << quint32( hakemistonAlku ) << quint16(0);
+
+    if( !onnistui_ || pos() + hakemisto.size() > ZIPRAJA || write( hakemisto ) != hakemisto.size())
+        onnistui_ = false;
+
+    close();
+    return onnistui_;
+}
+
+ZipArkisto::Sisalto ZipArkisto::valmistele(const QByteArray &data, bool pakattava)
+{
+    Sisalto sisalto;
+    sisalto.koko = static_cast<quint32>( data.size() );
+    sisalto.crc = static_cast<quint32>( crc32( crc32(0L, Z_NULL, 0),
+                                        reinterpret_cast<const Bytef*>(data.constData()),
+                                        static_cast<uInt>( data.size() ) ));
+
+    if( pakattava && !data.isEmpty())
+    {
+        z_stream virta;
+        virta.zalloc = Z_NULL;
+        virta.zfree = Z_NULL;
+        virta.opaque = Z_NULL;
+
+        // Negatiivinen ikkunan koko tuottaa raa'an deflate-virran, jota zip käyttää
+        if( deflateInit2( &virta, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK )
+        {
+            QByteArray pakattu( static_cast<int>( deflateBound(&virta, static_cast<uLong>(data.size()))), Qt::Uninitialized);
+            virta.next_in = reinterpret_cast<Bytef*>( const_cast<char*>( data.constData()) );
+            virta.avail_in = static_cast<uInt>( data.size() );
+            virta.next_out = reinterpret_cast<Bytef*>( pakattu.data() );
+            virta.avail_out = static_cast<uInt>( pakattu.size() );
+
+            if( deflate( &virta, Z_FINISH) == Z_STREAM_END && virta.total_out < static_cast<uLong>( data.size() ))
+            {
+                pakattu.resize( static_cast<int>( virta.total_out ));
+                sisalto.data = pakattu;
+                sisalto.pakattu = true;
+            }
+            deflateEnd( &virta );
+        }
+    }
+
+    if( !sisalto.pakattu )
+        sisalto.data = data;
+
+    return sisalto;
+}
+
+bool ZipArkisto::aloitaOsa(const QString &nimi, bool pakattava)
+{
+    kirjoitaValmiit();
+
+    if( !mahtuu( 30 + nimi.toUtf8().length() ))
+        onnistui_ = false;
+    if( !onnistui_ )
+        return false;
+
+    osa_ = Tietue();
+    osa_.nimi = nimi.toUtf8();
+    osa_.sijainti = static_cast<quint32>( pos() );
+    osa_.menetelma = pakattava ? DEFLATE : TALLENNETTU;
+    osa_.crc = static_cast<quint32>( crc32(0L, Z_NULL, 0) );
+
+    // Koot ja tarkiste kirjoitetaan otsakkeeseen, kun tiedosto on valmis
+    if( !kirjoitaTarkistaen( paikallinenOtsake( osa_ )))
+        return false;
+
+    if( pakattava )
+    {
+        virta_ = new z_stream;
+        virta_->zalloc = Z_NULL;
+        virta_->zfree = Z_NULL;
+        virta_->opaque = Z_NULL;
+        if( deflateInit2( virta_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK )
+            onnistui_ = false;
+    }
+    return onnistui_;
+}
+
+bool ZipArkisto::kirjoitaOsa(const char *data, qint64 pituus)
+{
+    if( !onnistui_ )
+        return false;
+
+    osa_.crc = static_cast<quint32>( crc32( osa_.crc, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(pituus)));
+    osa_.koko += static_cast<quint32>( pituus );
+
+    if( !virta_ )
+        return kirjoitaTarkistaen( data, pituus );
+
+    char puskuri[PUSKURI];
+    virta_->next_in = reinterpret_cast<Bytef*>( const_cast<char*>(data) );
+    virta_->avail_in = static_cast<uInt>( pituus );
+    do
+    {
+        virta_->next_out = reinterpret_cast<Bytef*>( puskuri );
+        virta_->avail_out = PUSKURI;
+        deflate( virta_, Z_NO_FLUSH);
+        if( !kirjoitaTarkistaen( puskuri, PUSKURI - virta_->avail_out))
+            break;
+    } while( virta_->avail_out == 0 );
+
+    return onnistui_;
+}
+
+bool ZipArkisto::lopetaOsa()
+{
+    qint64 datanAlku = osa_.sijainti + 30 + osa_.nimi.length();
+
+    if( virta_ )
+    {
+        char puskuri[PUSKURI];
+        virta_->avail_in = 0;
+        int tulos = Z_OK;
+        while( onnistui_ && tulos != Z_STREAM_END )
+        {
+            virta_->next_out = reinterpret_cast<Bytef*>( puskuri );
+            virta_->avail_out = PUSKURI;
+            tulos = deflate( virta_, Z_FINISH);
+            if( tulos == Z_STREAM_ERROR )
+            {
+                onnistui_ = false;
+                break;
+            }
+            kirjoitaTarkistaen( puskuri, PUSKURI - virta_->avail_out);
+        }
+        deflateEnd( virta_ );
+        delete virta_;
+        virta_ = nullptr;
+    }
+
+    qint64 loppu = pos();
+    osa_.pakattuKoko = static_cast<quint32>( loppu - datanAlku );
+
+    if( !onnistui_ || !seek( osa_.sijainti ) ||
+        write( paikallinenOtsake( osa_ )) != 30 + osa_.nimi.length() ||
+        !seek( loppu ))
+        onnistui_ = false;
+
+    tietueet_.append( osa_ );
+    return onnistui_;
+}
+
+void ZipArkisto::kirjoitaValmiit(bool kaikki)
+{
+    while( !jono_.isEmpty() && ( kaikki || jono_.head().tulos.isFinished() ))
+    {
+        Odottava odottava = jono_.dequeue();
+        kirjoitaTietue( odottava.nimi, odottava.tulos.result() );
+    }
+}
+
+void ZipArkisto::kirjoitaTietue(const QByteArray &nimi, const ZipArkisto::Sisalto &sisalto)
+{
+    Tietue tietue;
+    tietue.nimi = nimi;
+    tietue.crc = sisalto.crc;
+    tietue.koko = sisalto.koko;
+    tietue.pakattuKoko = static_cast<quint32>( sisalto.data.size() );
+    tietue.sijainti = static_cast<quint32>( pos() );
+    tietue.menetelma = sisalto.pakattu ? DEFLATE : TALLENNETTU;
+
+    // Koko tarkastetaan ennen kirjoittamista, ettei liian suurta arkistoa kirjoiteta turhaan loppuun
+    QByteArray otsake = paikallinenOtsake(tietue);
+    if( !onnistui_ || !mahtuu( otsake.size() + sisalto.data.size()) ||
+        write( otsake ) != otsake.size() ||
+        write( sisalto.data ) != sisalto.data.size())
+    {
+        onnistui_ = false;
+        return;
+    }
+
+    tietueet_.append( tietue );
+}
+
+bool ZipArkisto::mahtuu(qint64 lisays) const
+{
+    return pos() + lisays <= ZIPRAJA && tietueet_.count() < TIETUERAJA;
+}
+
+bool ZipArkisto::kirjoitaTarkistaen(const char *data, qint64 pituus)
+{
+    if( !onnistui_ || !mahtuu( pituus ) || write( data, pituus ) != pituus )
+        onnistui_ = false;
+    return onnistui_;
+}
+
+bool ZipArkisto::kirjoitaTarkistaen(const QByteArray &data)
+{
+    return kirjoitaTarkistaen( data.constData(), data.size() );
+}
+
+QByteArray ZipArkisto::paikallinenOtsake(const ZipArkisto::Tietue &tietue) const
+{
+    QByteArray otsake;
+    QDataStream out( &otsake, QIODevice::WriteOnly);
+    out.setByteOrder( QDataStream::LittleEndian );
+
+    out << quint32(0x04034b50) << VERSIO << UTF8NIMET << tietue.menetelma
+        << aika_ << paiva_
+        << tietue.crc << tietue.pakattuKoko << tietue.koko
+        << quint16( tietue.nimi.length() ) << quint16(0);
+    out.writeRawData( tietue.nimi.constData(), tietue.nimi.length());
+
+    return otsake;
+}
@@ -0,0 +1,130 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ZIPARKISTO_H
+#define ZIPARKISTO_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QDateTime>
+#include <QFuture>
+#include <QQueue>
+#include <QList>
+
+#include "arkistoija/arkistonkohde.h"
+
+struct z_stream_s;
+
+/**
+ * @brief Zip-arkiston kirjoittaminen suoraan tiedostoon
+ *
+ * Toisin kuin libzip, joka kirjoittaa paketin vasta suljettaessa, tämä
+ * kirjoittaa jokaisen tiedoston heti, joten arkistoa ei tarvitse
+ * muodostaa ensin levylle. Tekstitiedostot pakataan deflate-menetelmällä
+ * taustasäikeissä, jo pakatut liitteet tallennetaan sellaisenaan.
+ */
+class ZipArkisto : protected QFile, public ArkistonKohde
+{
+public:
+    ZipArkisto(const QString& polku);
+    ~ZipArkisto() override;
+
+    /**
+     * @brief Aloittaa zip-arkiston kirjoittamisen
+     * @return tosi, jos onnistui
+     */
+    bool aloita();
+
+    bool kirjoita(const QString& nimi, const QByteArray& data, bool pakattava = true) override;
+
+    /**
+     * @brief Kirjoittaa keskushakemiston ja sulkee tiedoston
+     * @return tosi, jos koko arkiston kirjoittaminen onnistui
+     */
+    bool valmis() override;
+
+    /**
+     * @brief Tiedoston sisältö valmiina kirjoitettavaksi
+     */
+    struct Sisalto
+    {
+        QByteArray data;
+        quint32 crc = 0;
+        quint32 koko = 0;
+        bool pakattu = false;
+    };
+
+    /**
+     * @brief Laskee tarkisteen ja pakkaa, jos pakkaaminen pienentää tiedostoa
+     *
+     * Ei käytä muuta tilaa, joten voidaan ajaa taustasäikeessä
+     */
+    static Sisalto valmistele(const QByteArray& data, bool pakattava);
+
+protected:
+    bool aloitaOsa(const QString& nimi, bool pakattava) override;
+    bool kirjoitaOsa(const char* data, qint64 pituus) override;
+    bool lopetaOsa() override;
+
+    struct Tietue
+    {
+        QByteArray nimi;
+        quint32 crc = 0;
+        quint32 pakattuKoko = 0;
+        quint32 koko = 0;
+        quint32 sijainti = 0;
+        quint16 menetelma = 0;
+    };
+
+    struct Odottava
+    {
+        QByteArray nimi;
+        QFuture<Sisalto> tulos;
+    };
+
+    /**
+     * @brief Kirjoittaa valmistuneet pakkaukset järjestyksessä
+     * @param kaikki Odotetaanko kaikkia keskeneräisiä
+     */
+    void kirjoitaValmiit(bool kaikki = false);
+    void kirjoitaTietue(const QByteArray& nimi, const Sisalto& sisalto);
+    QByteArray paikallinenOtsake(const Tietue& tietue) const;
+
+    /**
+     * @brief Mahtuuko arkistoon vielä lisays tavua ilman Zip64-laajennusta
+     */
+    bool mahtuu(qint64 lisays) const;
+    /**
+     * @brief Kirjoittaa tiedostoon ja merkitsee arkiston epäonnistuneeksi, jos kaikki ei mennyt perille
+     */
+    bool kirjoitaTarkistaen(const char* data, qint64 pituus);
+    bool kirjoitaTarkistaen(const QByteArray& data);
+
+    QList<Tietue> tietueet_;
+    QQueue<Odottava> jono_;
+
+    quint16 aika_ = 0;
+    quint16 paiva_ = 0;
+
+    // Virtana kirjoitettavan tiedoston tila
+    Tietue osa_;
+    z_stream_s* virta_ = nullptr;
+    bool onnistui_ = true;      // Kun yksikin kirjoitus epäonnistuu, loput jätetään tekemättä
+};
+
+#endif // ZIPARKISTO_H
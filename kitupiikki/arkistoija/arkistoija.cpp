@@ -25,6 +25,7 @@
 #include <QApplication>
 
 #include "arkistoija.h"
+#include "arkistonkohde.h"
 #include "db/tositemodel.h"
 
 #include "raportti/raportoija.h"
@@ -33,48 +34,62 @@
 #include "raportti/tilikarttaraportti.h"
 #include "raportti/tositeluetteloraportti.h"
 #include "raportti/taseerittely.h"
+#include "raportti/raporttivirta.h"
 
 #include <QDebug>
 
-Arkistoija::Arkistoija(Tilikausi tilikausi)
-    : tilikausi_(tilikausi)
+Arkistoija::Arkistoija(Tilikausi tilikausi, ArkistonKohde *kohde)
+    : kohde_(kohde), tilikausi_(tilikausi)
 {
 }
 
-void Arkistoija::luoHakemistot()
+void Arkistoija::luoHakemistot(const Tilikausi &tilikausi)
 {
     QDir hakemisto;
 
     hakemisto.mkpath( kp()->arkistopolku() );
-    hakemisto_ = QDir( kp()->arkistopolku() );
+    hakemisto = QDir( kp()->arkistopolku() );
 
-    QString arkistonimi = tilikausi_.arkistoHakemistoNimi();
+    QString arkistonimi = tilikausi.arkistoHakemistoNimi();
 
-    if( hakemisto_.exists( arkistonimi ) )
+    if( hakemisto.exists( arkistonimi ) )
     {
         // Jos hakemisto on jo olemassa, poistetaan se
-        hakemisto_.cd( arkistonimi);
-        hakemisto_.removeRecursively();
-        hakemisto_.cdUp();
+        hakemisto.cd( arkistonimi);
+        hakemisto.removeRecursively();
+        hakemisto.cdUp();
     }
 
 
-    hakemisto_.mkdir( arkistonimi );
-    hakemisto_.cd( arkistonimi );
+    hakemisto.mkdir( arkistonimi );
+}
 
+void Arkistoija::kirjoitaVakiotiedostot()
+{
     if( !kp()->logo().isNull() )
     {
-        kp()->logo().save(hakemisto_.absoluteFilePath("logo.png"),"PNG");
+        QByteArray logo;
+        QBuffer puskuri( &logo );
+        puskuri.open( QIODevice::WriteOnly );
+        kp()->logo().save( &puskuri, "PNG");
+        kohde_->kirjoita("logo.png", logo, false);
         onkoLogoa = true;
     }
 
 
     // Kopioidaan vakitiedostot
-    QFile::copy( ":/arkisto/arkisto.css", hakemisto_.absoluteFilePath("arkisto.css"));
-    QFile::copy( ":/arkisto/jquery.js", hakemisto_.absoluteFilePath("jquery.js"));
-    QFile::copy( ":/arkisto/ohje.html", hakemisto_.absoluteFilePath("ohje.html"));
-    QFile::copy( ":/pic/aboutpossu.png", hakemisto_.absoluteFilePath("kitupiikki.png"));
+    kopioiResurssi( ":/arkisto/arkisto.css", "arkisto.css", true);
+    kopioiResurssi( ":/arkisto/jquery.js", "jquery.js", true);
+    kopioiResurssi( ":/arkisto/ohje.html", "ohje.html", true);
+    kopioiResurssi( ":/pic/aboutpossu.png", "kitupiikki.png", false);
+
+}
 
+void Arkistoija::kopioiResurssi(const QString &resurssi, const QString &tiedostonnimi, bool pakattava)
+{
+    QFile tiedosto( resurssi );
+    tiedosto.open( QIODevice::ReadOnly );
+    kohde_->kirjoita( tiedostonnimi, tiedosto.readAll(), pakattava );
 }
 
 /**
@@ -245,8 +260,9 @@ void Arkistoija::arkistoiTositteet()
                      << "</td><td><a href='" << liiteIndeksi.data(LiiteModel::TiedostoNimiRooli).toString()
                      << "' class=avaaliite>Avaa</a></td></tr>\n";
 
+                // Liitteet ovat jo valmiiksi pakattuja (pdf, jpg), joten ne tallennetaan sellaisenaan
                 arkistoiByteArray(  liiteIndeksi.data(LiiteModel::TiedostoNimiRooli).toString() ,
-                                    liiteIndeksi.data(LiiteModel::PdfRooli).toByteArray() );
+                                    liiteIndeksi.data(LiiteModel::PdfRooli).toByteArray(), false );
 
             }
             out << "</table>";
@@ -414,15 +430,7 @@ void Arkistoija::arkistoiTositteet()
 
         out.flush();
 
-        shaBytes.append(QCryptographicHash::hash( bArray, QCryptographicHash::Sha256).toHex());
-        shaBytes.append(" ");
-        shaBytes.append(tiedostonnimi.toLatin1());
-        shaBytes.append("\n");
-
-        QFile tiedosto( hakemisto_.absoluteFilePath(tiedostonnimi) );
-        tiedosto.open( QIODevice::WriteOnly);
-        tiedosto.write( bArray);
-        tiedosto.close();
+        arkistoiByteArray( tiedostonnimi, bArray );
 
 
     }
@@ -432,9 +440,9 @@ void Arkistoija::arkistoiTositteet()
 void Arkistoija::kirjoitaIndeksiJaArkistoiRaportit()
 {
 
-    QFile tiedosto( hakemisto_.absoluteFilePath("index.html"));
-    tiedosto.open( QIODevice::WriteOnly);
-    QTextStream out( &tiedosto );
+    // Indeksi kootaan muistiin, koska raportit kirjoitetaan kohteeseen sen lomassa
+    QByteArray indeksi;
+    QTextStream out( &indeksi );
     out.setCodec("UTF-8");
 
     out << "<html><meta charset=\"UTF-8\"><head><title>";
@@ -560,16 +568,14 @@ void Arkistoija::kirjoitaIndeksiJaArkistoiRaportit()
         out << "Kirjanpito on viel&auml; keskener&auml;inen.";
 
     out << "</body></html>";
+    out.flush();
+
+    kohde_->kirjoita("index.html", indeksi);
 
     // Jos löytyy tilinpäätös, kirjoitetaan se
     QByteArray ba = kp()->liitteet()->liite( tilikausi_.alkaa().toString(Qt::ISODate) );
     if( !ba.isEmpty())
-    {
-        QFile tilinpaatos( hakemisto_.absoluteFilePath( "tilinpaatos.pdf" ) );
-        tilinpaatos.open(QIODevice::WriteOnly);
-        tilinpaatos.write(ba);
-        tilinpaatos.close();
-    }
+        kohde_->kirjoita("tilinpaatos.pdf", ba, false);
 }
 
 
@@ -592,15 +598,32 @@ void Arkistoija::arkistoiTiedosto(const QString &tiedostonnimi, const QString &h
     arkistoiByteArray( tiedostonnimi, bArray );
 }
 
-void Arkistoija::arkistoiByteArray(const QString &tiedostonnimi, const QByteArray &array)
+void Arkistoija::arkistoiByteArray(const QString &tiedostonnimi, const QByteArray &array, bool pakattava)
 {
-    QFile tiedosto( hakemisto_.absoluteFilePath(tiedostonnimi));
-    tiedosto.open( QIODevice::WriteOnly);
-    tiedosto.write( array );
-    tiedosto.close();
+    kohde_->kirjoita( tiedostonnimi, array, pakattava );
 
     // SHA-varmistus
-    shaBytes.append(QCryptographicHash::hash( array, QCryptographicHash::Sha256).toHex());
+    lisaaTiiviste( tiedostonnimi, QCryptographicHash::hash( array, QCryptographicHash::Sha256).toHex() );
+}
+
+void Arkistoija::arkistoiRaportti(const QString &tiedostonnimi, const std::function<void (RaportinKirjoittaja &)> &kirjoita)
+{
+    HtmlRaporttiVirta virta( kohde_->aloitaTiedosto(tiedostonnimi), true);
+    virta.lisaaOtsakkeeseen("<link rel='stylesheet' type='text/css' href='arkisto.css'>");
+    virta.lisaaSivunAlkuun( navipalkki() );
+
+    RaportinKirjoittaja kirjoittaja;
+    kirjoittaja.asetaVirta( &virta );
+    kirjoita( kirjoittaja );
+    kirjoittaja.lopetaVirta();
+
+    // Kohde laskee tiivisteen kirjoittaessaan, joten tiedostoa ei tarvitse lukea uudelleen
+    lisaaTiiviste( tiedostonnimi, kohde_->lopetaTiedosto() );
+}
+
+void Arkistoija::lisaaTiiviste(const QString &tiedostonnimi, const QByteArray& tiiviste)
+{
+    shaBytes.append( tiiviste );
     shaBytes.append(" ");
     shaBytes.append(tiedostonnimi.toLatin1());
     shaBytes.append("\n");
@@ -608,10 +631,7 @@ void Arkistoija::arkistoiByteArray(const QString &tiedostonnimi, const QByteArra
 
 void Arkistoija::kirjoitaHash()
 {
-    QFile tiedosto( hakemisto_.absoluteFilePath( "arkisto.sha256" ));
-    tiedosto.open( QIODevice::WriteOnly );
-    tiedosto.write( shaBytes );
-    tiedosto.close();
+    kohde_->kirjoita("arkisto.sha256", shaBytes );
 }
 
 QString Arkistoija::navipalkki(int edellinen, int seuraava)
@@ -650,22 +670,29 @@ QString Arkistoija::navipalkki(int edellinen, int seuraava)
 
 QString Arkistoija::arkistoi(Tilikausi &tilikausi)
 {
-    Arkistoija arkistoija(tilikausi);
-    arkistoija.luoHakemistot();
+    Arkistoija::luoHakemistot( tilikausi );
+    HakemistoKohde kohde( kp()->arkistopolku() + "/" + tilikausi.arkistoHakemistoNimi() );
+    return arkistoi( tilikausi, &kohde );
+}
+
+QString Arkistoija::arkistoi(Tilikausi &tilikausi, ArkistonKohde *kohde)
+{
+    Arkistoija arkistoija(tilikausi, kohde);
+    arkistoija.kirjoitaVakiotiedostot();
     arkistoija.arkistoiTositteet();
 
     arkistoija.arkistoiTiedosto("taseerittely.html",
                                  TaseErittely::kirjoitaRaportti( tilikausi.alkaa(), tilikausi.paattyy()).html(true) );
-    arkistoija.arkistoiTiedosto("paivakirja.html",
-                                PaivakirjaRaportti::kirjoitaRaportti( tilikausi.alkaa(), tilikausi.paattyy(), -1, false, false, true, true).html(true) );
-    arkistoija.arkistoiTiedosto("paakirja.html",
-                                PaakirjaRaportti::kirjoitaRaportti( tilikausi.alkaa(), tilikausi.paattyy(), -1, true, true).html(true));
+    arkistoija.arkistoiRaportti("paivakirja.html", [&tilikausi] (RaportinKirjoittaja& rk)
+        { PaivakirjaRaportti::kirjoitaRaportti( rk, tilikausi.alkaa(), tilikausi.paattyy(), -1, false, false, true, true); });
+    arkistoija.arkistoiRaportti("paakirja.html", [&tilikausi] (RaportinKirjoittaja& rk)
+        { PaakirjaRaportti::kirjoitaRaportti( rk, tilikausi.alkaa(), tilikausi.paattyy(), -1, true, true); });
     arkistoija.arkistoiTiedosto("tililuettelo.html",
                                 TilikarttaRaportti::kirjoitaRaportti(TilikarttaRaportti::KAYTOSSA_TILIT, tilikausi, true, false, tilikausi.paattyy(),true).html(true));
-    arkistoija.arkistoiTiedosto("tositeluettelo.html",
-                                TositeluetteloRaportti::kirjoitaRaportti( tilikausi.alkaa(), tilikausi.paattyy(), true, true, false, false, true).html(true) );
-    arkistoija.arkistoiTiedosto("tositepaivakirja.html",
-                                TositeluetteloRaportti::kirjoitaRaportti( tilikausi.alkaa(), tilikausi.paattyy(), true, true, true, true, true).html(true));
+    arkistoija.arkistoiRaportti("tositeluettelo.html", [&tilikausi] (RaportinKirjoittaja& rk)
+        { TositeluetteloRaportti::kirjoitaRaportti( rk, tilikausi.alkaa(), tilikausi.paattyy(), true, true, false, false, true); });
+    arkistoija.arkistoiRaportti("tositepaivakirja.html", [&tilikausi] (RaportinKirjoittaja& rk)
+        { TositeluetteloRaportti::kirjoitaRaportti( rk, tilikausi.alkaa(), tilikausi.paattyy(), true, true, true, true, true); });
 
     // Tämän pitää tulla lopuksi jotta hash toimii !!!
     arkistoija.kirjoitaIndeksiJaArkistoiRaportit();
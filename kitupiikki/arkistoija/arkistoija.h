@@ -30,8 +30,13 @@
 #include <QTextStream>
 #include <QBuffer>
 
+#include <functional>
+
 #include "db/kirjanpito.h"
 
+class RaportinKirjoittaja;
+class ArkistonKohde;
+
 /**
  * @brief Arkiston kirjoittaja
  */
@@ -39,9 +44,16 @@ class Arkistoija : public QObject
 {
     Q_OBJECT
 protected:
-    Arkistoija(Tilikausi tilikausi);
+    Arkistoija(Tilikausi tilikausi, ArkistonKohde* kohde);
     
-    void luoHakemistot();
+    /**
+     * @brief Luo tyhjän arkistohakemiston ohjelman arkistopolkuun
+     */
+    static void luoHakemistot(const Tilikausi& tilikausi);
+
+    void kirjoitaVakiotiedostot();
+    void kopioiResurssi(const QString& resurssi, const QString& tiedostonnimi, bool pakattava);
+
     void arkistoiTositteet();
 
     void kirjoitaIndeksiJaArkistoiRaportit();
@@ -49,13 +61,28 @@ protected:
     void arkistoiTiedosto(const QString& tiedostonnimi,
                           const QString& html);
 
-    void arkistoiByteArray(const QString& tiedostonnimi, const QByteArray& array);
+    /**
+     * @param pakattava Epätosi jo valmiiksi pakatuille tiedostoille, kuten liitteille
+     */
+    void arkistoiByteArray(const QString& tiedostonnimi, const QByteArray& array, bool pakattava = true);
+
+    /**
+     * @brief Kirjoittaa raportin suoraan tiedostoon sitä mukaa kuin rivejä syntyy
+     * @param kirjoita Funktio, joka kirjoittaa raportin sille annettuun kirjoittajaan
+     */
+    void arkistoiRaportti(const QString& tiedostonnimi,
+                          const std::function<void(RaportinKirjoittaja&)>& kirjoita);
+
+    /**
+     * @brief Lisää kirjoitetun tiedoston tiivisteen luetteloon
+     */
+    void lisaaTiiviste(const QString& tiedostonnimi, const QByteArray& tiiviste);
 
     void kirjoitaHash();
 
     QString navipalkki(int edellinen=0, int seuraava=0);
     
-    QDir hakemisto_;
+    ArkistonKohde* kohde_;
     Tilikausi tilikausi_;    
 
     bool onkoLogoa = false;
@@ -69,6 +96,17 @@ public:
      * @return Sha256-tiiviste heksamuodossa
      */
     static QString arkistoi(Tilikausi &tilikausi);
+
+    /**
+     * @brief Kirjoittaa kirjanpitoarkiston annettuun kohteeseen
+     *
+     * Kohteena voi olla hakemisto tai suoraan kirjoitettava zip- tai tar-paketti,
+     * jolloin arkistoa ei tarvitse muodostaa ensin levylle.
+     * Kohde viimeistellään kutsujan toimesta (ArkistonKohde::valmis).
+     *
+     * @return Sha256-tiiviste heksamuodossa
+     */
+    static QString arkistoi(Tilikausi &tilikausi, ArkistonKohde* kohde);
 };
 
 #endif // ARKISTOIJA_H
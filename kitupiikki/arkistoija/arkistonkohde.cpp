@@ -0,0 +1,138 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <QIODevice>
+#include <QCryptographicHash>
+
+#include "arkistonkohde.h"
+
+/**
+ * @brief Laite, jonka kautta tiedosto kirjoitetaan kohteeseen virtana
+ *
+ * Laskee samalla tiedoston tiivisteen, jottei kirjoitettua tiedostoa
+ * tarvitse lukea uudelleen.
+ */
+class ArkistonKohdeLaite : public QIODevice
+{
+public:
+    ArkistonKohdeLaite(ArkistonKohde* kohde)
+        : kohde_(kohde), tiiviste_(QCryptographicHash::Sha256) {}
+
+    void aloita()
+    {
+        tiiviste_.reset();
+        onnistui_ = true;
+        open( QIODevice::WriteOnly );
+    }
+
+    QByteArray lopeta()
+    {
+        close();
+        return tiiviste_.result().toHex();
+    }
+
+    bool onnistui() const { return onnistui_; }
+
+protected:
+    qint64 readData(char * /* data */, qint64 /* maxlen */) override { return -1; }
+
+    qint64 writeData(const char* data, qint64 len) override
+    {
+        tiiviste_.addData(data, static_cast<int>(len));
+        if( !kohde_->kirjoitaOsa(data, len))
+        {
+            onnistui_ = false;
+            return -1;
+        }
+        return len;
+    }
+
+    ArkistonKohde* kohde_;
+    QCryptographicHash tiiviste_;
+    bool onnistui_ = true;
+};
+
+
+ArkistonKohde::ArkistonKohde()
+    : laite_( new ArkistonKohdeLaite(this))
+{
+
+}
+
+ArkistonKohde::~ArkistonKohde()
+{
+    delete laite_;
+}
+
+bool ArkistonKohde::kirjoita(const QString &nimi, const QByteArray &data, bool pakattava)
+{
+    if( !aloitaOsa(nimi, pakattava))
+        return false;
+    bool onnistui = kirjoitaOsa( data.constData(), data.size());
+    return lopetaOsa() && onnistui;
+}
+
+QIODevice *ArkistonKohde::aloitaTiedosto(const QString &nimi, bool pakattava)
+{
+    aloitaOsa(nimi, pakattava);
+    laite_->aloita();
+    return laite_;
+}
+
+QByteArray ArkistonKohde::lopetaTiedosto()
+{
+    QByteArray tiiviste = laite_->lopeta();
+    lopetaOsa();
+    return tiiviste;
+}
+
+
+HakemistoKohde::HakemistoKohde(const QString &polku)
+    : hakemisto_(polku)
+{
+    hakemisto_.mkpath( polku );
+}
+
+bool HakemistoKohde::valmis()
+{
+    return onnistui_;
+}
+
+bool HakemistoKohde::aloitaOsa(const QString &nimi, bool /* pakattava */)
+{
+    tiedosto_.setFileName( hakemisto_.absoluteFilePath(nimi) );
+    if( !tiedosto_.open( QIODevice::WriteOnly ))
+        onnistui_ = false;
+    return tiedosto_.isOpen();
+}
+
+bool HakemistoKohde::kirjoitaOsa(const char *data, qint64 pituus)
+{
+    if( tiedosto_.write(data, pituus) != pituus )
+    {
+        onnistui_ = false;
+        return false;
+    }
+    return true;
+}
+
+bool HakemistoKohde::lopetaOsa()
+{
+    tiedosto_.close();
+    return onnistui_;
+}
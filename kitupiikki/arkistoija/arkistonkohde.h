@@ -0,0 +1,102 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ARKISTONKOHDE_H
+#define ARKISTONKOHDE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+
+class ArkistonKohdeLaite;
+
+/**
+ * @brief Paikka, johon Arkistoija kirjoittaa arkiston tiedostot
+ *
+ * Kohde voi olla hakemisto tai suoraan kirjoitettava zip- tai tar-paketti.
+ * Tiedoston voi kirjoittaa kerralla kirjoita():lla tai virtana
+ * aloitaTiedosto():n palauttamaan laitteeseen.
+ */
+class ArkistonKohde
+{
+public:
+    ArkistonKohde();
+    virtual ~ArkistonKohde();
+
+    /**
+     * @brief Kirjoittaa kokonaisen tiedoston
+     * @param nimi Tiedoston nimi arkistossa
+     * @param data Sisältö
+     * @param pakattava Kannattaako sisältö pakata (tekstit), vai onko se jo valmiiksi pakattua (liitteet)
+     * @return tosi, jos onnistui
+     */
+    virtual bool kirjoita(const QString& nimi, const QByteArray& data, bool pakattava = true);
+
+    /**
+     * @brief Aloittaa tiedoston, jonka sisältö kirjoitetaan palautettuun laitteeseen
+     *
+     * Tiedosto päätetään lopetaTiedosto():lla ennen seuraavan tiedoston kirjoittamista.
+     */
+    QIODevice* aloitaTiedosto(const QString& nimi, bool pakattava = true);
+
+    /**
+     * @brief Päättää aloitaTiedosto():lla aloitetun tiedoston
+     * @return Tiedoston sha256-tiiviste heksamuodossa
+     */
+    QByteArray lopetaTiedosto();
+
+    /**
+     * @brief Viimeistelee arkiston
+     * @return tosi, jos kaikki kirjoitukset onnistuivat
+     */
+    virtual bool valmis() { return true; }
+
+protected:
+    virtual bool aloitaOsa(const QString& nimi, bool pakattava) = 0;
+    virtual bool kirjoitaOsa(const char* data, qint64 pituus) = 0;
+    virtual bool lopetaOsa() = 0;
+
+private:
+    ArkistonKohdeLaite* laite_;
+
+    friend class ArkistonKohdeLaite;
+};
+
+
+/**
+ * @brief Arkisto tavallisena hakemistona
+ */
+class HakemistoKohde : public ArkistonKohde
+{
+public:
+    HakemistoKohde(const QString& polku);
+
+    bool valmis() override;
+
+protected:
+    bool aloitaOsa(const QString& nimi, bool pakattava) override;
+    bool kirjoitaOsa(const char* data, qint64 pituus) override;
+    bool lopetaOsa() override;
+
+    QDir hakemisto_;
+    QFile tiedosto_;
+    bool onnistui_ = true;
+};
+
+#endif // ARKISTONKOHDE_H
@@ -0,0 +1,76 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <QSqlQuery>
+#include <QStringList>
+
+#include "alvkooste.h"
+
+void AlvKooste::muuta(QSqlDatabase *tietokanta, int tositeId, int etumerkki)
+{
+    QSqlQuery kysely( *tietokanta );
+    kysely.exec( QString("SELECT strftime('%Y-%m-01', pvm) AS kuukausi, alvkoodi, IFNULL(alvprosentti,0) AS alvprosentti, "
+                         "IFNULL(tili,0) AS tili, SUM(IFNULL(debetsnt,0)) AS debetit, SUM(IFNULL(kreditsnt,0)) AS kreditit "
+                         "FROM vienti WHERE tosite=%1 AND alvkoodi > 0 "
+                         "GROUP BY kuukausi, alvkoodi, alvprosentti, tili").arg(tositeId) );
+
+    QSqlQuery lisays( *tietokanta );
+    lisays.prepare("INSERT OR IGNORE INTO alvkooste(kuukausi, alvkoodi, alvprosentti, tili) VALUES (?,?,?,?)");
+    QSqlQuery paivitys( *tietokanta );
+    paivitys.prepare("UPDATE alvkooste SET debetsnt = debetsnt + ?, kreditsnt = kreditsnt + ? "
+                     "WHERE kuukausi=? AND alvkoodi=? AND alvprosentti=? AND tili=?");
+
+    while( kysely.next())
+    {
+        for(int i=0; i < 4; i++)
+            lisays.bindValue(i, kysely.value(i));
+        lisays.exec();
+
+        paivitys.bindValue(0, etumerkki * kysely.value("debetit").toLongLong());
+        paivitys.bindValue(1, etumerkki * kysely.value("kreditit").toLongLong());
+        for(int i=0; i < 4; i++)
+            paivitys.bindValue(i + 2, kysely.value(i));
+        paivitys.exec();
+    }
+}
+
+QString AlvKooste::lahde(const QDate &alkaa, const QDate &paattyy)
+{
+    // Koosteesta haetaan ne kuukaudet, jotka ovat kokonaan kaudella
+    QDate ekaKuukausi = alkaa.day() == 1 ? alkaa : QDate( alkaa.year(), alkaa.month(), 1).addMonths(1);
+    QDate vikaKuukausi = QDate( paattyy.year(), paattyy.month(), 1);
+    if( paattyy.day() != paattyy.daysInMonth())
+        vikaKuukausi = vikaKuukausi.addMonths(-1);
+
+    const QString vienneista = QString("SELECT alvkoodi, alvprosentti, tili, debetsnt, kreditsnt FROM vienti "
+                                       "WHERE alvkoodi > 0 AND pvm BETWEEN '%1' AND '%2'");
+
+    if( ekaKuukausi > vikaKuukausi)
+        return "(" + vienneista.arg( alkaa.toString(Qt::ISODate) ).arg( paattyy.toString(Qt::ISODate)) + ")";
+
+    QStringList osat;
+    osat.append( QString("SELECT alvkoodi, alvprosentti, tili, debetsnt, kreditsnt FROM alvkooste "
+                         "WHERE kuukausi BETWEEN '%1' AND '%2'")
+                 .arg( ekaKuukausi.toString(Qt::ISODate)).arg( vikaKuukausi.toString(Qt::ISODate)));
+    if( alkaa < ekaKuukausi )
+        osat.append( vienneista.arg( alkaa.toString(Qt::ISODate)).arg( ekaKuukausi.addDays(-1).toString(Qt::ISODate)));
+    if( paattyy >= vikaKuukausi.addMonths(1))
+        osat.append( vienneista.arg( vikaKuukausi.addMonths(1).toString(Qt::ISODate)).arg( paattyy.toString(Qt::ISODate)));
+
+    return "(" + osat.join(" UNION ALL ") + ")";
+}
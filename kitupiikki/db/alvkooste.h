@@ -0,0 +1,60 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ALVKOOSTE_H
+#define ALVKOOSTE_H
+
+#include <QString>
+#include <QDate>
+#include <QSqlDatabase>
+
+/**
+ * @brief Arvonlisäverokirjausten kuukausittainen kooste
+ *
+ * Taulussa alvkooste pidetään vientien summat kuukausittain alv-koodin,
+ * verokannan ja tilin mukaan. Kooste päivitetään tositteen tallennuksen
+ * ja poistamisen yhteydessä, joten alv-laskelmaa varten ei tarvitse
+ * käydä läpi kaikkia kauden vientejä.
+ */
+class AlvKooste
+{
+public:
+    /**
+     * @brief Lisää tai vähentää tositteen alv-viennit koosteeseen
+     *
+     * Kutsutaan tallennettaessa -1:llä ennen vientien tallentamista
+     * ja +1:llä tallentamisen jälkeen.
+     *
+     * @param tietokanta Tietokanta, jonka transaktiossa päivitetään
+     * @param tositeId Tositteen id
+     * @param etumerkki 1 lisää, -1 vähentää
+     */
+    static void muuta(QSqlDatabase *tietokanta, int tositeId, int etumerkki);
+
+    /**
+     * @brief Alikysely, josta saadaan kauden alv-summat
+     *
+     * Kokonaiset kuukaudet haetaan koosteesta ja vajaat kuukaudet
+     * vienneistä. Alikyselyssä on sarakkeet alvkoodi, alvprosentti,
+     * tili, debetsnt ja kreditsnt, ja se käytetään muodossa
+     * <code>FROM %1 AS v</code>.
+     */
+    static QString lahde(const QDate& alkaa, const QDate& paattyy);
+};
+
+#endif // ALVKOOSTE_H
@@ -60,6 +60,7 @@ void AsetusModel::aseta(const QString &avain, const QString &arvo)
     {
         asetukset_[avain] = arvo;
         muokatut_[avain] = nykyinen;
+        versio_++;
     }
     else
     {
@@ -76,6 +77,7 @@ void AsetusModel::poista(const QString &avain)
         QSqlQuery query(*tietokanta_);
         query.exec( QString("DELETE from asetus WHERE avain=\"%1\"").arg(avain));
         asetukset_.remove(avain);
+        versio_++;
     }
 }
 
@@ -204,6 +206,7 @@ void AsetusModel::lataa()
 {
     asetukset_.clear();
     muokatut_.clear();
+    versio_++;
     QSqlQuery query(*tietokanta_);
     query.exec("SELECT avain,arvo,muokattu FROM asetus");
     while( query.next())
@@ -88,7 +88,14 @@ public:
     void tilikarttaMoodiin(bool onko);
 
     void lataa();
-    void tyhjenna() { asetukset_.clear(); }
+    void tyhjenna() { asetukset_.clear(); versio_++; }
+
+    /**
+     * @brief Kasvaa aina, kun jokin asetus muuttuu
+     *
+     * Asetuksista koottujen välimuistien (esim. laskupohja) vanhentamiseen
+     */
+    int versio() const { return versio_; }
 
 signals:
 
@@ -101,6 +108,7 @@ protected:
     QSqlDatabase *tietokanta_;
 
     bool alustetaanTietokantaa_;    /** tosi, jos tietokantaa vasta luodaan */
+    int versio_ = 0;
 
 };
 
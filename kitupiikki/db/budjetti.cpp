@@ -0,0 +1,58 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QSqlQuery>
+
+#include "budjetti.h"
+
+void Budjetti::paivita(QSqlDatabase *tietokanta, const QDate &kausi, const QVariantMap &budjetit)
+{
+    poista(tietokanta, kausi);
+
+    QSqlQuery kysely( *tietokanta );
+    kysely.prepare("INSERT INTO budjetti(kausi, kohdennus, tili, sentit) VALUES(:kausi, :kohdennus, :tili, :sentit)");
+
+    QMapIterator<QString,QVariant> kohdennusIter(budjetit);
+    while( kohdennusIter.hasNext())
+    {
+        kohdennusIter.next();
+        QMapIterator<QString,QVariant> tiliIter( kohdennusIter.value().toMap());
+        while( tiliIter.hasNext())
+        {
+            tiliIter.next();
+            kysely.bindValue(":kausi", kausi);
+            kysely.bindValue(":kohdennus", kohdennusIter.key().toInt());
+            kysely.bindValue(":tili", tiliIter.key().toInt());
+            kysely.bindValue(":sentit", tiliIter.value().toLongLong());
+            kysely.exec();
+        }
+    }
+}
+
+void Budjetti::poista(QSqlDatabase *tietokanta, const QDate &kausi)
+{
+    QSqlQuery kysely( *tietokanta );
+    kysely.exec( QString("DELETE FROM budjetti WHERE kausi='%1'").arg(kausi.toString(Qt::ISODate)));
+}
+
+QString Budjetti::kysely(const QDate &mista, const QDate &mihin)
+{
+    return QString("SELECT tilikausi.alkaa, tilikausi.loppuu, budjetti.kohdennus, budjetti.tili, budjetti.sentit "
+                   "FROM budjetti JOIN tilikausi ON budjetti.kausi=tilikausi.alkaa "
+                   "WHERE tilikausi.alkaa <= '%2' AND tilikausi.loppuu >= '%1'")
+            .arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate));
+}
@@ -0,0 +1,64 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BUDJETTI_H
+#define BUDJETTI_H
+
+#include <QString>
+#include <QDate>
+#include <QVariantMap>
+#include <QSqlDatabase>
+
+/**
+ * @brief Budjetit taulumuodossa
+ *
+ * Budjetit tallennetaan tilikauden json-kenttään, ja sen lisäksi
+ * taulussa budjetti pidetään yksi rivi tilikautta, kohdennusta ja
+ * tiliä kohden. Raportit hakevat budjetit taulusta yhdellä kyselyllä
+ * purkamatta jokaisen tilikauden jsonia.
+ */
+class Budjetti
+{
+public:
+    /**
+     * @brief Kirjoittaa tilikauden budjetit tauluun
+     *
+     * Kutsutaan aina, kun tilikauden json tallennetaan.
+     *
+     * @param tietokanta Tietokanta
+     * @param kausi Tilikauden alkupäivä
+     * @param budjetit Tilikauden json-kentän Budjetti (kohdennus -> tili -> sentit)
+     */
+    static void paivita(QSqlDatabase *tietokanta, const QDate& kausi, const QVariantMap& budjetit);
+
+    /**
+     * @brief Poistaa tilikauden budjetit taulusta
+     * @param tietokanta Tietokanta
+     * @param kausi Tilikauden alkupäivä
+     */
+    static void poista(QSqlDatabase *tietokanta, const QDate& kausi);
+
+    /**
+     * @brief Kysely ajanjaksoon osuvien tilikausien budjeteista
+     *
+     * Kyselyssä on sarakkeet alkaa, loppuu, kohdennus, tili (numero)
+     * ja sentit.
+     */
+    static QString kysely(const QDate& mista, const QDate& mihin);
+};
+
+#endif // BUDJETTI_H
@@ -18,6 +18,7 @@
 #include "eranvalintamodel.h"
 #include <QSqlQuery>
 #include "kirjanpito.h"
+#include "erasaldo.h"
 
 #include <QHash>
 #include <QPair>
@@ -82,6 +83,13 @@ QVariant EranValintaModel::data(const QModelIndex &index, int role) const
 
 void EranValintaModel::lataa(const Tili& tili, bool kaikki, QDate paivalle)
 {
+    // Nykyiset avoimet erät saadaan suoraan saldotaulusta
+    if( !kaikki && !paivalle.isValid())
+    {
+        lataaAvoimet(tili);
+        return;
+    }
+
     beginResetModel();
     erat_.clear();
 
@@ -126,6 +134,28 @@ void EranValintaModel::lataa(const Tili& tili, bool kaikki, QDate paivalle)
     endResetModel();
 }
 
+void EranValintaModel::lataaAvoimet(const Tili &tili, int mukaanEra)
+{
+    beginResetModel();
+    erat_.clear();
+
+    QSqlQuery query( *(kp()->tietokanta()) ) ;
+    query.setForwardOnly(true);
+    query.exec( EraSaldo::avoimet( tili.id(), mukaanEra) );
+
+    while( query.next())
+    {
+        TaseEra era;
+        era.eraId = query.value("id").toInt();
+        era.pvm = query.value("pvm").toDate();
+        era.selite = query.value("selite").toString();
+        era.saldoSnt = query.value("saldo").toLongLong();
+        era.tositeId = query.value("tosite").toInt();
+        erat_.append(era);
+    }
+    endResetModel();
+}
+
 TaseEra::TaseEra(int id)
 {
     eraId = id;
@@ -90,6 +90,16 @@ public:
      */
     void lataa(const Tili &tili, bool kaikki = false, QDate paivalle = QDate());
 
+    /**
+     * @brief Lataa tilin avoimet erät erien saldotaulusta
+     *
+     * Aika riippuu vain avoimien erien määrästä, ei tilin historiasta.
+     *
+     * @param tili Tili, jonka erät ladataan
+     * @param mukaanEra Erä, joka otetaan mukaan, vaikka se olisi jo tasan
+     */
+    void lataaAvoimet(const Tili &tili, int mukaanEra = 0);
+
 private:
     QList<TaseEra> erat_;
 };
@@ -0,0 +1,56 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <QSqlQuery>
+
+#include "erasaldo.h"
+
+void EraSaldo::muuta(QSqlDatabase *tietokanta, int tositeId, int etumerkki)
+{
+    QSqlQuery kysely( *tietokanta );
+    kysely.exec( QString("SELECT eraid, tili, SUM(IFNULL(debetsnt,0)) - SUM(IFNULL(kreditsnt,0)) AS saldo "
+                         "FROM vienti WHERE tosite=%1 AND eraid IS NOT NULL AND tili IS NOT NULL "
+                         "GROUP BY eraid, tili").arg(tositeId) );
+
+    QSqlQuery lisays( *tietokanta );
+    lisays.prepare("INSERT OR IGNORE INTO erasaldo(eraid, tili) VALUES (?,?)");
+    QSqlQuery paivitys( *tietokanta );
+    paivitys.prepare("UPDATE erasaldo SET saldo = saldo + ? WHERE eraid=? AND tili=?");
+
+    while( kysely.next())
+    {
+        lisays.bindValue(0, kysely.value("eraid"));
+        lisays.bindValue(1, kysely.value("tili"));
+        lisays.exec();
+
+        paivitys.bindValue(0, etumerkki * kysely.value("saldo").toLongLong());
+        paivitys.bindValue(1, kysely.value("eraid"));
+        paivitys.bindValue(2, kysely.value("tili"));
+        paivitys.exec();
+    }
+}
+
+QString EraSaldo::avoimet(int tiliId, int mukaanEra)
+{
+    // Ehto saldo <> 0 pidetään omana osanaan, jotta avoimien erien osittaisindeksiä käytetään.
+    // Erän aloittava vienti haetaan samalta tililtä kuten ennenkin (tili=%1 AND eraid=id)
+    return QString("SELECT vienti.id, vienti.pvm, vienti.selite, vienti.tosite, e.saldo "
+                   "FROM (SELECT eraid, saldo FROM erasaldo WHERE tili=%1 AND saldo <> 0 "
+                   "UNION SELECT eraid, saldo FROM erasaldo WHERE eraid=%2 AND tili=%1) AS e "
+                   "JOIN vienti ON vienti.id=e.eraid AND vienti.tili=%1 ORDER BY vienti.pvm").arg(tiliId).arg(mukaanEra);
+}
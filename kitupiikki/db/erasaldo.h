@@ -0,0 +1,61 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef ERASALDO_H
+#define ERASALDO_H
+
+#include <QSqlDatabase>
+#include <QString>
+
+/**
+ * @brief Tase-erien ajantasaiset saldot
+ *
+ * Taulussa erasaldo pidetään jokaisen tase-erän jäljellä oleva saldo
+ * tileittäin. Erä on avoin, kun sen saldo poikkeaa nollasta, ja avoimet
+ * erät löytyvät osittaisindeksin kautta käymättä läpi tilin historiaa.
+ * Saldot päivitetään tositteen tallennuksen ja poistamisen yhteydessä.
+ */
+class EraSaldo
+{
+public:
+    /**
+     * @brief Lisää tai vähentää tositteen tase-eräviennit saldoihin
+     *
+     * Kutsutaan tallennettaessa -1:llä ennen vientien tallentamista
+     * ja +1:llä tallentamisen jälkeen.
+     *
+     * @param tietokanta Tietokanta, jonka transaktiossa päivitetään
+     * @param tositeId Tositteen id
+     * @param etumerkki 1 lisää, -1 vähentää
+     */
+    static void muuta(QSqlDatabase *tietokanta, int tositeId, int etumerkki);
+
+    /**
+     * @brief Kysely tilin avoimista eristä
+     *
+     * Kyselyssä on sarakkeet id, pvm, selite, tosite ja saldo, ja erät
+     * ovat päivämääräjärjestyksessä.
+     *
+     * @param tiliId Tilin id
+     * @param mukaanEra Erä, joka otetaan mukaan, vaikka se olisi jo tasan
+     */
+    static QString avoimet(int tiliId, int mukaanEra = 0);
+};
+
+#endif // ERASALDO_H
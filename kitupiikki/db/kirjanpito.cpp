@@ -289,7 +289,7 @@ bool Kirjanpito::avaaTietokanta(const QString &tiedosto, bool ilmoitaVirheesta)
         if( QMessageBox::question(nullptr, tr("Kirjanpidon %1 päivittäminen").arg(asetusModel_->asetus("Nimi")),
                                   tr("Kirjanpito on luotu Kitupiikin versiolla %1 ja se täytyy päivittää, ennen kuin sitä "
                                      "voi käyttää nykyisellä versiolla %2.\n\n"
-                                     "Päivittämisen jälkeen kirjanpitoa ei voi enää avata vanhemmilla versioilla kuin 0.11\n\n"
+                                     "Päivittämisen jälkeen kirjanpitoa ei voi enää avata Kitupiikin vanhemmilla versioilla.\n\n"
                                      "On erittäin suositeltavaa varmuuskopioida kirjanpito ennen päivittämistä!\n\n"
                                      "Päivitetäänkö tietokanta Kitupiikin nykyiselle versiolle?").arg(asetusModel_->asetus("LuotuVersiolla"))
                                      .arg(qApp->applicationVersion()),
@@ -388,8 +388,27 @@ bool Kirjanpito::avaaTietokanta(const QString &tiedosto, bool ilmoitaVirheesta)
             asetaLogo(logo);
             liitteet_->tallenna();
         }
+        if( asetusModel_->luku("KpVersio") < 10)
+            asetusModel_->aseta("KpVersio", 10);
+
+        // Versiosta 11 alkaen jokaisella muutoksella on oma päivitystiedostonsa,
+        // ja versio kirjataan jokaisen onnistuneen päivityksen jälkeen
+        for(int versio = asetusModel_->luku("KpVersio") + 1; versio <= TIETOKANTAVERSIO; versio++)
+        {
+            if( !paivita(versio))
+            {
+                QMessageBox::critical(nullptr, tr("Kirjanpidon %1 päivittäminen epäonnistui").arg(asetusModel_->asetus("Nimi")),
+                                      tr("Kirjanpitoa ei voitu päivittää versioon %1 seuraavan virheen takia:\n%2\n\n"
+                                         "Käytössä oleva SQLite ei ehkä tue tekstihakua (FTS5) tai json-funktioita (JSON1).")
+                                      .arg(versio).arg( virheloki_.value( virheloki_.count() - 1) ));
+                tietokanta()->close();
+                asetusModel_->lataa();
+                emit tietokantaVaihtui();
+                return false;
+            }
+            asetusModel_->aseta("KpVersio", versio);
+        }
 
-        asetusModel_->aseta("KpVersio", TIETOKANTAVERSIO);
         asetusModel_->aseta("LuotuVersiolla", qApp->applicationVersion());
         QMessageBox::information(nullptr, tr("Kirjanpito päivitetty"),
                                  tr("Kirjanpito päivitetty käytössä olevaan versioon."));
@@ -482,21 +501,37 @@ QString Kirjanpito::satujono(int pituus)
     return randomString;
 }
 
-void Kirjanpito::paivita(int versioon)
+bool Kirjanpito::paivita(int versioon)
 {
     QFile sqltiedosto( QString(":/sql/update%1.sql").arg(versioon));
-    sqltiedosto.open(QIODevice::ReadOnly);
+    if( !sqltiedosto.open(QIODevice::ReadOnly))
+        return false;
     QTextStream in(&sqltiedosto);
+    in.setCodec("UTF-8");
     QString sqluonti = in.readAll();
     sqluonti.replace("\n"," ");
     QStringList sqlista = sqluonti.split(";");
-    QSqlQuery query;
+    QSqlQuery query( *tietokanta() );
+
+    // Vanhojen esitiedostoversioiden päivityksessä virheet ohitetaan
+    bool tarkistettava = versioon >= 11;
+    if( tarkistettava )
+        tietokanta()->transaction();
 
     foreach (QString kysely,sqlista)
     {
-        query.exec(kysely);
+        if( kysely.trimmed().isEmpty())
+            continue;
+        if( !query.exec(kysely) && tarkistettava )
+        {
+            lokiin(query);
+            tietokanta()->rollback();
+            return false;
+        }
         qApp->processEvents();
     }
+
+    return !tarkistettava || tietokanta()->commit();
 }
 
 Kirjanpito* Kirjanpito::instanssi__ = nullptr;
@@ -383,7 +383,7 @@ public:
      *
      * Jos yritetään avata uudempaa, tulee virhe
      */
-    static const int TIETOKANTAVERSIO = 10;
+    static const int TIETOKANTAVERSIO = 18;
 
     /**
      * @brief Palauttaa satunnaismerkkijonon
@@ -403,9 +403,15 @@ private:
 
     /**
      * @brief Suorittaa päivitykset
+     *
+     * Versiosta 11 alkaen päivitys tehdään yhtenä transaktiona, joka
+     * perutaan ensimmäisestä virheestä, esimerkiksi jos SQLitestä puuttuu
+     * FTS5 tai JSON1.
+     *
      * @param versioon Tietokantaversion (ei ohjelmaversio!)
+     * @return tosi, jos päivitys onnistui
      */
-    void paivita(int versioon);
+    bool paivita(int versioon);
 };
 
 /**
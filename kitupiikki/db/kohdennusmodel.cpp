@@ -120,6 +120,7 @@ bool KohdennusModel::setData(const QModelIndex &index, const QVariant &value, in
     else if( role == NimiRooli)
     {
         kohdennukset_[ index.row()].asetaNimi( value.toString());
+        paivitaHakemistot();
     }
     else if( role == AlkaaRooli)
     {
@@ -140,24 +141,24 @@ QString KohdennusModel::nimi(int id) const
     return kohdennus(id).nimi();
 }
 
-Kohdennus KohdennusModel::kohdennus(const int id) const
+const Kohdennus &KohdennusModel::kohdennus(const int id) const
 {
-    foreach (Kohdennus projekti, kohdennukset_)
-    {
-        if( projekti.id() == id)
-            return projekti;
-    }
-    return Kohdennus();
+    static const Kohdennus tyhja;
+
+    int indeksi = idHakemisto_.value(id, -1);
+    if( indeksi < 0 )
+        return tyhja;
+    return kohdennukset_.at(indeksi);
 }
 
-Kohdennus KohdennusModel::kohdennus(const QString &nimi) const
+const Kohdennus &KohdennusModel::kohdennus(const QString &nimi) const
 {
-    foreach (Kohdennus projekti, kohdennukset_)
-    {
-        if( projekti.nimi() == nimi)
-            return projekti;
-    }
-    return Kohdennus();
+    static const Kohdennus tyhja;
+
+    int indeksi = nimiHakemisto_.value(nimi, -1);
+    if( indeksi < 0 )
+        return tyhja;
+    return kohdennukset_.at(indeksi);
 }
 
 QList<Kohdennus> KohdennusModel::kohdennukset() const
@@ -193,6 +194,7 @@ void KohdennusModel::poistaRivi(int riviIndeksi)
         poistetutIdt_.append( kohdennus.id());
 
     kohdennukset_.removeAt(riviIndeksi);
+    paivitaHakemistot();
     endRemoveRows();
 }
 
@@ -223,6 +225,7 @@ void KohdennusModel::lataa()
                                      kysely.value(3).toDate(),
                                      kysely.value(4).toDate()));
     }
+    paivitaHakemistot();
     endResetModel();
 }
 
@@ -230,6 +233,7 @@ void KohdennusModel::lisaaUusi(const Kohdennus& uusi)
 {
     beginInsertRows(QModelIndex(), kohdennukset_.count(), kohdennukset_.count());
     kohdennukset_.append( uusi );
+    paivitaHakemistot();
     endInsertRows();
 }
 
@@ -275,6 +279,26 @@ void KohdennusModel::tallenna()
     poistetutIdt_.clear();
 
     tietokanta_->commit();
+    paivitaHakemistot();
+}
+
+void KohdennusModel::paivitaHakemistot()
+{
+    idHakemisto_.clear();
+    nimiHakemisto_.clear();
+    idHakemisto_.reserve( kohdennukset_.count() );
+    nimiHakemisto_.reserve( kohdennukset_.count() );
+
+    for(int i=0; i < kohdennukset_.count(); i++)
+    {
+        const Kohdennus& kohdennus = kohdennukset_.at(i);
+        // Useammasta osumasta (tallentamattomat id 0, samat nimet)
+        // hakemistoon jää ensimmäinen, kuten aiemmassa lineaarisessa haussa
+        if( !idHakemisto_.contains( kohdennus.id()))
+            idHakemisto_.insert( kohdennus.id(), i);
+        if( !nimiHakemisto_.contains( kohdennus.nimi()))
+            nimiHakemisto_.insert( kohdennus.nimi(), i);
+    }
 }
 
 
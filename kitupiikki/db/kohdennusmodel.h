@@ -21,6 +21,7 @@
 #include <QAbstractTableModel>
 #include <QDate>
 #include <QList>
+#include <QHash>
 #include <QSqlDatabase>
 
 #include "kohdennus.h"
@@ -61,8 +62,16 @@ public:
     bool setData(const QModelIndex &index, const QVariant &value, int role);
 
     QString nimi(int id) const;
-    Kohdennus kohdennus(const int id) const;
-    Kohdennus kohdennus(const QString& nimi) const;
+    /**
+     * @brief Kohdennus id:llä
+     *
+     * Haku tehdään hajautustaulusta, joten sitä voi käyttää rivikohtaisesti
+     * raporteissa ja selausnäkymissä.
+     *
+     * @return Viittaus kohdennukseen tai tyhjään kohdennukseen, jos ei löydy
+     */
+    const Kohdennus& kohdennus(const int id) const;
+    const Kohdennus& kohdennus(const QString& nimi) const;
     QList<Kohdennus> kohdennukset() const;
 
     /**
@@ -91,10 +100,18 @@ public slots:
 
 
 protected:
+    /**
+     * @brief Muodostaa id- ja nimihakemistot uudelleen
+     */
+    void paivitaHakemistot();
+
     QSqlDatabase *tietokanta_;
     QList<Kohdennus> kohdennukset_;
     QList<int> poistetutIdt_;
 
+    QHash<int,int> idHakemisto_;            // id -> indeksi kohdennukset_-listassa
+    QHash<QString,int> nimiHakemisto_;      // nimi -> indeksi
+
 
 };
 
@@ -129,6 +129,15 @@ bool LiiteModel::setData(const QModelIndex &index, const QVariant &value, int ro
 
 
 int LiiteModel::lisaaLiite(const QByteArray &liite, const QString &otsikko, const QString &polusta)
+{
+    QByteArray thumbnail;
+    if( !liite.startsWith("%PDF") ||  !kp()->settings()->value("PopplerPois").toBool() )
+        thumbnail = pikkukuva(liite);
+
+    return lisaaLiite(liite, otsikko, thumbnail, polusta);
+}
+
+int LiiteModel::lisaaLiite(const QByteArray &liite, const QString &otsikko, const QByteArray &pikkukuva, const QString &polusta)
 {
     beginInsertRows( QModelIndex(), liitteet_.count(), liitteet_.count() );
     Liite uusi;
@@ -138,10 +147,24 @@ int LiiteModel::lisaaLiite(const QByteArray &liite, const QString &otsikko, cons
     uusi.otsikko = otsikko;
     uusi.muokattu = true;
     uusi.lisattyPolusta = polusta;
+    uusi.thumbnail = pikkukuva;
 
-    if( liite.startsWith("%PDF") &&  !kp()->settings()->value("PopplerPois").toBool() )
-    {
+    liitteet_.append(uusi);
+
+    endInsertRows();
+    muokattu_ = true;
+    emit liiteMuutettu();
+
+    return uusi.liiteno;
+}
+
+QByteArray LiiteModel::pikkukuva(const QByteArray &liite)
+{
+    // Käytetään QImagea eikä QPixmapia, jotta pikkukuvan voi muodostaa myös säikeessä
+    QImage kuva;
 
+    if( liite.startsWith("%PDF") )
+    {
         // Peukkukuvan muodostaminen
         Poppler::Document *pdfDoc = Poppler::Document::loadFromData( liite );
         if( pdfDoc )
@@ -149,12 +172,7 @@ int LiiteModel::lisaaLiite(const QByteArray &liite, const QString &otsikko, cons
             Poppler::Page *pdfsivu = pdfDoc->page(0);
             if( pdfsivu )
             {
-                QImage image = pdfsivu->renderToImage(24,24);
-                QPixmap kuva = QPixmap::fromImage( image.scaled(64,64,Qt::KeepAspectRatio) );
-                QBuffer buffer(&uusi.thumbnail);
-                buffer.open(QIODevice::WriteOnly);
-                kuva.save(&buffer, "PNG");
-
+                kuva = pdfsivu->renderToImage(24,24);
                 delete pdfsivu;
             }
             delete pdfDoc;
@@ -163,23 +181,17 @@ int LiiteModel::lisaaLiite(const QByteArray &liite, const QString &otsikko, cons
     else if( liite.startsWith(  static_cast<char>( 0xff) ))
     {
         // Peukkukuvan muodostaminen jpg-tiedostosta
-        QImage kuva = QImage::fromData( liite, "JPG" );
-        if( !kuva.isNull())
-        {
-            QPixmap peukkukuva = QPixmap::fromImage( kuva.scaled(64,64,Qt::KeepAspectRatio) );
-            QBuffer buffer(&uusi.thumbnail);
-            buffer.open(QIODevice::WriteOnly);
-            peukkukuva.save(&buffer, "PNG");
-        }
+        kuva = QImage::fromData( liite, "JPG" );
     }
 
-    liitteet_.append(uusi);
-
-    endInsertRows();
-    muokattu_ = true;
-    emit liiteMuutettu();
-
-    return uusi.liiteno;
+    QByteArray thumbnail;
+    if( !kuva.isNull())
+    {
+        QBuffer buffer(&thumbnail);
+        buffer.open(QIODevice::WriteOnly);
+        kuva.scaled(64,64,Qt::KeepAspectRatio).save(&buffer, "PNG");
+    }
+    return thumbnail;
 }
 
 int LiiteModel::asetaLiite(const QByteArray &liite, const QString &otsikko)
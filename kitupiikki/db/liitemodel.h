@@ -80,6 +80,24 @@ public:
      * @return Liitteen nro
      */
     int lisaaLiite(const QByteArray &liite, const QString& otsikko, const QString& polusta = QString());
+    /**
+     * @brief Lisää liitteen valmiiksi muodostetulla pikkukuvalla
+     * @param liite
+     * @param otsikko
+     * @param pikkukuva pikkukuva() -funktiolla muodostettu PNG-kuva
+     * @return Liitteen nro
+     */
+    int lisaaLiite(const QByteArray &liite, const QString& otsikko, const QByteArray& pikkukuva, const QString& polusta = QString());
+    /**
+     * @brief Muodostaa liitteen pikkukuvan PNG-muodossa
+     *
+     * Ei käytä käyttöliittymäsäiettä vaativia luokkia, joten pikkukuvat
+     * voi muodostaa valmiiksi säikeissä.
+     *
+     * @param liite pdf- tai jpg-liite
+     * @return PNG-kuva tai tyhjä, jos kuvaa ei voitu muodostaa
+     */
+    static QByteArray pikkukuva(const QByteArray& liite);
     /**
      * @brief Jos samalla otsikolla olemassa, korvaa - muuten lisää
      * @param pdf
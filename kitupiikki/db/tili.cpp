@@ -60,51 +60,9 @@ int Tili::ysivertailuluku() const
 
 qlonglong Tili::saldoPaivalle(const QDate &pvm)
 {
-    QString kysymys = QString("SELECT SUM(debetsnt), SUM(kreditsnt) FROM vienti WHERE tili=%1 ").arg(id());
-    if( onko(TiliLaji::TASE) )
-        kysymys.append( QString(" AND pvm <= \"%1\" ").arg(pvm.toString(Qt::ISODate)));
-    else
-        kysymys.append( QString(" AND pvm BETWEEN \"%1\" AND \"%2\" ")
-                        .arg( kp()->tilikaudet()->tilikausiPaivalle(pvm).alkaa().toString(Qt::ISODate) )
-                        .arg( pvm.toString(Qt::ISODate )));
-
-    QSqlQuery kysely(kysymys);
-    if( kysely.next())
-    {
-        qlonglong debet = kysely.value(0).toLongLong();
-        qlonglong kredit = kysely.value(1).toLongLong();
-
-        if( onko(TiliLaji::EDELLISTENTULOS) )
-        {
-            // Edellisten yli/alijaamaan pitää laskea vielä edellisten tulokset
-            QSqlQuery edelliskysely( QString("SELECT SUM(debetsnt), SUM(kreditsnt) FROM vienti, tili "
-                                             "WHERE vienti.tili = tili.id AND pvm < \"%1\" "
-                                             "AND ysiluku > 300000000 ")
-                                     .arg(kp()->tilikaudet()->tilikausiPaivalle(pvm).alkaa().toString(Qt::ISODate)));
-            if( edelliskysely.next())
-            {
-                return kredit + edelliskysely.value(1).toLongLong() - debet - edelliskysely.value(0).toLongLong();
-            }
-        }
-        else if( onko(TiliLaji::KAUDENTULOS))
-        {
-            // Tämän tilikauden yli/alijaamaan
-            QSqlQuery edelliskysely( QString("SELECT SUM(debetsnt), SUM(kreditsnt) FROM vienti, tili "
-                                             "WHERE vienti.tili = tili.id AND pvm BETWEEN \"%1\" and \"%2\" "
-                                             "AND ysiluku > 300000000 ")
-                                     .arg(kp()->tilikaudet()->tilikausiPaivalle(pvm).alkaa().toString(Qt::ISODate))
-                                     .arg(kp()->tilikaudet()->tilikausiPaivalle(pvm).paattyy().toString(Qt::ISODate)));
-            if( edelliskysely.next())
-            {
-                return kredit + edelliskysely.value(1).toLongLong() - debet - edelliskysely.value(0).toLongLong();
-            }
-        }
-        else if( onko(TiliLaji::VASTAAVAA) )
-            return debet - kredit;
-        else
-            return kredit - debet;
-    }
-    return 0;
+    // Tili annetaan sellaisenaan, jotta saldo lasketaan oikein myös tilille,
+    // jota ei ole tilimallissa
+    return kp()->tilit()->saldot( pvm, QList<Tili>() << *this ).value( id() );
 }
 
 int Tili::montakoVientia() const
@@ -19,6 +19,7 @@
 
 #include "tilikausimodel.h"
 #include "kirjanpito.h"
+#include "budjetti.h"
 
 TilikausiModel::TilikausiModel(QSqlDatabase *tietokanta, QObject *parent) :
     QAbstractTableModel(parent), tietokanta_(tietokanta)
@@ -175,6 +176,7 @@ void TilikausiModel::muokkaaViimeinenTilikausi(const QDate &paattyy)
     {
         beginRemoveRows( QModelIndex(), kaudet_.count()-1, kaudet_.count()-1);
         tietokanta_->exec(QString("DELETE FROM tilikausi WHERE alkaa='%1' ").arg( kaudet_.last().alkaa().toString(Qt::ISODate) ) );
+        Budjetti::poista( tietokanta_, kaudet_.last().alkaa());
         kaudet_.removeLast();
         endRemoveRows();
     }
@@ -285,6 +287,7 @@ void TilikausiModel::tallennaJSON()
             kysely.bindValue(":json", kaudet_[i].json()->toSqlJson());
             kysely.bindValue(":alku", kaudet_[i].alkaa());
             kysely.exec();
+            Budjetti::paivita( tietokanta_, kaudet_[i].alkaa(), kaudet_[i].json()->variant("Budjetti").toMap() );
         }
     }
 
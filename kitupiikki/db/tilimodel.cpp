@@ -17,6 +17,8 @@
 
 
 #include <QSqlQuery>
+#include <QSet>
+#include <QStringList>
 #include <QSqlError>
 #include <QColor>
 #include <QDebug>
@@ -268,6 +270,104 @@ Tili TiliModel::tiliTyypilla(TiliLaji::TiliLuonne tyyppi) const
     return Tili();
 }
 
+QHash<int, qlonglong> TiliModel::saldot(const QDate &pvm, const QList<int> &tiliIdt) const
+{
+    if( tiliIdt.isEmpty())
+        return saldot( pvm, tilit_ );
+
+    QList<Tili> tilit;
+    QSet<int> halutut = tiliIdt.toSet();
+    for( const Tili& tili : tilit_)
+        if( halutut.contains(tili.id()))
+            tilit.append(tili);
+    return saldot( pvm, tilit );
+}
+
+QHash<int, qlonglong> TiliModel::saldot(const QDate &pvm, const QList<Tili> &tilit) const
+{
+    QHash<int,qlonglong> saldot;
+
+    QStringList taseIdt;
+    QStringList tulosIdt;
+    bool edellisetTulokset = false;
+    bool kaudenTulos = false;
+
+    for( const Tili& tili : tilit)
+    {
+        if( !tili.id())
+            continue;
+        saldot.insert( tili.id(), 0);
+        if( tili.onko(TiliLaji::TASE))
+            taseIdt.append( QString::number(tili.id()));
+        else
+            tulosIdt.append( QString::number(tili.id()));
+        edellisetTulokset |= tili.onko(TiliLaji::EDELLISTENTULOS);
+        kaudenTulos |= tili.onko(TiliLaji::KAUDENTULOS);
+    }
+
+    Tilikausi kausi = kp()->tilikaudet()->tilikausiPaivalle(pvm);
+    QSqlQuery kysely( *tietokanta_ );
+
+    // Debet- ja kreditsummat tileittäin
+    QHash<int,QPair<qlonglong,qlonglong>> summat;
+    if( !taseIdt.isEmpty())
+    {
+        kysely.exec( QString("SELECT tili, SUM(debetsnt), SUM(kreditsnt) FROM vienti WHERE tili IN (%1) "
+                             "AND pvm <= '%2' GROUP BY tili")
+                     .arg( taseIdt.join(",") ).arg( pvm.toString(Qt::ISODate)));
+        while( kysely.next())
+            summat.insert( kysely.value(0).toInt(), qMakePair( kysely.value(1).toLongLong(), kysely.value(2).toLongLong()));
+    }
+    if( !tulosIdt.isEmpty())
+    {
+        kysely.exec( QString("SELECT tili, SUM(debetsnt), SUM(kreditsnt) FROM vienti WHERE tili IN (%1) "
+                             "AND pvm BETWEEN '%2' AND '%3' GROUP BY tili")
+                     .arg( tulosIdt.join(",") ).arg( kausi.alkaa().toString(Qt::ISODate)).arg( pvm.toString(Qt::ISODate)));
+        while( kysely.next())
+            summat.insert( kysely.value(0).toInt(), qMakePair( kysely.value(1).toLongLong(), kysely.value(2).toLongLong()));
+    }
+
+    // Edellisten tilikausien ja tämän tilikauden yli/alijäämä tuloslaskelman tileiltä
+    qlonglong edellisetSnt = 0;
+    qlonglong kaudenSnt = 0;
+    if( edellisetTulokset )
+    {
+        kysely.exec( QString("SELECT SUM(debetsnt), SUM(kreditsnt) FROM vienti, tili "
+                             "WHERE vienti.tili = tili.id AND pvm < '%1' AND ysiluku > 300000000 ")
+                     .arg( kausi.alkaa().toString(Qt::ISODate)));
+        if( kysely.next())
+            edellisetSnt = kysely.value(1).toLongLong() - kysely.value(0).toLongLong();
+    }
+    if( kaudenTulos )
+    {
+        kysely.exec( QString("SELECT SUM(debetsnt), SUM(kreditsnt) FROM vienti, tili "
+                             "WHERE vienti.tili = tili.id AND pvm BETWEEN '%1' AND '%2' AND ysiluku > 300000000 ")
+                     .arg( kausi.alkaa().toString(Qt::ISODate)).arg( kausi.paattyy().toString(Qt::ISODate)));
+        if( kysely.next())
+            kaudenSnt = kysely.value(1).toLongLong() - kysely.value(0).toLongLong();
+    }
+
+    for( const Tili& tili : tilit)
+    {
+        if( !tili.id())
+            continue;
+
+        qlonglong debet = summat.value(tili.id()).first;
+        qlonglong kredit = summat.value(tili.id()).second;
+
+        if( tili.onko(TiliLaji::EDELLISTENTULOS))
+            saldot[tili.id()] = kredit - debet + edellisetSnt;
+        else if( tili.onko(TiliLaji::KAUDENTULOS))
+            saldot[tili.id()] = kredit - debet + kaudenSnt;
+        else if( tili.onko(TiliLaji::VASTAAVAA))
+            saldot[tili.id()] = debet - kredit;
+        else
+            saldot[tili.id()] = kredit - debet;
+    }
+
+    return saldot;
+}
+
 JsonKentta *TiliModel::jsonIndeksilla(int i)
 {
     return tilit_[i].json();
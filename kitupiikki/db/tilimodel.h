@@ -21,6 +21,8 @@
 #include <QAbstractTableModel>
 #include <QSqlDatabase>
 #include <QList>
+#include <QHash>
+#include <QDate>
 
 #include "db/tili.h"
 
@@ -85,6 +87,27 @@ public:
      */
     Tili tiliTyypilla(TiliLaji::TiliLuonne tyyppi) const;
 
+    /**
+     * @brief Laskee usean tilin saldot päivämäärälle kerralla
+     *
+     * Saldot lasketaan kuten Tili::saldoPaivalle, mutta kaikille tileille
+     * yhteisillä ryhmitellyillä kyselyillä. Myös edellisten ja tämän
+     * tilikauden yli/alijäämän tilit huomioidaan.
+     *
+     * @param pvm Päivämäärä, jolle saldot lasketaan
+     * @param tiliIdt Tilien id:t, tyhjä lista laskee kaikki tilit
+     * @return Saldot sentteinä tilin id:n mukaan
+     */
+    QHash<int,qlonglong> saldot(const QDate& pvm, const QList<int>& tiliIdt = QList<int>()) const;
+
+    /**
+     * @brief Laskee annettujen tilien saldot päivämäärälle kerralla
+     *
+     * Tilien tyypit otetaan annetuista tileistä, joten tilien ei tarvitse
+     * olla tässä mallissa.
+     */
+    QHash<int,qlonglong> saldot(const QDate& pvm, const QList<Tili>& tilit) const;
+
     JsonKentta *jsonIndeksilla(int i);
 
     bool onkoMuokattu() const;
@@ -0,0 +1,60 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tositehaku.h"
+
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+
+void TositeHaku::paivita(QSqlDatabase *tietokanta, int tositeId)
+{
+    QSqlQuery kysely( *tietokanta );
+    kysely.exec( QString("DELETE FROM tositehaku WHERE rowid=%1").arg(tositeId) );
+    kysely.exec( QString("INSERT INTO tositehaku(rowid, otsikko, kommentti, selite, asiakas) "
+                         "SELECT tosite.id, tosite.otsikko, tosite.kommentti, "
+                         "group_concat(vienti.selite, ' '), group_concat(vienti.asiakas, ' ') "
+                         "FROM tosite LEFT OUTER JOIN vienti ON vienti.tosite=tosite.id "
+                         "WHERE tosite.id=%1 GROUP BY tosite.id").arg(tositeId) );
+}
+
+void TositeHaku::poista(QSqlDatabase *tietokanta, int tositeId)
+{
+    QSqlQuery kysely( *tietokanta );
+    kysely.exec( QString("DELETE FROM tositehaku WHERE rowid=%1").arg(tositeId) );
+}
+
+QString TositeHaku::hakulauseke(const QString &teksti)
+{
+    QStringList osat;
+    for( QString sana : teksti.split(' ', QString::SkipEmptyParts))
+    {
+        // Lainausmerkit kahdennetaan, jolloin sana on aina pelkkä merkkijono
+        sana.replace('"', "\"\"");
+        osat.append( QString("\"%1\"*").arg(sana) );
+    }
+    return osat.join(' ');
+}
+
+QString TositeHaku::otsikonAlkuLauseke(const QString &alku)
+{
+    QString lause = alku.simplified();
+    if( lause.isEmpty())
+        return QString();
+    lause.replace('"', "\"\"");
+    return QString("otsikko : ^ \"%1\" *").arg(lause);
+}
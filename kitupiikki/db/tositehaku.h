@@ -0,0 +1,64 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TOSITEHAKU_H
+#define TOSITEHAKU_H
+
+#include <QString>
+#include <QSqlDatabase>
+
+/**
+ * @brief Tositteiden tekstihaku
+ *
+ * Tositteiden otsikot, kommentit sekä vientien selitteet ja asiakkaat
+ * pidetään FTS5-hakemistossa tositehaku, jonka rowid on tositteen id.
+ * Hakemisto päivitetään tositteen tallennuksen yhteydessä.
+ */
+class TositeHaku
+{
+public:
+    /**
+     * @brief Päivittää tositteen hakemistorivin
+     * @param tietokanta Tietokanta, jonka transaktiossa päivitetään
+     * @param tositeId Tositteen id
+     */
+    static void paivita(QSqlDatabase *tietokanta, int tositeId);
+
+    /**
+     * @brief Poistaa tositteen hakemistosta
+     */
+    static void poista(QSqlDatabase *tietokanta, int tositeId);
+
+    /**
+     * @brief Muodostaa MATCH-lausekkeen käyttäjän kirjoittamasta tekstistä
+     *
+     * Jokainen sana haetaan alkuosana, ja kaikkien sanojen on löydyttävä.
+     *
+     * @param teksti Haettava teksti
+     * @return Lauseke, tai tyhjä jos tekstissä ei ole haettavaa
+     */
+    static QString hakulauseke(const QString& teksti);
+
+    /**
+     * @brief MATCH-lauseke, joka hakee otsikon alkua
+     * @param alku Otsikon alku
+     * @return Lauseke, tai tyhjä jos tekstissä ei ole haettavaa
+     */
+    static QString otsikonAlkuLauseke(const QString& alku);
+};
+
+#endif // TOSITEHAKU_H
@@ -76,15 +76,21 @@ int Tositelaji::seuraavanTunnistenumero(const QDate pvm) const
         return 0;
 
     Tilikausi kausi = kp()->tilikausiPaivalle( pvm );
-    QString kysymys = QString("SELECT max(tunniste) FROM tosite WHERE "
-                    " pvm BETWEEN \"%1\" AND \"%2\" "
-                    " AND laji=\"%3\" ")
-                                .arg(kausi.alkaa().toString(Qt::ISODate))
-                                .arg(kausi.paattyy().toString(Qt::ISODate))
-                                .arg( id() );
 
+    // Ensisijaisesti numero saadaan laskurista
     QSqlQuery kysely;
-    kysely.exec(kysymys);
+    kysely.exec( QString("SELECT suurin FROM tunnistelaskuri WHERE laji=%1 AND kausi='%2'")
+                 .arg( id() )
+                 .arg( kausi.alkaa().toString(Qt::ISODate)));
+    if( kysely.next())
+        return kysely.value(0).toInt() + 1;
+
+    // Laskuria ei ole, jos kaudella ei vielä ole tämän lajin tositteita
+    kysely.exec( QString("SELECT max(tunniste) FROM tosite WHERE "
+                         " laji=%1 AND pvm BETWEEN '%2' AND '%3' ")
+                 .arg( id() )
+                 .arg(kausi.alkaa().toString(Qt::ISODate))
+                 .arg(kausi.paattyy().toString(Qt::ISODate)));
 
     if( kysely.next())
         return kysely.value(0).toInt() + 1;
@@ -92,3 +98,55 @@ int Tositelaji::seuraavanTunnistenumero(const QDate pvm) const
         return 1;
 }
 
+void Tositelaji::kirjaaTunniste(QSqlDatabase *tietokanta, int laji, const QDate &pvm, int tunniste)
+{
+    if( laji < 0 || !pvm.isValid() || tunniste < 1)
+        return;
+
+    Tilikausi kausi = kp()->tilikausiPaivalle( pvm );
+    if( !kausi.alkaa().isValid())
+        return;
+
+    // Puuttuva laskuri alustetaan kauden tositteista
+    QSqlQuery kysely( *tietokanta );
+    kysely.exec( QString("INSERT OR REPLACE INTO tunnistelaskuri(laji, kausi, suurin) "
+                         "VALUES (%1, '%2', MAX(%4, IFNULL( "
+                         "(SELECT suurin FROM tunnistelaskuri WHERE laji=%1 AND kausi='%2'), "
+                         "(SELECT IFNULL(MAX(tunniste),0) FROM tosite WHERE laji=%1 AND pvm BETWEEN '%2' AND '%3'))))")
+                 .arg( laji )
+                 .arg( kausi.alkaa().toString(Qt::ISODate))
+                 .arg( kausi.paattyy().toString(Qt::ISODate))
+                 .arg( tunniste ));
+}
+
+void Tositelaji::vapautaTunniste(QSqlDatabase *tietokanta, int laji, const QDate &pvm, int tunniste)
+{
+    if( laji < 0 || !pvm.isValid() || tunniste < 1)
+        return;
+
+    Tilikausi kausi = kp()->tilikausiPaivalle( pvm );
+    if( !kausi.alkaa().isValid())
+        return;
+
+    QSqlQuery kysely( *tietokanta );
+    kysely.exec( QString("UPDATE tunnistelaskuri SET suurin = "
+                         "(SELECT IFNULL(MAX(tunniste),0) FROM tosite WHERE laji=%1 AND pvm BETWEEN '%2' AND '%3') "
+                         "WHERE laji=%1 AND kausi='%2' AND suurin=%4")
+                 .arg( laji )
+                 .arg( kausi.alkaa().toString(Qt::ISODate))
+                 .arg( kausi.paattyy().toString(Qt::ISODate))
+                 .arg( tunniste ));
+}
+
+void Tositelaji::siirraTunnisteita(QSqlDatabase *tietokanta, int laji, const QDate &pvm, int alkaen, int lisays)
+{
+    Tilikausi kausi = kp()->tilikausiPaivalle( pvm );
+
+    QSqlQuery kysely( *tietokanta );
+    kysely.exec( QString("UPDATE tunnistelaskuri SET suurin = suurin + %1 "
+                         "WHERE laji=%2 AND kausi='%3' AND suurin >= %4")
+                 .arg( lisays )
+                 .arg( laji )
+                 .arg( kausi.alkaa().toString(Qt::ISODate))
+                 .arg( alkaen ));
+}
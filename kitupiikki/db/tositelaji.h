@@ -19,9 +19,12 @@
 #define TOSITELAJI_H
 
 #include <QString>
+#include <QDate>
 
 #include "jsonkentta.h"
 
+class QSqlDatabase;
+
 /**
  * @brief Tositelaji, joka muodostaa oman numerosarjan
  */
@@ -53,6 +56,29 @@ public:
      */
     int seuraavanTunnistenumero(const QDate pvm) const;
 
+    /**
+     * @brief Kirjaa tunnisteen numerosarjan laskuriin
+     *
+     * Laskurissa on kunkin tositelajin suurin tunniste tilikausittain,
+     * jotta seuraavaa numeroa ei tarvitse etsiä tositteista.
+     * Kutsutaan tositetta tallennettaessa samassa transaktiossa.
+     */
+    static void kirjaaTunniste(QSqlDatabase *tietokanta, int laji, const QDate& pvm, int tunniste);
+
+    /**
+     * @brief Päivittää laskurin, kun tunniste on poistunut käytöstä
+     *
+     * Laskuri lasketaan uudelleen vain, jos poistunut tunniste oli kauden suurin.
+     */
+    static void vapautaTunniste(QSqlDatabase *tietokanta, int laji, const QDate& pvm, int tunniste);
+
+    /**
+     * @brief Siirtää laskuria, kun tunnisteita on siirretty eteenpäin
+     * @param alkaen Ensimmäinen siirretty tunniste
+     * @param lisays Montako numeroa siirrettiin
+     */
+    static void siirraTunnisteita(QSqlDatabase *tietokanta, int laji, const QDate& pvm, int alkaen, int lisays);
+
 protected:
     int id_;
     QString tunnus_;
@@ -179,24 +179,25 @@ void TositelajiModel::poistaRivi(int riviIndeksi)
     if( laji.id())
         poistetutIdt_.append( laji.id());
     lajit_.removeAt( riviIndeksi);
+    paivitaHakemisto();
     endRemoveRows();
 }
 
-Tositelaji TositelajiModel::tositelaji(int id) const
+const Tositelaji &TositelajiModel::tositelaji(int id) const
 {
+    static const Tositelaji tyhja;
 
-    foreach (Tositelaji laji, lajit_)
-    {
-        if( laji.id() == id)
-            return laji;
-    }
-    return Tositelaji();
+    int indeksi = idHakemisto_.value(id, -1);
+    if( indeksi < 0)
+        return tyhja;
+    return lajit_.at(indeksi);
 }
 
 QModelIndex TositelajiModel::lisaaRivi()
 {
     beginInsertRows( QModelIndex(), lajit_.count(), lajit_.count() );
     lajit_.append( Tositelaji() );
+    paivitaHakemisto();
     endInsertRows();
     return index( lajit_.count()-1, 0);
 
@@ -214,6 +215,7 @@ void TositelajiModel::lataa()
         lajit_.append( Tositelaji(kysely.value(0).toInt(), kysely.value(1).toString(),
                                       kysely.value(2).toString(), kysely.value(3).toByteArray() ));
     }
+    paivitaHakemisto();
 
     endResetModel();
 }
@@ -253,8 +255,21 @@ bool TositelajiModel::tallenna()
         tallennus.exec( QString("DELETE tositelaji WHERE id=%1").arg(id));
     }
     poistetutIdt_.clear();
+    paivitaHakemisto();
 
     return true;
 }
 
+void TositelajiModel::paivitaHakemisto()
+{
+    idHakemisto_.clear();
+    idHakemisto_.reserve( lajit_.count());
+    for(int i=0; i < lajit_.count(); i++)
+    {
+        // Tallentamattomilla id on 0, hakemistoon jää ensimmäinen
+        if( !idHakemisto_.contains( lajit_.at(i).id()))
+            idHakemisto_.insert( lajit_.at(i).id(), i);
+    }
+}
+
 
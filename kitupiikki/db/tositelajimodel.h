@@ -20,6 +20,7 @@
 
 #include <QAbstractTableModel>
 #include <QSqlDatabase>
+#include <QHash>
 
 #include "tositelaji.h"
 
@@ -71,7 +72,11 @@ public:
 
     void poistaRivi(int riviIndeksi);
 
-    Tositelaji tositelaji(int id) const;
+    /**
+     * @brief Tositelaji id:llä hajautustaulusta
+     * @return Viittaus tositelajiin tai tyhjään tositelajiin, jos ei löydy
+     */
+    const Tositelaji& tositelaji(int id) const;
 
     QModelIndex lisaaRivi();
 
@@ -81,9 +86,13 @@ public slots:
     bool tallenna();
 
 protected:
+    void paivitaHakemisto();
+
     QList<Tositelaji> lajit_;
     QSqlDatabase *tietokanta_;
     QList<int> poistetutIdt_;
+
+    QHash<int,int> idHakemisto_;    // id -> indeksi lajit_-listassa
 };
 
 #endif // TOSITELAJIMODEL_H
@@ -28,6 +28,10 @@
 #include <QSqlRecord>
 
 #include "aloitussivu/aloitussivu.h"
+#include "db/tositehaku.h"
+#include "db/alvkooste.h"
+#include "db/erasaldo.h"
+#include "db/tuotemyynti.h"
 #include "versio.h"
 
 
@@ -220,10 +224,16 @@ void TositeModel::tyhjaa()
 
 }
 
-bool TositeModel::tallenna()
+bool TositeModel::tallenna(bool omaTransaktio)
 {
     // Tallentaa tositteen
-    tietokanta()->transaction();
+    if( omaTransaktio )
+        tietokanta()->transaction();
+
+    // Numerosarjan laskuria varten tositteen aiempi tunniste
+    QSqlQuery vanha(*tietokanta_);
+    if( id() > -1)
+        vanha.exec(QString("SELECT laji, pvm, tunniste FROM tosite WHERE id=%1").arg( id() ));
 
     QSqlQuery kysely(*tietokanta_);
     if( id() > -1)
@@ -268,7 +278,8 @@ bool TositeModel::tallenna()
     if( !kysely.exec() )
     {
         kp()->lokiin(kysely);
-        tietokanta()->rollback();
+        if( omaTransaktio )
+            tietokanta()->rollback();
         return false;
     }
 
@@ -276,16 +287,34 @@ bool TositeModel::tallenna()
     if( id() < 0)
         id_ = kysely.lastInsertId().toInt();
 
+    if( vanha.next() && ( vanha.value("laji").toInt() != tositelaji_ ||
+                          vanha.value("tunniste").toInt() != tunniste() ||
+                          kp()->tilikausiPaivalle( vanha.value("pvm").toDate() ).alkaa() != kp()->tilikausiPaivalle( pvm() ).alkaa() ))
+        Tositelaji::vapautaTunniste( tietokanta(), vanha.value("laji").toInt(), vanha.value("pvm").toDate(), vanha.value("tunniste").toInt());
+    Tositelaji::kirjaaTunniste( tietokanta(), tositelaji_, pvm(), tunniste());
+
+    // Alv-koosteesta ja erien saldoista vähennetään vanhat viennit ja lisätään tallennetut
+    AlvKooste::muuta( tietokanta(), id(), -1);
+    EraSaldo::muuta( tietokanta(), id(), -1);
+
     if( !vientiModel_->tallenna() || !liiteModel_->tallenna() )
     {
         // Tallennuksessa virheitä, perutaan ja palautetaan virhe
-        tietokanta()->rollback();
+        if( omaTransaktio )
+            tietokanta()->rollback();
         return false;
     }
 
-    tietokanta()->commit();
+    AlvKooste::muuta( tietokanta(), id(), 1);
+    EraSaldo::muuta( tietokanta(), id(), 1);
+    TositeHaku::paivita( tietokanta(), id() );
+    TuoteMyynti::paivita( tietokanta(), id() );
 
-    emit kp()->kirjanpitoaMuokattu();
+    if( omaTransaktio )
+    {
+        tietokanta()->commit();
+        emit kp()->kirjanpitoaMuokattu();
+    }
     muokattu_ = false;
     muokattuAika_ = QDateTime::currentDateTime();
 
@@ -309,9 +338,22 @@ bool TositeModel::poista()
     tietokanta()->transaction();
     QSqlQuery kysely(*tietokanta());
 
-    kysely.exec(QString("DELETE FROM vienti WHERE tosite=%1").arg( id() ));
-    kysely.exec(QString("DELETE FROM liite WHERE tosite=%1").arg( id() ));
-    kysely.exec(QString("DELETE FROM tosite WHERE id=%1").arg( id()) );
+    kysely.exec(QString("SELECT laji, pvm, tunniste FROM tosite WHERE id=%1").arg( id() ));
+    if( kysely.next())
+    {
+        int laji = kysely.value("laji").toInt();
+        QDate tositePvm = kysely.value("pvm").toDate();
+        int tositeTunniste = kysely.value("tunniste").toInt();
+
+        AlvKooste::muuta( tietokanta(), id(), -1);
+        EraSaldo::muuta( tietokanta(), id(), -1);
+        kysely.exec(QString("DELETE FROM vienti WHERE tosite=%1").arg( id() ));
+        kysely.exec(QString("DELETE FROM liite WHERE tosite=%1").arg( id() ));
+        kysely.exec(QString("DELETE FROM tosite WHERE id=%1").arg( id()) );
+        Tositelaji::vapautaTunniste( tietokanta(), laji, tositePvm, tositeTunniste);
+    }
+    TositeHaku::poista( tietokanta(), id() );
+    TuoteMyynti::poista( tietokanta(), id() );
 
     if( tietokanta()->commit())
     {
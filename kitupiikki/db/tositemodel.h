@@ -115,7 +115,13 @@ public slots:
      * Päivämäärä ja tositelaji jäävät kuitenkin edellisestä
      */
     void tyhjaa();
-    bool tallenna();
+    /**
+     * @brief Tallentaa tositteen
+     * @param omaTransaktio Jos epätosi, kutsuja on jo aloittanut transaktion
+     * ja hoitaa sen vahvistamisen tai perumisen (esim. ryhmälaskut yhdessä)
+     * @return Onnistuiko tallennus
+     */
+    bool tallenna(bool omaTransaktio = true);
     bool poista();
 
     /**
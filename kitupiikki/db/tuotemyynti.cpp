@@ -0,0 +1,55 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QSqlQuery>
+
+#include "tuotemyynti.h"
+
+void TuoteMyynti::paivita(QSqlDatabase *tietokanta, int tositeId)
+{
+    QSqlQuery kysely( *tietokanta );
+    kysely.exec( QString("DELETE FROM tuotemyynti WHERE tosite=%1").arg(tositeId) );
+    kysely.exec( QString("INSERT INTO tuotemyynti(tosite, vienti, pvm, nimike, tuote, asiakas, alvprosentti, kohdennus, maara, nettosnt, bruttosnt) "
+                         "SELECT vienti.tosite, vienti.id, vienti.pvm, json_extract(rivi.value,'$.Nimike'), "
+                         "json_extract(rivi.value,'$.Tuotekoodi'), vienti.asiakas, "
+                         "IFNULL(json_extract(rivi.value,'$.Alvprosentti'),0), IFNULL(json_extract(rivi.value,'$.Kohdennus'),0), "
+                         "json_extract(rivi.value,'$.Maara'), json_extract(rivi.value,'$.Nettoyht'), json_extract(rivi.value,'$.Yhteensa') "
+                         "FROM vienti, json_each(vienti.json,'$.Laskurivit') AS rivi "
+                         "WHERE vienti.tosite=%1 AND vienti.viite IS NOT NULL "
+                         "AND json_type(vienti.json,'$.Laskurivit')='array'").arg(tositeId) );
+}
+
+void TuoteMyynti::poista(QSqlDatabase *tietokanta, int tositeId)
+{
+    QSqlQuery kysely( *tietokanta );
+    kysely.exec( QString("DELETE FROM tuotemyynti WHERE tosite=%1").arg(tositeId) );
+}
+
+QString TuoteMyynti::kysely(TuoteMyynti::Ryhmittely ryhmittely, const QDate &mista, const QDate &mihin)
+{
+    QString avain = "nimike";
+    if( ryhmittely == Asiakkaittain)
+        avain = "asiakas";
+    else if( ryhmittely == Kuukausittain)
+        avain = "strftime('%Y-%m',pvm)";
+    else if( ryhmittely == Kohdennuksittain)
+        avain = "kohdennus";
+
+    return QString("SELECT %1 AS avain, SUM(maara) AS maara, SUM(nettosnt) AS netto, SUM(bruttosnt) AS brutto "
+                   "FROM tuotemyynti WHERE pvm BETWEEN '%2' AND '%3' GROUP BY avain ORDER BY avain")
+            .arg(avain).arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate));
+}
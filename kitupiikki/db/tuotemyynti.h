@@ -0,0 +1,60 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TUOTEMYYNTI_H
+#define TUOTEMYYNTI_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QDate>
+
+/**
+ * @brief Laskurivien myyntitilasto
+ *
+ * Myyntilaskujen rivit puretaan tallennettaessa laskuvientien
+ * json-kentästä tauluun tuotemyynti, jossa jokaisella rivillä on tuote,
+ * päivämäärä, asiakas, alv-prosentti ja kohdennus. Myyntiraportit ovat
+ * näin yksittäisiä koostekyselyjä indeksoidusta taulusta.
+ */
+class TuoteMyynti
+{
+public:
+    enum Ryhmittely { Tuotteittain, Asiakkaittain, Kuukausittain, Kohdennuksittain };
+
+    /**
+     * @brief Päivittää tositteen laskurivit tauluun
+     * @param tietokanta Tietokanta, jonka transaktiossa päivitetään
+     * @param tositeId Tositteen id
+     */
+    static void paivita(QSqlDatabase *tietokanta, int tositeId);
+
+    /**
+     * @brief Poistaa tositteen laskurivit taulusta
+     */
+    static void poista(QSqlDatabase *tietokanta, int tositeId);
+
+    /**
+     * @brief Myynnin koostekysely
+     *
+     * Kyselyssä on sarakkeet avain, maara, netto ja brutto avaimen mukaan
+     * järjestettynä. Kuukausittain avain on muotoa yyyy-MM, kohdennuksittain
+     * kohdennuksen id.
+     */
+    static QString kysely(Ryhmittely ryhmittely, const QDate& mista, const QDate& mihin);
+};
+
+#endif // TUOTEMYYNTI_H
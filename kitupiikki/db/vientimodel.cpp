@@ -623,7 +623,14 @@ void VientiModel::uusiPohjalta(const QString &otsikko)
 
 bool VientiModel::tallenna()
 {
-    QSqlQuery query(*tositeModel_->tietokanta());
+    // Lisäys- ja päivityslauseet valmistellaan vain kerran, jotta suurikin
+    // tosite (esim. poistot) tallentuu yhdellä valmistellulla lauseella
+    QSqlQuery lisays(*tositeModel_->tietokanta());
+    QSqlQuery paivitys(*tositeModel_->tietokanta());
+    QSqlQuery muu(*tositeModel_->tietokanta());
+    bool lisaysValmis = false;
+    bool paivitysValmis = false;
+
     for(int i=0; i < viennit_.count() ; i++)
     {
         VientiRivi rivi = viennit_[i];
@@ -633,26 +640,29 @@ bool VientiModel::tallenna()
 
         if( rivi.vientiId )
         {
-            query.prepare("UPDATE vienti SET pvm=:pvm, tili=:tili, debetsnt=:debetsnt, "
+            if( !paivitysValmis )
+                paivitysValmis = paivitys.prepare("UPDATE vienti SET pvm=:pvm, tili=:tili, debetsnt=:debetsnt, "
                           "kreditsnt=:kreditsnt, selite=:selite, alvkoodi=:alvkoodi,"
                           "kohdennus=:kohdennus, eraid=:eraid, alvprosentti=:alvprosentti, "
                           "viite=:viite, iban=:iban, erapvm=:erapvm, arkistotunnus=:arkistotunnus, "
                           "muokattu=:muokattu, json=:json, asiakas=:asiakas, vientirivi=:rivinro, laskupvm=:laskupvm"
                           " WHERE id=:id");
-            query.bindValue(":id", rivi.vientiId);
+            paivitys.bindValue(":id", rivi.vientiId);
             if( poistetutVientiIdt_.contains(rivi.vientiId))
                 poistetutVientiIdt_.removeAll(rivi.vientiId);
         }
         else
         {
-            query.prepare("INSERT INTO vienti(tosite,pvm,tili,debetsnt,kreditsnt,selite,"
+            if( !lisaysValmis )
+                lisaysValmis = lisays.prepare("INSERT INTO vienti(tosite,pvm,tili,debetsnt,kreditsnt,selite,"
                            "alvkoodi, alvprosentti, luotu, muokattu, json, kohdennus, eraid, vientirivi,"
                            "viite, iban, erapvm, arkistotunnus,asiakas,laskupvm) "
                             "VALUES(:tosite,:pvm,:tili,:debetsnt,:kreditsnt,:selite,"
                             ":alvkoodi, :alvprosentti, :luotu, :muokattu, :json, :kohdennus, :eraid, :rivinro,"
                             ":viite, :iban, :erapvm, :arkistotunnus, :asiakas, :laskupvm)");
-            query.bindValue(":luotu",  QDateTime::currentDateTime() );            
+            lisays.bindValue(":luotu",  QDateTime::currentDateTime() );
         }
+        QSqlQuery& query = rivi.vientiId ? paivitys : lisays;
         query.bindValue(":rivinro", i + 1);        // Pidetään viennit siististi numeroituina
 
 
@@ -713,28 +723,28 @@ bool VientiModel::tallenna()
             // Jos uusi tase-erä, niin merkitään tase-erä itseensä - helpottaa tase-erien laskentaa
             if( rivi.eraId == TaseEra::UUSIERA && !rivi.vientiId && !rivi.tili.onko(TiliLaji::TULOS))
             {
-                if(!query.exec(QString("UPDATE vienti SET eraid=%1 WHERE id=%1").arg(viennit_[i].vientiId) ))
+                if(!muu.exec(QString("UPDATE vienti SET eraid=%1 WHERE id=%1").arg(viennit_[i].vientiId) ))
                 {
-                    kp()->lokiin(query);
+                    kp()->lokiin(muu);
                     return false;
                 }
             }
         }
         else
             // Poistetaan tagit, jotta ne voitaisiin kohta lisätä...
-            if(!query.exec( QString("DELETE FROM merkkaus WHERE vienti=%1").arg( rivi.vientiId)))
+            if(!muu.exec( QString("DELETE FROM merkkaus WHERE vienti=%1").arg( rivi.vientiId)))
             {
-                kp()->lokiin(query);
+                kp()->lokiin(muu);
                 return false;
             }
 
         for(const Kohdennus& tagi : rivi.tagit)
         {
-            if( !query.exec( QString("INSERT INTO merkkaus(vienti,kohdennus) VALUES(%1,%2)")
+            if( !muu.exec( QString("INSERT INTO merkkaus(vienti,kohdennus) VALUES(%1,%2)")
                         .arg(viennit_[i].vientiId)
                         .arg(tagi.id()) ) )
             {
-                kp()->lokiin(query);
+                kp()->lokiin(muu);
                 return false;
             }
 
@@ -745,9 +755,9 @@ bool VientiModel::tallenna()
     // Lopuksi pitäisi vielä poistaa ne rivit, jotka on poistettu...
     foreach (int id, poistetutVientiIdt_)
     {
-        if( !query.exec( QString("DELETE FROM vienti WHERE id=%1").arg(id)) )
+        if( !muu.exec( QString("DELETE FROM vienti WHERE id=%1").arg(id)) )
         {
-            kp()->lokiin(query);
+            kp()->lokiin(muu);
             return false;
         }
     }
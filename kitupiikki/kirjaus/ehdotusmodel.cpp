@@ -20,6 +20,7 @@
 #include <QDebug>
 
 #include "ehdotusmodel.h"
+#include "maksualvhaku.h"
 #include "db/kirjanpito.h"
 
 EhdotusModel::EhdotusModel()
@@ -169,110 +170,78 @@ void EhdotusModel::tallenna(VientiModel *model, int yhdistettavaVastatiliNumero,
 
 }
 
-/**
- * @brief The Maksuperusteisen arvonlisäveron määrittelyn apurakenne
- *
- * Yksi maksuperäisen arvonlisäveron erä
- */
-struct MaksuAlvEra
-{
-    MaksuAlvEra() {}
-
-    int alvprosentti = 0;
-    qlonglong sentit = 0;
-    int id = 0;
-};
-
 void EhdotusModel::viimeisteleMaksuperusteinen()
 {
-    for( VientiRivi rivi : viennit_)
+    // Poimitaan ensin suoritukset, jotta kaikkien erien tiedot voidaan hakea kerralla
+    QList<VientiRivi> suoritukset;
+    QList<int> eraIdt;
+    for( const VientiRivi& rivi : viennit_)
     {
         if( kp()->onkoMaksuperusteinenAlv(rivi.pvm) &&
-                (rivi.tili.onko(TiliLaji::MYYNTISAATAVA) || rivi.tili.onko(TiliLaji::OSTOVELKA)))
+                (rivi.tili.onko(TiliLaji::MYYNTISAATAVA) || rivi.tili.onko(TiliLaji::OSTOVELKA)) &&
+                rivi.eraId > 0)
         {
-            bool myynti = rivi.tili.onko(TiliLaji::MYYNTISAATAVA);
-            Tili haeTili = myynti ? kp()->tilit()->tiliTyypilla(TiliLaji::KOHDENTAMATONALVVELKA) :
-                                    kp()->tilit()->tiliTyypilla(TiliLaji::KOHDENTAMATONALVSAATAVA);
-
-
-            QList<MaksuAlvEra> verot;
-            qlonglong verosumma = 0;
-
-            TaseEra era(rivi.eraId);
-            QSqlQuery tositeKysely( QString("SELECT tosite FROM vienti WHERE id=%1").arg(rivi.eraId));
-
-
-            int tosite = tositeKysely.next() ? tositeKysely.value("tosite").toInt() : -1;
-
-
-            // Haetaan tositteella olevat kohdentamattomat verokirjaukset
-
-            QSqlQuery kysely( QString("SELECT alvprosentti, debetsnt, kreditsnt, id FROM vienti "
-                                      "WHERE tili=%1 AND tosite=%2").arg(haeTili.id()).arg(tosite));
-
-
-            while( kysely.next())
-            {
-                MaksuAlvEra maksuEra;
-                maksuEra.alvprosentti = kysely.value("alvprosentti").toInt();
-                maksuEra.id = kysely.value("id").toInt();
-
-                // Haetaan tämän veroerän saldo
-                // Lähinnä siltä varalta, jos erääntymisen takia verot onkin jo maksettu
-                // niin turha niitä on maksaa enää toista kertaa
-
-                TaseEra veroEra(maksuEra.id);
-                maksuEra.sentit = veroEra.saldoSnt;
-
+            suoritukset.append(rivi);
+            eraIdt.append(rivi.eraId);
+        }
+    }
 
-                if( maksuEra.sentit)
-                    verot.append(maksuEra);
+    if( suoritukset.isEmpty())
+        return;
 
-                verosumma += maksuEra.sentit;
-            }
+    Tili velkaTili = kp()->tilit()->tiliTyypilla(TiliLaji::KOHDENTAMATONALVVELKA);
+    Tili saatavaTili = kp()->tilit()->tiliTyypilla(TiliLaji::KOHDENTAMATONALVSAATAVA);
 
+    MaksuAlvHaku haku( *kp()->tietokanta() );
+    haku.hae( eraIdt, QList<int>() << velkaTili.id() << saatavaTili.id() );
 
-            double kerroin = 1.00;
-            if( era.saldoSnt != rivi.debetSnt - rivi.kreditSnt )
-                kerroin = ((double) (rivi.debetSnt - rivi.kreditSnt)) / (double) era.saldoSnt;
+    for( const VientiRivi& rivi : suoritukset)
+    {
+        bool myynti = rivi.tili.onko(TiliLaji::MYYNTISAATAVA);
+        Tili haeTili = myynti ? velkaTili : saatavaTili;
 
-            // Nyt sitten tehdään suhteelliset kirjaukset
-            for( auto vero : verot)
-            {
-                qlonglong sentit = kerroin == 1.00 ?  vero.sentit :
-                                                      qRound( kerroin * (double) vero.sentit );
-
-                // Kirjataan alv-velkaan taikka alv-saataviin
-                VientiRivi verorivi;
-                verorivi.pvm = rivi.pvm;
-                verorivi.tili = myynti ? kp()->tilit()->tiliTyypilla(TiliLaji::ALVVELKA) :
-                                         kp()->tilit()->tiliTyypilla(TiliLaji::ALVSAATAVA);
-
-                verorivi.debetSnt = sentit < 0 ? 0 - sentit : 0;
-                verorivi.kreditSnt = sentit > 0 ? sentit : 0;
-                verorivi.alvprosentti = vero.alvprosentti;
-                verorivi.selite = tr("Maksuperusteinen %1 % alv %2 / %3 [%4]").arg(verorivi.alvprosentti)
-                        .arg(era.tositteenTunniste()).arg(era.pvm.toString("dd.MM.yyyy"))
-                        .arg(era.selite);
-
-                verorivi.alvkoodi = myynti ? AlvKoodi::ALVKIRJAUS + AlvKoodi::MAKSUPERUSTEINEN_MYYNTI :
-                                             AlvKoodi::ALVVAHENNYS + AlvKoodi::MAKSUPERUSTEINEN_OSTO ;
-
-                lisaaVienti(verorivi);
-
-                // Rivi, jolla kirjataan pois kohdentamattoman veron tililtä
-                VientiRivi poisrivi;
-                poisrivi.tili = haeTili;
-                poisrivi.pvm = rivi.pvm;
-                poisrivi.debetSnt = sentit > 0 ? sentit : 0;
-                poisrivi.kreditSnt = sentit < 0 ? 0 - sentit : 0;
-                poisrivi.selite = verorivi.selite;
-                poisrivi.eraId = vero.id;
-                poisrivi.alvkoodi = AlvKoodi::TILITYS;
-                lisaaVienti(poisrivi);
+        MaksuAlvLasku era = haku.lasku( rivi.eraId );
+        QString tositteenTunniste;
+        if( era.tositeLoytyi )
+            tositteenTunniste = QString("%1%2/%3").arg( era.tositelajiTunnus )
+                    .arg( era.tunniste )
+                    .arg( kp()->tilikaudet()->tilikausiPaivalle( era.pvm ).kausitunnus() );
 
-            }
+        QList<MaksuAlvEra> verot = MaksuAlvHaku::jaa( rivi.debetSnt - rivi.kreditSnt, era.saldoSnt,
+                                                     haku.verot( rivi.eraId, haeTili.id() ));
 
+        for( const MaksuAlvEra& vero : verot)
+        {
+            qlonglong sentit = vero.sentit;
+
+            // Kirjataan alv-velkaan taikka alv-saataviin
+            VientiRivi verorivi;
+            verorivi.pvm = rivi.pvm;
+            verorivi.tili = myynti ? kp()->tilit()->tiliTyypilla(TiliLaji::ALVVELKA) :
+                                     kp()->tilit()->tiliTyypilla(TiliLaji::ALVSAATAVA);
+
+            verorivi.debetSnt = sentit < 0 ? 0 - sentit : 0;
+            verorivi.kreditSnt = sentit > 0 ? sentit : 0;
+            verorivi.alvprosentti = vero.alvprosentti;
+            verorivi.selite = tr("Maksuperusteinen %1 % alv %2 / %3 [%4]").arg(verorivi.alvprosentti)
+                    .arg(tositteenTunniste).arg(era.pvm.toString("dd.MM.yyyy"))
+                    .arg(era.selite);
+
+            verorivi.alvkoodi = myynti ? AlvKoodi::ALVKIRJAUS + AlvKoodi::MAKSUPERUSTEINEN_MYYNTI :
+                                         AlvKoodi::ALVVAHENNYS + AlvKoodi::MAKSUPERUSTEINEN_OSTO ;
+
+            lisaaVienti(verorivi);
+
+            // Rivi, jolla kirjataan pois kohdentamattoman veron tililtä
+            VientiRivi poisrivi;
+            poisrivi.tili = haeTili;
+            poisrivi.pvm = rivi.pvm;
+            poisrivi.debetSnt = sentit > 0 ? sentit : 0;
+            poisrivi.kreditSnt = sentit < 0 ? 0 - sentit : 0;
+            poisrivi.selite = verorivi.selite;
+            poisrivi.eraId = vero.id;
+            poisrivi.alvkoodi = AlvKoodi::TILITYS;
+            lisaaVienti(poisrivi);
         }
     }
 }
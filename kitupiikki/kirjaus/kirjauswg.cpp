@@ -52,6 +52,7 @@
 #include "siirrydlg.h"
 
 #include "db/kirjanpito.h"
+#include "db/tositehaku.h"
 #include "laskutus/laskunmaksudialogi.h"
 
 #include "tuonti/tuonti.h"
@@ -488,14 +489,18 @@ void KirjausWg::numeroSiirto()
     {
         // Siirretään tunnistenumeroita eteenpäin
 
+        int laji = ui->tositetyyppiCombo->currentData(TositelajiModel::IdRooli).toInt();
         QString kasky = QString("UPDATE tosite SET tunniste = tunniste + %1 WHERE laji = %2 AND tunniste >= %3 AND pvm BETWEEN '%4' AND '%5'")
                 .arg( dui.lisaaSpin->value() )
-                .arg( ui->tositetyyppiCombo->currentData(TositelajiModel::IdRooli).toInt() )
+                .arg( laji )
                 .arg( dui.alkuSpin->value())
                 .arg( kausi.alkaa().toString(Qt::ISODate) )
                 .arg( kausi.paattyy().toString(Qt::ISODate));
 
+        kp()->tietokanta()->transaction();
         QSqlQuery kysely(kasky);
+        Tositelaji::siirraTunnisteita( kp()->tietokanta(), laji, kausi.alkaa(), dui.alkuSpin->value(), dui.lisaaSpin->value());
+        kp()->tietokanta()->commit();
 
         paivitaTunnisteVari();
     }
@@ -538,8 +543,21 @@ void KirjausWg::siirryTositteeseen()
 
 void KirjausWg::paivitaOtsikonTaydennys(const QString &teksti)
 {
-    if( teksti.length() > 2 && !teksti.contains(QChar('\'')))
-        taydennysSql_->setQuery(QString("SELECT otsikko FROM tosite WHERE otsikko LIKE '%1%' order by otsikko").arg(teksti));
+    QString lauseke = TositeHaku::otsikonAlkuLauseke(teksti);
+    if( teksti.length() > 2 && !lauseke.isEmpty())
+    {
+        // Ehdokkaat haetaan tekstihakemistosta, ja LIKE varmistaa
+        // että otsikko alkaa juuri kirjoitetulla tekstillä
+        QSqlQuery kysely( *kp()->tietokanta() );
+        kysely.prepare("SELECT DISTINCT otsikko FROM tositehaku WHERE tositehaku MATCH :lauseke "
+                       "AND otsikko LIKE :alku ESCAPE '\\' ORDER BY otsikko");
+        kysely.bindValue(":lauseke", lauseke);
+        QString alku = teksti;
+        alku.replace("\\","\\\\").replace("%","\\%").replace("_","\\_");
+        kysely.bindValue(":alku", alku + "%");
+        kysely.exec();
+        taydennysSql_->setQuery( kysely );
+    }
     else
         taydennysSql_->clear();
 
@@ -0,0 +1,133 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "maksualvhaku.h"
+
+#include <QSqlQuery>
+#include <QStringList>
+#include <QSet>
+
+namespace {
+
+QString idLista(const QList<int>& idt)
+{
+    QStringList lista;
+    for(int id : idt)
+        lista.append( QString::number(id));
+    return lista.join(',');
+}
+
+}
+
+MaksuAlvHaku::MaksuAlvHaku(const QSqlDatabase &tietokanta) :
+    tietokanta_(tietokanta)
+{
+
+}
+
+void MaksuAlvHaku::hae(const QList<int> &eraIdt, const QList<int> &veroTiliIdt)
+{
+    laskut_.clear();
+    verot_.clear();
+
+    if( eraIdt.isEmpty())
+        return;
+
+    QSqlQuery kysely( tietokanta_ );
+    kysely.setForwardOnly(true);
+
+    // Erien avaavat viennit, tositteet ja saldot
+    kysely.exec( QString("SELECT vienti.id, vienti.pvm, vienti.selite, vienti.tosite, tositelaji.tunnus, tosite.tunniste, "
+                         "(SELECT SUM(debetsnt) FROM vienti AS e WHERE e.eraid=vienti.id) AS debetit, "
+                         "(SELECT SUM(kreditsnt) FROM vienti AS e WHERE e.eraid=vienti.id) AS kreditit "
+                         "FROM vienti LEFT OUTER JOIN tosite ON vienti.tosite=tosite.id "
+                         "LEFT OUTER JOIN tositelaji ON tosite.laji=tositelaji.id "
+                         "WHERE vienti.id IN (%1)").arg( idLista(eraIdt) ));
+
+    QSet<int> tositteet;
+    while( kysely.next())
+    {
+        MaksuAlvLasku lasku;
+        lasku.eraId = kysely.value("id").toInt();
+        lasku.pvm = kysely.value("pvm").toDate();
+        lasku.selite = kysely.value("selite").toString();
+        lasku.tositeId = kysely.value("tosite").toInt();
+        lasku.tositeLoytyi = !kysely.value("tunnus").isNull();
+        lasku.tositelajiTunnus = kysely.value("tunnus").toString();
+        lasku.tunniste = kysely.value("tunniste").toInt();
+        lasku.saldoSnt = kysely.value("debetit").toLongLong() - kysely.value("kreditit").toLongLong();
+        laskut_.insert( lasku.eraId, lasku);
+        tositteet.insert( lasku.tositeId );
+    }
+
+    if( tositteet.isEmpty() || veroTiliIdt.isEmpty())
+        return;
+
+    // Laskujen tositteilla olevat kohdentamattomat verot saldoineen. Jos verot on jo
+    // erääntymisen takia maksettu, ei niitä makseta enää toista kertaa
+    kysely.exec( QString("SELECT vienti.tosite, vienti.tili, vienti.alvprosentti, vienti.id, "
+                         "(SELECT SUM(debetsnt) FROM vienti AS e WHERE e.eraid=vienti.id) AS debetit, "
+                         "(SELECT SUM(kreditsnt) FROM vienti AS e WHERE e.eraid=vienti.id) AS kreditit "
+                         "FROM vienti WHERE vienti.tosite IN (%1) AND vienti.tili IN (%2) ORDER BY vienti.id")
+                 .arg( idLista( tositteet.toList() )).arg( idLista(veroTiliIdt)));
+
+    while( kysely.next())
+    {
+        MaksuAlvEra maksuEra;
+        maksuEra.alvprosentti = kysely.value("alvprosentti").toInt();
+        maksuEra.id = kysely.value("id").toInt();
+        maksuEra.sentit = kysely.value("debetit").toLongLong() - kysely.value("kreditit").toLongLong();
+
+        QList<MaksuAlvEra>& verot = verot_[ qMakePair( kysely.value("tosite").toInt(), kysely.value("tili").toInt()) ];
+        if( maksuEra.sentit)
+            verot.append(maksuEra);
+    }
+}
+
+MaksuAlvLasku MaksuAlvHaku::lasku(int eraId) const
+{
+    return laskut_.value(eraId);
+}
+
+QList<MaksuAlvEra> MaksuAlvHaku::verot(int eraId, int veroTiliId) const
+{
+    if( !laskut_.contains(eraId))
+        return QList<MaksuAlvEra>();
+    return verot_.value( qMakePair( laskut_.value(eraId).tositeId, veroTiliId ));
+}
+
+QList<MaksuAlvEra> MaksuAlvHaku::jaa(qlonglong suoritus, qlonglong eraSaldo, const QList<MaksuAlvEra> &verot)
+{
+    // Jo tasan mennyt erä: ei suhteutettavaa
+    if( !eraSaldo )
+        return QList<MaksuAlvEra>();
+
+    double kerroin = 1.00;
+    if( eraSaldo != suoritus )
+        kerroin = ((double) suoritus) / (double) eraSaldo;
+
+    // Nyt sitten tehdään suhteelliset kirjaukset
+    QList<MaksuAlvEra> jaetut;
+    for( MaksuAlvEra vero : verot)
+    {
+        if( kerroin != 1.00)
+            vero.sentit = qRound64( kerroin * (double) vero.sentit );
+        jaetut.append(vero);
+    }
+    return jaetut;
+}
@@ -0,0 +1,101 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef MAKSUALVHAKU_H
+#define MAKSUALVHAKU_H
+
+#include <QDate>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QSqlDatabase>
+#include <QString>
+
+/**
+ * @brief Maksuperusteisen arvonlisäveron määrittelyn apurakenne
+ *
+ * Yksi maksuperäisen arvonlisäveron erä
+ */
+struct MaksuAlvEra
+{
+    MaksuAlvEra() {}
+
+    int alvprosentti = 0;
+    qlonglong sentit = 0;
+    int id = 0;
+};
+
+/**
+ * @brief Maksuperusteisen laskun tase-erän tiedot
+ */
+struct MaksuAlvLasku
+{
+    int eraId = 0;
+    QDate pvm;
+    QString selite;
+    int tositeId = -1;
+    bool tositeLoytyi = false;
+    QString tositelajiTunnus;
+    int tunniste = 0;
+    qlonglong saldoSnt = 0;
+};
+
+/**
+ * @brief Maksuperusteisen alv:n viimeistelyn tarvitsemat tiedot kerralla
+ *
+ * Hakee kaikkien suoritettavien laskujen tase-erät saldoineen sekä laskujen
+ * tositteilla olevat kohdentamattomat verot saldoineen kahdella kyselyllä,
+ * jotta suurenkin tiliotteen viimeistely ei tee kyselyitä riveittäin.
+ */
+class MaksuAlvHaku
+{
+public:
+    MaksuAlvHaku(const QSqlDatabase& tietokanta);
+
+    /**
+     * @brief Hakee erien ja niiden kohdentamattomien verojen tiedot
+     * @param eraIdt Suoritettavien laskujen tase-erät
+     * @param veroTiliIdt Kohdentamattoman alv-velan ja -saatavan tilit
+     */
+    void hae(const QList<int>& eraIdt, const QList<int>& veroTiliIdt);
+
+    MaksuAlvLasku lasku(int eraId) const;
+
+    /**
+     * @brief Laskun tositteella olevat avoimet kohdentamattomat verot
+     * @param eraId Laskun tase-erä
+     * @param veroTiliId Kohdentamattoman veron tili
+     */
+    QList<MaksuAlvEra> verot(int eraId, int veroTiliId) const;
+
+    /**
+     * @brief Jakaa verot suorituksen suhteessa erän saldoon
+     * @param suoritus Suorituksen määrä (debet - kredit)
+     * @param eraSaldo Erän saldo ennen suoritusta
+     * @param verot Erän avoimet verot
+     * @return Suoritukseen kohdistuvat verot
+     */
+    static QList<MaksuAlvEra> jaa(qlonglong suoritus, qlonglong eraSaldo, const QList<MaksuAlvEra>& verot);
+
+private:
+    QSqlDatabase tietokanta_;
+    QHash<int, MaksuAlvLasku> laskut_;
+    QHash<QPair<int,int>, QList<MaksuAlvEra>> verot_;
+};
+
+#endif // MAKSUALVHAKU_H
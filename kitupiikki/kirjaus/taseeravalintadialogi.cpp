@@ -49,7 +49,7 @@ TaseEraValintaDialogi::TaseEraValintaDialogi(QWidget *parent) :
     connect( ui->suodatusEdit, SIGNAL(textChanged(QString)), proxy_, SLOT(setFilterFixedString(QString)));
     connect( ui->view->selectionModel(), SIGNAL(currentChanged(QModelIndex,QModelIndex)), this, SLOT(eraValintaVaihtuu()) );
 
-    connect( ui->vainAvoimetCheck, SIGNAL(clicked(bool)), this, SLOT(sntSuodatusVaihtuu()));
+    connect( ui->vainAvoimetCheck, SIGNAL(clicked(bool)), this, SLOT(avoimetVaihtuu()));
     connect( ui->summaEdit, SIGNAL(textEdited(QString)), this, SLOT(sntSuodatusVaihtuu()));
 }
 
@@ -67,7 +67,9 @@ bool TaseEraValintaDialogi::nayta(VientiModel *model, QModelIndex &index)
     taseEra_ = index.data( VientiModel::EraIdRooli).toInt();
     vientiId_ = index.data( VientiModel::IdRooli).toInt();
 
-    model_.lataa( tili_, true );
+    // Oletuksena näytetään vain avoimet erät sekä viennin nykyinen erä
+    ui->vainAvoimetCheck->setChecked(true);
+    model_.lataaAvoimet( tili_, taseEra_ );
 
     ui->view->setCurrentIndex( proxy_->index(0,0));
 
@@ -184,10 +186,6 @@ void TaseEraValintaDialogi::sntSuodatusVaihtuu()
         int sentit = qRound(ui->summaEdit->text().replace(',','.').toDouble() * 100);
         sntProxy_->setFilterRegExp( QString("^[-]?%1$").arg(sentit) );
     }
-    else if( ui->vainAvoimetCheck->isChecked())
-    {
-        sntProxy_->setFilterRegExp("^[-1-9].*");
-    }
     else
         sntProxy_->setFilterFixedString("");
 
@@ -201,3 +199,13 @@ void TaseEraValintaDialogi::sntSuodatusVaihtuu()
         }
     }
 }
+
+void TaseEraValintaDialogi::avoimetVaihtuu()
+{
+    if( ui->vainAvoimetCheck->isChecked())
+        model_.lataaAvoimet( tili_, taseEra_);
+    else
+        model_.lataa( tili_, true);
+
+    sntSuodatusVaihtuu();
+}
@@ -55,6 +55,7 @@ public:
 public slots:
     void eraValintaVaihtuu();
     void sntSuodatusVaihtuu();
+    void avoimetVaihtuu();
 
 private:
     Ui::TaseEraValintaDialogi *ui;
@@ -16,14 +16,12 @@
 */
 #include "erittelyruudukko.h"
 
-#include "db/kirjanpito.h"
-
-
 ErittelyRuudukko::ErittelyRuudukko(LaskuModel *model, LaskunTulostaja *tulostaja)
     : tulostaja_(tulostaja)
 {
-    bool kaikki = !kp()->asetukset()->onko("LaskuLyhyetRivit");
+    bool kaikki = !tulostaja->laskupohja().lyhyetRivit;
     bool alennuksia  = model->onkoAlennuksia();
+    bool alvSarake = model->alverittely( tulostaja->laskupohja().alv ).count() > 1;
 
     // Ensin otsikot ja tasaukset
     lisaaSarake("nimike");
@@ -36,7 +34,7 @@ ErittelyRuudukko::ErittelyRuudukko(LaskuModel *model, LaskunTulostaja *tulostaja
         lisaaSarake("alennus", Qt::AlignRight);
     if( kaikki )
         lisaaSarake("netto", Qt::AlignRight);
-    if( model->alverittely().count() > 1)
+    if( alvSarake )
         lisaaSarake("alv",Qt::AlignRight);
     if( kaikki )
         lisaaSarake("vero", Qt::AlignRight);
@@ -66,7 +64,7 @@ ErittelyRuudukko::ErittelyRuudukko(LaskuModel *model, LaskunTulostaja *tulostaja
         }
         if( kaikki )            
              rivi.append(  nettosnt > 0 ? QString("%L1 €").arg( ( nettosnt / 100.0) ,0,'f',2) : QString());
-        if( model->alverittely().count() > 1)
+        if( alvSarake )
             rivi.append( model->data( model->index(i, LaskuModel::ALV), Qt::DisplayRole ).toString() );
         if( kaikki )
         {
@@ -185,8 +183,8 @@ void ErittelyRuudukko::tulostaErittelyOtsikko(QPagedPaintDevice *printer, QPaint
     if(sivuntunniste)
     {
         painter->setFont(QFont("Sans",10));
-        painter->drawText( QRectF(0,0,sivunleveys/2,painter->fontMetrics().height()), Qt::AlignLeft, kp()->asetukset()->asetus("LaskuAputoiminimi").isEmpty() ? kp()->asetukset()->asetus("Nimi") : kp()->asetukset()->asetus("LaskuAputoiminimi"));
-        painter->drawText( QRectF(sivunleveys/2,0,sivunleveys/2, painter->fontMetrics().height()), Qt::AlignRight, kp()->paivamaara().toString("dd.MM.yyyy"));
+        painter->drawText( QRectF(0,0,sivunleveys/2,painter->fontMetrics().height()), Qt::AlignLeft, tulostaja_->laskupohja().laskuttaja);
+        painter->drawText( QRectF(sivunleveys/2,0,sivunleveys/2, painter->fontMetrics().height()), Qt::AlignRight, tulostaja_->paivamaara().toString("dd.MM.yyyy"));
         painter->translate(0, painter->fontMetrics().height()*2);
     }
 
@@ -21,6 +21,7 @@
 #include "db/kirjanpito.h"
 
 #include "laskuntulostaja.h"
+#include "finvoiceaineisto.h"
 #include "validator/ibanvalidator.h"
 
 #include <QRegularExpression>
@@ -91,20 +92,56 @@ bool Finvoice::muodostaFinvoice(LaskuModel *model)
     return true;
 }
 
+bool Finvoice::muodostaAineisto(const QList<int> &vientiIdt, const QString &tiedostonnimi)
+{
+    QFile tiedosto( tiedostonnimi );
+    if( !tiedosto.open( QIODevice::WriteOnly ))
+        return false;
+
+    // Pankkiyhteydellä lähetettävässä aineistossa jokaisella laskulla on oma SOAP-kehys
+    const FinvoiceMyyja myyjanTiedot = myyja();
+    FinvoiceAineisto<LaskuModel> aineisto( [&vientiIdt] (int i) { return LaskuModel::haeLasku( vientiIdt.at(i) ); },
+                                           [myyjanTiedot] (LaskuModel *model) { return lasku(model, myyjanTiedot, true); } );
+    bool onni = aineisto.kirjoita( &tiedosto, vientiIdt.count() );
+    tiedosto.close();
+    return onni;
+}
+
 QByteArray Finvoice::lasku(LaskuModel *model)
+{
+    return lasku( model, myyja(), kp()->asetukset()->onko("VerkkolaskuSOAP"));
+}
+
+FinvoiceMyyja Finvoice::myyja()
+{
+    FinvoiceMyyja myyja;
+    myyja.nimi = kp()->asetukset()->asetus("Nimi");
+    myyja.ytunnus = kp()->asetukset()->asetus("Ytunnus");
+    myyja.osoite = kp()->asetukset()->asetus("Osoite");
+    myyja.sahkoposti = kp()->asetukset()->onko("Sahkoposti") ? kp()->asetukset()->asetus("Sahkoposti") : QString();
+    myyja.puhelin = kp()->asetukset()->onko("Puhelin") ? kp()->asetukset()->asetus("Puhelin") : QString();
+    myyja.verkkolaskuOsoite = kp()->asetukset()->asetus("VerkkolaskuOsoite");
+    myyja.verkkolaskuValittaja = kp()->asetukset()->asetus("VerkkolaskuValittaja");
+    myyja.iban = kp()->tilit()->tiliNumerolla( kp()->asetukset()->luku("LaskuTili")).json()->str("IBAN");
+    myyja.alv = kp()->asetukset()->onko("AlvVelvollinen");
+    myyja.rf = kp()->asetukset()->onko("LaskuRF");
+    return myyja;
+}
+
+QByteArray Finvoice::lasku(LaskuModel *model, const FinvoiceMyyja &myyja, bool soapKehys)
 {
     QByteArray soapArray;
 
-    QString lahettajanVerkkolasku = kp()->asetukset()->asetus("VerkkolaskuOsoite");
-    QString lahettajanValittaja = kp()->asetukset()->asetus("VerkkolaskuValittaja");
+    QString lahettajanVerkkolasku = myyja.verkkolaskuOsoite;
+    QString lahettajanValittaja = myyja.verkkolaskuValittaja;
     QString vastaanottajanVerkkolasku = model->verkkolaskuOsoite();
     QString vastaanottajanValittaja =  model->verkkolaskuValittaja();
     QString aikaleima = QDateTime::currentDateTime().toString("yyyy-MM-ddThh:mm:ss");
-    QString alvtunnus = QString("FI%1").arg(kp()->asetukset()->asetus("Ytunnus"));
+    QString alvtunnus = QString("FI%1").arg(myyja.ytunnus);
     alvtunnus.remove('-');
-    QString iban = kp()->tilit()->tiliNumerolla( kp()->asetukset()->luku("LaskuTili")).json()->str("IBAN");
+    QString iban = myyja.iban;
 
-    if( kp()->asetukset()->onko("VerkkolaskuSOAP") )  // Kirjoita SOAP
+    if( soapKehys )  // Kirjoita SOAP
     {
         QTextStream out(&soapArray);
         out << R"(<SOAP-ENV:Envelope xmlns:SOAP-ENV="http://schemas.xmlsoap.org/soap/envelope/" xmlns:xlink="http://www.w3.org/1999/xlink" xmlns:eb="http://www.oasis-open.org/committees/ebxml-msg/schema/msg-header-2_0.xsd">)" << "\n";
@@ -120,7 +157,7 @@ QByteArray Finvoice::lasku(LaskuModel *model)
         out << R"(</eb:From>)" << "\n";
         out << R"(<eb:To>)" << "\n";
         out << R"(<eb:PartyId>)" << vastaanottajanVerkkolasku << R"(</eb:PartyId>)" << "\n";
-        out << R"(<eb:Role>Sender</eb:Role>)" << "\n";
+        out << R"(<eb:Role>Receiver</eb:Role>)" << "\n";
         out << R"(</eb:To>)" << "\n";
         out << R"(<eb:To>)" << "\n";
         out << R"(<eb:PartyId>)" << vastaanottajanValittaja << R"(</eb:PartyId>)" << "\n";
@@ -138,8 +175,9 @@ QByteArray Finvoice::lasku(LaskuModel *model)
         out << R"(</SOAP-ENV:Header>)" << "\n";
         out << R"(<SOAP-ENV:Body>)" << "\n";
         out << R"(<eb:Manifest eb:id="Manifest" eb:version="2.0">)" << "\n";
-        out << R"(<eb:Reference eb:id="Finvoice" xlink:href="200911180001">)" << "\n";
-        out << R"(<eb:Schema eb:location="http://www.finvoice.info/finvoice.xsd" eb:version="2.0"/>)" << "\n";
+        // Kehys viittaa sanomaan sen tunnisteella (MessageIdentifier)
+        out << R"(<eb:Reference eb:id="Finvoice" xlink:href=")" << model->laskunro() << R"(">)" << "\n";
+        out << R"(<eb:Schema eb:location="http://www.finvoice.info/finvoice.xsd" eb:version="3.0"/>)" << "\n";
         out << R"(</eb:Reference>)" << "\n";
         out << R"(</eb:Manifest>)" << "\n";
         out << R"(</SOAP-ENV:Body>)" << "\n";
@@ -156,12 +194,12 @@ QByteArray Finvoice::lasku(LaskuModel *model)
 
     writer.writeStartDocument("1.0");
     writer.writeStartElement("Finvoice");
-    writer.writeAttribute("Version","2.01");
+    writer.writeAttribute("Version","3.0");
 
     writer.writeStartElement("MessageTransmissionDetails");
 
     writer.writeStartElement("MessageSenderDetails");
-    writer.writeTextElement("FromIndentifier", lahettajanVerkkolasku);
+    writer.writeTextElement("FromIdentifier", lahettajanVerkkolasku);
     writer.writeTextElement("FromIntermediator", lahettajanValittaja);
     writer.writeEndElement();
 
@@ -178,13 +216,13 @@ QByteArray Finvoice::lasku(LaskuModel *model)
     writer.writeEndElement();
 
     writer.writeStartElement("SellerPartyDetails");
-    writer.writeTextElement("SellerPartyIdentifier", kp()->asetukset()->asetus("Ytunnus"));
-    writer.writeTextElement("SellerOrganisationName", kp()->asetukset()->asetus("Nimi"));
+    writer.writeTextElement("SellerPartyIdentifier", myyja.ytunnus);
+    writer.writeTextElement("SellerOrganisationName", myyja.nimi);
 
-    if( kp()->asetukset()->onko("AlvVelvollinen"))
+    if( myyja.alv )
         writer.writeTextElement("SellerOrganisationTaxCode", alvtunnus );
 
-    HajoitettuOsoite myyjanOsoite = hajoitaOsoite( kp()->asetukset()->asetus("osoite") );
+    HajoitettuOsoite myyjanOsoite = hajoitaOsoite( myyja.osoite );
     writer.writeStartElement("SellerPostalAddressDetails");
     writer.writeTextElement("SellerStreetName", myyjanOsoite.lahiosoite);
     writer.writeTextElement("SellerTownName", myyjanOsoite.postitoimipaikka);
@@ -196,19 +234,19 @@ QByteArray Finvoice::lasku(LaskuModel *model)
 
     writer.writeStartElement("SellerInformationDetails");
 
-    if( kp()->asetukset()->onko("Sahkoposti"))
-        writer.writeTextElement("SellerCommonEmailaddressIdentifier", kp()->asetukset()->asetus("Sahkoposti"));
-    if( kp()->asetukset()->onko("Puhelin"))
-        writer.writeTextElement("SellerPhoneNumber", kp()->asetukset()->asetus("Puhelin"));
+    if( !myyja.puhelin.isEmpty())
+        writer.writeTextElement("SellerPhoneNumber", myyja.puhelin);
+    if( !myyja.sahkoposti.isEmpty())
+        writer.writeTextElement("SellerCommonEmailaddressIdentifier", myyja.sahkoposti);
 
     writer.writeStartElement("SellerAccountDetails");
 
     writer.writeStartElement("SellerAccountID");
-    writer.writeAttribute("IdentificationsSchemeName","IBAN");
+    writer.writeAttribute("IdentificationSchemeName","IBAN");
     writer.writeCharacters(iban );
     writer.writeEndElement();
     writer.writeStartElement("SellerBic");
-    writer.writeAttribute("IdentificationsSchemeName", "BIC");
+    writer.writeAttribute("IdentificationSchemeName", "BIC");
     writer.writeCharacters( LaskutModel::bicIbanilla(iban) );
     writer.writeEndElement();
 
@@ -217,7 +255,7 @@ QByteArray Finvoice::lasku(LaskuModel *model)
 
     writer.writeStartElement("BuyerPartyDetails");
     if( !model->ytunnus().isEmpty() && model->ytunnus().at(0).isDigit())
-        writer.writeTextElement("ByerPartyIdentifier", model->ytunnus());
+        writer.writeTextElement("BuyerPartyIdentifier", model->ytunnus());
     writer.writeTextElement("BuyerOrganisationName", model->laskunsaajanNimi());
 
     if( !model->ytunnus().isEmpty() && model->ytunnus().at(0).isLetter())
@@ -232,12 +270,15 @@ QByteArray Finvoice::lasku(LaskuModel *model)
     writer.writeEndElement();
     writer.writeEndElement();
 
-    writer.writeStartElement("DeliveryDetails");
-    writer.writeStartElement("DeliveryDate");
-    writer.writeAttribute("Format","CCYYMMDD");
-    writer.writeCharacters( model->toimituspaiva().toString("yyyyMMdd") );
-    writer.writeEndElement();
-    writer.writeEndElement();
+    if( model->toimituspaiva().isValid())
+    {
+        writer.writeStartElement("DeliveryDetails");
+        writer.writeStartElement("DeliveryDate");
+        writer.writeAttribute("Format","CCYYMMDD");
+        writer.writeCharacters( model->toimituspaiva().toString("yyyyMMdd") );
+        writer.writeEndElement();
+        writer.writeEndElement();
+    }
 
     writer.writeStartElement("InvoiceDetails");
     writer.writeTextElement("InvoiceTypeCode","INV01");
@@ -245,14 +286,14 @@ QByteArray Finvoice::lasku(LaskuModel *model)
     writer.writeTextElement("OriginCode","Original");
     writer.writeTextElement("InvoiceNumber", QString::number(model->laskunro()));
     writer.writeStartElement("InvoiceDate");
-    if( !model->asiakkaanViite().isEmpty())
-        writer.writeTextElement("BuyerReferenceIdentifier", model->asiakkaanViite());
     writer.writeAttribute("Format","CCYYMMDD");
     writer.writeCharacters( QDate::currentDate().toString("yyyyMMdd") );
     writer.writeEndElement();
+    if( !model->asiakkaanViite().isEmpty())
+        writer.writeTextElement("BuyerReferenceIdentifier", model->asiakkaanViite());
 
     // Hakee alv-erittelyt
-    QList<AlvErittelyRivi> alvErittely = model->alverittely();
+    QList<AlvErittelyRivi> alvErittely = model->alverittely( myyja.alv );
 
     writer.writeStartElement("InvoiceTotalVatExcludedAmount");
     writer.writeAttribute("AmountCurrencyIdentifier","EUR");
@@ -278,15 +319,14 @@ QByteArray Finvoice::lasku(LaskuModel *model)
         writer.writeCharacters( QString("%1").arg( alv.netto() / 100.0 , 0, 'f', 2).replace('.',',') );
         writer.writeEndElement();
 
-        if( alv.vero() > 1e-5)
-            writer.writeTextElement("VatRatePercent", QString("%1,0").arg( alv.alvProsentti() ) );
+        writer.writeTextElement("VatRatePercent", QString("%1,0").arg( alv.vero() > 1e-5 ? alv.alvProsentti() : 0 ) );
+        writer.writeTextElement("VatCode", vatCode(alv.alvKoodi()) );
 
         writer.writeStartElement("VatRateAmount");
         writer.writeAttribute("AmountCurrencyIdentifier","EUR");
         writer.writeCharacters( QString("%1").arg( alv.vero() / 100.0 , 0, 'f', 2).replace('.',',') );
         writer.writeEndElement();
 
-        writer.writeTextElement("VatCode", vatCode(alv.alvKoodi()) );
         QString vatTeksti = vatFree( alv.alvKoodi() );
         if( !vatTeksti.isEmpty())
             writer.writeTextElement("VatFreeText", vatTeksti);
@@ -306,7 +346,7 @@ QByteArray Finvoice::lasku(LaskuModel *model)
     {
         writer.writeStartElement("PaymentOverDueFineDetails");
         writer.writeTextElement("PaymentOverDueFineFreeText", "Viivästyskorko");
-        writer.writeTextElement("PaymentOverDueFinePercent", QString::number(model->viivastysKorko(),'g',1) );
+        writer.writeTextElement("PaymentOverDueFinePercent", QString("%1").arg(model->viivastysKorko(), 0, 'f', 1).replace('.',',') );
         writer.writeEndElement();
     }
     writer.writeEndElement();
@@ -323,14 +363,17 @@ QByteArray Finvoice::lasku(LaskuModel *model)
 
         writer.writeTextElement("ArticleName", indeksi.data(LaskuModel::NimikeRooli).toString() );
 
+        // Näytettävä määrä on muotoiltu kielen mukaan, sanomaan aina pilkulla
+        QString maara = QString("%1").arg( indeksi.sibling(i, LaskuModel::MAARA).data(Qt::EditRole).toDouble(), 0, 'f', 2).replace('.',',');
+
         writer.writeStartElement("OrderedQuantity");
         writer.writeAttribute("QuantityUnitCode", indeksi.sibling(i, LaskuModel::YKSIKKO).data().toString());
-        writer.writeCharacters( indeksi.sibling(i, LaskuModel::MAARA).data().toString() );
+        writer.writeCharacters( maara );
         writer.writeEndElement();
 
         writer.writeStartElement("InvoicedQuantity");
         writer.writeAttribute("QuantityUnitCode", indeksi.sibling(i, LaskuModel::YKSIKKO).data().toString());
-        writer.writeCharacters( indeksi.sibling(i, LaskuModel::MAARA).data().toString() );
+        writer.writeCharacters( maara );
         writer.writeEndElement();
 
         writer.writeStartElement("UnitPriceAmount");
@@ -338,6 +381,10 @@ QByteArray Finvoice::lasku(LaskuModel *model)
         writer.writeCharacters( QString("%1").arg( indeksi.data(LaskuModel::AHintaRooli).toLongLong() / 100.0 , 0, 'f', 2).replace('.',','));
         writer.writeEndElement();
 
+        double verosnt = model->data( model->index(i, LaskuModel::NIMIKE), LaskuModel::VeroRooli ).toDouble();
+
+        writer.writeTextElement("RowPositionIdentifier", QString::number( i + 1));
+
         if( indeksi.data(LaskuModel::AleProsenttiRooli).toInt())
         {
             writer.writeStartElement("RowDiscountPercent");
@@ -345,10 +392,8 @@ QByteArray Finvoice::lasku(LaskuModel *model)
             writer.writeEndElement();
         }
 
-        double verosnt = model->data( model->index(i, LaskuModel::NIMIKE), LaskuModel::VeroRooli ).toDouble();
-
-        writer.writeTextElement("RowPositionIdentifier", QString::number( i + 1));
         writer.writeTextElement("RowVatRatePercent",  QString("%1,0").arg(indeksi.data(LaskuModel::AlvProsenttiRooli).toInt()));
+        writer.writeTextElement("RowVatCode", vatCode( indeksi.data(LaskuModel::AlvKoodiRooli).toInt() ) );
 
         writer.writeStartElement("RowVatAmount");
         writer.writeAttribute("AmountCurrencyIdentifier","EUR");
@@ -357,13 +402,9 @@ QByteArray Finvoice::lasku(LaskuModel *model)
 
         writer.writeStartElement("RowVatExcludedAmount");
         writer.writeAttribute("AmountCurrencyIdentifier","EUR");
-        writer.writeCharacters( QString("%1").arg( indeksi.data(LaskuModel::BruttoRooli).toLongLong() / 100.0 , 0, 'f', 2).replace('.',','));
+        writer.writeCharacters( QString("%1").arg( indeksi.data(LaskuModel::NettoRooli).toLongLong() / 100.0 , 0, 'f', 2).replace('.',','));
         writer.writeEndElement();
 
-
-        int alvkoodi = indeksi.data(LaskuModel::AlvKoodiRooli).toInt();
-        writer.writeTextElement("RowVatCode", vatCode( alvkoodi ) );
-
         writer.writeEndElement();
     }
 
@@ -381,16 +422,16 @@ QByteArray Finvoice::lasku(LaskuModel *model)
     writer.writeStartElement("EpiPartyDetails");
     writer.writeStartElement("EpiBfiPartyDetails");
     writer.writeStartElement("EpiBfiIdentifier");
-    writer.writeAttribute("IdentificationsSchemeName", "BIC");
+    writer.writeAttribute("IdentificationSchemeName", "BIC");
     writer.writeCharacters( LaskutModel::bicIbanilla(iban) );
     writer.writeEndElement();
     writer.writeEndElement();
 
     writer.writeStartElement("EpiBeneficiaryPartyDetails");
-    writer.writeTextElement("EpiNameAddressDetails", kp()->asetukset()->asetus("Nimi"));
+    writer.writeTextElement("EpiNameAddressDetails", myyja.nimi);
     writer.writeTextElement("EpiBei", alvtunnus.mid(2));
     writer.writeStartElement("EpiAccountID");
-    writer.writeAttribute("IdentificationsSchemeName","IBAN");
+    writer.writeAttribute("IdentificationSchemeName","IBAN");
     writer.writeCharacters(iban );
     writer.writeEndElement();
     writer.writeEndElement();
@@ -398,18 +439,18 @@ QByteArray Finvoice::lasku(LaskuModel *model)
     writer.writeStartElement("EpiPaymentInstructionDetails");                              
     writer.writeStartElement("EpiRemittanceInfoIdentifier");
 
-    if( kp()->asetukset()->onko("LaskuRF"))
+    if( myyja.rf )
     {
         // RF-muotoinen viite
         QString rf= "RF00" + model->viitenumero();
         int tarkiste = 98 - IbanValidator::ibanModulo( rf );
-        writer.writeAttribute("IdentificationsSchemeName", "ISO");
+        writer.writeAttribute("IdentificationSchemeName", "ISO");
         writer.writeCharacters( QString("RF%1%2").arg(tarkiste,2,10,QChar('0')).arg(rf.mid(4)) );
 
     }
     else
     {
-        writer.writeAttribute("IdentificationsSchemeName", "SPY");
+        writer.writeAttribute("IdentificationSchemeName", "SPY");
         writer.writeCharacters( model->viitenumero() );
 
     }
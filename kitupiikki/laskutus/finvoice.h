@@ -31,6 +31,25 @@ struct HajoitettuOsoite
     QString maakoodi;
 };
 
+/**
+ * @brief Laskuttajan tiedot Finvoice-sanomaan
+ *
+ * Luetaan asetuksista pääsäikeessä, jotta sanomia voi muodostaa rinnakkain
+ */
+struct FinvoiceMyyja
+{
+    QString nimi;
+    QString ytunnus;
+    QString osoite;
+    QString sahkoposti;
+    QString puhelin;
+    QString verkkolaskuOsoite;
+    QString verkkolaskuValittaja;
+    QString iban;
+    bool alv = false;
+    bool rf = false;
+};
+
 /**
  * @brief Finvoice-laskun käsittely
  */
@@ -42,6 +61,28 @@ public:
 
     static bool muodostaFinvoice(LaskuModel *model);
     static QByteArray lasku(LaskuModel* model);
+    /**
+     * @brief Laskun Finvoice-sanoma
+     *
+     * Ei lue kirjanpitoa eikä asetuksia, joten voidaan kutsua taustasäikeestä
+     *
+     * @param myyja Laskuttajan tiedot, ks. myyja()
+     * @param soapKehys Kirjoitetaanko sanoman eteen SOAP-kehys
+     */
+    static QByteArray lasku(LaskuModel* model, const FinvoiceMyyja& myyja, bool soapKehys);
+
+    /**
+     * @brief Laskuttajan tiedot asetuksista
+     */
+    static FinvoiceMyyja myyja();
+
+    /**
+     * @brief Kirjoittaa useamman laskun sanomat SOAP-kehyksineen yhteen tiedostoon
+     * @param vientiIdt Laskujen viennit
+     * @param tiedostonnimi Kirjoitettava tiedosto
+     * @return tosi, jos onnistui
+     */
+    static bool muodostaAineisto(const QList<int>& vientiIdt, const QString& tiedostonnimi);
 
     static HajoitettuOsoite hajoitaOsoite(const QString& osoite);
 
@@ -0,0 +1,110 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FINVOICEAINEISTO_H
+#define FINVOICEAINEISTO_H
+
+#include <QIODevice>
+#include <QList>
+#include <QFuture>
+#include <QtConcurrent>
+
+#include <functional>
+
+/**
+ * @brief Useamman laskun Finvoice-aineisto yhteen tiedostoon
+ *
+ * Laskut ladataan pääsäikeessä (tietokantaa käytetään vain sieltä)
+ * ikkunallinen kerrallaan. Sillä aikaa, kun edellisen ikkunan sanomia
+ * muodostetaan rinnakkain, ladataan seuraava. Valmiit sanomat kirjoitetaan
+ * laskujen järjestyksessä ja laskut vapautetaan heti, joten muistissa on
+ * kerrallaan enintään kaksi ikkunallista laskuja laskujen määrästä riippumatta.
+ */
+template <typename Lasku>
+class FinvoiceAineisto
+{
+public:
+    typedef std::function<Lasku*(int)> Lataaja;
+    typedef std::function<QByteArray(Lasku*)> Muodostaja;
+
+    /**
+     * @param lataaja Lataa laskun indeksillä, nullptr keskeyttää
+     * @param muodostaja Muodostaa laskun sanoman, kutsutaan rinnakkain
+     * @param ikkuna Kerrallaan ladattavien laskujen määrä
+     */
+    FinvoiceAineisto(Lataaja lataaja, Muodostaja muodostaja, int ikkuna = 32)
+        : lataaja_(lataaja), muodostaja_(muodostaja), ikkuna_(ikkuna) {}
+
+    /**
+     * @brief Kirjoittaa aineiston
+     * @param laite Kirjoitettavaksi avattu laite
+     * @param laskuja Lataajaa kutsutaan indekseillä 0 .. laskuja-1
+     * @return tosi, jos kaikki laskut ladattiin ja kirjoitettiin
+     */
+    bool kirjoita(QIODevice *laite, int laskuja)
+    {
+        bool onni = true;
+        QList<Lasku*> kasiteltavat;
+        QFuture<QByteArray> sanomat;
+        suurinLadattuna_ = 0;
+
+        for(int alku = 0; (alku < laskuja && onni) || !kasiteltavat.isEmpty(); alku += ikkuna_)
+        {
+            QList<Lasku*> ladatut;
+            for(int i = alku; i < laskuja && i < alku + ikkuna_ && onni; i++)
+            {
+                Lasku *lasku = lataaja_(i);
+                if( lasku )
+                    ladatut.append(lasku);
+                else
+                    onni = false;
+            }
+            suurinLadattuna_ = qMax( suurinLadattuna_, kasiteltavat.count() + ladatut.count());
+
+            if( !kasiteltavat.isEmpty())
+            {
+                sanomat.waitForFinished();
+                for(const QByteArray& sanoma : sanomat.results())
+                    onni = onni && laite->write(sanoma) == sanoma.size();
+                qDeleteAll(kasiteltavat);
+            }
+
+            kasiteltavat = ladatut;
+            if( onni && !kasiteltavat.isEmpty())
+                sanomat = QtConcurrent::mapped(kasiteltavat, muodostaja_);
+            else
+            {
+                qDeleteAll(kasiteltavat);
+                kasiteltavat.clear();
+            }
+        }
+        return onni;
+    }
+
+    /**
+     * @brief Enimmäismäärä laskuja, jotka olivat yhtä aikaa ladattuina
+     */
+    int suurinLadattuna() const { return suurinLadattuna_; }
+
+protected:
+    Lataaja lataaja_;
+    Muodostaja muodostaja_;
+    int ikkuna_;
+    int suurinLadattuna_ = 0;
+};
+
+#endif // FINVOICEAINEISTO_H
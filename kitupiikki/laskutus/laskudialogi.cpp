@@ -415,25 +415,23 @@ void LaskuDialogi::haeOsoite()
     QString nimistr = ui->saajaEdit->text();
     nimistr.remove(QRegExp("['\"]"));
 
-    kysely.exec( QString("SELECT json FROM vienti WHERE asiakas='%1' AND iban is null ORDER BY muokattu DESC").arg( nimistr)) ;
+    haeYhteystiedot( kysely, nimistr );
 
     if( kysely.next() )
     {
-        JsonKentta json;
-        json.fromJson( kysely.value(0).toByteArray() );
-        ui->emailEdit->setText( json.str("Email"));
-        ui->ytunnus->setText( json.str("YTunnus"));
-        ui->verkkoOsoiteEdit->setText( json.str("VerkkolaskuOsoite"));
-        ui->verkkoValittajaEdit->setText( json.str("VerkkolaskuValittaja"));
-
-        qDebug() << "Kieli:" << json.str("Kieli");
-        if( !json.str("Kieli").isEmpty())
-            ui->kieliCombo->setCurrentIndex( ui->kieliCombo->findData( json.str("Kieli") ));
-
-        if( !json.str("Osoite").isEmpty())
+        ui->emailEdit->setText( kysely.value("email").toString());
+        ui->ytunnus->setText( kysely.value("ytunnus").toString());
+        ui->verkkoOsoiteEdit->setText( kysely.value("verkkolaskuosoite").toString());
+        ui->verkkoValittajaEdit->setText( kysely.value("verkkolaskuvalittaja").toString());
+
+        QString kieli = kysely.value("kieli").toString();
+        if( !kieli.isEmpty())
+            ui->kieliCombo->setCurrentIndex( ui->kieliCombo->findData( kieli ));
+
+        if( !kysely.value("osoite").toString().isEmpty())
         {
             // Haetaan aiempi osoite
-            ui->osoiteEdit->setPlainText( json.str("Osoite"));
+            ui->osoiteEdit->setPlainText( kysely.value("osoite").toString());
             return;
         }
     }
@@ -682,7 +680,7 @@ void LaskuDialogi::lisaaAsiakasListalta(const QModelIndex &indeksi)
     QString nimistr = indeksi.data(AsiakkaatModel::NimiRooli).toString();
     nimistr.remove(QRegExp("['\"]"));
 
-    kysely.exec( QString("SELECT json FROM vienti WHERE asiakas='%1' AND iban is null ORDER BY muokattu DESC").arg( nimistr)) ;
+    haeYhteystiedot( kysely, nimistr );
     QString osoite = nimistr;
     QString email;
     QString ytunnus;
@@ -691,17 +689,15 @@ void LaskuDialogi::lisaaAsiakasListalta(const QModelIndex &indeksi)
 
     if( kysely.next() )
     {
-        JsonKentta json;
-        json.fromJson( kysely.value(0).toByteArray() );
-        email =  json.str("Email");
-        ytunnus = json.str("YTunnus");
-        verkkolaskuosoite = json.str("VerkkolaskuOsoite");
-        verkkolaskuvalittaja = json.str("VerkkolaskuValittaja");
-
-        if( !json.str("Osoite").isEmpty())
+        email =  kysely.value("email").toString();
+        ytunnus = kysely.value("ytunnus").toString();
+        verkkolaskuosoite = kysely.value("verkkolaskuosoite").toString();
+        verkkolaskuvalittaja = kysely.value("verkkolaskuvalittaja").toString();
+
+        if( !kysely.value("osoite").toString().isEmpty())
         {
             // Haetaan aiempi osoite
-            osoite = json.str("Osoite");
+            osoite = kysely.value("osoite").toString();
         }
     }
 
@@ -788,6 +784,20 @@ void LaskuDialogi::paivitaTuoteluettelonNaytto()
     ui->tuotelistaOhje->setVisible( !tuotteita );
 }
 
+void LaskuDialogi::haeYhteystiedot(QSqlQuery &kysely, const QString &asiakas)
+{
+    kysely.prepare("SELECT json_extract(json,'$.Email') AS email, "
+                   "json_extract(json,'$.YTunnus') AS ytunnus, "
+                   "json_extract(json,'$.Osoite') AS osoite, "
+                   "json_extract(json,'$.Kieli') AS kieli, "
+                   "json_extract(json,'$.VerkkolaskuOsoite') AS verkkolaskuosoite, "
+                   "json_extract(json,'$.VerkkolaskuValittaja') AS verkkolaskuvalittaja "
+                   "FROM vienti WHERE asiakas=:asiakas AND iban IS NULL "
+                   "ORDER BY muokattu DESC LIMIT 1");
+    kysely.bindValue(":asiakas", asiakas);
+    kysely.exec();
+}
+
 int LaskuDialogi::laskuIkkunoita()
 {
     return laskuIkkunoita__;
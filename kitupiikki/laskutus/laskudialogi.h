@@ -20,6 +20,7 @@
 
 #include <QDialog>
 #include <QSortFilterProxyModel>
+#include <QSqlQuery>
 
 #include "laskumodel.h"
 #include "tuotemodel.h"
@@ -107,6 +108,15 @@ private:
      */
     void paivitaTuoteluettelonNaytto();
 
+    /**
+     * @brief Hakee asiakkaan viimeisimmät yhteystiedot
+     *
+     * Tiedot luetaan vienti-taulun json-kentästä asiakashakemiston kautta
+     * viimeksi muokatulta riviltä. Sarakkeet email, ytunnus, osoite, kieli,
+     * verkkolaskuosoite ja verkkolaskuvalittaja.
+     */
+    static void haeYhteystiedot(QSqlQuery& kysely, const QString& asiakas);
+
     static int laskuIkkunoita__;
 
 public slots:
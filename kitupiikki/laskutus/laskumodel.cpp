@@ -39,6 +39,11 @@
 #include <QDebug>
 #include <QSqlError>
 #include <QJsonDocument>
+#include <QProgressDialog>
+#include <QSettings>
+#include <QFutureWatcher>
+#include <QEventLoop>
+#include <QtConcurrent>
 
 LaskuModel::LaskuModel(QObject *parent) :
     QAbstractTableModel( parent ), kieli_("FI")
@@ -48,33 +53,8 @@ LaskuModel::LaskuModel(QObject *parent) :
     kirjausperuste_ = kp()->asetukset()->luku("LaskuKirjausperuste") ;
     viivkorko_ = kp()->asetukset()->asetus("LaskuViivastyskorko").toDouble();
 
-    // Ladataan tekstit
-    // Hakee tekstit
-    QFile tiedosto(":/lasku/laskutekstit.txt");
-    tiedosto.open(QIODevice::ReadOnly);
-
-    QTextStream in( &tiedosto );
-    in.setCodec("utf-8");
-    while( !in.atEnd() )
-    {
-        QString rivi = in.readLine();
-        rivi.replace('|','\n');
-        int valinpaikka = rivi.indexOf(' ');
-        if( valinpaikka )
-            tekstit_.insert( rivi.left(valinpaikka), rivi.mid(valinpaikka + 1));
-    }
-
-    // Vielä muokatut asetuksista
-    // Näin voidaan määritellä muokatut tekstit eri kirjanpidoille
-
-    QStringList muokatut = kp()->asetukset()->lista("LaskuTekstit");
-    for( QString rivi : muokatut)
-    {
-        int valinpaikka = rivi.indexOf(' ');
-        if( valinpaikka )
-            tekstit_[ rivi.left(valinpaikka)] = rivi.mid(valinpaikka + 1);
-    }
-
+    // Tekstiluettelo on koottu valmiiksi laskupohjaan
+    tekstit_ = LaskunTulostaja::pohja()->tekstit;
 }
 
 LaskuModel *LaskuModel::teeHyvityslasku(int hyvitettavaVientiId)
@@ -609,7 +589,12 @@ int LaskuModel::kplDesimaalit() const
 
 QList<AlvErittelyRivi> LaskuModel::alverittely() const
 {
-    if( !kp()->asetukset()->onko("AlvVelvollinen"))
+    return alverittely( kp()->asetukset()->onko("AlvVelvollinen") );
+}
+
+QList<AlvErittelyRivi> LaskuModel::alverittely(bool alvVelvollinen) const
+{
+    if( !alvVelvollinen )
         return QList<AlvErittelyRivi>();
 
     QMap<int,AlvErittelyRivi> alvit;
@@ -631,7 +616,11 @@ QList<AlvErittelyRivi> LaskuModel::alverittely() const
 
 void LaskuModel::haeRyhmasta(int indeksi)
 {
-    QModelIndex ind = ryhma_->index(indeksi, 0);
+    asetaVastaanottaja( ryhma_->index(indeksi, 0) );
+}
+
+void LaskuModel::asetaVastaanottaja(const QModelIndex &ind)
+{
     laskunsaajanNimi_ = ind.data(LaskuRyhmaModel::NimiRooli).toString();
     osoite_ =  ind.data(LaskuRyhmaModel::OsoiteRooli).toString();
     email_ = ind.data(LaskuRyhmaModel::SahkopostiRooli).toString();
@@ -647,19 +636,121 @@ bool LaskuModel::tallenna(Tili rahatili)
         return false;
 
     if( tyyppi() == RYHMALASKU)
+        return tallennaRyhma(rahatili);
+
+    // Luo tilapäisen pdf-tiedoston
+    QByteArray pdf = LaskunTulostaja(this).pdf();
+
+    QByteArray pikkukuva;
+    if( !kp()->settings()->value("PopplerPois").toBool())
+        pikkukuva = LiiteModel::pikkukuva(pdf);
+
+    if( !tallennaTosite(rahatili, pdf, pikkukuva) )
+        return false;
+
+    paivitaSeuraavaLaskunumero();
+    return true;
+}
+
+namespace {
+
+/**
+ * @brief Ryhmälaskun yhden vastaanottajan lasku tulosteineen
+ */
+struct RyhmanLasku
+{
+    LaskuModel* lasku = nullptr;
+    bool pikkukuvalla = true;
+
+    // Pääsäikeessä haetut tiedot, jottei taustasäikeissä lueta kirjanpitoa
+    QSharedPointer<const LaskuPohja> pohja;
+    QString iban;
+    QDate paivamaara;
+
+    QByteArray pdf;
+    QByteArray pikkukuva;
+};
+
+void tulostaRyhmanLasku(RyhmanLasku& tulostettava)
+{
+    LaskunTulostaja tulostaja( tulostettava.lasku, tulostettava.pohja, tulostettava.iban, tulostettava.paivamaara );
+    tulostettava.pdf = tulostaja.pdf();
+    if( tulostettava.pikkukuvalla )
+        tulostettava.pikkukuva = LiiteModel::pikkukuva( tulostettava.pdf );
+}
+
+}
+
+bool LaskuModel::tallennaRyhma(Tili rahatili)
+{
+    const int laskuja = ryhmaModel()->rowCount(QModelIndex());
+    bool pikkukuvat = !kp()->settings()->value("PopplerPois").toBool();
+    QSharedPointer<const LaskuPohja> pohja = LaskunTulostaja::pohja();
+    QString iban = LaskunTulostaja::laskunIban();
+    QDate paivamaara = kp()->paivamaara();
+
+    QList<RyhmanLasku> laskut;
+    for(int i=0; i < laskuja; i++)
+    {
+        RyhmanLasku uusi;
+        uusi.lasku = ryhmanLasku(i);
+        uusi.pikkukuvalla = pikkukuvat;
+        uusi.pohja = pohja;
+        uusi.iban = iban;
+        uusi.paivamaara = paivamaara;
+        laskut.append( uusi );
+    }
+
+    QProgressDialog odota(tr("Tallennetaan laskuja"), tr("Peruuta"), 0, 2 * laskuja);
+    odota.setWindowModality(Qt::ApplicationModal);
+    odota.setMinimumDuration(0);
+
+    // Tulostetaan laskut rinnakkain. Tietokantaa käytetään vain tästä säikeestä.
+    QFutureWatcher<void> vahti;
+    QEventLoop silmukka;
+    connect( &vahti, &QFutureWatcher<void>::progressValueChanged, &odota, &QProgressDialog::setValue);
+    connect( &odota, &QProgressDialog::canceled, &vahti, &QFutureWatcher<void>::cancel);
+    connect( &vahti, &QFutureWatcher<void>::finished, &silmukka, &QEventLoop::quit);
+    vahti.setFuture( QtConcurrent::map(laskut, &tulostaRyhmanLasku) );
+    if( !vahti.isFinished())
+        silmukka.exec();
+    vahti.waitForFinished();
+
+    bool onni = !vahti.isCanceled() && !odota.wasCanceled();
+
+    if( onni )
     {
-        bool onni = true;
-        tyyppi_ = LASKU;
-        for(int i=0; i < ryhmaModel()->rowCount(QModelIndex()); i++)
+        // Kaikki tositteet tallennetaan yhdessä transaktiossa
+        kp()->tietokanta()->transaction();
+        for(int i=0; i < laskut.count() && onni; i++)
         {
-            haeRyhmasta(i);
-            if( !tallenna(rahatili) )
+            onni = laskut.at(i).lasku->tallennaTosite(rahatili, laskut.at(i).pdf, laskut.at(i).pikkukuva, false);
+            odota.setValue( laskuja + i + 1);
+            if( odota.wasCanceled())
                 onni = false;
         }
-        tyyppi_ = RYHMALASKU;
-        return onni;
+
+        if( onni && kp()->tietokanta()->commit())
+        {
+            emit kp()->kirjanpitoaMuokattu();
+            for( const RyhmanLasku& tallennettu : laskut)
+                tallennettu.lasku->paivitaSeuraavaLaskunumero();
+        }
+        else
+        {
+            kp()->tietokanta()->rollback();
+            onni = false;
+        }
     }
 
+    for( const RyhmanLasku& tallennettu : laskut)
+        delete tallennettu.lasku;
+
+    return onni;
+}
+
+bool LaskuModel::tallennaTosite(Tili rahatili, const QByteArray &pdf, const QByteArray &pikkukuva, bool omaTransaktio)
+{
     // Ensin tehdään tosite
     TositeModel tosite( kp()->tietokanta() );
 
@@ -703,12 +794,8 @@ bool LaskuModel::tallenna(Tili rahatili)
     }
 
     // Tallennetaan liite
-    // Luo tilapäisen pdf-tiedoston
-
     QString liiteOtsikko = tr("Lasku nr %1").arg(laskunro());
-    LaskunTulostaja tulostaja(this);
-
-    int liitenro = tosite.liiteModel()->lisaaLiite( tulostaja.pdf(), liiteOtsikko );
+    int liitenro = tosite.liiteModel()->lisaaLiite( pdf, liiteOtsikko, pikkukuva );
 
 
     // #96 Laskun kirjaaminen yhdistelmäriveillä
@@ -917,17 +1004,34 @@ bool LaskuModel::tallenna(Tili rahatili)
 
 
     viennit->lisaaVienti(raharivi);
-    if( !tosite.tallenna() )
-    {
-        return false;
-    }
+    return tosite.tallenna(omaTransaktio);
+}
+
+void LaskuModel::paivitaSeuraavaLaskunumero()
+{
     // Laskunumeroinnin korjaus ryhmälaskuja tallennettaessa #351
     if( laskunro() == kp()->asetukset()->isoluku("LaskuSeuraavaId"))
         kp()->asetukset()->aseta("LaskuSeuraavaId",  (laskunro() / 10 + 1) * 10 + laskeViiteTarkiste( laskunro() / 10 + 1));
     else if( laskunro() > kp()->asetukset()->isoluku("LaskuSeuraavaId"))
         kp()->asetukset()->aseta("LaskuSeuraavaId",  laskunro() );
+}
 
-    return true;
+LaskuModel *LaskuModel::ryhmanLasku(int indeksi) const
+{
+    LaskuModel *lasku = new LaskuModel();
+    lasku->tyyppi_ = LASKU;
+    lasku->rivit_ = rivit_;
+    lasku->erapaiva_ = erapaiva_;
+    lasku->toimituspaiva_ = toimituspaiva_;
+    lasku->lisatieto_ = lisatieto_;
+    lasku->kirjausperuste_ = kirjausperuste_;
+    lasku->viittausLasku_ = viittausLasku_;
+    lasku->asiakkaanViite_ = asiakkaanViite_;
+    lasku->kieli_ = kieli_;
+    lasku->viivkorko_ = viivkorko_;
+    lasku->tekstit_ = tekstit_;
+    lasku->asetaVastaanottaja( ryhma_->index(indeksi, 0) );
+    return lasku;
 }
 
 unsigned int LaskuModel::laskeViiteTarkiste(qulonglong luvusta)
@@ -184,6 +184,11 @@ public:
      * @return
      */
     QList<AlvErittelyRivi> alverittely() const;
+    /**
+     * @brief Laskun arvonlisäveroerittely lukematta asetuksia
+     * @param alvVelvollinen Jos ei alv-velvollinen, erittely on tyhjä
+     */
+    QList<AlvErittelyRivi> alverittely(bool alvVelvollinen) const;
 
     LaskuRyhmaModel* ryhmaModel() { return ryhma_;}
 
@@ -260,6 +265,34 @@ protected:
     void haeAvoinSaldo();
     void ilmoitaMuokattu(bool onkoMuokattu=true);
 
+    /**
+     * @brief Tallentaa ryhmälaskun kaikki laskut
+     *
+     * Laskujen pdf:t muodostetaan rinnakkain säikeissä, ja tositteet
+     * tallennetaan yhdessä transaktiossa, joten keskeytetystä ajosta ei jää
+     * kirjanpitoon osittaista ryhmää.
+     */
+    bool tallennaRyhma(Tili rahatili);
+    /**
+     * @brief Tallentaa laskun tositteen
+     * @param pdf Laskun pdf-tuloste
+     * @param pikkukuva Liitteen pikkukuva
+     * @param omaTransaktio Epätosi, jos tallennetaan osana ryhmää
+     */
+    bool tallennaTosite(Tili rahatili, const QByteArray& pdf, const QByteArray& pikkukuva, bool omaTransaktio = true);
+    /**
+     * @brief Siirtää seuraavan laskunumeron tämän laskun jälkeiseksi #351
+     */
+    void paivitaSeuraavaLaskunumero();
+    /**
+     * @brief Luo ryhmän yhdelle vastaanottajalle oman laskun
+     *
+     * Jokaisella vastaanottajalla on oma kopio, jotta laskut voidaan
+     * tulostaa säikeissä samanaikaisesti.
+     */
+    LaskuModel* ryhmanLasku(int indeksi) const;
+    void asetaVastaanottaja(const QModelIndex& ind);
+
 private:
     QList<LaskuRivi> rivit_;
     QDate erapaiva_;
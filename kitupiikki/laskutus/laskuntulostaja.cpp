@@ -32,10 +32,78 @@
 #include "erittelyruudukko.h"
 
 
-LaskunTulostaja::LaskunTulostaja(LaskuModel *model) : QObject(model), model_(model)
+LaskunTulostaja::LaskunTulostaja(LaskuModel *model) : QObject(model), iban( laskunIban() ), model_(model), pohja_( pohja() ),
+    paivamaara_( kp()->paivamaara() )
 {
-    // Hakee laskulle tulostuvan IBAN-numeron
-    iban = kp()->tilit()->tiliNumerolla( kp()->asetukset()->luku("LaskuTili")).json()->str("IBAN");
+
+}
+
+LaskunTulostaja::LaskunTulostaja(LaskuModel *model, QSharedPointer<const LaskuPohja> pohja, const QString &ibanNumero, const QDate &paivamaara) :
+    iban( ibanNumero ), model_(model), pohja_( pohja ), paivamaara_( paivamaara )
+{
+
+}
+
+QString LaskunTulostaja::laskunIban()
+{
+    return kp()->tilit()->tiliNumerolla( kp()->asetukset()->luku("LaskuTili")).json()->str("IBAN");
+}
+
+QSharedPointer<const LaskuPohja> LaskunTulostaja::pohja()
+{
+    static QSharedPointer<const LaskuPohja> valmis;
+    static QString valmiinTunniste;
+
+    const AsetusModel *asetukset = kp()->asetukset();
+    QString tunniste = QString("%1 %2 %3").arg( kp()->tiedostopolku() )
+                                          .arg( asetukset->versio() )
+                                          .arg( kp()->logo().cacheKey() );
+    if( valmis.isNull() || tunniste != valmiinTunniste)
+    {
+        valmis = koostaPohja();
+        valmiinTunniste = tunniste;
+    }
+    return valmis;
+}
+
+QSharedPointer<const LaskuPohja> LaskunTulostaja::koostaPohja()
+{
+    const AsetusModel *asetukset = kp()->asetukset();
+    LaskuPohja *pohja = new LaskuPohja;
+
+    QFile tiedosto(":/lasku/laskutekstit.txt");
+    tiedosto.open(QIODevice::ReadOnly);
+    pohja->tekstit = LaskuPohja::lueTekstit( &tiedosto, asetukset->lista("LaskuTekstit"));
+
+    pohja->logo = LaskuPohja::skaalaaLogo( kp()->logo() );
+    pohja->viivakoodifontti = QFont("code128_XL", 36);
+    pohja->viivakoodifontti.setLetterSpacing(QFont::AbsoluteSpacing, 0.0);
+
+    pohja->nimi = asetukset->asetus("Nimi");
+    pohja->laskuttaja = asetukset->asetus("LaskuAputoiminimi").isEmpty() ? pohja->nimi : asetukset->asetus("LaskuAputoiminimi");
+    pohja->osoite = asetukset->asetus("Osoite");
+    pohja->sahkoposti = asetukset->asetus("Sahkoposti");
+    pohja->puhelin = asetukset->asetus("Puhelin");
+    pohja->ytunnus = asetukset->asetus("Ytunnus");
+    pohja->huomautusaika = asetukset->asetus("LaskuHuomautusaika");
+
+    pohja->harjoitus = asetukset->onko("Harjoitus") && !asetukset->onko("Demo");
+    pohja->logossaNimi = asetukset->onko("LogossaNimi");
+    pohja->alv = asetukset->onko("AlvVelvollinen");
+    pohja->rf = asetukset->onko("LaskuRF");
+    pohja->eiTilisiirtoa = asetukset->onko("LaskuEiTilisiirto");
+    pohja->eiViivakoodia = asetukset->onko("LaskuEiViivakoodi");
+    pohja->eiQR = asetukset->onko("LaskuEiQR");
+    pohja->lyhyetRivit = asetukset->onko("LaskuLyhyetRivit");
+
+    pohja->ikkuna = asetukset->onko("LaskuIkkuna");
+    pohja->ikkunaX = asetukset->luku("LaskuIkkunaX", 0);
+    pohja->ikkunaY = asetukset->luku("LaskuIkkunaY", 0);
+    pohja->ikkunaLeveys = asetukset->luku("LaskuIkkunaLeveys", 90);
+    pohja->ikkunaKorkeus = asetukset->luku("LaskuIkkunaKorkeus", 30);
+    pohja->isoIkkuna = asetukset->luku("LaskuIkkunaKorkeus", 35) > 55;
+
+    return QSharedPointer<const LaskuPohja>( pohja );
 }
 
 bool LaskunTulostaja::tulosta(QPagedPaintDevice *printer, QPainter *painter, bool kaytaIkkunakuorta)
@@ -43,7 +111,7 @@ bool LaskunTulostaja::tulosta(QPagedPaintDevice *printer, QPainter *painter, boo
     double mm = printer->width() * 1.00 / printer->widthMM();
     qreal marginaali = 0.0;
 
-    if( kp()->asetukset()->onko("Harjoitus") && !kp()->asetukset()->onko("Demo") )
+    if( pohja_->harjoitus )
     {
         painter->save();
         painter->setPen( QPen(Qt::green));
@@ -52,7 +120,7 @@ bool LaskunTulostaja::tulosta(QPagedPaintDevice *printer, QPainter *painter, boo
         painter->restore();
     }
 
-    if( model_->laskunSumma() > 0 && model_->kirjausperuste() != LaskuModel::KATEISLASKU && !kp()->asetukset()->onko("LaskuEiTilisiirto"))
+    if( model_->laskunSumma() > 0 && model_->kirjausperuste() != LaskuModel::KATEISLASKU && !pohja_->eiTilisiirtoa)
     {
         painter->translate( 0, painter->window().height() - mm * 95 );
         marginaali += alatunniste(printer, painter) + mm * 95;
@@ -119,7 +187,7 @@ QString LaskunTulostaja::html()
     QString osoite = model_->osoite();
     osoite.replace("\n","<br/>");
 
-    QString omaosoite = kp()->asetukset()->asetus("Osoite");
+    QString omaosoite = pohja_->osoite;
     omaosoite.replace("\n","<br>");
 
     QString otsikko = t("laskuotsikko");
@@ -130,18 +198,18 @@ QString LaskunTulostaja::html()
     else if(model_->kirjausperuste() == LaskuModel::KATEISLASKU)
         otsikko = tr("Kuitti");
 
-    if( kp()->asetukset()->onko("Harjoitus") && !kp()->asetukset()->onko("Demo") )
+    if( pohja_->harjoitus )
     {
         otsikko = QString("<p style='text-align:right;'><span style='color: green;'>HARJOITUS</span></p>") + otsikko;
     }
 
-    txt.append(tr("<tr><td width=50% style=\"border-bottom: 1px solid black;\">%1<br>%2</td><td colspan=2 style='font-size: large; border-bottom: 1px solid black;'>%3</td></tr>\n").arg(kp()->asetukset()->asetus("Nimi")).arg(omaosoite).arg(otsikko) );
+    txt.append(tr("<tr><td width=50% style=\"border-bottom: 1px solid black;\">%1<br>%2</td><td colspan=2 style='font-size: large; border-bottom: 1px solid black;'>%3</td></tr>\n").arg(pohja_->nimi).arg(omaosoite).arg(otsikko) );
     txt.append(QString("<td rowspan=8 style=\"border-bottom: 1px solid black; border-right: 1px solid black;\">%1</td>").arg(osoite));
 
     if( model_->tyyppi() != LaskuModel::HYVITYSLASKU )
-        txt.append(QString("<td width=25% style=\"border-bottom: 1px solid black;\">%2</td><td width=25% style=\"border-bottom: 1px solid black;\">%1</td></tr>\n").arg( kp()->paivamaara().toString("dd.MM.yyyy") ).arg(t("lpvm")));
+        txt.append(QString("<td width=25% style=\"border-bottom: 1px solid black;\">%2</td><td width=25% style=\"border-bottom: 1px solid black;\">%1</td></tr>\n").arg( paivamaara_.toString("dd.MM.yyyy") ).arg(t("lpvm")));
     else
-        txt.append(tr("<td width=25% style=\"border-bottom: 1px solid black;\">%2</td><td width=25% style=\"border-bottom: 1px solid black;\">%1</td></tr>\n").arg( kp()->paivamaara().toString("dd.MM.yyyy") ).arg(t("hyvpvm")));
+        txt.append(tr("<td width=25% style=\"border-bottom: 1px solid black;\">%2</td><td width=25% style=\"border-bottom: 1px solid black;\">%1</td></tr>\n").arg( paivamaara_.toString("dd.MM.yyyy") ).arg(t("hyvpvm")));
 
     if( model_->kirjausperuste() == LaskuModel::HYVITYSLASKU)
         txt.append(tr("<tr><td style=\"border-bottom: 1px solid black;\">%2</td><td style=\"border-bottom: 1px solid black;\">%1</td></tr>\n").arg(model_->laskunro() ).arg(t("hyvnro")));
@@ -180,10 +248,10 @@ QString LaskunTulostaja::html()
 
     txt.append("</table><p>" + lisatieto + "</p>");
 
-    bool alv = kp()->asetukset()->onko("AlvVelvollinen");
+    bool alv = pohja_->alv;
 
 
-    QList<AlvErittelyRivi> alvErittely = model_->alverittely();
+    QList<AlvErittelyRivi> alvErittely = model_->alverittely( pohja_->alv );
 
     ErittelyRuudukko erittely(model_, this);
     txt.append( erittely.html());
@@ -224,12 +292,12 @@ QString LaskunTulostaja::html()
         txt.append(tr("<hr><p>%2 <b>%1</b></p><hr>").arg( virtuaaliviivakoodi()).arg(t("virtviiv")) );
 
     txt.append("<table>");
-    if( kp()->asetukset()->asetus("Ytunnus").length())
-        txt.append(QString("<tr><td>%2 </td><td>%1</td></tr>\n").arg(kp()->asetukset()->asetus("Ytunnus")).arg(t("ytunnus")));
-    if( kp()->asetukset()->asetus("Puhelin").length())
-        txt.append(QString("<tr><td>%2 </td><td>%1</td></tr> \n").arg(kp()->asetukset()->asetus("Puhelin")).arg(t("puhelin")));
-    if( kp()->asetukset()->asetus("Sahkoposti").length())
-        txt.append(QString("<tr><td>%2 </td><td>%1</td></tr> \n").arg(kp()->asetukset()->asetus("Sahkoposti")).arg(t("sahkoposti")));
+    if( pohja_->ytunnus.length())
+        txt.append(QString("<tr><td>%2 </td><td>%1</td></tr>\n").arg(pohja_->ytunnus).arg(t("ytunnus")));
+    if( pohja_->puhelin.length())
+        txt.append(QString("<tr><td>%2 </td><td>%1</td></tr> \n").arg(pohja_->puhelin).arg(t("puhelin")));
+    if( pohja_->sahkoposti.length())
+        txt.append(QString("<tr><td>%2 </td><td>%1</td></tr> \n").arg(pohja_->sahkoposti).arg(t("sahkoposti")));
 
     txt.append("</table></body></html>\n");
 
@@ -241,7 +309,7 @@ QString LaskunTulostaja::virtuaaliviivakoodi() const
     if( model_->laskunSumma() > 99999999 )  // Ylisuuri laskunsumma
         return QString();
 
-    QString koodi = kp()->asetukset()->onko("LaskuRF") ?
+    QString koodi = pohja_->rf ?
          QString("5 %1 %2 %3 %4 %5")
                 .arg(iban.mid(2,16))    // Numeerinen tilinumero
                 .arg(model_->laskunSumma(), 8, 10, QChar('0'))
@@ -272,7 +340,7 @@ QString LaskunTulostaja::valeilla(const QString &teksti)
 
 QString LaskunTulostaja::muotoiltuViite() const
 {
-    if( kp()->asetukset()->onko("LaskuRF"))
+    if( pohja_->rf )
     {
         QString rf= "RF00" + model_->viitenumero();
         int tarkiste = 98 - IbanValidator::ibanModulo( rf );
@@ -329,10 +397,10 @@ void LaskunTulostaja::ylaruudukko(QPagedPaintDevice *printer, QPainter *painter,
     QRectF ikkuna;
     double keskiviiva = leveys / 2;
 
-    if( kp()->asetukset()->onko("LaskuIkkuna") && kaytaIkkunakuorta)
-        ikkuna = QRectF( (kp()->asetukset()->luku("LaskuIkkunaX", 0) - printer->pageLayout().margins(QPageLayout::Millimeter).left()  ) * mm,
-                       (kp()->asetukset()->luku("LaskuIkkunaY",0) - printer->pageLayout().margins(QPageLayout::Millimeter).top()) * mm,
-                       kp()->asetukset()->luku("LaskuIkkunaLeveys",90) * mm, kp()->asetukset()->luku("LaskuIkkunaKorkeus",30) * mm);
+    if( pohja_->ikkuna && kaytaIkkunakuorta)
+        ikkuna = QRectF( (pohja_->ikkunaX - printer->pageLayout().margins(QPageLayout::Millimeter).left()  ) * mm,
+                       (pohja_->ikkunaY - printer->pageLayout().margins(QPageLayout::Millimeter).top()) * mm,
+                       pohja_->ikkunaLeveys * mm, pohja_->ikkunaKorkeus * mm);
     else
         ikkuna = QRectF( 0, rk * 3, keskiviiva, rk * 3);
 
@@ -346,7 +414,7 @@ void LaskunTulostaja::ylaruudukko(QPagedPaintDevice *printer, QPainter *painter,
     QRectF lahettajaAlue = QRectF( 0, 0, keskiviiva, rk * 2.2);
 
     // Jos käytössä on isoikkunakuori, tulostetaan myös lähettäjän nimi ja osoite sinne
-    if( kp()->asetukset()->luku("LaskuIkkunaKorkeus", 35) > 55 )
+    if( pohja_->isoIkkuna )
     {
         lahettajaAlue = QRectF( ikkuna.x(), ikkuna.y(), ikkuna.width(), 30 * mm);
         ikkuna = QRectF( ikkuna.x(), ikkuna.y() + 30 * mm, ikkuna.width(), ikkuna.height() - 30 * mm);
@@ -356,26 +424,26 @@ void LaskunTulostaja::ylaruudukko(QPagedPaintDevice *printer, QPainter *painter,
     // Lähettäjätiedot
 
     double vasen = 0.0;
-    if( !kp()->logo().isNull() )
+    if( !pohja_->logo.isNull() )
     {
-        double logosuhde = (1.0 * kp()->logo().width() ) / kp()->logo().height();
+        double logosuhde = (1.0 * pohja_->logo.width() ) / pohja_->logo.height();
         double skaala = logosuhde < 5.00 ? logosuhde : 5.00;    // Logon sallittu suhde enintään 5:1
 
-        painter->drawImage( QRectF( lahettajaAlue.x()+mm, lahettajaAlue.y()+mm, rk*2*skaala, rk*2 ),  kp()->logo()  );
+        painter->drawImage( QRectF( lahettajaAlue.x()+mm, lahettajaAlue.y()+mm, rk*2*skaala, rk*2 ),  pohja_->logo  );
         vasen += rk * 2.2 * skaala;
 
     }
     painter->setFont(QFont("Sans",14));
     double pv = painter->fontMetrics().height();    
-    QString nimi = kp()->asetukset()->onko("LogossaNimi") ? QString() : ( kp()->asetukset()->asetus("LaskuAputoiminimi").isEmpty() ? kp()->asetukset()->asetus("Nimi") : kp()->asetukset()->asetus("LaskuAputoiminimi") );   // Jos nimi logossa, sitä ei toisteta
+    QString nimi = pohja_->logossaNimi ? QString() : pohja_->laskuttaja;   // Jos nimi logossa, sitä ei toisteta
     QRectF lahettajaRect = painter->boundingRect( QRectF( lahettajaAlue.x()+vasen, lahettajaAlue.y(),
                                                        lahettajaAlue.width()-vasen, 20 * mm), Qt::TextWordWrap, nimi );
     painter->drawText(QRectF( lahettajaRect), Qt::AlignLeft | Qt::TextWordWrap, nimi);
 
     painter->setFont(QFont("Sans",9));
     QRectF lahettajaosoiteRect = painter->boundingRect( QRectF( lahettajaAlue.x()+vasen, lahettajaAlue.y() + lahettajaRect.height(),
-                                                       lahettajaAlue.width()-vasen, 20 * mm), Qt::TextWordWrap, kp()->asetus("Osoite") );
-    painter->drawText(lahettajaosoiteRect, Qt::AlignLeft, kp()->asetus("Osoite") );
+                                                       lahettajaAlue.width()-vasen, 20 * mm), Qt::TextWordWrap, pohja_->osoite );
+    painter->drawText(lahettajaosoiteRect, Qt::AlignLeft, pohja_->osoite );
 
     // Tulostetaan saajan osoite ikkunaan
     painter->setFont(QFont("Sans", TEKSTIPT));
@@ -439,7 +507,7 @@ void LaskunTulostaja::ylaruudukko(QPagedPaintDevice *printer, QPainter *painter,
 
     painter->setFont(QFont("Sans", TEKSTIPT));
 
-    painter->drawText(QRectF( keskiviiva + mm, pv - rk, leveys / 4, rk-mm ), Qt::AlignBottom, kp()->paivamaara().toString("dd.MM.yyyy") );
+    painter->drawText(QRectF( keskiviiva + mm, pv - rk, leveys / 4, rk-mm ), Qt::AlignBottom, paivamaara_.toString("dd.MM.yyyy") );
     painter->drawText(QRectF( keskiviiva + mm, pv + mm, leveys / 4, rk-mm ), Qt::AlignBottom,  model_->toimituspaiva().toString("dd.MM.yyyy") );
     painter->drawText(QRectF( puoliviiva + mm, pv - rk, leveys / 2, rk-mm ), Qt::AlignBottom, QString::number(model_->laskunro()) );
 
@@ -472,7 +540,7 @@ void LaskunTulostaja::ylaruudukko(QPagedPaintDevice *printer, QPainter *painter,
             painter->drawText(QRectF( puoliviiva + mm, pv + rk, (leveys-keskiviiva) / 2, rk-mm ), Qt::AlignBottom,  QString("%L1 %").arg(model_->viivastysKorko(),0,'f',1) );
         }
     }
-    painter->drawText(QRectF( keskiviiva + mm, pv + rk, (leveys-keskiviiva) / 2, rk-mm ), Qt::AlignBottom,  kp()->asetus("LaskuHuomautusaika") );
+    painter->drawText(QRectF( keskiviiva + mm, pv + rk, (leveys-keskiviiva) / 2, rk-mm ), Qt::AlignBottom,  pohja_->huomautusaika );
 
     painter->drawText(QRectF( keskiviiva + mm, pv + rk * 2, (leveys-keskiviiva) / 2, rk-mm ), Qt::AlignBottom,  model_->asiakkaanViite() );
 
@@ -551,23 +619,23 @@ qreal LaskunTulostaja::alatunniste(QPagedPaintDevice *printer, QPainter *painter
 
     painter->translate(0, 2.1 * rk );
     painter->setFont(QFont("Sans",8));
-    painter->drawText(QRectF(0,0,leveys/5*2,rk), Qt::AlignLeft, kp()->asetukset()->asetus("Nimi")  );
-    painter->drawText(QRectF(0, painter->fontMetrics().height(),leveys/5*2,rk), Qt::AlignLeft, kp()->asetukset()->asetus("Sahkoposti")  );
+    painter->drawText(QRectF(0,0,leveys/5*2,rk), Qt::AlignLeft, pohja_->nimi  );
+    painter->drawText(QRectF(0, painter->fontMetrics().height(),leveys/5*2,rk), Qt::AlignLeft, pohja_->sahkoposti  );
 
-    if( !kp()->asetukset()->asetus("Puhelin").isEmpty() )
+    if( !pohja_->puhelin.isEmpty() )
     {
         painter->drawText(QRectF(leveys/5*2,0,leveys/5,rk), Qt::AlignLeft, t("puhelin"));
-        painter->drawText(QRectF(leveys/5*2, painter->fontMetrics().height() ,leveys/5,rk), Qt::AlignLeft, kp()->asetus("Puhelin"));
+        painter->drawText(QRectF(leveys/5*2, painter->fontMetrics().height() ,leveys/5,rk), Qt::AlignLeft, pohja_->puhelin);
     }
 
-    QString ytunnus = kp()->asetukset()->asetus("Ytunnus");
+    const QString& ytunnus = pohja_->ytunnus;
 
     if( !ytunnus.isEmpty() )
     {
         painter->drawText(QRectF(leveys/5*3,0,leveys/5,rk), Qt::AlignLeft, t("ytunnus"));
         painter->drawText(QRectF(leveys/5*3, painter->fontMetrics().height() ,leveys/5,rk), Qt::AlignLeft, ytunnus);
     }
-    if( kp()->asetukset()->onko("AlvVelvollinen"))
+    if( pohja_->alv )
     {
         painter->drawText(QRectF(leveys/5*4,0,leveys/5,rk), Qt::AlignLeft, t("alvtunnus"));
         painter->drawText(QRectF(leveys*4/5,painter->fontMetrics().height(),leveys/5,rk), Qt::AlignLeft,  "FI"+ytunnus.left(7)+ytunnus.right(1) );
@@ -577,11 +645,9 @@ qreal LaskunTulostaja::alatunniste(QPagedPaintDevice *printer, QPainter *painter
 
 
     // Viivakoodi
-    if( !kp()->asetukset()->onko("LaskuEiViivakoodi") && kp()->asetukset()->onko("LaskuEiTilisiirto") && model_->laskunSumma() > 0 && model_->kirjausperuste() != LaskuModel::KATEISLASKU)
+    if( !pohja_->eiViivakoodia && pohja_->eiTilisiirtoa && model_->laskunSumma() > 0 && model_->kirjausperuste() != LaskuModel::KATEISLASKU)
     {
-        QFont koodifontti( "code128_XL", 36);
-        koodifontti.setLetterSpacing(QFont::AbsoluteSpacing, 0.0);
-        painter->setFont( koodifontti);
+        painter->setFont( pohja_->viivakoodifontti );
         QString koodi( code128() );
         painter->drawText( QRectF( mm*20, -2.2*rk-mm*15, mm*100, mm*10), Qt::AlignCenter, koodi  );
 
@@ -604,7 +670,7 @@ void LaskunTulostaja::erittely(LaskuModel *model, QPagedPaintDevice *printer, QP
     qreal leveys = painter->window().width();
     double mm = printer->width() * 1.00 / printer->widthMM();
 
-    QList<AlvErittelyRivi> alvLista = model->alverittely();
+    QList<AlvErittelyRivi> alvLista = model->alverittely( pohja_->alv );
 
 
     // Tarvittaessa vaihdetaan sivua
@@ -612,12 +678,12 @@ void LaskunTulostaja::erittely(LaskuModel *model, QPagedPaintDevice *printer, QP
     {
         printer->newPage();
         painter->resetTransform();
-        painter->drawText( QRectF(0,0,leveys/2,rk), Qt::AlignLeft, kp()->asetukset()->asetus("LaskuAputoiminimi").isEmpty() ? kp()->asetukset()->asetus("Nimi") : kp()->asetukset()->asetus("LaskuAputoiminimi"));
-        painter->drawText( QRectF(leveys/2,0,leveys/2, rk), Qt::AlignRight, kp()->paivamaara().toString("dd.MM.yyyy"));
+        painter->drawText( QRectF(0,0,leveys/2,rk), Qt::AlignLeft, pohja_->laskuttaja);
+        painter->drawText( QRectF(leveys/2,0,leveys/2, rk), Qt::AlignRight, paivamaara_.toString("dd.MM.yyyy"));
         painter->translate(0, rk*2);
     }
 
-    bool alv = kp()->asetukset()->onko("AlvVelvollinen");
+    bool alv = pohja_->alv;
     if( model->tyyppi() != LaskuModel::MAKSUMUISTUTUS && !alvLista.isEmpty())
     {
         painter->translate( 0, rk * 0.5);
@@ -703,11 +769,10 @@ void LaskunTulostaja::erittelyOtsikko(QPagedPaintDevice *printer, QPainter *pain
 
 void LaskunTulostaja::tilisiirto(QPagedPaintDevice *printer, QPainter *painter)
 {
-    painter->setFont(QFont("Sans", 7));
     double mm = printer->width() * 1.00 / printer->widthMM();
 
     // QR-koodi
-    if( !kp()->asetukset()->onko("LaskuEiQR"))
+    if( !pohja_->eiQR)
     {
         QByteArray qrTieto = qrSvg();
         if( !qrTieto.isEmpty())
@@ -717,37 +782,7 @@ void LaskunTulostaja::tilisiirto(QPagedPaintDevice *printer, QPainter *painter)
         }
     }
 
-    painter->drawText( QRectF(0,0,mm*19,mm*16.9), Qt::AlignRight | Qt::AlignHCenter, t("bst"));
-    painter->drawText( QRectF(0, mm*18, mm*19, mm*14.8), Qt::AlignRight | Qt::AlignHCenter, t("bsa"));
-    painter->drawText( QRectF(0, mm*32.7, mm*19, mm*20), Qt::AlignRight | Qt::AlignTop, t("bmo"));
-    painter->drawText( QRectF(0, mm*51.3, mm*19, mm*10), Qt::AlignRight | Qt::AlignBottom , t("bak"));
-    painter->drawText( QRectF(0, mm*62.3, mm*19, mm*8.5), Qt::AlignRight | Qt::AlignHCenter, t("btl"));
-    painter->drawText( QRectF(mm * 22, 0, mm*20, mm*10), Qt::AlignLeft, t("iban"));
-
-    painter->drawText( QRectF(mm*112.4, mm*53.8, mm*15, mm*8.5), Qt::AlignLeft | Qt::AlignTop, t("bvn"));
-    painter->drawText( QRectF(mm*112.4, mm*62.3, mm*15, mm*8.5), Qt::AlignLeft | Qt::AlignTop, t("bep"));
-    painter->drawText( QRectF(mm*159, mm*62.3, mm*19, mm*8.5), Qt::AlignLeft, t("eur"));
-
-
-    painter->setFont(QFont("Sans",6));
-    painter->drawText( QRectF( mm * 140, mm * 72, mm * 60, mm * 20), Qt::AlignLeft | Qt::TextWordWrap, t("behto") );
-    painter->setPen( QPen( QBrush(Qt::black), mm * 0.5));
-    painter->drawLine(QLineF(mm*111.4,0,mm*111.4,mm*69.8));
-    painter->drawLine(QLineF(0, mm*16.9, mm*111.4, mm*16.9));
-    painter->drawLine(QLineF(0, mm*31.7, mm*111.4, mm*31.7));
-    painter->drawLine(QLineF(mm*20, 0, mm*20, mm*31.7));
-    painter->drawLine(QLineF(0, mm*61.3, mm*200, mm*61.3));
-    painter->drawLine(QLineF(0, mm*69.8, mm*200, mm*69.8));
-    painter->drawLine(QLineF(mm*111.4, mm*52.8, mm*200, mm*52.8));
-    painter->drawLine(QLineF(mm*131.4, mm*52.8, mm*131.4, mm*69.8));
-    painter->drawLine(QLineF(mm*158, mm*61.3, mm*158, mm*69.8));
-    painter->drawLine(QLineF(mm*20, mm*61.3, mm*20, mm*69.8));
-
-    painter->setPen( QPen(QBrush(Qt::black), mm * 0.13));
-    painter->drawLine( QLineF( mm*22, mm*57.1, mm*108, mm*57.1));
-
-    painter->setPen( QPen(QBrush(Qt::black), mm * 0.13, Qt::DashLine));
-    painter->drawLine( QLineF( 0, -1 * mm, painter->window().width(), -1 * mm));
+    pohja_->tilisiirtolomake(painter, mm, model_->kieli());
 
     painter->setFont(QFont("Sans", 10));
 
@@ -758,28 +793,15 @@ void LaskunTulostaja::tilisiirto(QPagedPaintDevice *printer, QPainter *painter)
     painter->drawText( QRectF(mm*133.4, mm*62.3, mm*30, mm*7.5), Qt::AlignLeft | Qt::AlignBottom, model_->erapaiva().toString("dd.MM.yyyy") );
     painter->drawText( QRectF(mm*165, mm*62.3, mm*30, mm*7.5), Qt::AlignRight | Qt::AlignBottom, QString("%L1").arg( (model_->laskunSumma() / 100.0) ,0,'f',2) );
 
-    painter->drawText( QRectF(mm*22, mm*17, mm*90, mm*13), Qt::AlignTop | Qt::TextWordWrap, kp()->asetus("Nimi") + "\n" + kp()->asetus("Osoite")  );
     painter->drawText( QRectF(mm*22, 0, mm*90, mm*17), Qt::AlignVCenter ,  valeilla( iban )  );
 
-
-    painter->save();
-    painter->setFont(QFont("Sans", 7));
-    painter->translate(mm * 2, mm* 60);
-    painter->rotate(-90.0);
-    painter->drawText(0,0,t("btilis"));
-    painter->restore();
-
     // Viivakoodi
-    if( !kp()->asetukset()->onko("LaskuEiViivakoodi"))
+    if( !pohja_->eiViivakoodia)
     {
         painter->save();
-
-        QFont koodifontti( "code128_XL", 36);
-        koodifontti.setLetterSpacing(QFont::AbsoluteSpacing, 0.0);
-        painter->setFont( koodifontti);
+        painter->setFont( pohja_->viivakoodifontti );
         QString koodi( code128() );
         painter->drawText( QRectF( mm*20, mm*72, mm*100, mm*13), Qt::AlignCenter, koodi  );
-
         painter->restore();
     }
 }
@@ -827,7 +849,7 @@ QByteArray LaskunTulostaja::qrSvg() const
     if( bic.isEmpty())
         return QByteArray();
     data.append(bic + "\n");
-    data.append(kp()->asetukset()->asetus("Nimi") + "\n");
+    data.append(pohja_->nimi + "\n");
     data.append(iban + "\n");
     data.append( QString("EUR%1.%2\n\n").arg( model_->laskunSumma() / 100 ).arg( model_->laskunSumma() % 100, 2, 10, QChar('0') ));
     data.append(muotoiltuViite().remove(QChar(' ')) + "\n\n");
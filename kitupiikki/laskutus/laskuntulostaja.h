@@ -23,8 +23,10 @@
 #include <QPrinter>
 #include <QFile>
 #include <QMap>
+#include <QSharedPointer>
 
 #include "laskumodel.h"
+#include "laskupohja.h"
 
 /**
  * @brief Laskuntulostajan alv-erittelyä varten
@@ -48,6 +50,18 @@ class LaskunTulostaja : public QObject
 public:
     explicit LaskunTulostaja(LaskuModel *model);
 
+    /**
+     * @brief Tulostaja, joka ei itse lue kirjanpitoa eikä asetuksia
+     *
+     * Pohja, IBAN ja päivämäärä haetaan etukäteen pääsäikeessä, joten
+     * tällä tulostajalla ryhmälaskuja voi tulostaa taustasäikeissä.
+     * Tulostajalla ei ole vanhempaa, koska malli kuuluu pääsäikeelle.
+     * Maksumuistutuksia ei voi tulostaa näin, koska niihin haetaan
+     * alkuperäinen lasku tietokannasta.
+     */
+    LaskunTulostaja(LaskuModel *model, QSharedPointer<const LaskuPohja> pohja,
+                    const QString& ibanNumero, const QDate& paivamaara);
+
 signals:
 
 public slots:
@@ -82,6 +96,31 @@ public:
 
     QString veroteksti(int verokoodi) const;
 
+    /**
+     * @brief Laskupohja nykyisillä asetuksilla
+     *
+     * Pohja kootaan uudelleen vain, kun kirjanpito, asetukset tai logo vaihtuvat.
+     * Lukee kirjanpitoa ja asetuksia, joten kutsutaan vain pääsäikeestä.
+     * Valmista pohjaa voi käyttää taustasäikeissä, ks. tallennaRyhma().
+     */
+    static QSharedPointer<const LaskuPohja> pohja();
+
+    /**
+     * @brief Kokoaa uuden laskupohjan ohi välimuistin
+     *
+     * Lukee tekstiluettelon ja asetukset ja skaalaa logon joka kutsulla.
+     * Kutsutaan vain pääsäikeestä.
+     */
+    static QSharedPointer<const LaskuPohja> koostaPohja();
+
+    /**
+     * @brief Laskulle tulostuva IBAN-numero
+     */
+    static QString laskunIban();
+
+    const LaskuPohja& laskupohja() const { return *pohja_; }
+    QDate paivamaara() const { return paivamaara_; }
+
 protected:
     void ylaruudukko(QPagedPaintDevice *printer, QPainter *painter, bool kaytaIkkunakuorta = true);
     qreal alatunniste(QPagedPaintDevice *printer, QPainter *painter);
@@ -111,6 +150,8 @@ protected:
 
 private:
     LaskuModel *model_;
+    QSharedPointer<const LaskuPohja> pohja_;
+    QDate paivamaara_;
 
 };
 
@@ -0,0 +1,117 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "laskupohja.h"
+
+#include <QIODevice>
+#include <QTextStream>
+#include <QPainter>
+
+QString LaskuPohja::t(const QString &avain, const QString &kieli) const
+{
+    if( tekstit.contains( kieli + avain ))
+        return  tekstit.value( kieli + avain );
+
+    return tekstit.value( avain, avain );
+}
+
+void LaskuPohja::tilisiirtolomake(QPainter *painter, qreal mm, const QString &kieli) const
+{
+    painter->save();
+    painter->setFont(QFont("Sans", 7));
+
+    painter->drawText( QRectF(0,0,mm*19,mm*16.9), Qt::AlignRight | Qt::AlignHCenter, t("bst", kieli));
+    painter->drawText( QRectF(0, mm*18, mm*19, mm*14.8), Qt::AlignRight | Qt::AlignHCenter, t("bsa", kieli));
+    painter->drawText( QRectF(0, mm*32.7, mm*19, mm*20), Qt::AlignRight | Qt::AlignTop, t("bmo", kieli));
+    painter->drawText( QRectF(0, mm*51.3, mm*19, mm*10), Qt::AlignRight | Qt::AlignBottom , t("bak", kieli));
+    painter->drawText( QRectF(0, mm*62.3, mm*19, mm*8.5), Qt::AlignRight | Qt::AlignHCenter, t("btl", kieli));
+    painter->drawText( QRectF(mm * 22, 0, mm*20, mm*10), Qt::AlignLeft, t("iban", kieli));
+
+    painter->drawText( QRectF(mm*112.4, mm*53.8, mm*15, mm*8.5), Qt::AlignLeft | Qt::AlignTop, t("bvn", kieli));
+    painter->drawText( QRectF(mm*112.4, mm*62.3, mm*15, mm*8.5), Qt::AlignLeft | Qt::AlignTop, t("bep", kieli));
+    painter->drawText( QRectF(mm*159, mm*62.3, mm*19, mm*8.5), Qt::AlignLeft, t("eur", kieli));
+
+    painter->setFont(QFont("Sans",6));
+    painter->drawText( QRectF( mm * 140, mm * 72, mm * 60, mm * 20), Qt::AlignLeft | Qt::TextWordWrap, t("behto", kieli) );
+
+    QVector<QLineF> viivat;
+    viivat << QLineF(mm*111.4,0,mm*111.4,mm*69.8)
+           << QLineF(0, mm*16.9, mm*111.4, mm*16.9)
+           << QLineF(0, mm*31.7, mm*111.4, mm*31.7)
+           << QLineF(mm*20, 0, mm*20, mm*31.7)
+           << QLineF(0, mm*61.3, mm*200, mm*61.3)
+           << QLineF(0, mm*69.8, mm*200, mm*69.8)
+           << QLineF(mm*111.4, mm*52.8, mm*200, mm*52.8)
+           << QLineF(mm*131.4, mm*52.8, mm*131.4, mm*69.8)
+           << QLineF(mm*158, mm*61.3, mm*158, mm*69.8)
+           << QLineF(mm*20, mm*61.3, mm*20, mm*69.8);
+    painter->setPen( QPen( QBrush(Qt::black), mm * 0.5));
+    painter->drawLines(viivat);
+
+    painter->setPen( QPen(QBrush(Qt::black), mm * 0.13));
+    painter->drawLine( QLineF( mm*22, mm*57.1, mm*108, mm*57.1));
+
+    painter->setPen( QPen(QBrush(Qt::black), mm * 0.13, Qt::DashLine));
+    painter->drawLine( QLineF( 0, -1 * mm, painter->window().width(), -1 * mm));
+
+    painter->setFont(QFont("Sans", 10));
+    painter->drawText( QRectF(mm*22, mm*17, mm*90, mm*13), Qt::AlignTop | Qt::TextWordWrap, nimi + "\n" + osoite  );
+
+    painter->setFont(QFont("Sans", 7));
+    painter->translate(mm * 2, mm* 60);
+    painter->rotate(-90.0);
+    painter->drawText(0,0,t("btilis", kieli));
+
+    painter->restore();
+}
+
+QMap<QString, QString> LaskuPohja::lueTekstit(QIODevice *laite, const QStringList &muokatut)
+{
+    QMap<QString,QString> tekstit;
+
+    QTextStream in( laite );
+    in.setCodec("utf-8");
+    while( !in.atEnd() )
+    {
+        QString rivi = in.readLine();
+        rivi.replace('|','\n');
+        int valinpaikka = rivi.indexOf(' ');
+        if( valinpaikka )
+            tekstit.insert( rivi.left(valinpaikka), rivi.mid(valinpaikka + 1));
+    }
+
+    // Vielä muokatut asetuksista
+    // Näin voidaan määritellä muokatut tekstit eri kirjanpidoille
+    for( const QString& rivi : muokatut)
+    {
+        int valinpaikka = rivi.indexOf(' ');
+        if( valinpaikka )
+            tekstit[ rivi.left(valinpaikka)] = rivi.mid(valinpaikka + 1);
+    }
+    return tekstit;
+}
+
+QImage LaskuPohja::skaalaaLogo(const QImage &logo)
+{
+    // Logo tulostetaan noin kahden sentin korkuisena, jolloin
+    // 400 pikseliä riittää tarkimpaankin tulostukseen
+    const int KORKEUS = 400;
+
+    if( logo.isNull() || logo.height() <= KORKEUS )
+        return logo;
+    return logo.scaledToHeight( KORKEUS, Qt::SmoothTransformation );
+}
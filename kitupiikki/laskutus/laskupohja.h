@@ -0,0 +1,100 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LASKUPOHJA_H
+#define LASKUPOHJA_H
+
+#include <QMap>
+#include <QImage>
+#include <QFont>
+#include <QStringList>
+
+class QIODevice;
+class QPainter;
+
+/**
+ * @brief Laskun muuttumattomat osat valmiiksi koottuna
+ *
+ * Tekstiluettelo, skaalattu logo, lähettäjän tiedot ja tilisiirtolomakkeen
+ * kiinteät tekstit ja viivat kootaan kerran kirjanpitoa ja asetusten versiota
+ * kohden (LaskunTulostaja::pohja). Laskukohtaisesti tulostetaan vain muuttuvat
+ * kentät, rivit, QR-koodi ja viivakoodi.
+ *
+ * Pohjaa ei muuteta koottaessa, joten sitä voi käyttää useasta säikeestä.
+ */
+struct LaskuPohja
+{
+    LaskuPohja() {}
+
+    QMap<QString,QString> tekstit;
+    QImage logo;
+    QFont viivakoodifontti;
+
+    QString nimi;
+    QString laskuttaja;         /** Aputoiminimi tai nimi */
+    QString osoite;
+    QString sahkoposti;
+    QString puhelin;
+    QString ytunnus;
+    QString huomautusaika;
+
+    bool harjoitus = false;
+    bool logossaNimi = false;
+    bool alv = false;
+    bool rf = false;
+    bool eiTilisiirtoa = false;
+    bool eiViivakoodia = false;
+    bool eiQR = false;
+    bool lyhyetRivit = false;   /** Erittelyssä ei netto- ja verosarakkeita */
+
+    bool ikkuna = false;
+    int ikkunaX = 0;
+    int ikkunaY = 0;
+    int ikkunaLeveys = 90;
+    int ikkunaKorkeus = 30;
+    bool isoIkkuna = false;     /** Lähettäjäkin tulostetaan ikkunaan */
+
+    /**
+     * @brief Teksti annetulla kielellä
+     * @param avain Tekstin hakutunnus
+     * @param kieli Kielen tunnus (FI, SV, EN)
+     */
+    QString t(const QString& avain, const QString& kieli) const;
+
+    /**
+     * @brief Tulostaa tilisiirtolomakkeen kiinteät tekstit ja viivat
+     *
+     * Painterin origo on lomakkeen vasemmassa yläkulmassa
+     */
+    void tilisiirtolomake(QPainter *painter, qreal mm, const QString& kieli) const;
+
+    /**
+     * @brief Lukee tekstiluettelon
+     * @param laite laskutekstit.txt
+     * @param muokatut Kirjanpidon omat tekstit (LaskuTekstit-asetus)
+     */
+    static QMap<QString,QString> lueTekstit(QIODevice *laite, const QStringList& muokatut);
+
+    /**
+     * @brief Pienentää logon tulostettavaan kokoon
+     *
+     * Muuten pdf-tiedostoon pakattaisiin jokaiselle laskulle koko tallennettu kuva
+     */
+    static QImage skaalaaLogo(const QImage& logo);
+};
+
+#endif // LASKUPOHJA_H
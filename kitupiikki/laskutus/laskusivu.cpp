@@ -26,6 +26,7 @@
 #include "lisaikkuna.h"
 #include "naytin/naytinikkuna.h"
 #include "yhteystietowidget.h"
+#include "finvoice.h"
 
 #include <QTabBar>
 #include <QSplitter>
@@ -37,6 +38,10 @@
 #include <QDateEdit>
 #include <QLabel>
 #include <QSqlQuery>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QApplication>
+#include <QDir>
 
 #include <QHeaderView>
 #include <QSortFilterProxyModel>
@@ -73,7 +78,7 @@ LaskuSivu::LaskuSivu()
 
     laskuView_->setModel(laskuViiteProxy_);
     laskuView_->setSelectionBehavior(QTableView::SelectRows);
-    laskuView_->setSelectionMode(QTableView::SingleSelection);
+    laskuView_->setSelectionMode(QTableView::ExtendedSelection);
     laskuView_->setSortingEnabled(true);
     laskuView_->horizontalHeader()->setStretchLastSection(true);
 
@@ -115,6 +120,7 @@ void LaskuSivu::paaTab(int indeksi)
     else if(indeksi != ASIAKAS && lajiTab_->count() == 4)
         lajiTab_->removeTab(TIEDOT);
     uusiAsiakasNappi_->setVisible(indeksi == ASIAKAS);
+    aineistoNappi_->setVisible(indeksi == MYYNTI && kp()->asetukset()->onko("VerkkolaskuKaytossa"));
 
     if( indeksi ==  ASIAKAS)
         asiakasmodel_->paivita(false);
@@ -178,7 +184,11 @@ void LaskuSivu::asiakasValintaMuuttuu()
 
 void LaskuSivu::laskuValintaMuuttuu()
 {
-    if( laskuView_->currentIndex().isValid() )
+    // Toiminnot kohdistuvat nykyiseen laskuun, joten niitä ei tarjota,
+    // kun valittuna on useampi lasku. Aineiston voi muodostaa useammasta.
+    int valittuja = laskuView_->selectionModel()->selectedRows().count();
+
+    if( laskuView_->currentIndex().isValid() && valittuja < 2 )
     {
         QModelIndex index = laskuView_->currentIndex();
         int tosite = index.data(LaskutModel::TositeRooli).toInt();
@@ -208,6 +218,7 @@ void LaskuSivu::laskuValintaMuuttuu()
                                      index.data(LaskutModel::EraPvmRooli).toDate().isValid() );
 
         kopioiNappi_->setEnabled( index.data(LaskutModel::KirjausPerusteRooli).toInt() >= 0 );
+        aineistoNappi_->setEnabled( true );
 
     }
     else
@@ -218,6 +229,7 @@ void LaskuSivu::laskuValintaMuuttuu()
         poistaNappi_->setDisabled(true);
         hyvitysNappi_->setDisabled(true);
         kopioiNappi_->setDisabled(true);
+        aineistoNappi_->setEnabled( valittuja > 1 );
         muistutusNappi_->hide();
     }
 }
@@ -349,6 +361,32 @@ void LaskuSivu::poistaLasku()
     tosite.poista();
 }
 
+void LaskuSivu::verkkolaskuAineisto()
+{
+    QList<int> vientiIdt;
+    for( const QModelIndex& index : laskuView_->selectionModel()->selectedRows())
+    {
+        if( index.data(LaskutModel::KirjausPerusteRooli).toInt() >= 0 &&
+            index.data(LaskutModel::TyyppiRooli).toInt() != LaskuModel::OSTOLASKU)
+            vientiIdt.append( index.data(LaskutModel::VientiIdRooli).toInt() );
+    }
+    if( vientiIdt.isEmpty())
+        return;
+
+    QString tiedosto = QFileDialog::getSaveFileName(this, tr("Tallenna verkkolaskuaineisto"),
+                                                    QDir(kp()->asetukset()->asetus("VerkkolaskuKansio")).absoluteFilePath("finvoice.xml"),
+                                                    tr("Finvoice-aineisto (*.xml)"));
+    if( tiedosto.isEmpty())
+        return;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool onni = Finvoice::muodostaAineisto(vientiIdt, tiedosto);
+    QApplication::restoreOverrideCursor();
+
+    if( !onni )
+        QMessageBox::critical(this, tr("Verkkolaskuaineisto"), tr("Aineiston tallentaminen tiedostoon %1 epäonnistui").arg(tiedosto));
+}
+
 void LaskuSivu::luoUi()
 {
     paaTab_ = new QTabBar();
@@ -435,6 +473,10 @@ void LaskuSivu::luoUi()
     muistutusNappi_ = new QPushButton(QIcon(":/pic/varoitus.png"), tr("Maksumuistutus"));
     connect( muistutusNappi_, &QPushButton::clicked, this, &LaskuSivu::maksumuistutus);
     nappileiska->addWidget(muistutusNappi_);
+    aineistoNappi_ = new QPushButton(QIcon(":/pic/verkkolasku.png"), tr("&Verkkolaskuaineisto"));
+    aineistoNappi_->setToolTip(tr("Valittujen laskujen Finvoice-sanomat yhteen tiedostoon"));
+    connect( aineistoNappi_, &QPushButton::clicked, this, &LaskuSivu::verkkolaskuAineisto);
+    nappileiska->addWidget(aineistoNappi_);
 
     nappileiska->addStretch();
     uusiAsiakasNappi_ = new QPushButton(QIcon(":/pic/yrittaja.png"), tr("Uusi &asiakas"));
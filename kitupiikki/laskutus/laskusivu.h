@@ -77,6 +77,7 @@ public slots:
     void maksumuistutus();
     void ryhmaLasku();
     void poistaLasku();
+    void verkkolaskuAineisto();
 
 private:
     void luoUi();
@@ -109,6 +110,7 @@ private:
     QPushButton* kopioiNappi_;
     QPushButton* hyvitysNappi_;
     QPushButton* muistutusNappi_;
+    QPushButton* aineistoNappi_;
     QPushButton* uusiAsiakasNappi_;
 
     YhteystietoWidget* yhteystiedot_;
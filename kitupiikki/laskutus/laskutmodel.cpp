@@ -196,25 +196,40 @@ void LaskutModel::lataaAvoimet()
 
 void LaskutModel::paivita(int valinta, QDate mista, QDate mihin)
 {
-    QString kysely = QString("SELECT vienti.id, pvm, tili, debetsnt, kreditsnt, eraid, viite, erapvm, vienti.json, tosite, asiakas, laskupvm, kohdennus, tyyppi, selite "
+    // Laskun tyyppitiedot ja maksumuistutuksen olemassaolo haetaan suoraan
+    // json-kentän hakemistoista, joten jsonia ei tarvitse jäsentää jokaiselle
+    // ehdokasriville. Erien avoimet saldot lasketaan samalla yhdellä
+    // ryhmitellyllä alikyselyllä eikä erikseen jokaiselle riville.
+    QString kysely = QString("SELECT vienti.id, pvm, tili, debetsnt, kreditsnt, eraid, viite, erapvm, vienti.json, tosite, asiakas, laskupvm, kohdennus, tyyppi, selite, "
+                             "json_extract(vienti.json,'$.Kirjausperuste') AS kirjausperuste, "
+                             "EXISTS( SELECT 1 FROM vienti AS muistutus "
+                             "WHERE json_extract(muistutus.json,'$.Maksumuistutus') = CAST(vienti.viite AS INTEGER) "
+                             "AND muistutus.eraid = vienti.eraid ) AS muistutettu, "
+                             "IFNULL(erasaldot.saldo, 0) AS erasaldo "
                              "FROM vienti LEFT OUTER JOIN tili ON vienti.tili=tili.id "
+                             "LEFT OUTER JOIN (SELECT eraid AS saldoera, SUM(IFNULL(debetsnt,0)) - SUM(IFNULL(kreditsnt,0)) AS saldo "
+                             "FROM vienti WHERE eraid IS NOT NULL GROUP BY eraid) AS erasaldot ON erasaldot.saldoera=vienti.eraid "
                              "WHERE ((viite IS NOT NULL AND iban IS NULL) OR (tyyppi='AO' and vienti.id=vienti.eraid)) ");
 
     if( mista.isValid() && mihin.isValid())
         kysely.append( QString(" AND pvm BETWEEN '%1' AND '%2' ") .arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate)) );
 
+    // Hyvityslaskuja ei näytetä avoimina saatika erääntyneinä
+    if( valinta != KAIKKI )
+        kysely.append(" AND IFNULL(json_extract(vienti.json,'$.Hyvityslasku'),0) = 0 ");
+
     beginResetModel();
     laskut.clear();
     QSqlQuery query( kysely );
 
     while( query.next())
     {
-        TaseEra era( query.value("eraid").toInt());
+        qlonglong eraSaldo = query.value("erasaldo").toLongLong();
         int vientiId = query.value("vienti.id").toInt();
 
-        if( valinta == AVOIMET && (!era.saldoSnt || !query.value("erapvm").toDate().isValid() ))
+        if( valinta == AVOIMET && (!eraSaldo || !query.value("erapvm").toDate().isValid() ))
             continue;
-        if( valinta == ERAANTYNEET && ( !era.saldoSnt || !query.value("erapvm").toDate().isValid() || query.value("erapvm").toDate() > kp()->paivamaara() ))
+        if( valinta == ERAANTYNEET && ( !eraSaldo || !query.value("erapvm").toDate().isValid() || query.value("erapvm").toDate() > kp()->paivamaara() ))
             continue;
 
         JsonKentta json( query.value("vienti.json").toByteArray() );
@@ -227,32 +242,23 @@ void LaskutModel::paivita(int valinta, QDate mista, QDate mihin)
         lasku.erapvm = query.value("erapvm").toDate();
         lasku.eraId = query.value("eraid").toInt();
         lasku.summaSnt = query.value("debetSnt").toInt() - query.value("kreditSnt").toInt();
-        lasku.avoinSnt = json.luku("Hyvityslasku") ? 0 : era.saldoSnt;        // Hyvityslaskuille avoinsnt näytetään nollaa
+        lasku.avoinSnt = json.luku("Hyvityslasku") ? 0 : eraSaldo;        // Hyvityslaskuille avoinsnt näytetään nollaa
         lasku.asiakas = query.value("asiakas").toString();
         if( lasku.asiakas.isEmpty())
             lasku.asiakas = query.value("selite").toString();
         lasku.tosite = query.value("tosite").toInt();
 
-        lasku.kirjausperuste =  json.luku("Kirjausperuste");
+        lasku.kirjausperuste =  query.value("kirjausperuste").toInt();
         lasku.tiliid = query.value("tili").toInt();
         lasku.json = json;
         lasku.kohdennusId = query.value("kohdennus").toInt();
 
         if( valinta != KAIKKI && !lasku.avoinSnt)
-            continue;   // Hyvityslaskuja ei näytetä avoimina saatika erääntyneinä
+            continue;
 
-        // Jos lasku on erääntynyt, selvitetään, onko siitä jo lähetetty maksumuistutus
+        // Jos lasku on erääntynyt, onko siitä jo lähetetty maksumuistutus
         if( !lasku.viite.isEmpty() && lasku.erapvm < kp()->paivamaara())
-        {
-            QString muistutuskysymys = QString("SELECT json FROM vienti WHERE eraid=%1").arg(lasku.eraId);
-            QSqlQuery muistutuskysely(muistutuskysymys);
-            while( muistutuskysely.next())
-            {
-                JsonKentta muistutusJson( muistutuskysely.value("json").toByteArray() );
-                if( muistutusJson.str("Maksumuistutus")==lasku.viite)
-                    lasku.muistutettu = true;
-            }
-        }
+            lasku.muistutettu = query.value("muistutettu").toBool();
 
         laskut.append(lasku);
     }
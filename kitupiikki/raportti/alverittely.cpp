@@ -21,6 +21,7 @@
 
 #include "ui_taseerittely.h"
 #include "db/kirjanpito.h"
+#include "db/alvkooste.h"
 
 #include "alv/marginaalilaskelma.h"
 
@@ -69,12 +70,23 @@ RaportinKirjoittaja AlvErittely::kirjoitaRaporti(QDate alkupvm, QDate loppupvm)
     kirjoittaja.lisaaOtsake(otsikko);
 
     QSqlQuery kysely;
+
+    // Kaudella käytetyt alv-koodit saadaan koosteesta, jolloin viennit
+    // voidaan hakea (alvkoodi, pvm)-indeksin kautta
+    QStringList koodit;
+    kysely.exec( QString("select distinct alvkoodi from %1 as v").arg( AlvKooste::lahde(alkupvm, loppupvm)) );
+    while( kysely.next())
+        koodit.append( kysely.value(0).toString() );
+    if( koodit.isEmpty())
+        koodit.append("-1");
+
     QString kysymys = QString("select vienti.pvm as paiva, debetsnt, kreditsnt, selite, alvkoodi, alvprosentti, nro, tunniste, laji "
                               "from vienti,tili,tosite where vienti.tosite=tosite.id and vienti.tili=tili.id "
-                              "and vienti.pvm between \"%1\" and \"%2\" "
-                              "and alvkoodi > 0 order by alvkoodi, alvprosentti desc, tili, vienti.pvm")
+                              "and vienti.alvkoodi in (%3) and vienti.pvm between \"%1\" and \"%2\" "
+                              "order by alvkoodi, alvprosentti desc, tili, vienti.pvm")
             .arg(alkupvm.toString(Qt::ISODate))
-            .arg(loppupvm.toString(Qt::ISODate));
+            .arg(loppupvm.toString(Qt::ISODate))
+            .arg(koodit.join(","));
 
     int nAlvkoodi = -1; // edellisten alv-prosentti jne...
     int nTili = -1;
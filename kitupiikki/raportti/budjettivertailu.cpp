@@ -90,12 +90,19 @@ RaportinKirjoittaja Budjettivertailu::raportti()
 
     Raportoija raportoija(raporttiTyyppi);
 
+    if( ui_->kohdennusCheck->isChecked())
+        raportoija.lisaaKohdennus( ui_->kohdennusCombo->currentData(KohdennusModel::IdRooli).toInt() );
+
     Tilikausi kausi = kp()->tilikaudet()->tilikausiIndeksilla( ui_->kausiCombo->currentIndex() );
+    // Toteuma haetaan kerran, ja ero- ja prosenttisarakkeet lasketaan siitä
     raportoija.lisaaKausi( kausi.alkaa(), kausi.paattyy(),  Raportoija::BUDJETTI );
     raportoija.lisaaKausi( kausi.alkaa(), kausi.paattyy(),  Raportoija::TOTEUTUNUT );
     raportoija.lisaaKausi( kausi.alkaa(), kausi.paattyy(),  Raportoija::BUDJETTIERO );
     raportoija.lisaaKausi( kausi.alkaa(), kausi.paattyy(),  Raportoija::TOTEUMAPROSENTTI );
 
+    if( raportoija.tyyppi() == Raportoija::KOHDENNUSLASKELMA && !ui_->kohdennusCheck->isChecked())
+        raportoija.etsiKohdennukset();
+
     return  raportoija.raportti( ui_->erittelyCheck->isChecked());
 
 }
@@ -0,0 +1,75 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QSqlQuery>
+
+#include "kausisummat.h"
+
+KausiSummat::KausiSummat(QSqlDatabase tietokanta) :
+    tietokanta_( tietokanta )
+{
+
+}
+
+void KausiSummat::hae(const QDate &mista, const QDate &mihin, bool kertyma)
+{
+    kuukaudet_.clear();
+
+    QString rajaus = kertyma ? QString("pvm <= '%1'").arg(mihin.toString(Qt::ISODate))
+                             : QString("pvm BETWEEN '%1' AND '%2'").arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate));
+
+    QSqlQuery kysely( tietokanta_ );
+    kysely.setForwardOnly(true);
+    kysely.exec( QString("SELECT CASE WHEN pvm < '%1' THEN '' ELSE strftime('%Y-%m-01',pvm) END AS kuukausi, "
+                         "ysiluku, SUM(debetsnt), SUM(kreditsnt) FROM vienti, tili "
+                         "WHERE vienti.tili = tili.id AND %2 GROUP BY kuukausi, ysiluku")
+                 .arg(mista.toString(Qt::ISODate)).arg(rajaus) );
+
+    while( kysely.next())
+    {
+        QDate kuukausi = QDate::fromString( kysely.value(0).toString(), Qt::ISODate);
+        kuukaudet_[kuukausi].insert( kysely.value(1).toInt(),
+                                     kysely.value(2).toLongLong() - kysely.value(3).toLongLong() );
+    }
+}
+
+QMap<int, qlonglong> KausiSummat::summat(const QDate &alkaa, const QDate &paattyy, int ysiluvusta, int ysilukuun) const
+{
+    QMap<int,qlonglong> tulos;
+
+    auto iter = alkaa.isValid() ? kuukaudet_.lowerBound(alkaa) : kuukaudet_.constBegin();
+    for( ; iter != kuukaudet_.constEnd() && iter.key() <= paattyy; ++iter)
+    {
+        for( auto tili = iter.value().lowerBound(ysiluvusta); tili != iter.value().constEnd() && tili.key() <= ysilukuun; ++tili)
+            tulos[ tili.key() ] += tili.value();
+    }
+    return tulos;
+}
+
+qlonglong KausiSummat::summa(const QDate &alkaa, const QDate &paattyy, int ysiluvusta, int ysilukuun) const
+{
+    qlonglong yhteensa = 0;
+    for( qlonglong sentit : summat(alkaa, paattyy, ysiluvusta, ysilukuun))
+        yhteensa += sentit;
+    return yhteensa;
+}
+
+bool KausiSummat::kuukausirajoilla(const QDate &alkaa, const QDate &paattyy)
+{
+    return alkaa.isValid() && paattyy.isValid() && alkaa <= paattyy &&
+           alkaa.day() == 1 && paattyy.day() == paattyy.daysInMonth();
+}
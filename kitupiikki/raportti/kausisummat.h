@@ -0,0 +1,74 @@
+/*
+   Copyright (C) 2019 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KAUSISUMMAT_H
+#define KAUSISUMMAT_H
+
+#include <QDate>
+#include <QMap>
+#include <QSqlDatabase>
+
+/**
+ * @brief Vientien summat kuukausittain
+ *
+ * Trendiraportin kaikki sarakkeet lasketaan yhdellä kuukausittain ja
+ * tileittäin ryhmitellyllä kyselyllä. Kuukausien rajoilla alkavan ja
+ * päättyvän kauden summat saadaan sen jälkeen laskemalla kuukausien
+ * summat yhteen, joten sarakkeiden määrä ei lisää kyselyjä.
+ */
+class KausiSummat
+{
+public:
+    KausiSummat(QSqlDatabase tietokanta = QSqlDatabase::database());
+
+    /**
+     * @brief Hakee summat kuukausittain
+     * @param mista Ensimmäisen kuukauden alku
+     * @param mihin Viimeisen kuukauden loppu
+     * @param kertyma Tosi, jos ennen alkua kirjatut viennit haetaan yhteen
+     *        alkusummaan (tase)
+     */
+    void hae(const QDate& mista, const QDate& mihin, bool kertyma = false);
+
+    /**
+     * @brief Tilien summat (debet - kredit) kaudelta
+     * @param alkaa Kauden alkupäivä, tyhjä päivämäärä kirjanpidon alusta
+     * @param paattyy Kauden loppupäivä
+     * @param ysiluvusta Pienin mukaan otettava ysiluku
+     * @param ysilukuun Suurin mukaan otettava ysiluku
+     * @return ysiluku, sentit
+     */
+    QMap<int,qlonglong> summat(const QDate& alkaa, const QDate& paattyy,
+                               int ysiluvusta = 0, int ysilukuun = 999999999) const;
+
+    /**
+     * @brief Kauden kaikkien välille osuvien tilien summa (debet - kredit)
+     */
+    qlonglong summa(const QDate& alkaa, const QDate& paattyy,
+                    int ysiluvusta = 0, int ysilukuun = 999999999) const;
+
+    /**
+     * @brief Voidaanko kausi laskea kuukausisummista
+     */
+    static bool kuukausirajoilla(const QDate& alkaa, const QDate& paattyy);
+
+protected:
+    QSqlDatabase tietokanta_;
+    QMap<QDate, QMap<int,qlonglong> > kuukaudet_;   // Kuukauden alku (alkusumma tyhjällä päivällä), ysiluku
+};
+
+#endif // KAUSISUMMAT_H
@@ -104,55 +104,47 @@ RaportinKirjoittaja LaskuRaportti::myyntilaskut(QDate saldopvm, bool avoimet, La
     rk.lisaaOtsake(otsikko);
 
 
-    QString jarjestys = "laskupvm";
+    QString jarjestys = "vienti.laskupvm";
     if( lajittelu == Viitenumero)
-        jarjestys = "id";
+        jarjestys = "vienti.id";
     else if( lajittelu == Erapaiva)
-        jarjestys = "erapvm";
+        jarjestys = "vienti.erapvm";
     else if( lajittelu == Summa)
-        jarjestys = "summaSnt";
+        jarjestys = "vienti.debetsnt";
     else if( lajittelu == Asiakas)
-        jarjestys = "asiakas";
+        jarjestys = "vienti.asiakas";
 
 
     qlonglong laskusumma = 0;
     qlonglong avoinsumma = 0;
 
-    QString kysymys = QString("SELECT pvm, debetsnt, kreditsnt, eraid, viite, erapvm, asiakas, laskupvm FROM vienti LEFT OUTER JOIN tili ON vienti.tili=tili.id "
-                     "WHERE ((viite IS NOT NULL AND iban IS NULL) OR (tyyppi='AO' and vienti.id=vienti.eraid) ) AND vienti.id=vienti.eraid ");
+    // Avoin saldo lasketaan kaikille erille yhdellä ryhmitellyllä kyselyllä
+    QString kysymys = QString("SELECT vienti.debetsnt AS debetsnt, vienti.viite AS viite, vienti.erapvm AS erapvm, "
+                              "vienti.asiakas AS asiakas, vienti.laskupvm AS laskupvm, "
+                              "COALESCE(saldot.debet,0) - COALESCE(saldot.kredit,0) AS avoinna "
+                              "FROM vienti LEFT OUTER JOIN tili ON vienti.tili=tili.id "
+                              "LEFT OUTER JOIN (%1) AS saldot ON saldot.eraid=vienti.id "
+                              "WHERE ((vienti.viite IS NOT NULL AND vienti.iban IS NULL) OR (tili.tyyppi='AO' and vienti.id=vienti.eraid) ) AND vienti.id=vienti.eraid ")
+                        .arg( eraSaldot(saldopvm) );
 
     if( rajaus == RajaaErapaiva)
-        kysymys.append( QString(" AND erapvm BETWEEN '%1' AND '%2' ") .arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate)) );
+        kysymys.append( QString(" AND vienti.erapvm BETWEEN '%1' AND '%2' ") .arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate)) );
     else if( rajaus == RajaaLaskupaiva)
-        kysymys.append( QString(" AND laskupvm BETWEEN '%1' AND '%2' ") .arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate)) );
+        kysymys.append( QString(" AND vienti.laskupvm BETWEEN '%1' AND '%2' ") .arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate)) );
 
-    kysymys.append(" ORDER BY " + jarjestys);
+    if( avoimet )
+        kysymys.append(" AND COALESCE(saldot.debet,0) <> COALESCE(saldot.kredit,0) ");
 
+    kysymys.append(" ORDER BY " + jarjestys + ", vienti.id");
 
-    QSqlQuery kysely(kysymys);
+
+    QSqlQuery kysely;
+    kysely.setForwardOnly(true);
+    kysely.exec(kysymys);
 
     while( kysely.next() )
     {
-        qlonglong avoinna = 0;
-
-        if( kysely.value("eraid").toInt() )
-        {
-            QString erakysymys = QString("SELECT sum(debetsnt) as debet, sum(kreditsnt) as kredit FROM vienti WHERE eraid=%1 AND pvm<='%2'")
-                    .arg( kysely.value("eraid").toInt())
-                    .arg( saldopvm.toString(Qt::ISODate));
-
-            QSqlQuery erakysely( erakysymys);
-            if( erakysely.next())
-            {
-                avoinna -= erakysely.value("kredit").toLongLong();
-                avoinna += erakysely.value("debet").toLongLong();
-            }
-
-        }
-
-        // Lopuksi tulostus
-        if( avoimet && !avoinna)
-            continue;
+        qlonglong avoinna = kysely.value("avoinna").toLongLong();
 
         RaporttiRivi rivi;
         if( viitteet)
@@ -221,46 +213,46 @@ RaportinKirjoittaja LaskuRaportti::ostolaskut(QDate saldopvm, bool avoimet, Lask
 
     rk.lisaaOtsake(otsikko);
 
-    // Rivit laitetaan QMapiin ja alkuun niiden lajitteluavain
-    QMultiMap<QString, RaporttiRivi> rivit;
-
-
     qlonglong laskusumma = 0;
     qlonglong avoinsumma = 0;
 
+    QString jarjestys = "vienti.pvm";
+    if( lajittelu == Erapaiva)
+        jarjestys = "vienti.erapvm";
+    else if( lajittelu == Summa)
+        jarjestys = "vienti.kreditsnt";
+
+    QString kysymys = QString("SELECT vienti.pvm AS pvm, vienti.kreditsnt AS kreditsnt, vienti.viite AS viite, vienti.iban AS iban, "
+                              "vienti.erapvm AS erapvm, vienti.json AS json, vienti.selite AS selite, "
+                              "COALESCE(saldot.kredit,0) - COALESCE(saldot.debet,0) AS avoinna "
+                              "FROM vienti JOIN tili ON vienti.tili=tili.id "
+                              "LEFT OUTER JOIN (%1) AS saldot ON saldot.eraid=vienti.id "
+                              "WHERE tili.tyyppi='BO' AND vienti.eraid=vienti.id ")
+                        .arg( eraSaldot(saldopvm) );
 
-    QString ehto;
     if( rajaus == RajaaErapaiva )
-            ehto = QString(" erapvm BETWEEN %1 and %2 AND")
-                    .arg( mista.toString(Qt::ISODate) ).arg( mihin.toString(Qt::ISODate));
+        kysymys.append( QString(" AND vienti.erapvm BETWEEN '%1' AND '%2' ")
+                        .arg( mista.toString(Qt::ISODate) ).arg( mihin.toString(Qt::ISODate)) );
     else if( rajaus == RajaaLaskupaiva )
-            ehto = QString(" pvm BETWEEN %1 and %2 AND")
-                    .arg( mista.toString(Qt::ISODate) ).arg( mihin.toString(Qt::ISODate));
+        kysymys.append( QString(" AND vienti.pvm BETWEEN '%1' AND '%2' ")
+                        .arg( mista.toString(Qt::ISODate) ).arg( mihin.toString(Qt::ISODate)) );
 
-    QString kysymys = QString("SELECT vienti.id, pvm, kreditsnt, viite, iban, erapvm, vienti.json, selite FROM vienti,tili WHERE "
-                             " %1 vienti.tili=tili.id AND tili.tyyppi='BO' AND vienti.eraid=vienti.id  ").arg(ehto);
+    if( avoimet )
+        kysymys.append(" AND COALESCE(saldot.debet,0) <> COALESCE(saldot.kredit,0) ");
 
-    QSqlQuery kysely(kysymys);
+    kysymys.append(" ORDER BY " + jarjestys + ", vienti.id");
 
-    while( kysely.next() )
-    {
-        qlonglong avoinna = 0l;
-        JsonKentta json( kysely.value("vienti.json").toByteArray() );
-
-        // Nyt pitää hakea tähän tase-erään tulevat muutokset ko. päivään asti
-        QSqlQuery erakysely( QString("SELECT debetsnt, kreditsnt FROM vienti "
-                         "WHERE eraid=%1 AND pvm <= '%2'")
-                             .arg( kysely.value("vienti.id").toInt()  ).arg(saldopvm.toString(Qt::ISODate)));
+    QSqlQuery kysely;
+    kysely.setForwardOnly(true);
+    kysely.exec(kysymys);
 
-        while( erakysely.next())
-        {
-            avoinna += erakysely.value("kreditsnt").toLongLong();
-            avoinna -= erakysely.value("debetsnt").toLongLong();
-        }
+    // Myyjän nimi on json-kentässä, joten myyjän mukaan lajitellaan vasta täällä
+    QMultiMap<QString, RaporttiRivi> myyjittain;
 
-        // Lopuksi tulostus
-        if( avoimet && !avoinna)
-            continue;
+    while( kysely.next() )
+    {
+        qlonglong avoinna = kysely.value("avoinna").toLongLong();
+        JsonKentta json( kysely.value("json").toByteArray() );
 
         QString saaja = json.str("SaajanNimi");
         if( saaja.isEmpty())
@@ -281,19 +273,13 @@ RaportinKirjoittaja LaskuRaportti::ostolaskut(QDate saldopvm, bool avoimet, Lask
         laskusumma += kysely.value("kreditsnt").toLongLong();
         avoinsumma += avoinna;
 
-        QString avain = kysely.value("pvm").toDate().toString(Qt::ISODate);
-        if( lajittelu == Erapaiva)
-            avain = kysely.value("erapvm").toDate().toString(Qt::ISODate);
-        else if( lajittelu == Summa)
-            avain = QString("%1").arg(kysely.value("kreditSnt").toLongLong(), 10, 10, QChar('0'));
-        else if( lajittelu == Asiakas)
-            avain = json.str(saaja);
-
-        rivit.insert( avain, rivi);
+        if( lajittelu == Asiakas)
+            myyjittain.insert( saaja.toLower(), rivi);
+        else
+            rk.lisaaRivi(rivi);
     }
 
-    // Laitetaan nyt rivit järjestyksessä
-    for( const RaporttiRivi& rivi : rivit.values())
+    for( const RaporttiRivi& rivi : myyjittain.values())
         rk.lisaaRivi(rivi);
 
     if( summat )
@@ -314,6 +300,13 @@ RaportinKirjoittaja LaskuRaportti::ostolaskut(QDate saldopvm, bool avoimet, Lask
 }
 
 
+QString LaskuRaportti::eraSaldot(const QDate &saldopvm)
+{
+    return QString("SELECT eraid, SUM(debetsnt) AS debet, SUM(kreditsnt) AS kredit FROM vienti "
+                   "WHERE eraid IS NOT NULL AND pvm <= '%1' GROUP BY eraid")
+            .arg( saldopvm.toString(Qt::ISODate) );
+}
+
 void LaskuRaportti::tyyppivaihtuu()
 {
     ui->lajitteleViite->setEnabled( ui->myyntiRadio->isChecked() );
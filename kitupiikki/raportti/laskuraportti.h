@@ -63,6 +63,13 @@ protected:
     static RaportinKirjoittaja ostolaskut(QDate saldopvm, bool avoimet = true, Lajittelu lajittelu = Laskupaiva, bool summat=true, bool viitteet=true,
                                             PvmRajaus rajaus = KaikkiLaskut, QDate mista = QDate(), QDate mihin = QDate());
 
+    /**
+     * @brief Kaikkien erien debet- ja kreditsummat saldopäivään asti
+     *
+     * Alikysely (eraid, debet, kredit), joka liitetään laskujen otsikkoriveihin
+     */
+    static QString eraSaldot(const QDate& saldopvm);
+
 
     Ui::Laskuraportti *ui;
 };
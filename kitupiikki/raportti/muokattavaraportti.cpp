@@ -63,7 +63,8 @@ MuokattavaRaportti::MuokattavaRaportti(const QString &raporttinimi)
     }
 
     QStringList tyyppiLista;
-    tyyppiLista << tr("Totetunut") << tr("Budjetti") << tr("Budjettiero €") << tr("Toteutunut %");
+    tyyppiLista << tr("Totetunut") << tr("Budjetti") << tr("Budjettiero €") << tr("Toteutunut %")
+                << tr("Keskiarvo") << tr("Muutos %");
     QStringListModel *tyyppiListaModel = new QStringListModel(this);
     tyyppiListaModel->setStringList(tyyppiLista);
 
@@ -72,6 +73,14 @@ MuokattavaRaportti::MuokattavaRaportti(const QString &raporttinimi)
     ui->tyyppi3->setModel(tyyppiListaModel);
     ui->tyyppi4->setModel(tyyppiListaModel);
 
+    // Trendiraportissa ensimmäisen sarakkeen väli jaetaan kausiin
+    ui->jaksotusCombo->addItem( tr("Kuukausittain"), Raportoija::KUUKAUSITTAIN);
+    ui->jaksotusCombo->addItem( tr("Neljännesvuosittain"), Raportoija::NELJANNESVUOSITTAIN);
+    ui->jaksotusCombo->addItem( tr("Vuosittain"), Raportoija::VUOSITTAIN);
+    ui->jaksotusCombo->addItem( tr("Tilikausittain"), Raportoija::TILIKAUSITTAIN);
+    ui->jaksotusCombo->addItem( tr("Liukuva 12 kk"), Raportoija::LIUKUVA12KK);
+    connect( ui->trendiCheck, &QCheckBox::toggled, this, &MuokattavaRaportti::paivitaSarakkeet);
+
     // Jos alkupäivämäärä on tilikauden aloittava, päivitetään myös päättymispäivä tilikauden päättäväksi
     connect( ui->alkaa1Date, &QDateEdit::dateChanged, [this](const QDate& date){  if( kp()->tilikaudet()->tilikausiPaivalle(date).alkaa() == date) this->ui->loppuu1Date->setDate( kp()->tilikaudet()->tilikausiPaivalle(date).paattyy() );  });
     connect( ui->alkaa2Date, &QDateEdit::dateChanged, [this](const QDate& date){  if( kp()->tilikaudet()->tilikausiPaivalle(date).alkaa() == date) this->ui->loppuu2Date->setDate( kp()->tilikaudet()->tilikausiPaivalle(date).paattyy() );  });
@@ -95,7 +104,13 @@ RaportinKirjoittaja MuokattavaRaportti::raportti()
     if( ui->kohdennusCheck->isChecked())
         raportoija.lisaaKohdennus( ui->kohdennusCombo->currentData(KohdennusModel::IdRooli).toInt() );
 
-    if( raportoija.onkoKausiraportti())
+    if( ui->trendiCheck->isChecked())
+    {
+        raportoija.lisaaKaudet( ui->alkaa1Date->date(), ui->loppuu1Date->date(),
+                                static_cast<Raportoija::Jaksotus>( ui->jaksotusCombo->currentData().toInt() ),
+                                ui->muutosCheck->isChecked(), ui->keskiarvoCheck->isChecked());
+    }
+    else if( raportoija.onkoKausiraportti())
     {
         raportoija.lisaaKausi( ui->alkaa1Date->date(), ui->loppuu1Date->date(), ui->tyyppi1->currentIndex());
         if( ui->sarake2Box->isChecked())
@@ -128,21 +143,7 @@ void MuokattavaRaportti::paivitaUi()
         raporttiNimi = ui->muotoCombo->currentData(Qt::UserRole).toString();
 
 
-    Raportoija raportoija(raporttiNimi);
-
-    // Jos tehdään taselaskelmaa, piilotetaan turhat tiedot!
-    ui->alkaa1Date->setVisible( raportoija.onkoKausiraportti() );
-    ui->alkaa2Date->setVisible( raportoija.onkoKausiraportti() );
-    ui->alkaa3Date->setVisible( raportoija.onkoKausiraportti() );
-    ui->alkaa4Date->setVisible( raportoija.onkoKausiraportti() );
-    ui->alkaaLabel->setVisible( raportoija.onkoKausiraportti() );
-    ui->paattyyLabel->setVisible( raportoija.onkoKausiraportti() );
-
-    ui->tyyppi1->setVisible( raportoija.onkoKausiraportti());
-    ui->tyyppi2->setVisible( raportoija.onkoKausiraportti());
-    ui->tyyppi3->setVisible( raportoija.onkoKausiraportti());
-    ui->tyyppi4->setVisible( raportoija.onkoKausiraportti());
-
+    paivitaSarakkeet();
 
     // Sitten laitetaan valmiiksi tilikausia nykyisestä taaksepäin
     int tilikausiIndeksi = kp()->tilikaudet()->indeksiPaivalle( kp()->paivamaara() );
@@ -195,3 +196,30 @@ void MuokattavaRaportti::paivitaUi()
 
 }
 
+void MuokattavaRaportti::paivitaSarakkeet()
+{
+    Raportoija raportoija(raporttiNimi);
+    bool trendi = ui->trendiCheck->isChecked();
+    bool kausi = raportoija.onkoKausiraportti();
+
+    // Jos tehdään taselaskelmaa, piilotetaan turhat tiedot!
+    // Trendin kaudet jaetaan ensimmäisen sarakkeen väliltä, myös taseessa
+    ui->alkaa1Date->setVisible( kausi || trendi );
+    ui->alkaa2Date->setVisible( kausi && !trendi );
+    ui->alkaa3Date->setVisible( kausi && !trendi );
+    ui->alkaa4Date->setVisible( kausi && !trendi );
+    ui->alkaaLabel->setVisible( kausi || trendi );
+    ui->paattyyLabel->setVisible( kausi || trendi );
+
+    ui->tyyppi1->setVisible( kausi && !trendi );
+    ui->tyyppi2->setVisible( kausi && !trendi );
+    ui->tyyppi3->setVisible( kausi && !trendi );
+    ui->tyyppi4->setVisible( kausi && !trendi );
+
+    ui->sarake2Box->setVisible( !trendi );
+    ui->sarake3Box->setVisible( !trendi );
+    ui->sarake4Box->setVisible( !trendi );
+    ui->loppuu2Date->setVisible( !trendi );
+    ui->loppuu3Date->setVisible( !trendi );
+    ui->loppuu4Date->setVisible( !trendi );
+}
@@ -40,6 +40,10 @@ public:
 
 public slots:
     void paivitaUi();
+    /**
+     * @brief Näyttää tai piilottaa sarakkeiden valinnat raportin tyypin ja trenditilan mukaan
+     */
+    void paivitaSarakkeet();
 
 protected:
     Ui::MuokattavaRaportti *ui;   
@@ -21,9 +21,8 @@
 #include "db/kirjanpito.h"
 
 #include <QSqlQuery>
-#include <QMap>
-#include <QJsonDocument>
 #include <QVariant>
+#include <QComboBox>
 
 
 MyyntiRaportti::MyyntiRaportti()
@@ -35,6 +34,14 @@ MyyntiRaportti::MyyntiRaportti()
 
     ui->alkaa->setDate(kausi.alkaa());
     ui->paattyy->setDate(kausi.paattyy());
+
+    ryhmittelyCombo_ = new QComboBox;
+    ryhmittelyCombo_->addItem(tr("Tuotteittain"), TuoteMyynti::Tuotteittain);
+    ryhmittelyCombo_->addItem(tr("Asiakkaittain"), TuoteMyynti::Asiakkaittain);
+    ryhmittelyCombo_->addItem(tr("Kuukausittain"), TuoteMyynti::Kuukausittain);
+    if( kp()->kohdennukset()->kohdennuksia())
+        ryhmittelyCombo_->addItem(tr("Kohdennuksittain"), TuoteMyynti::Kohdennuksittain);
+    ui->formLayout->addRow(tr("Ryhmittely"), ryhmittelyCombo_);
 }
 
 MyyntiRaportti::~MyyntiRaportti()
@@ -44,78 +51,75 @@ MyyntiRaportti::~MyyntiRaportti()
 
 RaportinKirjoittaja MyyntiRaportti::raportti()
 {
-    return kirjoitaRaportti(ui->alkaa->date(), ui->paattyy->date());
+    return kirjoitaRaportti(ui->alkaa->date(), ui->paattyy->date(), true,
+                            static_cast<TuoteMyynti::Ryhmittely>( ryhmittelyCombo_->currentData().toInt() ));
 }
 
-RaportinKirjoittaja MyyntiRaportti::kirjoitaRaportti(QDate mista, QDate mihin, bool summat)
+RaportinKirjoittaja MyyntiRaportti::kirjoitaRaportti(QDate mista, QDate mihin, bool summat, TuoteMyynti::Ryhmittely ryhmittely)
 {
+    // Kappalemäärät ja yksikköhinnat ovat mielekkäitä vain tuotteittain
+    bool tuotteittain = ryhmittely == TuoteMyynti::Tuotteittain;
 
     RaportinKirjoittaja rk;
     rk.asetaOtsikko("MYYNTI");
     rk.asetaKausiteksti(QString("%1 - %2").arg(mista.toString("dd.MM.yyyy")).arg(mihin.toString("dd.MM.yyyy")));
     rk.lisaaVenyvaSarake();
-    rk.lisaaSarake("999999.99");
-    rk.lisaaEurosarake();
+    if( tuotteittain )
+    {
+        rk.lisaaSarake("999999.99");
+        rk.lisaaEurosarake();
+    }
     rk.lisaaEurosarake();
     rk.lisaaEurosarake();
 
     // Otsikot
     {
         RaporttiRivi otsikko;
-        otsikko.lisaa("Tuote");
-        otsikko.lisaa("Kpl");
-        otsikko.lisaa("á netto");
+        if( ryhmittely == TuoteMyynti::Asiakkaittain)
+            otsikko.lisaa("Asiakas");
+        else if( ryhmittely == TuoteMyynti::Kuukausittain)
+            otsikko.lisaa("Kuukausi");
+        else if( ryhmittely == TuoteMyynti::Kohdennuksittain)
+            otsikko.lisaa("Kohdennus");
+        else
+        {
+            otsikko.lisaa("Tuote");
+            otsikko.lisaa("Kpl");
+            otsikko.lisaa("á netto");
+        }
         otsikko.lisaa("Yht netto");
         otsikko.lisaa("Yht brutto");
         rk.lisaaOtsake(otsikko);
     }
 
-    QMap<QString,double> myyntiKpl;
-    QMap<QString,qlonglong> myyntiSnt;
-    QMap<QString,qlonglong> bruttoSnt;
+    qlonglong nettoSumma = 0;
+    qlonglong bruttoSumma = 0;
 
+    // Laskurivit on koottu tallennettaessa tuotemyynti-tauluun
     QSqlQuery kysely;
-    kysely.exec(QString("SELECT json from vienti where viite is not null and pvm between '%1' and '%2'")
-                .arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate)));
+    kysely.setForwardOnly(true);
+    kysely.exec( TuoteMyynti::kysely(ryhmittely, mista, mihin) );
 
     while( kysely.next())
     {
-        QJsonDocument json = QJsonDocument::fromJson( kysely.value(0).toByteArray() );
-        QVariantMap vmap = json.toVariant().toMap();
-        if( vmap.contains("Laskurivit"))
-        {
-            for( const QVariant& var : vmap.value("Laskurivit").toList())
-            {
-                QString nimike = var.toMap().value("Nimike").toString();
-
-                double maara = var.toMap().value("Maara").toDouble();
-                qlonglong sentit = var.toMap().value("Nettoyht").toLongLong();
-                qlonglong brutto = var.toMap().value("Yhteensa").toLongLong();
-
-                myyntiKpl[nimike] = myyntiKpl.value(nimike,0.0) + maara;
-                myyntiSnt[nimike] = myyntiSnt.value(nimike, 0) + sentit;
-                bruttoSnt[nimike] = bruttoSnt.value(nimike, 0) + brutto;
-            }
-        }
-    }
+        QString nimi = kysely.value("avain").toString();
+        if( ryhmittely == TuoteMyynti::Kohdennuksittain)
+            nimi = kp()->kohdennukset()->kohdennus( kysely.value("avain").toInt() ).nimi();
+        else if( ryhmittely == TuoteMyynti::Kuukausittain)
+            nimi = QDate::fromString( nimi + "-01", Qt::ISODate).toString("MM/yyyy");
 
-    qlonglong nettoSumma = 0;
-    qlonglong bruttoSumma = 0;
-
-    QMapIterator<QString,double> iter(myyntiKpl);
-    while( iter.hasNext() )
-    {
-        iter.next();
+        double kpl = kysely.value("maara").toDouble();
+        qlonglong snt = kysely.value("netto").toLongLong();
+        qlonglong brutto = kysely.value("brutto").toLongLong();
 
         RaporttiRivi rivi;
-        rivi.lisaa( iter.key());
+        rivi.lisaa( nimi );
 
-        double kpl = iter.value();
-        qlonglong snt = myyntiSnt.value(iter.key());
-        qlonglong brutto = bruttoSnt.value(iter.key());
-
-        rivi.lisaa( QString("%L1").arg(kpl,0,'f',2), 1, true );
-        rivi.lisaa( snt / kpl);
+        if( tuotteittain )
+        {
+            rivi.lisaa( QString("%L1").arg(kpl,0,'f',2), 1, true );
+            rivi.lisaa( snt / kpl);
+        }
         rivi.lisaa( snt );
         rivi.lisaa( brutto );
 
@@ -128,7 +132,7 @@ RaportinKirjoittaja MyyntiRaportti::kirjoitaRaportti(QDate mista, QDate mihin, b
     if( summat )
     {
         RaporttiRivi summarivi;
-        summarivi.lisaa( tr("Myynti yhteensä") , 3 );
+        summarivi.lisaa( tr("Myynti yhteensä") , tuotteittain ? 3 : 1 );
         summarivi.lisaa( nettoSumma );
         summarivi.lisaa( bruttoSumma );
         summarivi.viivaYlle();
@@ -139,4 +143,3 @@ RaportinKirjoittaja MyyntiRaportti::kirjoitaRaportti(QDate mista, QDate mihin, b
     return rk;
 }
 
-
@@ -20,6 +20,9 @@
 
 
 #include "raportti.h"
+#include "db/tuotemyynti.h"
+
+class QComboBox;
 
 namespace Ui {
     class TaseErittely;
@@ -41,12 +44,15 @@ public:
      * @param mista Pvm alkaen
      * @param mihin Pvm saakka
      * @param summat Tulostetaanko lopuksi summarivi
+     * @param ryhmittely Tuotteittain, asiakkaittain, kuukausittain tai kohdennuksittain
      * @return
      */
-    static RaportinKirjoittaja kirjoitaRaportti(QDate mista, QDate mihin, bool summat = true);
+    static RaportinKirjoittaja kirjoitaRaportti(QDate mista, QDate mihin, bool summat = true,
+                                                TuoteMyynti::Ryhmittely ryhmittely = TuoteMyynti::Tuotteittain);
 
 protected:
     Ui::TaseErittely *ui;
+    QComboBox *ryhmittelyCombo_;
 };
 
 #endif // MYYNTIRAPORTTI_H
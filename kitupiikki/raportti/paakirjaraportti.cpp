@@ -77,8 +77,13 @@ RaportinKirjoittaja PaakirjaRaportti::raportti()
 RaportinKirjoittaja PaakirjaRaportti::kirjoitaRaportti(QDate mista, QDate mihin, int kohdennuksella, bool tulostakohdennus, bool tulostaSummarivi, int tililta)
 {
     RaportinKirjoittaja rk;
+    kirjoitaRaportti(rk, mista, mihin, kohdennuksella, tulostakohdennus, tulostaSummarivi, tililta);
+    return rk;
+}
 
-    Kohdennus kohdennus = kp()->kohdennukset()->kohdennus(kohdennuksella);
+void PaakirjaRaportti::kirjoitaRaportti(RaportinKirjoittaja &rk, QDate mista, QDate mihin, int kohdennuksella, bool tulostakohdennus, bool tulostaSummarivi, int tililta)
+{
+    const Kohdennus& kohdennus = kp()->kohdennukset()->kohdennus(kohdennuksella);
 
     if( kohdennuksella > -1 )
         // Tulostetaan vain yhdestä kohdennuksesta
@@ -348,9 +353,6 @@ RaportinKirjoittaja PaakirjaRaportti::kirjoitaRaportti(QDate mista, QDate mihin,
         summarivi.viivaYlle();
         rk.lisaaRivi(summarivi);
     }
-
-    return rk;
-
 }
 
 void PaakirjaRaportti::haeTilitComboon()
@@ -36,6 +36,13 @@ public:
                                                  bool tulostakohdennus = false,
                                                  bool tulostaSummarivi = true,
                                                  int tililta = 0);
+    /**
+     * @brief Kirjoittaa pääkirjan annettuun kirjoittajaan, jolle voi asettaa virran
+     */
+    static void kirjoitaRaportti( RaportinKirjoittaja& rk, QDate mista, QDate mihin, int kohdennuksella = -1,
+                                  bool tulostakohdennus = false,
+                                  bool tulostaSummarivi = true,
+                                  int tililta = 0);
 public slots:
     void haeTilitComboon();
 protected:
@@ -81,9 +81,13 @@ RaportinKirjoittaja PaivakirjaRaportti::raportti()
 
 RaportinKirjoittaja PaivakirjaRaportti::kirjoitaRaportti(QDate mista, QDate mihin, int kohdennuksella, bool tositejarjestys, bool ryhmitalajeittain, bool tulostakohdennukset, bool tulostasummat)
 {
-
     RaportinKirjoittaja kirjoittaja;
+    kirjoitaRaportti(kirjoittaja, mista, mihin, kohdennuksella, tositejarjestys, ryhmitalajeittain, tulostakohdennukset, tulostasummat);
+    return kirjoittaja;
+}
 
+void PaivakirjaRaportti::kirjoitaRaportti(RaportinKirjoittaja &kirjoittaja, QDate mista, QDate mihin, int kohdennuksella, bool tositejarjestys, bool ryhmitalajeittain, bool tulostakohdennukset, bool tulostasummat)
+{
     if( kohdennuksella > -1 )
         // Tulostetaan vain yhdestä kohdennuksesta
         kirjoittaja.asetaOtsikko( QString("PÄIVÄKIRJA (%1)").arg( kp()->kohdennukset()->kohdennus(kohdennuksella).nimi() ) );
@@ -196,7 +200,7 @@ RaportinKirjoittaja PaivakirjaRaportti::kirjoitaRaportti(QDate mista, QDate mihi
 
             // Ryhmittely tositelajeittain: Tulostetaan tositelajien otsikot
             edellinenTositelajiId = kysely.value("tositelajiId").toInt();
-            Tositelaji laji = kp()->tositelajit()->tositelaji( edellinenTositelajiId );
+            const Tositelaji& laji = kp()->tositelajit()->tositelaji( edellinenTositelajiId );
             RaporttiRivi rr;
             kirjoittaja.lisaaRivi(rr);  // Lisätään ensin tyhjä rivi
             rr.lisaa( laji.nimi() , 3);
@@ -211,7 +215,7 @@ RaportinKirjoittaja PaivakirjaRaportti::kirjoitaRaportti(QDate mista, QDate mihi
         rivi.lisaa( pvm );
         csvRivi.lisaa(pvm);
 
-        Tositelaji laji = kp()->tositelajit()->tositelaji( kysely.value("tositelajiId").toInt() );
+        const Tositelaji& laji = kp()->tositelajit()->tositelaji( kysely.value("tositelajiId").toInt() );
 
         rivi.lisaaLinkilla( RaporttiRiviSarake::TOSITE_ID, kysely.value("tositeId").toInt() ,
                           QString("%1%2/%3").arg( laji.tunnus() ).arg(kysely.value("tunniste").toInt())
@@ -233,7 +237,7 @@ RaportinKirjoittaja PaivakirjaRaportti::kirjoitaRaportti(QDate mista, QDate mihi
             // Kohdennussarake
             if( kysely.value("vienti.kohdennus").toInt() )
             {
-                Kohdennus kohdennus = kp()->kohdennukset()->kohdennus( kysely.value("kohdennus").toInt() );
+                const Kohdennus& kohdennus = kp()->kohdennukset()->kohdennus( kysely.value("kohdennus").toInt() );
                 rivi.lisaa( kohdennus.nimi() );
                 csvRivi.lisaa( kohdennus.nimi() );
             }
@@ -284,8 +288,6 @@ RaportinKirjoittaja PaivakirjaRaportti::kirjoitaRaportti(QDate mista, QDate mihi
         summarivi.lihavoi();
         kirjoittaja.lisaaRivi( summarivi );
     }
-
-    return kirjoittaja;
 }
 
 
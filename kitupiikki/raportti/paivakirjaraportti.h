@@ -53,6 +53,14 @@ public:
                                  bool ryhmitalajeittain = false, bool tulostakohdennukset = false,
                                  bool tulostasummat = false);
 
+    /**
+     * @brief Kirjoittaa päiväkirjan annettuun kirjoittajaan, jolle voi asettaa virran
+     */
+    static void kirjoitaRaportti( RaportinKirjoittaja& kirjoittaja, QDate mista, QDate mihin,
+                                  int kohdennuksella = -1, bool tositejarjestys = false,
+                                  bool ryhmitalajeittain = false, bool tulostakohdennukset = false,
+                                  bool tulostasummat = false);
+
 protected:
     static void kirjoitaSummaRivi(RaportinKirjoittaja &rk, qlonglong debet, qlonglong kredit, int sarakeleveys);
 
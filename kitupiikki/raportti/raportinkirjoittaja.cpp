@@ -22,7 +22,9 @@
 #include <QPixmap>
 #include <QSettings>
 #include <QApplication>
+#include <QBuffer>
 #include "raportinkirjoittaja.h"
+#include "raporttivirta.h"
 
 #include <QPdfWriter>
 
@@ -39,6 +41,7 @@ RaportinKirjoittaja::RaportinKirjoittaja(bool csvKaytossa) :
 void RaportinKirjoittaja::asetaOtsikko(const QString &otsikko)
 {
     otsikko_ = otsikko;
+    asettelu_.clear();
 }
 
 void RaportinKirjoittaja::asetaKausiteksti(const QString &kausiteksti)
@@ -52,6 +55,7 @@ void RaportinKirjoittaja::lisaaSarake(const QString &leveysteksti, RaporttiRivi:
     uusi.leveysteksti = leveysteksti;
     uusi.sarakkeenKaytto = kaytto;
     sarakkeet_.append(uusi);
+    asettelu_.clear();
 }
 
 void RaportinKirjoittaja::lisaaSarake(int leveysprosentti)
@@ -59,6 +63,7 @@ void RaportinKirjoittaja::lisaaSarake(int leveysprosentti)
     RaporttiSarake uusi;
     uusi.leveysprossa = leveysprosentti;
     sarakkeet_.append(uusi);
+    asettelu_.clear();
 }
 
 void RaportinKirjoittaja::lisaaVenyvaSarake(int tekija)
@@ -66,6 +71,7 @@ void RaportinKirjoittaja::lisaaVenyvaSarake(int tekija)
     RaporttiSarake uusi;
     uusi.jakotekija = tekija;
     sarakkeet_.append(uusi);
+    asettelu_.clear();
 }
 
 void RaportinKirjoittaja::lisaaEurosarake()
@@ -81,37 +87,122 @@ void RaportinKirjoittaja::lisaaPvmSarake()
 void RaportinKirjoittaja::lisaaOtsake(const RaporttiRivi& otsikkorivi)
 {
     otsakkeet_.append(otsikkorivi);
+    asettelu_.clear();
 }
 
 void RaportinKirjoittaja::lisaaRivi(const RaporttiRivi& rivi)
 {
-    rivit_.append(rivi);
+    viimeisenSarakkeita_ = rivi.sarakkeita();
+
+    if( virta_ )
+    {
+        if( !virtaAloitettu_ )
+        {
+            virta_->aloita( *this );
+            virtaAloitettu_ = true;
+        }
+        virta_->kirjoita( rivi );
+        return;
+    }
+
+    rivit_.lisaa(rivi);
+    asettelu_.clear();
 }
 
 void RaportinKirjoittaja::lisaaTyhjaRivi()
 {
-    if( rivit_.count())
-        if( rivit_.last().sarakkeita() )
-            rivit_.append( RaporttiRivi(RaporttiRivi::EICSV));
+    if( viimeisenSarakkeita_ > 0 )
+        lisaaRivi( RaporttiRivi(RaporttiRivi::EICSV));
+}
+
+void RaportinKirjoittaja::asetaVirta(RaporttiVirta *virta)
+{
+    virta_ = virta;
+    virtaAloitettu_ = false;
+}
+
+void RaportinKirjoittaja::lopetaVirta()
+{
+    if( !virta_ )
+        return;
+
+    if( !virtaAloitettu_)
+        virta_->aloita( *this );
+    virta_->lopeta();
+
+    virta_ = nullptr;
+    virtaAloitettu_ = false;
 }
 
 int RaportinKirjoittaja::tulosta(QPagedPaintDevice *printer, QPainter *painter, bool raidoita, int alkusivunumero) const
 {
-    if( rivit_.isEmpty())
+    if( rivit_.onkoTyhja())
         return 0;     // Ei tulostettavaa !
 
 
     int pienennys = sarakkeet_.count() > 4 && printer->pageSizeMM().width() < 300 ? 2 : 0;
 
-    QFont fontti("Sans", 10 - pienennys );
-    painter->setFont(fontti);
+    painter->setFont( QFont("Sans", 10 - pienennys ) );
+
+    // Asettelu lasketaan uudelleen vain, jos sivun mitat ovat muuttuneet
+    if( !asettelu_ || asettelu_->sivunleveys != painter->window().width() ||
+        asettelu_->sivunkorkeus != painter->window().height() ||
+        asettelu_->dpi != painter->device()->logicalDpiY() ||
+        asettelu_->pienennys != pienennys )
+        asettelu_ = laskeAsettelu( painter, pienennys );
+
+    // Pidetään asettelu tallessa, vaikka raporttiin lisättäisiin rivejä kesken tulostuksen
+    QSharedPointer<RaportinAsettelu> asettelu = asettelu_;
+
+    for( int sivu = 0; sivu < asettelu->sivut.count(); sivu++)
+    {
+        if( sivu )
+            printer->newPage();
+
+        tulostaSivunAlku( painter, sivu + alkusivunumero, *asettelu);
+
+        int loppu = sivu + 1 < asettelu->sivut.count() ? asettelu->sivut.at(sivu + 1) : asettelu->rivit.count();
+        for( int r = asettelu->sivut.at(sivu); r < loppu; r++)
+        {
+            const RaportinAsettelu::Rivi& paikka = asettelu->rivit.at(r);
+            tulostaRivi( painter, rivit_.rivi( paikka.rivi ), paikka, *asettelu, raidoita );
+        }
+    }
+
+    // Pelkistä csv-riveistä koostuvakin raportti vie sivun, jotta
+    // sivunumerointi jatkuu kuten ennen
+    return qMax( 1, asettelu->sivut.count() );
+}
+
+QSharedPointer<RaportinAsettelu> RaportinKirjoittaja::laskeAsettelu(QPainter *painter, int pienennys) const
+{
+    QSharedPointer<RaportinAsettelu> asettelu( new RaportinAsettelu );
+
+    aloitaAsettelu( painter, pienennys, *asettelu);
+
+    for( int r = 0; r < rivit_.riveja(); r++)
+        asetteleRivi( painter, rivit_.rivi(r), r, *asettelu);
+
+    return asettelu;
+}
+
+void RaportinKirjoittaja::aloitaAsettelu(QPainter *painter, int pienennys, RaportinAsettelu &asettelu) const
+{
+    painter->save();
+    painter->setFont( QFont("Sans", 10 - pienennys ) );
 
     int rivinkorkeus = painter->fontMetrics().height();
     int sivunleveys = painter->window().width();
-    int sivunkorkeus = painter->window().height();
+
+    asettelu.sivunleveys = sivunleveys;
+    asettelu.sivunkorkeus = painter->window().height();
+    asettelu.dpi = painter->device()->logicalDpiY();
+    asettelu.pienennys = pienennys;
+    asettelu.rivinkorkeus = rivinkorkeus;
 
     // Lasketaan sarakkeiden leveydet
-    QVector<int> leveydet( sarakkeet_.count() );
+    QVector<int>& leveydet = asettelu.leveydet;
+    leveydet.resize( sarakkeet_.count() );
 
     int tekijayhteensa = 0; // Lasketaan jäävän tilan jako
     int jaljella = sivunleveys;
@@ -143,279 +234,214 @@ int RaportinKirjoittaja::tulosta(QPagedPaintDevice *printer, QPainter *painter,
 
     if( tekijayhteensa )
         jaljella = 0;   // Koko tila käytetty venyvällä sarakkeella
+    asettelu.jaljella = jaljella;
 
-    // Nyt taulukosta löytyy sarakkeiden leveydet, ja tulostaminen
-    // voidaan aloittaa
-
-    int sivu = 1;
-    int rivilla = 0;
-
-    foreach (RaporttiRivi rivi, rivit_)
+    // Ylätunnisteen ja otsakkeiden viemä tila sivun alussa
+    int sivunalku = 0;
+    if( !otsikko_.isEmpty())
+        sivunalku += mitoitaYlatunniste( painter ).korkeus;
+    if( !otsakkeet_.isEmpty())
     {
-        if( rivi.kaytto() == RaporttiRivi::CSV)
-            continue;
-
-        fontti.setPointSize( rivi.pistekoko() - pienennys );
-        fontti.setBold( rivi.onkoLihava() );
-        painter->setFont(fontti);
-
-        // Lasketaan ensin sarakkeiden rectit
-        // ja samalla lasketaan taulukkoon liput
-
-        QVector<QRect> laatikot( rivi.sarakkeita() );
-        QVector<int> liput( rivi.sarakkeita() );
-        QVector<QString> tekstit( rivi.sarakkeita() );
-
-        int korkeinrivi = rivinkorkeus;
-        int x = 0;  // Missä kohtaa ollaan leveyssuunnassa
-        int sarake = 0; // Missä taulukon sarakkeessa ollaan menossa
+        sivunalku += rivinkorkeus;
+        for( const RaporttiRivi& otsikkorivi : otsakkeet_)
+            if( otsikkorivi.kaytto() != RaporttiRivi::CSV)
+                sivunalku += rivinkorkeus;
+    }
+    asettelu.sivunalku = sivunalku;
 
-        for(int i=0; i < rivi.sarakkeita(); i++)
-        {
+    painter->restore();
+}
 
-            int sarakeleveys = 0;
-            // ysind (Yhdistettyjen Sarakkeiden Indeksi) kelaa ne sarakkeet läpi,
-            // jotka tällä riville yhdistetty toisiinsa
-            for( int ysind = 0; ysind < rivi.leveysSaraketta(i); ysind++ )
-            {
-                sarakeleveys += leveydet.at(sarake);
-                sarake++;
-            }
+template <class Rivi>
+bool RaportinKirjoittaja::asetteleRivi(QPainter *painter, const Rivi &rivi, int indeksi, RaportinAsettelu &asettelu) const
+{
+    if( rivi.kaytto() == RaporttiRivi::CSV)
+        return false;
 
-            // Nyt saatu tämän sarakkeen leveys
+    painter->save();
+    QFont fontti("Sans", rivi.pistekoko() - asettelu.pienennys );
+    fontti.setBold( rivi.onkoLihava() );
+    painter->setFont(fontti);
 
-            int lippu = Qt::TextWordWrap;
-            QString teksti = rivi.teksti(i);
-            if( rivi.tasattuOikealle(i))
-            {
-                lippu |= Qt::AlignRight;
-                teksti.append("  ");
-                // Ei tasata ihan oikealle vaan välilyönnin päähän
-            }
-            tekstit[i] = teksti;
+    RaportinAsettelu::Rivi paikka;
+    paikka.rivi = indeksi;
+    paikka.ensimmainenSolu = asettelu.laatikot.count();
 
-            liput[i] = lippu;
-            // Laatikoita ei asemoida korkeussuunnassa, vaan translatella liikutaan
-            laatikot[i] = painter->boundingRect( x, 0,
-                                                sarakeleveys, sivunkorkeus,
-                                                lippu, teksti );
+    int korkeinrivi = asettelu.rivinkorkeus;
+    int x = 0;  // Missä kohtaa ollaan leveyssuunnassa
+    int sarake = 0; // Missä taulukon sarakkeessa ollaan menossa
 
-            x += sarakeleveys;
-            if( laatikot[i].height() > korkeinrivi )
-                korkeinrivi = laatikot[i].height();
-        }
+    for(int i=0; i < rivi.sarakkeita(); i++)
+    {
 
-        if( painter->transform().dy() > sivunkorkeus - korkeinrivi)
+        int sarakeleveys = 0;
+        // ysind (Yhdistettyjen Sarakkeiden Indeksi) kelaa ne sarakkeet läpi,
+        // jotka tällä riville yhdistetty toisiinsa
+        for( int ysind = 0; ysind < rivi.leveysSaraketta(i); ysind++ )
         {
-            // Sivu tulee täyteen
-            printer->newPage();
-            sivu++;
-            rivilla = 0;
-            painter->restore();
+            sarakeleveys += asettelu.leveydet.at(sarake);
+            sarake++;
         }
 
-        if( painter->transform().dy() < 0.1 )
-        {
-            // Ollaan sivun alussa
-
-            painter->save();
-            painter->setFont(QFont("Sans", 10 - pienennys));
-
-            // Tulostetaan ylätunniste
-            if( !otsikko_.isEmpty())
-                tulostaYlatunniste( painter, sivu + alkusivunumero - 1);
-
-            if( !otsakkeet_.isEmpty())
-                painter->translate(0, rivinkorkeus);
-
-            // Otsikkorivit
-            foreach (RaporttiRivi otsikkorivi, otsakkeet_)
-            {
-                if( otsikkorivi.kaytto() == RaporttiRivi::CSV)
-                    continue;
-
-                x = 0;
-                sarake = 0;
-
-                for( int i = 0; i < otsikkorivi.sarakkeita(); i++)
-                {
-
-                    int lippu = 0;
-                    QString teksti = otsikkorivi.teksti(i);
-
-                    if( otsikkorivi.tasattuOikealle(i))
-                    {
-                        lippu = Qt::AlignRight;
-                        teksti.append("  ");
-                    }
-                    int sarakeleveys = 0;
-
-                    for( int ysind = 0; ysind < otsikkorivi.leveysSaraketta(i); ysind++ )
-                    {
-                        sarakeleveys += leveydet[sarake];
-                        sarake++;
-                    }
-                    painter->drawText( QRect(x,0,sarakeleveys,rivinkorkeus),
-                                      lippu, teksti );
-
-                    x += sarakeleveys;
-                }
-                painter->translate(0, rivinkorkeus);
-            } // Otsikkorivi
-            if( !otsikko_.isEmpty() || !otsakkeet_.isEmpty())
-                painter->drawLine(0,0,sivunleveys,0);
-        }
+        // Nyt saatu tämän sarakkeen leveys
 
-        // Jos raidoitus, niin raidoitetaan eli osan rivien taakse harmaata
-        if( raidoita && rivilla % 6 > 2)
+        int lippu = Qt::TextWordWrap;
+        QString teksti = rivi.teksti(i);
+        if( rivi.tasattuOikealle(i))
         {
-            painter->save();
-            painter->setBrush(QBrush(QColor(222,222,222)));
-            painter->setPen(Qt::NoPen);
-
-            painter->drawRect(0,0,sivunleveys, korkeinrivi);
-
-            painter->restore();
-
+            lippu |= Qt::AlignRight;
+            teksti.append("  ");
+            // Ei tasata ihan oikealle vaan välilyönnin päähän
         }
 
-        fontti.setPointSize( rivi.pistekoko() - pienennys );
-        fontti.setBold( rivi.onkoLihava() );
-        painter->setFont(fontti);
+        // Laatikoita ei asemoida korkeussuunnassa, vaan translatella liikutaan
+        QRect laatikko = painter->boundingRect( x, 0,
+                                                sarakeleveys, asettelu.sivunkorkeus,
+                                                lippu, teksti );
+        asettelu.laatikot.append( laatikko );
+        asettelu.liput.append( lippu );
 
-        // Sitten tulostetaan tämä varsinainen rivi
-        for( int i=0; i < rivi.sarakkeita(); i++)
-        {
-            painter->drawText( laatikot[i], liput[i] , tekstit[i] );
-        }
-        if( rivi.onkoViivaa())  // Viivan tulostaminen rivin ylle
-        {
-            painter->drawLine(0,0, sivunleveys - jaljella , 0);
-        }
+        x += sarakeleveys;
+        if( laatikko.height() > korkeinrivi )
+            korkeinrivi = laatikko.height();
+    }
+    painter->restore();
 
-        painter->translate(0, korkeinrivi);
-        rivilla++;
+    if( asettelu.y > 0 && asettelu.y > asettelu.sivunkorkeus - korkeinrivi)
+    {
+        // Sivu tulee täyteen
+        asettelu.y = 0;
+        asettelu.rivilla = 0;
     }
 
-    painter->restore();
+    bool uusiSivu = asettelu.y == 0;
+    if( uusiSivu )
+    {
+        asettelu.sivut.append( asettelu.rivit.count() );
+        asettelu.y = asettelu.sivunalku;
+    }
 
-    return sivu;
+    paikka.y = asettelu.y;
+    paikka.korkeus = korkeinrivi;
+    paikka.rivilla = asettelu.rivilla++;
+    asettelu.rivit.append( paikka );
+
+    asettelu.y += korkeinrivi;
+    return uusiSivu;
 }
 
-QString RaportinKirjoittaja::html(bool linkit) const
+void RaportinKirjoittaja::tulostaSivunAlku(QPainter *painter, int sivunumero, const RaportinAsettelu &asettelu) const
 {
-    QString txt;
-
-    txt.append("<html><meta charset=\"utf-8\"><title>");
-    txt.append( otsikko() );
-    txt.append("</title>"
-               "<style>"
-               " body { font-family: Helvetica; }"
-               " h1 { font-weight: normal; }"
-               " .lihava { font-weight: bold; } "
-               " tr.viiva td { border-top: 1px solid black; }"
-               " td.oikealle { text-align: right; } "
-               " th { text-align: left; color: darkgray;}"
-               " a { text-decoration: none; color: black; }"
-               " td { padding-right: 2em; }"
-               " td:last-of-type { padding-right: 0; }"
-               " table { border-collapse: collapse;}"
-               " p.tulostettu { margin-top:2em; color: darkgray; }"
-               " span.treeni { color: green; }"
-               "</style>"
-               "</head><body>");
-
-    txt.append("<h1>" + otsikko() + "</h1>");
-    txt.append("<p>" + kp()->asetukset()->asetus("Nimi") + "<br>");
-    txt.append( kausiteksti() + "</p>");
-    txt.append("<table width=100%><thead>\n");
+    int rivinkorkeus = asettelu.rivinkorkeus;
+
+    painter->save();
+    painter->setFont(QFont("Sans", 10 - asettelu.pienennys));
+
+    // Tulostetaan ylätunniste
+    if( !otsikko_.isEmpty())
+        tulostaYlatunniste( painter, sivunumero);
+
+    if( !otsakkeet_.isEmpty())
+        painter->translate(0, rivinkorkeus);
 
     // Otsikkorivit
-    foreach (RaporttiRivi otsikkorivi, otsakkeet_ )
+    for( const RaporttiRivi& otsikkorivi : otsakkeet_)
     {
         if( otsikkorivi.kaytto() == RaporttiRivi::CSV)
             continue;
 
-        txt.append("<tr>");
-        for(int i=0; i < otsikkorivi.sarakkeita(); i++)
-        {
+        int x = 0;
+        int sarake = 0;
 
-            txt.append(QString("<th colspan=%1>").arg( otsikkorivi.leveysSaraketta(i)));
-            txt.append( otsikkorivi.teksti(i));
-            txt.append("</th>");
-        }
-        txt.append("</tr>\n");
-    }
+        for( int i = 0; i < otsikkorivi.sarakkeita(); i++)
+        {
 
-    txt.append("</thead>\n");
-    // Rivit
-    foreach (RaporttiRivi rivi, rivit_)
-    {
-        if( rivi.kaytto() == RaporttiRivi::CSV)
-            continue;
+            int lippu = 0;
+            QString teksti = otsikkorivi.teksti(i);
 
-        QStringList trluokat;
-        if( rivi.onkoLihava())
-            trluokat << "lihava";
-        if( rivi.onkoViivaa())
-            trluokat << "viiva";
+            if( otsikkorivi.tasattuOikealle(i))
+            {
+                lippu = Qt::AlignRight;
+                teksti.append("  ");
+            }
+            int sarakeleveys = 0;
 
-        if( trluokat.isEmpty())
-            txt.append("<tr>");
-        else
-            txt.append("<tr class=\"" + trluokat.join(' ') + "\">");
+            for( int ysind = 0; ysind < otsikkorivi.leveysSaraketta(i); ysind++ )
+            {
+                sarakeleveys += asettelu.leveydet.at(sarake);
+                sarake++;
+            }
+            painter->drawText( QRect(x,0,sarakeleveys,rivinkorkeus),
+                              lippu, teksti );
 
-        if( !rivi.sarakkeita())
-            txt.append("<td>&nbsp;</td>"); // Tyhjätkin rivit näkyviin!
+            x += sarakeleveys;
+        }
+        painter->translate(0, rivinkorkeus);
+    } // Otsikkorivi
+    if( !otsikko_.isEmpty() || !otsakkeet_.isEmpty())
+        painter->drawLine(0,0,asettelu.sivunleveys,0);
 
-        for(int i=0; i < rivi.sarakkeita(); i++)
-        {
+    painter->restore();
+}
 
-            if( rivi.tasattuOikealle(i) )
-                txt.append(QString("<td colspan=%1 class=oikealle>").arg(rivi.leveysSaraketta(i)));
-            else
-                txt.append(QString("<td colspan=%1>").arg(rivi.leveysSaraketta(i)));
+template <class Rivi>
+void RaportinKirjoittaja::tulostaRivi(QPainter *painter, const Rivi &rivi, const RaportinAsettelu::Rivi &paikka,
+                                      const RaportinAsettelu &asettelu, bool raidoita) const
+{
+    painter->save();
+    painter->translate(0, paikka.y);
 
-            if(linkit)
-            {
-                if( rivi.sarake(i).linkkityyppi == RaporttiRiviSarake::TOSITE_ID)
-                {
-                    // Linkki tositteeseen
-                    txt.append( QString("<a href=\"%1.html\">").arg( rivi.sarake(i).linkkidata , 8, 10 , QChar('0') ) );
-                }
-                else if( rivi.sarake(i).linkkityyppi == RaporttiRiviSarake::TILI_NRO)
-                {
-                    // Linkki tiliin
-                    txt.append( QString("<a href=\"paakirja.html#%2\">").arg( rivi.sarake(i).linkkidata));
-                }
-                else if( rivi.sarake(i).linkkityyppi == RaporttiRiviSarake::TILI_LINKKI)
-                {
-                    // Nimiö dataan
-                    txt.append( QString("<a name=\"%1\">").arg( rivi.sarake(i).linkkidata));
-                }
-            }
-            QString tekstia = rivi.teksti(i);
-            tekstia.replace(' ', "&nbsp;");
-            tekstia.replace('\n', "<br>");
+    // Jos raidoitus, niin raidoitetaan eli osan rivien taakse harmaata
+    if( raidoita && paikka.rivilla % 6 > 2)
+    {
+        painter->save();
+        painter->setBrush(QBrush(QColor(222,222,222)));
+        painter->setPen(Qt::NoPen);
 
-            txt.append(  tekstia );
+        painter->drawRect(0,0,asettelu.sivunleveys, paikka.korkeus);
 
-            if( linkit && rivi.sarake(i).linkkityyppi )
-                txt.append("</a>");
+        painter->restore();
+    }
 
-            txt.append("&nbsp;</td>");
-        }
-        txt.append("</tr>\n");
+    QFont fontti("Sans", rivi.pistekoko() - asettelu.pienennys );
+    fontti.setBold( rivi.onkoLihava() );
+    painter->setFont(fontti);
 
+    // Asettelussa on vain solujen laatikot, tekstit luetaan rivistä
+    for( int i=0; i < rivi.sarakkeita(); i++)
+    {
+        int solu = paikka.ensimmainenSolu + i;
+        QString teksti = rivi.teksti(i);
+        if( rivi.tasattuOikealle(i))
+            teksti.append("  ");
+        painter->drawText( asettelu.laatikot.at(solu), asettelu.liput.at(solu), teksti );
     }
-    txt.append("</table>");
-    txt.append("<p class=tulostettu>Tulostettu " + QDate::currentDate().toString("dd.MM.yyyy"));
-    if( kp()->onkoHarjoitus())
-        txt.append("<br><span class=treeni>Kirjanpito on laadittu Kitupiikki-ohjelman harjoittelutilassa</span>");
+    if( rivi.onkoViivaa())  // Viivan tulostaminen rivin ylle
+    {
+        painter->drawLine(0,0, asettelu.sivunleveys - asettelu.jaljella , 0);
+    }
+    painter->restore();
+}
+
+// Rivit asetellaan sekä talletetuista riveistä että virrasta
+template bool RaportinKirjoittaja::asetteleRivi<RaporttiRivi>(QPainter*, const RaporttiRivi&, int, RaportinAsettelu&) const;
+template bool RaportinKirjoittaja::asetteleRivi<RaporttiPuskurinRivi>(QPainter*, const RaporttiPuskurinRivi&, int, RaportinAsettelu&) const;
+template void RaportinKirjoittaja::tulostaRivi<RaporttiRivi>(QPainter*, const RaporttiRivi&, const RaportinAsettelu::Rivi&, const RaportinAsettelu&, bool) const;
+template void RaportinKirjoittaja::tulostaRivi<RaporttiPuskurinRivi>(QPainter*, const RaporttiPuskurinRivi&, const RaportinAsettelu::Rivi&, const RaportinAsettelu&, bool) const;
+
+QString RaportinKirjoittaja::html(bool linkit) const
+{
+    QByteArray data;
+    QBuffer puskuri(&data);
+    puskuri.open(QIODevice::WriteOnly);
 
-    txt.append("</p></body></html>\n");
+    HtmlRaporttiVirta virta( &puskuri, linkit);
+    virta.aloita( *this );
+    for( int r = 0; r < rivit_.riveja(); r++)
+        virta.kirjoita( rivit_.rivi(r) );
+    virta.lopeta();
 
-    return txt;
+    return QString::fromUtf8( data );
 }
 
 QByteArray RaportinKirjoittaja::pdf(bool taustaraidat, bool tulostaA4) const
@@ -433,56 +459,56 @@ QByteArray RaportinKirjoittaja::pdf(bool taustaraidat, bool tulostaA4) const
     else
         writer.setPageLayout( kp()->printer()->pageLayout() );
 
+    // Samalla tarkkuudella kuin esikatselussa, jotta sen asettelu kelpaa
+    writer.setResolution( kp()->printer()->resolution() );
+
     QPainter painter( &writer );
 
     tulosta( &writer, &painter, taustaraidat );
     painter.end();
 
     return array;
-
 }
 
 QByteArray RaportinKirjoittaja::csv() const
 {
-    QChar erotin = kp()->settings()->value("CsvErotin", QChar(',')).toChar();
+    QByteArray data;
+    QBuffer puskuri(&data);
+    puskuri.open(QIODevice::WriteOnly);
 
-    QString txt;
+    CsvRaporttiVirta virta( &puskuri );
+    virta.aloita( *this );
+    for( int r = 0; r < rivit_.riveja(); r++)
+        virta.kirjoita( rivit_.rivi(r) );
+    virta.lopeta();
 
-    for( RaporttiRivi otsikko : otsakkeet_)
-    {
-        if( otsikko.kaytto() == RaporttiRivi::EICSV)
-            continue;
-
-        QStringList otsakkeet;
-        for(int i=0; i < otsikko.sarakkeita(); i++)
-            otsakkeet.append( otsikko.csv(i));
-        txt.append( otsakkeet.join(erotin));
-    }
-    for( RaporttiRivi rivi : rivit_ )
-    {
-        if( rivi.kaytto() == RaporttiRivi::EICSV)
-            continue;
+    return data;
+}
 
-        if( rivi.sarakkeita() )
-        {
+RaportinKirjoittaja::Ylatunniste RaportinKirjoittaja::mitoitaYlatunniste(QPainter *painter) const
+{
+    Ylatunniste mitat;
+    int sivunleveys = painter->window().width();
+    int rivinkorkeus = painter->fontMetrics().height();
 
-            txt.append("\r\n");
-            QStringList sarakkeet;
-            for( int i=0; i < rivi.sarakkeita(); i++)
-            {
-                sarakkeet.append( rivi.csv(i));
-            }
-            txt.append( sarakkeet.join(erotin));
-        }
-    }
+    mitat.nimi = kp()->asetukset()->onko("LogossaNimi") ? QString() : Kirjanpito::db()->asetus("Nimi");
 
-    if( kp()->settings()->value("CsvKoodaus").toString() == "latin1")
+    if( !kp()->logo().isNull() )
     {
-        txt.replace("€","EUR");
-        return txt.toLatin1();
+        double skaala = ((double) kp()->logo().width()) / kp()->logo().height();
+        double skaalattu = skaala < 5.0 ? skaala : 5.0;
+        mitat.logoRect = QRect(0,0,rivinkorkeus*2*skaalattu, rivinkorkeus*2);
+        mitat.vasenreunus = rivinkorkeus * 2 * skaalattu + painter->fontMetrics().width("A");
     }
-    else
-        return txt.toUtf8();
+
+    mitat.nimiRect = painter->boundingRect( mitat.vasenreunus, 0, sivunleveys / 3 - mitat.vasenreunus, painter->viewport().height(),
+                                            Qt::TextWordWrap, mitat.nimi );
+    mitat.otsikkoRect = painter->boundingRect( sivunleveys/3, 0, sivunleveys / 3, painter->viewport().height(),
+                                               Qt::AlignHCenter | Qt::TextWordWrap, otsikko());
+
+    mitat.korkeus = int( mitat.nimiRect.height() > mitat.otsikkoRect.height() ? mitat.nimiRect.height() : mitat.otsikkoRect.height() )
+            + rivinkorkeus;
+    return mitat;
 }
 
 void RaportinKirjoittaja::tulostaYlatunniste(QPainter *painter, int sivu) const
@@ -491,26 +517,15 @@ void RaportinKirjoittaja::tulostaYlatunniste(QPainter *painter, int sivu) const
     int sivunleveys = painter->window().width();
     int rivinkorkeus = painter->fontMetrics().height();
 
-    QString nimi = kp()->asetukset()->onko("LogossaNimi") ? QString() : Kirjanpito::db()->asetus("Nimi");
-    QString paivays = kp()->paivamaara().toString("dd.MM.yyyy");
-
-    int vasenreunus = 0;
+    Ylatunniste mitat = mitoitaYlatunniste( painter );
 
-    if( !kp()->logo().isNull() )
-    {
-        double skaala = ((double) kp()->logo().width()) / kp()->logo().height();
-        double skaalattu = skaala < 5.0 ? skaala : 5.0;
-        painter->drawPixmap( QRect(0,0,rivinkorkeus*2*skaalattu, rivinkorkeus*2), QPixmap::fromImage( kp()->logo() ) );
-        vasenreunus = rivinkorkeus * 2 * skaalattu + painter->fontMetrics().width("A");
-    }
+    QString paivays = kp()->paivamaara().toString("dd.MM.yyyy");
 
-    QRectF nimiRect = painter->boundingRect( vasenreunus, 0, sivunleveys / 3 - vasenreunus, painter->viewport().height(),
-                                             Qt::TextWordWrap, nimi );
-    QRectF otsikkoRect = painter->boundingRect( sivunleveys/3, 0, sivunleveys / 3, painter->viewport().height(),
-                                                Qt::AlignHCenter | Qt::TextWordWrap, otsikko());
+    if( !mitat.logoRect.isNull() )
+        painter->drawPixmap( mitat.logoRect, QPixmap::fromImage( kp()->logo() ) );
 
-    painter->drawText( nimiRect, Qt::AlignLeft | Qt::TextWordWrap, nimi );
-    painter->drawText( otsikkoRect, Qt::AlignHCenter | Qt::TextWordWrap, otsikko());
+    painter->drawText( mitat.nimiRect, Qt::AlignLeft | Qt::TextWordWrap, mitat.nimi );
+    painter->drawText( mitat.otsikkoRect, Qt::AlignHCenter | Qt::TextWordWrap, otsikko());
     painter->drawText( QRect(sivunleveys*2/3, 0, sivunleveys/3, rivinkorkeus), Qt::AlignRight, paivays);
 
     if( kp()->asetukset()->onko("Harjoitus") && !kp()->asetukset()->onko("Demo") )
@@ -522,11 +537,11 @@ void RaportinKirjoittaja::tulostaYlatunniste(QPainter *painter, int sivu) const
         painter->restore();
     }
 
-    painter->translate(0, nimiRect.height() > otsikkoRect.height() ? nimiRect.height() : otsikkoRect.height() );
+    painter->translate(0, mitat.korkeus - rivinkorkeus );
 
     QString ytunnus = Kirjanpito::db()->asetus("Ytunnus") ;    
 
-    painter->drawText(QRect(vasenreunus,0,sivunleveys/3, rivinkorkeus ), Qt::AlignLeft, ytunnus );
+    painter->drawText(QRect(mitat.vasenreunus,0,sivunleveys/3, rivinkorkeus ), Qt::AlignLeft, ytunnus );
 
     painter->drawText(QRect(sivunleveys/3,0,sivunleveys/3, rivinkorkeus  ), Qt::AlignHCenter, kausiteksti_);
     if( sivu )
@@ -20,9 +20,15 @@
 
 #include <QString>
 #include <QList>
+#include <QVector>
+#include <QRect>
+#include <QSharedPointer>
 #include <QPrinter>
 
 #include "raporttirivi.h"
+#include "raporttipuskuri.h"
+
+class RaporttiVirta;
 
 /**
  * @brief  Yksi raportin sarake, RaportinKirjoittajan sisäiseen käyttöön
@@ -35,6 +41,45 @@ struct RaporttiSarake
     RaporttiRivi::RivinKaytto sarakkeenKaytto = RaporttiRivi::KAIKKI;
 };
 
+/**
+ * @brief Raportin valmiiksi laskettu sivutus, RaportinKirjoittajan sisäiseen käyttöön
+ *
+ * Sarakkeiden leveydet, solujen laatikot ja sivunvaihdot lasketaan kerran,
+ * ja samaa asettelua käytetään esikatselussa, tulostuksessa ja pdf:ssä
+ * niin kauan kuin sivun mitat pysyvät samoina.
+ */
+struct RaportinAsettelu
+{
+    struct Rivi
+    {
+        int rivi;           /**< Indeksi raportin riveihin */
+        int y;              /**< Paikka sivulla */
+        int korkeus;
+        int rivilla;        /**< Monesko rivi sivulla, raidoitusta varten */
+        int ensimmainenSolu;
+    };
+
+    int sivunleveys = 0;
+    int sivunkorkeus = 0;
+    int dpi = 0;
+    int pienennys = 0;
+    int jaljella = 0;
+    int rivinkorkeus = 0;
+    int sivunalku = 0;      /**< Ylätunnisteen ja otsakkeiden korkeus */
+
+    int y = 0;              /**< Asettelun kohta viimeisellä sivulla */
+    int rivilla = 0;
+
+    QVector<int> leveydet;  /**< Sarakkeiden leveydet */
+    QVector<Rivi> rivit;
+    QVector<int> sivut;     /**< Kunkin sivun ensimmäinen rivi */
+
+    /** Solujen laatikot ja tasausliput. Tekstit luetaan tulostettaessa
+     *  raportin riveistä, jotta niitä ei pidetä muistissa kahteen kertaan. */
+    QVector<QRect> laatikot;
+    QVector<int> liput;
+};
+
 /**
  * @brief Raporttien kirjoittaja
  *
@@ -76,6 +121,16 @@ struct RaporttiSarake
  *    kirjoittaja.tulosta( &printer, &painter );
  * @endcode
  *
+ * Suuret raportit voi myös kirjoittaa suoraan tiedostoon rivi kerrallaan,
+ * jolloin rivejä ei talleteta kirjoittajaan
+ *
+ * @code
+ *    HtmlRaporttiVirta virta( &tiedosto );
+ *    kirjoittaja.asetaVirta( &virta );
+ *    ... lisätään rivit ...
+ *    kirjoittaja.lopetaVirta();
+ * @endcode
+ *
  */
 class RaportinKirjoittaja
 {
@@ -120,6 +175,19 @@ public:
      */
     void lisaaTyhjaRivi();
 
+    /**
+     * @brief Ohjaa rivit suoraan virtaan
+     *
+     * Otsikko, sarakkeet ja otsakkeet on asetettava ennen ensimmäistä riviä.
+     * Virtaan kirjoitettuja rivejä ei talleteta, joten html(), csv() ja tulosta()
+     * eivät niitä näe.
+     */
+    void asetaVirta(RaporttiVirta* virta);
+    /**
+     * @brief Päättää virtaan kirjoittamisen
+     */
+    void lopetaVirta();
+
     /**
      * @brief Tulostaa kirjoitetun raportin
      * @param printer
@@ -156,6 +224,9 @@ public:
     QString otsikko() const { return otsikko_; }
     QString kausiteksti() const { return kausiteksti_; }
 
+    int sarakkeita() const { return sarakkeet_.count(); }
+    const QList<RaporttiRivi>& otsakkeet() const { return otsakkeet_; }
+
     bool csvKaytossa() const { return csvKaytossa_;}
 
     void tulostaYlatunniste(QPainter *painter, int sivu) const;
@@ -165,8 +236,57 @@ signals:
 public slots:
 
 protected:
+    friend class PdfRaporttiVirta;
 
+    /**
+     * @brief Laskee raportin sivutuksen maalarin sivukoolle
+     */
+    QSharedPointer<RaportinAsettelu> laskeAsettelu(QPainter *painter, int pienennys) const;
+
+    /**
+     * @brief Laskee sarakkeiden leveydet ja sivun alun korkeuden uutta asettelua varten
+     */
+    void aloitaAsettelu(QPainter *painter, int pienennys, RaportinAsettelu& asettelu) const;
+
+    /**
+     * @brief Asettelee yhden rivin asettelun loppuun
+     * @param indeksi Rivin indeksi raportissa
+     * @return tosi, jos rivi aloitti uuden sivun
+     */
+    template <class Rivi>
+    bool asetteleRivi(QPainter *painter, const Rivi& rivi, int indeksi, RaportinAsettelu& asettelu) const;
+
+    /**
+     * @brief Tulostaa sivun ylätunnisteen ja otsakkeet
+     */
+    void tulostaSivunAlku(QPainter *painter, int sivunumero, const RaportinAsettelu& asettelu) const;
 
+    /**
+     * @brief Tulostaa asetellun rivin
+     */
+    template <class Rivi>
+    void tulostaRivi(QPainter *painter, const Rivi& rivi, const RaportinAsettelu::Rivi& paikka,
+                     const RaportinAsettelu& asettelu, bool raidoita) const;
+
+    /**
+     * @brief Ylätunnisteen mitat
+     */
+    struct Ylatunniste
+    {
+        QString nimi;
+        QRectF nimiRect;
+        QRectF otsikkoRect;
+        QRect logoRect;         // Tyhjä, jos logoa ei ole
+        int vasenreunus = 0;
+        int korkeus = 0;
+    };
+
+    /**
+     * @brief Mitoittaa ylätunnisteen
+     *
+     * Samaa mitoitusta käytetään sekä asettelussa että tulostettaessa.
+     */
+    Ylatunniste mitoitaYlatunniste(QPainter *painter) const;
 
 protected:
     QString otsikko_;
@@ -175,7 +295,13 @@ protected:
 
     QList<RaporttiSarake> sarakkeet_;
     QList<RaporttiRivi> otsakkeet_;
-    QList<RaporttiRivi> rivit_;
+    RaporttiPuskuri rivit_;
+
+    mutable QSharedPointer<RaportinAsettelu> asettelu_;
+
+    RaporttiVirta* virta_ = nullptr;
+    bool virtaAloitettu_ = false;
+    int viimeisenSarakkeita_ = -1;
 
 };
 
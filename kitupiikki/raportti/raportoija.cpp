@@ -24,14 +24,18 @@
 
 #include "raportoija.h"
 #include "raporttirivi.h"
+#include "kausisummat.h"
 
 #include "db/kirjanpito.h"
 #include "db/tilikausi.h"
+#include "db/budjetti.h"
 
 
 Raportoija::Raportoija(const QString &raportinNimi) :
     otsikko_(raportinNimi),
-    tyyppi_ ( VIRHEELLINEN )
+    tyyppi_ ( VIRHEELLINEN ),
+    kohdennusDataHaettu_( false ),
+    budjetitHaettu_( false )
 {
     kaava_ = kp()->asetukset()->lista("Raportti/" + raportinNimi);
     // Jos raporttia ei ole, jää VIRHEELLINEN-raportti
@@ -56,10 +60,71 @@ void Raportoija::lisaaKausi(const QDate &alkaa, const QDate &paattyy, int tyyppi
     sarakeTyypit_.append(tyyppi);
 }
 
-void Raportoija::lisaaTasepaiva(const QDate &pvm)
+void Raportoija::lisaaTasepaiva(const QDate &pvm, int tyyppi)
 {
     loppuPaivat_.append(pvm);
-    sarakeTyypit_.append(TOTEUTUNUT);
+    sarakeTyypit_.append(tyyppi);
+}
+
+int Raportoija::lisaaKaudet(const QDate &alkaa, const QDate &paattyy, Raportoija::Jaksotus jaksotus, bool muutokset, bool keskiarvo)
+{
+    int kausia = 0;
+    QDate alku = alkaa;
+
+    while( alku.isValid() && alku <= paattyy )
+    {
+        QDate kaudenAlku = alku;
+        QDate loppu;
+
+        switch (jaksotus) {
+        case KUUKAUSITTAIN:
+            loppu = alku.addMonths(1).addDays(-1);
+            break;
+        case NELJANNESVUOSITTAIN:
+            loppu = alku.addMonths(3).addDays(-1);
+            break;
+        case VUOSITTAIN:
+            loppu = alku.addYears(1).addDays(-1);
+            break;
+        case TILIKAUSITTAIN:
+            loppu = kp()->tilikaudet()->tilikausiPaivalle(alku).paattyy();
+            break;
+        case LIUKUVA12KK:
+            // Joka kuukaudelle sarake, jossa kuukausi ja sitä edeltävät 11 kuukautta
+            loppu = alku.addMonths(1).addDays(-1);
+            kaudenAlku = loppu.addDays(1).addMonths(-12);
+            break;
+        }
+
+        if( !loppu.isValid() || loppu > paattyy)
+            loppu = paattyy;
+
+        if( onkoTaseraportti())
+            lisaaTasepaiva(loppu);
+        else
+            lisaaKausi(kaudenAlku, loppu);
+
+        if( muutokset && kausia )
+        {
+            if( onkoTaseraportti())
+                lisaaTasepaiva(loppu, MUUTOSPROSENTTI);
+            else
+                lisaaKausi(kaudenAlku, loppu, MUUTOSPROSENTTI);
+        }
+
+        kausia++;
+        alku = loppu.addDays(1);
+    }
+
+    if( keskiarvo && kausia )
+    {
+        if( onkoTaseraportti())
+            lisaaTasepaiva(paattyy, KESKIARVO);
+        else
+            lisaaKausi(alkaa, paattyy, KESKIARVO);
+    }
+
+    return kausia;
 }
 
 RaportinKirjoittaja Raportoija::raportti(bool tulostaErittelyt)
@@ -85,6 +150,7 @@ RaportinKirjoittaja Raportoija::raportti(bool tulostaErittelyt)
                 sijoitaBudjetti();
         }
 
+        laskeJohdetut();
         kirjoitaDatasta(rk, tulostaErittelyt);
     }
     else if( tyyppi() == TASE )
@@ -97,6 +163,7 @@ RaportinKirjoittaja Raportoija::raportti(bool tulostaErittelyt)
 
         laskeTaseDate();
         budjetti_.resize( loppuPaivat_.count() );
+        laskeJohdetut();
 
         kirjoitaDatasta(rk, tulostaErittelyt);
     }
@@ -120,7 +187,7 @@ RaportinKirjoittaja Raportoija::raportti(bool tulostaErittelyt)
 
         for( int kohdennusId : kohdennusKaytossa_)
         {
-            Kohdennus kohdennus = kp()->kohdennukset()->kohdennus( kohdennusId );
+            const Kohdennus& kohdennus = kp()->kohdennukset()->kohdennus( kohdennusId );
 
             RaporttiRivi rr;
             rr.lihavoi();
@@ -129,6 +196,7 @@ RaportinKirjoittaja Raportoija::raportti(bool tulostaErittelyt)
 
             laskeKohdennusData( kohdennus.id() );
             sijoitaBudjetti( kohdennus.id() );
+            laskeJohdetut();
 
             kirjoitaDatasta(rk, tulostaErittelyt);
             rk.lisaaRivi( RaporttiRivi());
@@ -435,7 +503,16 @@ void Raportoija::kirjoitaDatasta(RaportinKirjoittaja &rk, bool tulostaErittelyt)
                         rr.lisaa("");
                     else
                         rr.lisaa( 10000 * summat.at(sarake) / budjetit.at(sarake), true );
-
+                    break;
+                case KESKIARVO:
+                    rr.lisaa( summat.at(sarake), true);
+                    break;
+                case MUUTOSPROSENTTI:
+                    // Vertailukauden summat ovat budjetin paikalla
+                    if( !budjetit.at(sarake))
+                        rr.lisaa("");
+                    else
+                        rr.lisaa( 10000 * (summat.at(sarake) - budjetit.at(sarake)) / qAbs(budjetit.at(sarake)), true );
                 }
 
             }
@@ -506,6 +583,16 @@ void Raportoija::kirjoitaDatasta(RaportinKirjoittaja &rk, bool tulostaErittelyt)
                                     rr.lisaa("");
                                 else
                                     rr.lisaa( 10000 * data_.at(sarake).value(iter.key(), 0) / budjetti_.at(sarake).value(iter.key(), 0), true );
+                                break;
+                            case KESKIARVO:
+                                rr.lisaa( data_.at(sarake).value(iter.key(), 0) , true );
+                                break;
+                            case MUUTOSPROSENTTI:
+                                if( !budjetti_.at(sarake).value(iter.key(), 0))
+                                    rr.lisaa("");
+                                else
+                                    rr.lisaa( 10000 * (data_.at(sarake).value(iter.key(), 0) - budjetti_.at(sarake).value(iter.key(), 0))
+                                              / qAbs(budjetti_.at(sarake).value(iter.key(), 0)), true );
                             }
 
                         }
@@ -544,11 +631,31 @@ void Raportoija::sijoitaTulosKyselyData(const QString &kysymys, int i)
 
 void Raportoija::laskeTulosData()
 {
+    // Kuukausien rajoilla olevat kaudet lasketaan yhdellä kyselyllä kuukausisummista
+    QList<int> kuukausittain;
+    for( int i = 0; i < alkuPaivat_.count(); i++)
+    {
+        if( sarakeTyypit_.value(i) != BUDJETTI && !onkoJohdettu(sarakeTyypit_.value(i)) && aiempiSarake(i, BUDJETTI) < 0 &&
+            KausiSummat::kuukausirajoilla( alkuPaivat_.at(i), loppuPaivat_.at(i)))
+            kuukausittain.append(i);
+    }
+    if( kuukausittain.count() > 1)
+        laskeTulosKuukausittain(kuukausittain);
+    else
+        kuukausittain.clear();
+
     // Tuloslaskelman summien laskemista
     for( int i = 0; i < alkuPaivat_.count(); i++)
     {
-        if( sarakeTyypit_.value(i) != BUDJETTI )
+        if( sarakeTyypit_.value(i) != BUDJETTI && !onkoJohdettu(sarakeTyypit_.value(i)) && !kuukausittain.contains(i))
         {
+            // Saman kauden toteuma on jo laskettu
+            int aiempi = aiempiSarake(i, BUDJETTI);
+            if( aiempi > -1 )
+            {
+                data_[i] = data_.at(aiempi);
+                continue;
+            }
 
             QString kysymys = QString("SELECT ysiluku, sum(debetsnt), sum(kreditsnt) "
                                       "from vienti,tili where vienti.tili = tili.id and ysiluku > 300000000 "
@@ -561,11 +668,59 @@ void Raportoija::laskeTulosData()
     }
 }
 
+void Raportoija::laskeTulosKuukausittain(const QList<int> &sarakkeet)
+{
+    QDate mista;
+    QDate mihin;
+    for( int i : sarakkeet)
+    {
+        if( !mista.isValid() || alkuPaivat_.at(i) < mista)
+            mista = alkuPaivat_.at(i);
+        if( !mihin.isValid() || loppuPaivat_.at(i) > mihin)
+            mihin = loppuPaivat_.at(i);
+    }
+
+    KausiSummat kuukaudet;
+    kuukaudet.hae( mista, mihin );
+
+    for( int i : sarakkeet)
+    {
+        qlonglong tulossumma = 0;
+        QMap<int,qlonglong> summat = kuukaudet.summat( alkuPaivat_.at(i), loppuPaivat_.at(i), 300000001);
+        QMapIterator<int,qlonglong> iter(summat);
+        while( iter.hasNext())
+        {
+            iter.next();
+            data_[i].insert( iter.key(), 0 - iter.value());
+            tilitKaytossa_.insert( iter.key(), true);
+            tulossumma -= iter.value();
+        }
+        data_[i].insert( 0, tulossumma );
+    }
+}
+
 void Raportoija::laskeTaseDate()
 {
+    // Kun tasepäivät ovat kuukausien lopussa ja tilikaudet alkavat kuukauden alusta,
+    // lasketaan kaikki sarakkeet kuukausisummista
+    bool kuukausittain = loppuPaivat_.count() > 1;
+    for( int i=0; i < loppuPaivat_.count() && kuukausittain; i++)
+    {
+        if( !KausiSummat::kuukausirajoilla( kp()->tilikaudet()->tilikausiPaivalle( loppuPaivat_.at(i)).alkaa(), loppuPaivat_.at(i)))
+            kuukausittain = false;
+    }
+    if( kuukausittain )
+    {
+        laskeTaseKuukausittain();
+        return;
+    }
+
     // Taseen summien laskeminen
     for( int i=0; i < loppuPaivat_.count(); i++)
     {
+        if( onkoJohdettu( sarakeTyypit_.value(i)))
+            continue;
+
         // 1) Tasetilien summat
         QString kysymys = QString("SELECT ysiluku, sum(debetsnt), sum(kreditsnt) "
                                   "from vienti,tili where vienti.tili = tili.id and ysiluku < 300000000 "
@@ -586,110 +741,216 @@ void Raportoija::laskeTaseDate()
             tilitKaytossa_.insert( ysiluku, true);
         }
 
-        // 2)  Sijoitetaan "edellisten tilikausien alijäämä/ylijäämä" ko.tilille
+        // 2)  Edellisten tilikausien alijäämä/ylijäämä
         Tilikausi tilikausi = kp()->tilikaudet()->tilikausiPaivalle( loppuPaivat_.at(i) );
+        qlonglong edYlijaama = 0;
 
         kysymys = QString("SELECT sum(debetsnt), sum(kreditsnt) FROM vienti, tili WHERE vienti.tili=tili.id "
                           " AND ysiluku > 300000000 AND pvm < \"%1\" ").arg( tilikausi.alkaa().toString(Qt::ISODate));
         query.exec(kysymys);
         if( query.next())
-        {
-            qlonglong edYlijaama = query.value(1).toLongLong() - query.value(0).toLongLong();
-
-            int kertymaTilinYsiluku = kp()->tilit()->edellistenYlijaamaTili().ysivertailuluku();
-            if( kertymaTilinYsiluku )
-            {
-                data_[i][ kertymaTilinYsiluku] = edYlijaama + data_[i].value( kertymaTilinYsiluku, 0);
-                tilitKaytossa_.insert(kertymaTilinYsiluku, true);
-            }
-
-        }
+            edYlijaama = query.value(1).toLongLong() - query.value(0).toLongLong();
 
-        // 3) Sijoitetaan tämän tilikauden tulos "tulostilille" 0 ja määritellylle tulostilille
+        // 3) Tämän tilikauden tulos
+        qlonglong tulos = 0;
         kysymys = QString("SELECT sum(debetsnt), sum(kreditsnt) FROM vienti, tili WHERE vienti.tili=tili.id"
                           " AND ysiluku > 300000000 AND pvm BETWEEN \"%1\" AND \"%2\"")
                 .arg( tilikausi.alkaa().toString(Qt::ISODate) ).arg( loppuPaivat_.at(i).toString(Qt::ISODate));
 
         query.exec(kysymys);
         if( query.next() )
+            tulos = query.value(1).toLongLong() - query.value(0).toLongLong();
+
+        sijoitaTaseTulos(i, edYlijaama, tulos);
+    }
+}
+
+void Raportoija::laskeTaseKuukausittain()
+{
+    QDate mista;
+    QDate mihin;
+    for( int i=0; i < loppuPaivat_.count(); i++)
+    {
+        QDate kaudenAlku = kp()->tilikaudet()->tilikausiPaivalle( loppuPaivat_.at(i) ).alkaa();
+        if( !mista.isValid() || kaudenAlku < mista)
+            mista = kaudenAlku;
+        if( !mihin.isValid() || loppuPaivat_.at(i) > mihin)
+            mihin = loppuPaivat_.at(i);
+    }
+
+    // Tilikausien alkua aiemmat viennit tulevat yhteen alkusummaan
+    KausiSummat kuukaudet;
+    kuukaudet.hae( mista, mihin, true);
+
+    for( int i=0; i < loppuPaivat_.count(); i++)
+    {
+        if( onkoJohdettu( sarakeTyypit_.value(i)))
+            continue;
+
+        QMap<int,qlonglong> summat = kuukaudet.summat( QDate(), loppuPaivat_.at(i), 0, 299999999);
+        QMapIterator<int,qlonglong> iter(summat);
+        while( iter.hasNext())
         {
-            qlonglong debet = query.value(0).toLongLong();
-            qlonglong kredit = query.value(1).toLongLong();
-            data_[i].insert(0, kredit - debet);
-            if( kp()->tilit()->tiliTyypilla(TiliLaji::KAUDENTULOS).onkoValidi())
-            {
-                data_[i].insert(kp()->tilit()->tiliTyypilla(TiliLaji::KAUDENTULOS).ysivertailuluku(), kredit - debet);
-                tilitKaytossa_.insert(kp()->tilit()->tiliTyypilla(TiliLaji::KAUDENTULOS).ysivertailuluku(), true  );
-            }
+            iter.next();
+            if( iter.key() < 200000000)    // Vastaavaa
+                data_[i].insert( iter.key(), iter.value() );
+            else                           // Vastattavaa
+                data_[i].insert( iter.key(), 0 - iter.value() );
+            tilitKaytossa_.insert( iter.key(), true);
         }
 
+        QDate kaudenAlku = kp()->tilikaudet()->tilikausiPaivalle( loppuPaivat_.at(i) ).alkaa();
+        sijoitaTaseTulos( i,
+                          0 - kuukaudet.summa( QDate(), kaudenAlku.addDays(-1), 300000001),
+                          0 - kuukaudet.summa( kaudenAlku, loppuPaivat_.at(i), 300000001));
+    }
+}
+
+void Raportoija::sijoitaTaseTulos(int sarake, qlonglong edYlijaama, qlonglong tulos)
+{
+    // Sijoitetaan "edellisten tilikausien alijäämä/ylijäämä" ko.tilille
+    int kertymaTilinYsiluku = kp()->tilit()->edellistenYlijaamaTili().ysivertailuluku();
+    if( kertymaTilinYsiluku )
+    {
+        data_[sarake][ kertymaTilinYsiluku] = edYlijaama + data_[sarake].value( kertymaTilinYsiluku, 0);
+        tilitKaytossa_.insert(kertymaTilinYsiluku, true);
+    }
+
+    // Sijoitetaan tämän tilikauden tulos "tulostilille" 0 ja määritellylle tulostilille
+    data_[sarake].insert(0, tulos);
+    if( kp()->tilit()->tiliTyypilla(TiliLaji::KAUDENTULOS).onkoValidi())
+    {
+        data_[sarake].insert(kp()->tilit()->tiliTyypilla(TiliLaji::KAUDENTULOS).ysivertailuluku(), tulos);
+        tilitKaytossa_.insert(kp()->tilit()->tiliTyypilla(TiliLaji::KAUDENTULOS).ysivertailuluku(), true  );
     }
 }
 
 void Raportoija::laskeKohdennusData(int kohdennusId, bool poiminnassa)
 {
-    data_.clear();
+    if( !kohdennusDataHaettu_ )
+    {
+        haeKohdennusData();
+        kohdennusDataHaettu_ = true;
+    }
+
+    data_ = kohdennusData_.value(kohdennusId);
     data_.resize( loppuPaivat_.count());
+    tilitKaytossa_ = kohdennusTilit_.value(kohdennusId);
 
-    tilitKaytossa_.clear();
-    Kohdennus kohdennus = kp()->kohdennukset()->kohdennus(kohdennusId);
+    if( poiminnassa )
+    {
+        // Tasemuodossa vastattavaa-puolen tasetilit kreditin mukaan
+        for( int i = 0; i < data_.count(); i++)
+        {
+            QMutableMapIterator<int,qlonglong> iter( data_[i] );
+            while( iter.hasNext())
+            {
+                iter.next();
+                if( iter.key() > 200000000 && iter.key() < 300000000 )
+                    iter.setValue( 0 - iter.value() );
+            }
+        }
+    }
+}
+
+void Raportoija::haeKohdennusData()
+{
+    kohdennusData_.clear();
+    kohdennusTilit_.clear();
+
+    QHash<int,bool> merkkaukset;
+    auto onkoMerkkaus = [&merkkaukset] (int kohdennusId) -> bool
+    {
+        if( !merkkaukset.contains(kohdennusId))
+            merkkaukset.insert( kohdennusId, kp()->kohdennukset()->kohdennus(kohdennusId).tyyppi() == Kohdennus::MERKKAUS );
+        return merkkaukset.value(kohdennusId);
+    };
+
+    auto sarakkeet = [this] (int kohdennusId) -> QVector< QMap<int,qlonglong> >&
+    {
+        QVector< QMap<int,qlonglong> >& vektori = kohdennusData_[kohdennusId];
+        if( vektori.isEmpty())
+            vektori.resize( loppuPaivat_.count());
+        return vektori;
+    };
 
-    // Kohdennuksen summien laskemista
     for( int i = 0; i < alkuPaivat_.count(); i++)
     {
-        QString kysymys;
+        if( onkoJohdettu( sarakeTyypit_.value(i)))
+            continue;
 
-        if( kohdennus.tyyppi() == Kohdennus::MERKKAUS)
-            kysymys = QString("SELECT ysiluku, sum(debetsnt), sum(kreditsnt) "
-                                  "from merkkaus, vienti,tili where merkkaus.kohdennus=%3 "
-                                  "AND merkkaus.vienti=vienti.id AND vienti.tili = tili.id and ysiluku > 300000000 "
-                                  "and pvm between \"%1\" and \"%2\"  "
-                                  "group by ysiluku")
-                .arg( alkuPaivat_.at(i).toString(Qt::ISODate))
-                .arg(loppuPaivat_.at(i).toString(Qt::ISODate))
-                .arg(kohdennusId);
-        else
-            kysymys = QString("SELECT ysiluku, sum(debetsnt), sum(kreditsnt) "
-                                  "from vienti,tili where vienti.tili = tili.id and ysiluku > 300000000 "
-                                  "and pvm between \"%1\" and \"%2\" and kohdennus=%3 "
-                                  "group by ysiluku")
-                .arg( alkuPaivat_.at(i).toString(Qt::ISODate))
-                .arg(loppuPaivat_.at(i).toString(Qt::ISODate))
-                .arg(kohdennusId);
+        int aiempi = aiempiSarake(i);
+        if( aiempi > -1 )
+        {
+            for( auto iter = kohdennusData_.begin(); iter != kohdennusData_.end(); ++iter)
+                iter.value()[i] = iter.value().at(aiempi);
+            continue;
+        }
 
-        sijoitaTulosKyselyData(kysymys, i);
+        QString alku = alkuPaivat_.at(i).toString(Qt::ISODate);
+        QString loppu = loppuPaivat_.at(i).toString(Qt::ISODate);
 
-        // Tasetilien summat
-        if( kohdennus.tyyppi() == Kohdennus::MERKKAUS)
-            kysymys = QString("SELECT ysiluku, sum(debetsnt), sum(kreditsnt) "
-                                      "from merkkaus, vienti,tili where merkkaus.kohdennus=%2 AND "
-                                      "merkkaus.vienti=vienti.id AND vienti.tili = tili.id and ysiluku < 300000000 "
-                                      "and pvm <= \"%1\"  "
-                                      "group by ysiluku").arg(loppuPaivat_.at(i).toString(Qt::ISODate))
-                                                         .arg(kohdennusId);
-
-        kysymys = QString("SELECT ysiluku, sum(debetsnt), sum(kreditsnt) "
-                                  "from vienti,tili where vienti.tili = tili.id and ysiluku < 300000000 "
-                                  "and pvm <= \"%1\" and kohdennus=%2 "
-                                  "group by ysiluku").arg(loppuPaivat_.at(i).toString(Qt::ISODate))
-                                                     .arg(kohdennusId);
-        QSqlQuery query(kysymys);
-        while (query.next())
+        // Tulostilien summat, merkkaukset merkkaustaulun kautta
+        QSqlQuery query( QString("SELECT kohdennus, ysiluku, sum(debetsnt), sum(kreditsnt) "
+                                 "from vienti,tili where vienti.tili = tili.id and ysiluku > 300000000 "
+                                 "and pvm between \"%1\" and \"%2\" "
+                                 "group by kohdennus, ysiluku").arg(alku).arg(loppu) );
+        while( query.next())
         {
-            int ysiluku = query.value(0).toInt();
-            qlonglong debet = query.value(1).toLongLong();
-            qlonglong kredit = query.value(2).toLongLong();
+            int kohdennusId = query.value(0).toInt();
+            if( onkoMerkkaus(kohdennusId))
+                continue;
+            int ysiluku = query.value(1).toInt();
+            qlonglong summa = query.value(3).toLongLong() - query.value(2).toLongLong();
+            sarakkeet(kohdennusId)[i].insert( ysiluku, summa );
+            sarakkeet(kohdennusId)[i][0] += summa;
+            kohdennusTilit_[kohdennusId].insert( ysiluku, true);
+        }
 
-            if( poiminnassa && ysiluku > 200000000 )
-                data_[i].insert( ysiluku, kredit - debet);
-            else
-                data_[i].insert( ysiluku, debet - kredit );
+        query.exec( QString("SELECT merkkaus.kohdennus, ysiluku, sum(debetsnt), sum(kreditsnt) "
+                            "from merkkaus, vienti,tili where merkkaus.vienti=vienti.id "
+                            "AND vienti.tili = tili.id and ysiluku > 300000000 "
+                            "and pvm between \"%1\" and \"%2\"  "
+                            "group by merkkaus.kohdennus, ysiluku").arg(alku).arg(loppu) );
+        while( query.next())
+        {
+            int kohdennusId = query.value(0).toInt();
+            if( !onkoMerkkaus(kohdennusId))
+                continue;
+            int ysiluku = query.value(1).toInt();
+            qlonglong summa = query.value(3).toLongLong() - query.value(2).toLongLong();
+            sarakkeet(kohdennusId)[i].insert( ysiluku, summa );
+            sarakkeet(kohdennusId)[i][0] += summa;
+            kohdennusTilit_[kohdennusId].insert( ysiluku, true);
+        }
 
-            tilitKaytossa_.insert( ysiluku, true);
+        // Tasetilien summat
+        query.exec( QString("SELECT kohdennus, ysiluku, sum(debetsnt), sum(kreditsnt) "
+                            "from vienti,tili where vienti.tili = tili.id and ysiluku < 300000000 "
+                            "and pvm <= \"%1\" "
+                            "group by kohdennus, ysiluku").arg(loppu) );
+        while( query.next())
+        {
+            int kohdennusId = query.value(0).toInt();
+            int ysiluku = query.value(1).toInt();
+            sarakkeet(kohdennusId)[i].insert( ysiluku, query.value(2).toLongLong() - query.value(3).toLongLong() );
+            kohdennusTilit_[kohdennusId].insert( ysiluku, true);
         }
     }
 }
 
+int Raportoija::aiempiSarake(int sarake, int ohitettavaTyyppi) const
+{
+    for( int i = 0; i < sarake; i++)
+    {
+        if( sarakeTyypit_.value(i) != ohitettavaTyyppi && !onkoJohdettu( sarakeTyypit_.value(i)) &&
+            alkuPaivat_.value(i) == alkuPaivat_.value(sarake) &&
+            loppuPaivat_.value(i) == loppuPaivat_.value(sarake) )
+            return i;
+    }
+    return -1;
+}
+
 QString Raportoija::sarakeTyyppiTeksti(int sarake)
 {
     switch (sarakeTyypit_.value(sarake))
@@ -702,63 +963,169 @@ QString Raportoija::sarakeTyyppiTeksti(int sarake)
             return tr("Budjettiero €");
         case TOTEUMAPROSENTTI:
             return tr("Toteutunut %");
+        case KESKIARVO:
+            return tr("Keskiarvo");
+        case MUUTOSPROSENTTI:
+            return tr("Muutos %");
     }
     return  QString();
 }
 
 void Raportoija::sijoitaBudjetti(int kohdennus)
 {
-    budjetti_.clear();
+    if( !budjetitHaettu_ )
+    {
+        haeBudjetit();
+        budjetitHaettu_ = true;
+    }
+
+    budjetti_ = kohdennusBudjetit_.value(kohdennus);
     budjetti_.resize( sarakeTyypit_.count() );
 
     for(int i=0; i < sarakeTyypit_.count(); i++)
     {
-        qlonglong summa = 0;
+        if( sarakeTyypit_.value(i) != TOTEUTUNUT && !budjetti_.at(i).contains(0))
+            budjetti_[i].insert(0, 0);
+    }
 
-        if( sarakeTyypit_.value(i) == TOTEUTUNUT)
-        {
+    QMapIterator<int,bool> tiliIter( budjettiTilit_.value(kohdennus) );
+    while( tiliIter.hasNext())
+    {
+        tiliIter.next();
+        tilitKaytossa_.insert( tiliIter.key(), true);
+    }
+}
+
+void Raportoija::haeBudjetit()
+{
+    kohdennusBudjetit_.clear();
+    budjettiTilit_.clear();
+
+    // Haetaan kerralla kaikkien budjettisarakkeiden kaudet kattava aika
+    QVector<bool> laskettava( sarakeTyypit_.count() );
+    QDate mista;
+    QDate mihin;
+
+    for(int i=0; i < sarakeTyypit_.count(); i++)
+    {
+        if( sarakeTyypit_.value(i) == TOTEUTUNUT || onkoJohdettu( sarakeTyypit_.value(i)) || aiempiSarake(i, TOTEUTUNUT) > -1)
             continue;
-        }
+        laskettava[i] = true;
+        if( !mista.isValid() || alkuPaivat_.value(i) < mista)
+            mista = alkuPaivat_.value(i);
+        if( !mihin.isValid() || loppuPaivat_.value(i) > mihin)
+            mihin = loppuPaivat_.value(i);
+    }
 
-        for(int kausi=0; kausi < kp()->tilikaudet()->rowCount(QModelIndex()); kausi++ )
+    if( !mista.isValid() || !mihin.isValid())
+        return;
+
+    auto sarakkeet = [this] (int kohdennusId) -> QVector< QMap<int,qlonglong> >&
+    {
+        QVector< QMap<int,qlonglong> >& vektori = kohdennusBudjetit_[kohdennusId];
+        if( vektori.isEmpty())
+            vektori.resize( sarakeTyypit_.count());
+        return vektori;
+    };
+
+    QSqlQuery kysely( Budjetti::kysely(mista, mihin) );
+    while( kysely.next())
+    {
+        QDate alkaa = kysely.value(0).toDate();
+        QDate loppuu = kysely.value(1).toDate();
+        int kohdennusId = kysely.value(2).toInt();
+        int tilille = Tili::ysiluku( kysely.value(3).toInt() ) + 9;
+        qlonglong sentit = kysely.value(4).toLongLong();
+
+        for(int i=0; i < sarakeTyypit_.count(); i++)
         {
-            Tilikausi tilikausi = kp()->tilikaudet()->tilikausiIndeksilla(kausi);
-            if( tilikausi.alkaa() > loppuPaivat_.value(i) || tilikausi.paattyy() < alkuPaivat_.value(i))
+            if( !laskettava.at(i) || alkaa > loppuPaivat_.value(i) || loppuu < alkuPaivat_.value(i))
                 continue;
 
-            // Lisätään tämä tilikausi budjettiin
-            QVariantMap kohdennusMap = tilikausi.json()->variant("Budjetti").toMap();
-            QMapIterator<QString,QVariant> kohdennusIter(kohdennusMap);
-            while( kohdennusIter.hasNext())
+            // Kohdennuksen budjettiin ja kaikkien kohdennusten (-1) budjettiin
+            for( int kohdennus : { kohdennusId, -1 })
             {
-                kohdennusIter.next();
-                if( kohdennus > -1 && kohdennusIter.key().toInt() != kohdennus)
-                    continue;   // Ohitetaan väärä kohdennus
+                QMap<int,qlonglong>& budjetti = sarakkeet(kohdennus)[i];
+                budjetti[tilille] += sentit;
+                budjetti[0] += sentit;
+                budjettiTilit_[kohdennus].insert( tilille, true );
+            }
+        }
+    }
 
-                QVariantMap tiliMap = kohdennusIter.value().toMap();
-                QMapIterator<QString, QVariant> tiliIter(tiliMap);
+    // Saman kauden budjettisarakkeet jaetaan
+    for(int i=0; i < sarakeTyypit_.count(); i++)
+    {
+        int aiempi = sarakeTyypit_.value(i) != TOTEUTUNUT && !onkoJohdettu( sarakeTyypit_.value(i)) ? aiempiSarake(i, TOTEUTUNUT) : -1;
+        if( aiempi < 0)
+            continue;
+        for( auto iter = kohdennusBudjetit_.begin(); iter != kohdennusBudjetit_.end(); ++iter)
+            iter.value()[i] = iter.value().at(aiempi);
+    }
+}
+
+
+void Raportoija::laskeJohdetut()
+{
+    budjetti_.resize( sarakeTyypit_.count() );
+
+    for( int i=0; i < sarakeTyypit_.count(); i++)
+    {
+        if( sarakeTyypit_.value(i) == KESKIARVO )
+        {
+            // Keskiarvo niistä toteumista, jotka päättyvät sarakkeen kaudella
+            QMap<int,qlonglong> summat;
+            int kausia = 0;
+            for( int j=0; j < sarakeTyypit_.count(); j++)
+            {
+                if( sarakeTyypit_.value(j) != TOTEUTUNUT || loppuPaivat_.value(j) > loppuPaivat_.value(i) ||
+                    ( alkuPaivat_.value(i).isValid() && loppuPaivat_.value(j) < alkuPaivat_.value(i)))
+                    continue;
 
-                while( tiliIter.hasNext())
+                QMapIterator<int,qlonglong> iter( data_.at(j));
+                while( iter.hasNext())
                 {
-                    tiliIter.next();
-                    int tilille = Tili::ysiluku( tiliIter.key().toInt() ) + 9;
-                    qlonglong ennen = budjetti_[i].value( tilille, 0 );
-                    qlonglong lisattava = tiliIter.value().toLongLong();
-                    budjetti_[i].insert(tilille, ennen +  lisattava );
-                    summa += lisattava;
-                    tilitKaytossa_.insert( tilille, true );
+                    iter.next();
+                    summat[iter.key()] += iter.value();
                 }
+                kausia++;
+            }
+
+            data_[i].clear();
+            QMapIterator<int,qlonglong> iter( summat );
+            while( iter.hasNext())
+            {
+                iter.next();
+                data_[i].insert( iter.key(), iter.value() / kausia );
             }
         }
-        budjetti_[i].insert(0, summa);
+        else if( sarakeTyypit_.value(i) == MUUTOSPROSENTTI)
+        {
+            // Edeltävä toteuma ja sen vertailukautena sitä edeltävä toteuma
+            int kausi = -1;
+            int vertailu = -1;
+            for( int j = i - 1; j >= 0 && vertailu < 0; j--)
+            {
+                if( sarakeTyypit_.value(j) != TOTEUTUNUT)
+                    continue;
+                if( kausi < 0)
+                    kausi = j;
+                else
+                    vertailu = j;
+            }
+            data_[i] = kausi > -1 ? data_.at(kausi) : QMap<int,qlonglong>();
+            budjetti_[i] = vertailu > -1 ? data_.at(vertailu) : QMap<int,qlonglong>();
+        }
     }
 }
 
-
 void Raportoija::etsiKohdennukset()
 {
     for( int i = 0; i < loppuPaivat_.count(); i++)
     {
+        if( aiempiSarake(i) > -1 )
+            continue;
+
         QString kysymys = QString("SELECT kohdennus from vienti where pvm between \"%1\" and \"%2\" group by kohdennus")
                 .arg( alkuPaivat_.at(i).toString(Qt::ISODate))
                 .arg( loppuPaivat_.at(i).toString( Qt::ISODate));
@@ -768,33 +1135,17 @@ void Raportoija::etsiKohdennukset()
             kohdennusKaytossa_.push_back( kysely.value(0).toInt());
     }
 
-    for( int sarakeTyyppi : sarakeTyypit_ )
+    // Budjettisarakkeisiin myös ne kohdennukset, joille on näinä aikoina budjetti
+    if( !budjetitHaettu_ )
     {
-        // Jos budjettiin liittyvä sarake, haetaan kaikki ne kohdennukset, joissa näinä aikoina
-        // budjetti
-        if( sarakeTyyppi != TOTEUTUNUT)
-        {
-            for(int i=0; i < loppuPaivat_.count(); i++)
-            {
-                // Lisätään budjetin kohdennukset näistä tilikausista
-                for(int kausi=0; kausi < kp()->tilikaudet()->rowCount(QModelIndex()); kausi++ )
-                {
-                    Tilikausi tilikausi = kp()->tilikaudet()->tilikausiIndeksilla(kausi);
-                    if( tilikausi.alkaa() > loppuPaivat_.value(i) || tilikausi.paattyy() < alkuPaivat_.value(i))
-                        continue;
-
-                    // Lisätään tämä tilikausi budjettiin
-                    QVariantMap kohdennusMap = tilikausi.json()->variant("Budjetti").toMap();
-                    QMapIterator<QString,QVariant> kohdennusIter(kohdennusMap);
-                    while( kohdennusIter.hasNext())
-                    {
-                        kohdennusIter.next();
-                        kohdennusKaytossa_.push_back(kohdennusIter.key().toInt());
-                    }
-                }
-            }
-            break;
-        }
+        haeBudjetit();
+        budjetitHaettu_ = true;
+    }
+
+    for( int kohdennusId : kohdennusBudjetit_.keys())
+    {
+        if( kohdennusId > -1 )
+            kohdennusKaytossa_.push_back( kohdennusId );
     }
 }
 
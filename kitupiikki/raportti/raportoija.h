@@ -22,6 +22,7 @@
 #include <QDate>
 #include <QVector>
 #include <QMap>
+#include <QHash>
 #include <QObject>
 
 #include "raportinkirjoittaja.h"
@@ -63,7 +64,18 @@ public:
         TOTEUTUNUT = 0,
         BUDJETTI = 1,
         BUDJETTIERO = 2,
-        TOTEUMAPROSENTTI = 3
+        TOTEUMAPROSENTTI = 3,
+        KESKIARVO = 4,
+        MUUTOSPROSENTTI = 5
+    };
+
+    enum Jaksotus
+    {
+        KUUKAUSITTAIN,
+        NELJANNESVUOSITTAIN,
+        VUOSITTAIN,
+        TILIKAUSITTAIN,
+        LIUKUVA12KK
     };
 
     /**
@@ -83,7 +95,28 @@ public:
      * @brief Lisää tasetyyppiseen raporttiin tasepäivän (sarakkeen)
      * @param pvm Tasepäivämäärä (tilikauden viimeinen päivä)
      */
-    void lisaaTasepaiva(const QDate& pvm);
+    void lisaaTasepaiva(const QDate& pvm, int tyyppi = TOTEUTUNUT);
+
+    /**
+     * @brief Lisää trendiraporttiin peräkkäiset kaudet
+     *
+     * Kuukausien rajoilla olevien kausien summat lasketaan kaikille
+     * sarakkeille yhdellä kuukausittain ryhmitellyllä kyselyllä.
+     * Taseraporttiin lisätään kausien loppupäivät tasepäiviksi.
+     *
+     * Keskiarvosarake (KESKIARVO) laskee keskiarvon niistä toteumasarakkeista,
+     * joiden loppupäivä on sen kaudella, ja muutossarake (MUUTOSPROSENTTI)
+     * vertaa edeltävää toteumasaraketta sitä edeltävään.
+     *
+     * @param alkaa Ensimmäisen kauden alkupäivä
+     * @param paattyy Viimeisen kauden viimeinen päivä
+     * @param jaksotus Kausien pituus
+     * @param muutokset Lisätäänkö jokaisen kauden jälkeen muutos % edellisestä kaudesta
+     * @param keskiarvo Lisätäänkö loppuun kausien keskiarvo
+     * @return Lisättyjen kausien määrä
+     */
+    int lisaaKaudet(const QDate& alkaa, const QDate& paattyy, Jaksotus jaksotus,
+                    bool muutokset = false, bool keskiarvo = false);
 
     /**
      * @brief Raportin tyyppi
@@ -151,6 +184,28 @@ protected:
     void laskeTulosData();
     void laskeTaseDate();
 
+    /**
+     * @brief Laskee tuloslaskelman kuukausirajoilla olevat sarakkeet kuukausisummista
+     */
+    void laskeTulosKuukausittain(const QList<int> &sarakkeet);
+    /**
+     * @brief Laskee kaikki taseen sarakkeet kuukausisummista
+     */
+    void laskeTaseKuukausittain();
+    /**
+     * @brief Sijoittaa tasesarakkeeseen edellisten kausien yli/alijäämän ja kauden tuloksen
+     */
+    void sijoitaTaseTulos(int sarake, qlonglong edYlijaama, qlonglong tulos);
+
+    /**
+     * @brief Laskee keskiarvo- ja muutossarakkeet jo lasketuista sarakkeista
+     *
+     * Muutossarakkeen vertailukauden summat sijoitetaan budjetin paikalle.
+     */
+    void laskeJohdetut();
+
+    static bool onkoJohdettu(int tyyppi) { return tyyppi == KESKIARVO || tyyppi == MUUTOSPROSENTTI; }
+
     /**
      * @brief Laskee kohdennusten datan
      * @param kohdennusId Kohdennuksen id
@@ -158,6 +213,33 @@ protected:
      */
     void laskeKohdennusData(int kohdennusId, bool poiminnassa=false);
 
+    /**
+     * @brief Hakee kaikkien kohdennusten summat
+     *
+     * Summat haetaan kohdennuksittain ryhmitellyllä kyselyllä kerran
+     * kautta kohden, ja laskeKohdennusData poimii niistä kohdennuksen
+     * summat.
+     */
+    void haeKohdennusData();
+
+    /**
+     * @brief Hakee kaikkien kohdennusten budjetit yhdellä kyselyllä budjettitaulusta
+     */
+    void haeBudjetit();
+
+    /**
+     * @brief Aiempi sarake, jolla on sama kausi
+     *
+     * Saman kauden summia ei haeta uudelleen, vaan johdetut sarakkeet
+     * (budjettiero, toteutunut %) käyttävät jo laskettuja summia.
+     * Keskiarvo- ja muutossarakkeita ei huomioida.
+     *
+     * @param sarake Sarakkeen indeksi
+     * @param ohitettavaTyyppi Tämän tyyppisiä sarakkeita ei huomioida
+     * @return Aiemman sarakkeen indeksi tai -1
+     */
+    int aiempiSarake(int sarake, int ohitettavaTyyppi = -1) const;
+
     QString sarakeTyyppiTeksti(int sarake);
 
     void sijoitaBudjetti(int kohdennus = -1);
@@ -178,6 +260,13 @@ protected:
     QVector< QMap< int, qlonglong> > data_;    // ysiluku, sentit
     QVector< QMap< int, qlonglong> > budjetti_; // ysiluku, sentit
     QMap<int,bool> tilitKaytossa_;           // ysiluku
+
+    QHash<int, QVector< QMap<int, qlonglong> > > kohdennusData_;      // kohdennusId
+    QHash<int, QMap<int,bool> > kohdennusTilit_;                       // kohdennusId
+    QHash<int, QVector< QMap<int, qlonglong> > > kohdennusBudjetit_;  // kohdennusId, -1 kaikki
+    QHash<int, QMap<int,bool> > budjettiTilit_;                        // kohdennusId, -1 kaikki
+    bool kohdennusDataHaettu_;
+    bool budjetitHaettu_;
     std::list<int> kohdennusKaytossa_;       // kohdennusId
 
 
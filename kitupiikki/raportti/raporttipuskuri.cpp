@@ -0,0 +1,107 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "raporttipuskuri.h"
+
+RaporttiPuskuri::RaporttiPuskuri()
+{
+
+}
+
+void RaporttiPuskuri::lisaa(const RaporttiRivi &rivi)
+{
+    Rivi uusi;
+    uusi.ensimmainenSolu = solut_.count();
+    uusi.sarakkeita = static_cast<quint16>( rivi.sarakkeita() );
+    uusi.pistekoko = static_cast<quint8>( rivi.pistekoko() );
+    uusi.tyyli = static_cast<quint8>( (rivi.onkoLihava() ? LIHAVA : 0) |
+                                      (rivi.onkoViivaa() ? VIIVA : 0) |
+                                      (rivi.kaytto() << 2) );
+
+    for( int i=0; i < rivi.sarakkeita(); i++)
+    {
+        const RaporttiRiviSarake& sarake = rivi.sarake(i);
+        Solu solu;
+        solu.liput = static_cast<quint8>( (sarake.tasaaOikealle ? OIKEALLE : 0) |
+                                          (sarake.tulostaPlus ? PLUS : 0) );
+        solu.leveys = static_cast<quint8>( sarake.leveysSaraketta );
+        solu.linkkityyppi = static_cast<quint8>( sarake.linkkityyppi );
+        solu.linkkidata = sarake.linkkidata;
+
+        if( sarake.arvo.type() == QVariant::LongLong )
+        {
+            solu.tyyppi = SENTIT;
+            solu.arvo = sarake.arvo.toLongLong();
+        }
+        else if( sarake.arvo.type() == QVariant::String )
+        {
+            solu.tyyppi = TEKSTI;
+            solu.arvo = merkkijono( sarake.arvo.toString() );
+        }
+        else
+        {
+            solu.tyyppi = TYHJA;
+            solu.arvo = 0;
+        }
+        solut_.append(solu);
+    }
+    rivit_.append(uusi);
+}
+
+RaporttiRivi::RivinKaytto RaporttiPuskuri::kaytto(int rivi) const
+{
+    return static_cast<RaporttiRivi::RivinKaytto>( rivit_.at(rivi).tyyli >> 2 );
+}
+
+QString RaporttiPuskuri::teksti(int rivi, int sarake) const
+{
+    const Solu& s = solu(rivi, sarake);
+    if( s.tyyppi == SENTIT)
+        return RaporttiRivi::rahaTekstina( s.arvo, s.liput & PLUS );
+    else if( s.tyyppi == TEKSTI)
+        return merkkijonot_.at( static_cast<int>(s.arvo) );
+    return QString();
+}
+
+QString RaporttiPuskuri::csv(int rivi, int sarake, QChar despilkku) const
+{
+    const Solu& s = solu(rivi, sarake);
+    if( s.tyyppi == SENTIT)
+        return RaporttiRivi::rahaCsv( s.arvo, despilkku);
+    else if( s.tyyppi == TEKSTI)
+        return RaporttiRivi::tekstiCsv( merkkijonot_.at( static_cast<int>(s.arvo) ));
+    return QString();
+}
+
+RaporttiRiviSarake::Linkki RaporttiPuskuri::linkkityyppi(int rivi, int sarake) const
+{
+    return static_cast<RaporttiRiviSarake::Linkki>( solu(rivi, sarake).linkkityyppi );
+}
+
+int RaporttiPuskuri::merkkijono(const QString &teksti)
+{
+    // Samat tekstit (tilien nimet, päivämäärät) talletetaan vain kerran
+    QHash<QString,int>::const_iterator iter = merkkijonoIndeksit_.constFind(teksti);
+    if( iter != merkkijonoIndeksit_.constEnd())
+        return iter.value();
+
+    int indeksi = merkkijonot_.count();
+    merkkijonot_.append(teksti);
+    merkkijonoIndeksit_.insert(teksti, indeksi);
+    return indeksi;
+}
@@ -0,0 +1,139 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef RAPORTTIPUSKURI_H
+#define RAPORTTIPUSKURI_H
+
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+#include "raporttirivi.h"
+
+class RaporttiPuskurinRivi;
+
+/**
+ * @brief Raportin rivit tiiviissä muodossa, RaportinKirjoittajan sisäiseen käyttöön
+ *
+ * Rivit lisätään RaporttiRivinä, mutta talletetaan tyypitettyinä soluina
+ * yhteen taulukkoon: rahamäärät sentteinä ja tekstit indekseinä
+ * merkkijonovarastoon, jossa kukin eri teksti on vain kerran.
+ * Rivin tyyli (lihavointi, viiva, pistekoko, käyttö) on omassa taulukossaan.
+ *
+ * Solut luetaan rivin ja sarakkeen indeksillä ilman kopiointia.
+ */
+class RaporttiPuskuri
+{
+public:
+    RaporttiPuskuri();
+
+    void lisaa(const RaporttiRivi& rivi);
+
+    int riveja() const { return rivit_.count(); }
+    bool onkoTyhja() const { return rivit_.isEmpty(); }
+
+    /**
+     * @brief Näkymä yhteen riviin
+     */
+    RaporttiPuskurinRivi rivi(int indeksi) const;
+
+    int sarakkeita(int rivi) const { return rivit_.at(rivi).sarakkeita; }
+    RaporttiRivi::RivinKaytto kaytto(int rivi) const;
+    bool onkoLihava(int rivi) const { return rivit_.at(rivi).tyyli & LIHAVA; }
+    bool onkoViivaa(int rivi) const { return rivit_.at(rivi).tyyli & VIIVA; }
+    int pistekoko(int rivi) const { return rivit_.at(rivi).pistekoko; }
+
+    QString teksti(int rivi, int sarake) const;
+    /**
+     * @brief Sarake csv-muodossa
+     * @param despilkku Rahamäärien desimaalierotin
+     */
+    QString csv(int rivi, int sarake, QChar despilkku) const;
+    int leveysSaraketta(int rivi, int sarake) const { return solu(rivi, sarake).leveys; }
+    bool tasattuOikealle(int rivi, int sarake) const { return solu(rivi, sarake).liput & OIKEALLE; }
+    RaporttiRiviSarake::Linkki linkkityyppi(int rivi, int sarake) const;
+    int linkkidata(int rivi, int sarake) const { return solu(rivi, sarake).linkkidata; }
+
+protected:
+    enum Tyyppi { TYHJA, TEKSTI, SENTIT };
+    enum SolunLiput { OIKEALLE = 0x1, PLUS = 0x2 };
+    enum RivinTyyli { LIHAVA = 0x1, VIIVA = 0x2 };
+
+    struct Solu
+    {
+        quint8 tyyppi;
+        quint8 liput;
+        quint8 leveys;
+        quint8 linkkityyppi;
+        qint32 linkkidata;
+        qint64 arvo;        /**< Sentit tai merkkijonon indeksi */
+    };
+
+    struct Rivi
+    {
+        int ensimmainenSolu;
+        quint16 sarakkeita;
+        quint8 pistekoko;
+        quint8 tyyli;       /**< RivinTyyli-liput ja käyttö */
+    };
+
+    const Solu& solu(int rivi, int sarake) const { return solut_.at( rivit_.at(rivi).ensimmainenSolu + sarake ); }
+    int merkkijono(const QString& teksti);
+
+protected:
+    QVector<Rivi> rivit_;
+    QVector<Solu> solut_;
+    QVector<QString> merkkijonot_;
+    QHash<QString,int> merkkijonoIndeksit_;
+};
+
+/**
+ * @brief Yksi puskurin rivi samoilla metodeilla kuin RaporttiRivi
+ *
+ * Kevyt näkymä, joka ei kopioi rivin tietoja
+ */
+class RaporttiPuskurinRivi
+{
+public:
+    RaporttiPuskurinRivi(const RaporttiPuskuri* puskuri, int rivi) :
+        puskuri_(puskuri), rivi_(rivi) {}
+
+    int sarakkeita() const { return puskuri_->sarakkeita(rivi_); }
+    RaporttiRivi::RivinKaytto kaytto() const { return puskuri_->kaytto(rivi_); }
+    bool onkoLihava() const { return puskuri_->onkoLihava(rivi_); }
+    bool onkoViivaa() const { return puskuri_->onkoViivaa(rivi_); }
+    int pistekoko() const { return puskuri_->pistekoko(rivi_); }
+
+    QString teksti(int sarake) const { return puskuri_->teksti(rivi_, sarake); }
+    QString csv(int sarake, QChar despilkku) const { return puskuri_->csv(rivi_, sarake, despilkku); }
+    int leveysSaraketta(int sarake) const { return puskuri_->leveysSaraketta(rivi_, sarake); }
+    bool tasattuOikealle(int sarake) const { return puskuri_->tasattuOikealle(rivi_, sarake); }
+    RaporttiRiviSarake::Linkki linkkityyppi(int sarake) const { return puskuri_->linkkityyppi(rivi_, sarake); }
+    int linkkidata(int sarake) const { return puskuri_->linkkidata(rivi_, sarake); }
+
+protected:
+    const RaporttiPuskuri* puskuri_;
+    int rivi_;
+};
+
+inline RaporttiPuskurinRivi RaporttiPuskuri::rivi(int indeksi) const
+{
+    return RaporttiPuskurinRivi(this, indeksi);
+}
+
+#endif // RAPORTTIPUSKURI_H
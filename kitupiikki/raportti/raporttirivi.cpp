@@ -62,16 +62,13 @@ void RaporttiRivi::lisaa(const QDate &pvm)
     lisaa( pvm.toString("dd.MM.yyyy"), 1, false);
 }
 
-QString RaporttiRivi::teksti(int sarake)
+QString RaporttiRivi::teksti(int sarake) const
 {
-    QVariant arvo = sarakkeet_.at(sarake).arvo;
+    const QVariant& arvo = sarakkeet_.at(sarake).arvo;
 
     if( arvo.type() == QVariant::LongLong )
     {
-        if( sarakkeet_.at(sarake).tulostaPlus && arvo.toLongLong() > 0)
-            return QString("+%L1").arg(  arvo.toLongLong()  / 100.0 ,0,'f',2 );
-
-        return QString("%L1").arg(  arvo.toLongLong()  / 100.0 ,0,'f',2 );
+        return rahaTekstina( arvo.toLongLong(), sarakkeet_.at(sarake).tulostaPlus );
     }
     else if( arvo.type() == QVariant::Date )
     {
@@ -86,17 +83,18 @@ QString RaporttiRivi::teksti(int sarake)
 
 }
 
-QString RaporttiRivi::csv(int sarake)
+QString RaporttiRivi::csv(int sarake) const
+{
+    return csv( sarake, kp()->settings()->value("CsvDesimaali", QChar(',')).toChar() );
+}
+
+QString RaporttiRivi::csv(int sarake, QChar despilkku) const
 {
-    QVariant arvo = sarakkeet_.at(sarake).arvo;
+    const QVariant& arvo = sarakkeet_.at(sarake).arvo;
 
     if( arvo.type() == QVariant::LongLong )
     {
-        QChar despilkku = kp()->settings()->value("CsvDesimaali", QChar(',')).toChar();
-        if( despilkku == ',')
-            return QString("\"%1\"").arg( arvo.toLongLong()  / 100.0 ,0,'f',2 ).replace('.',',');
-        else
-            return QString("\"%1\"").arg( arvo.toLongLong()  / 100.0 ,0,'f',2 );
+        return rahaCsv( arvo.toLongLong(), despilkku );
     }
     else if( arvo.type() == QVariant::Date )
     {
@@ -105,16 +103,35 @@ QString RaporttiRivi::csv(int sarake)
     }
     else if( arvo.type() == QVariant::String)
     {
-        QString str = arvo.toString();
-        if( str.contains(',') || str.contains('\"') || str.contains('\n') || str.contains(';') || str.contains(' ') || str.contains('\t'))
-        {
-            str.replace("\"", "\"\"");
-            return QString("\"%1\"").arg(str);
-        }
-        return arvo.toString();
+        return tekstiCsv( arvo.toString() );
     }
     else
         return QString();
 }
 
+QString RaporttiRivi::rahaTekstina(qlonglong sentit, bool tulostaPlus)
+{
+    if( tulostaPlus && sentit > 0)
+        return QString("+%L1").arg( sentit / 100.0 ,0,'f',2 );
+
+    return QString("%L1").arg( sentit / 100.0 ,0,'f',2 );
+}
+
+QString RaporttiRivi::rahaCsv(qlonglong sentit, QChar despilkku)
+{
+    if( despilkku == ',')
+        return QString("\"%1\"").arg( sentit  / 100.0 ,0,'f',2 ).replace('.',',');
+    else
+        return QString("\"%1\"").arg( sentit  / 100.0 ,0,'f',2 );
+}
 
+QString RaporttiRivi::tekstiCsv(const QString &teksti)
+{
+    if( teksti.contains(',') || teksti.contains('\"') || teksti.contains('\n') || teksti.contains(';') || teksti.contains(' ') || teksti.contains('\t'))
+    {
+        QString str = teksti;
+        str.replace("\"", "\"\"");
+        return QString("\"%1\"").arg(str);
+    }
+    return teksti;
+}
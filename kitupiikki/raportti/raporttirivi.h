@@ -20,7 +20,8 @@
 
 #include <QString>
 #include <QDate>
-#include <QList>
+#include <QVector>
+#include <QVariant>
 
 /**
  * @brief Yhden raportin sarakkeen tiedot, RaporttiRivin käyttöön
@@ -113,35 +114,43 @@ public:
      * @param sarake Sarakkeen indeksi
      * @return
      */
-    QString teksti(int sarake);
+    QString teksti(int sarake) const;
 
     /**
      * @brief Csv-muotoon tulostettava sarake
      * @param sarake Sarakkeen indeksi
      * @return
      */
-    QString csv(int sarake);
+    QString csv(int sarake) const;
+    /**
+     * @brief Csv-muotoon tulostettava sarake
+     * @param despilkku Rahamäärien desimaalierotin
+     */
+    QString csv(int sarake, QChar despilkku) const;
 
     /**
      * @brief Palauttaa sarakkeen
      * @param indeksi Sarakkeen indeksi
      * @return
      */
-    RaporttiRiviSarake sarake(int indeksi) { return sarakkeet_[indeksi]; }
+    const RaporttiRiviSarake& sarake(int indeksi) const { return sarakkeet_.at(indeksi); }
 
     /**
      * @brief Kuinka monta ruudukkosaraketta tämä sarake täyttää
      * @param sarake
      * @return
      */
-    int leveysSaraketta(int sarake) { return sarakkeet_[sarake].leveysSaraketta; }
+    int leveysSaraketta(int sarake) const { return sarakkeet_.at(sarake).leveysSaraketta; }
 
     /**
      * @brief Onko sarake tasattu oikealle
      * @param sarake
      * @return
      */
-    bool tasattuOikealle(int sarake) { return sarakkeet_[sarake].tasaaOikealle; }
+    bool tasattuOikealle(int sarake) const { return sarakkeet_.at(sarake).tasaaOikealle; }
+
+    RaporttiRiviSarake::Linkki linkkityyppi(int sarake) const { return sarakkeet_.at(sarake).linkkityyppi; }
+    int linkkidata(int sarake) const { return sarakkeet_.at(sarake).linkkidata; }
 
     /**
      * @brief Tyhjentää otsikkorivin
@@ -190,9 +199,24 @@ public:
      */
     RivinKaytto kaytto() const { return rivinKaytto_;}
 
+    /**
+     * @brief Rahamäärä tulostettavaksi tekstiksi
+     */
+    static QString rahaTekstina(qlonglong sentit, bool tulostaPlus = false);
+
+    /**
+     * @brief Rahamäärä csv-muotoon
+     * @param despilkku Desimaalierotin
+     */
+    static QString rahaCsv(qlonglong sentit, QChar despilkku);
+
+    /**
+     * @brief Teksti csv-muotoon, tarvittaessa lainausmerkeissä
+     */
+    static QString tekstiCsv(const QString& teksti);
 
 protected:
-    QList<RaporttiRiviSarake> sarakkeet_;
+    QVector<RaporttiRiviSarake> sarakkeet_;
     bool lihava_;
     bool ylaviiva_;
     int pistekoko_;
@@ -0,0 +1,298 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "raporttivirta.h"
+
+#include <QPdfWriter>
+#include <QPainter>
+#include <QFont>
+#include <QSettings>
+#include <QApplication>
+
+#include "db/kirjanpito.h"
+
+RaporttiVirta::RaporttiVirta(QIODevice *laite) :
+    laite_(laite)
+{
+
+}
+
+RaporttiVirta::~RaporttiVirta()
+{
+
+}
+
+HtmlRaporttiVirta::HtmlRaporttiVirta(QIODevice *laite, bool linkit) :
+    RaporttiVirta(laite), out_(laite), linkit_(linkit)
+{
+    out_.setCodec("UTF-8");
+}
+
+void HtmlRaporttiVirta::aloita(const RaportinKirjoittaja &raportti)
+{
+    out_ << "<html><meta charset=\"utf-8\"><title>";
+    out_ << raportti.otsikko();
+    out_ << "</title>"
+            "<style>"
+            " body { font-family: Helvetica; }"
+            " h1 { font-weight: normal; }"
+            " .lihava { font-weight: bold; } "
+            " tr.viiva td { border-top: 1px solid black; }"
+            " td.oikealle { text-align: right; } "
+            " th { text-align: left; color: darkgray;}"
+            " a { text-decoration: none; color: black; }"
+            " td { padding-right: 2em; }"
+            " td:last-of-type { padding-right: 0; }"
+            " table { border-collapse: collapse;}"
+            " p.tulostettu { margin-top:2em; color: darkgray; }"
+            " span.treeni { color: green; }"
+            "</style>";
+    out_ << otsakkeeseen_;
+    out_ << "</head><body>";
+    out_ << sivunAlkuun_;
+
+    out_ << "<h1>" << raportti.otsikko() << "</h1>";
+    out_ << "<p>" << kp()->asetukset()->asetus("Nimi") << "<br>";
+    out_ << raportti.kausiteksti() << "</p>";
+    out_ << "<table width=100%><thead>\n";
+
+    // Otsikkorivit
+    for( const RaporttiRivi& otsikkorivi : raportti.otsakkeet() )
+    {
+        if( otsikkorivi.kaytto() == RaporttiRivi::CSV)
+            continue;
+
+        out_ << "<tr>";
+        for(int i=0; i < otsikkorivi.sarakkeita(); i++)
+        {
+
+            out_ << QString("<th colspan=%1>").arg( otsikkorivi.leveysSaraketta(i));
+            out_ << otsikkorivi.teksti(i);
+            out_ << "</th>";
+        }
+        out_ << "</tr>\n";
+    }
+
+    out_ << "</thead>\n";
+}
+
+void HtmlRaporttiVirta::kirjoita(const RaporttiRivi &rivi)
+{
+    kirjoitaRivi(rivi);
+}
+
+void HtmlRaporttiVirta::kirjoita(const RaporttiPuskurinRivi &rivi)
+{
+    kirjoitaRivi(rivi);
+}
+
+void HtmlRaporttiVirta::lopeta()
+{
+    out_ << "</table>";
+    out_ << "<p class=tulostettu>Tulostettu " << QDate::currentDate().toString("dd.MM.yyyy");
+    if( kp()->onkoHarjoitus())
+        out_ << "<br><span class=treeni>Kirjanpito on laadittu Kitupiikki-ohjelman harjoittelutilassa</span>";
+
+    out_ << "</p></body></html>\n";
+    out_.flush();
+}
+
+template <class Rivi>
+void HtmlRaporttiVirta::kirjoitaRivi(const Rivi &rivi)
+{
+    if( rivi.kaytto() == RaporttiRivi::CSV)
+        return;
+
+    QStringList trluokat;
+    if( rivi.onkoLihava())
+        trluokat << "lihava";
+    if( rivi.onkoViivaa())
+        trluokat << "viiva";
+
+    if( trluokat.isEmpty())
+        out_ << "<tr>";
+    else
+        out_ << "<tr class=\"" << trluokat.join(' ') << "\">";
+
+    if( !rivi.sarakkeita())
+        out_ << "<td>&nbsp;</td>"; // Tyhjätkin rivit näkyviin!
+
+    for(int i=0; i < rivi.sarakkeita(); i++)
+    {
+
+        if( rivi.tasattuOikealle(i) )
+            out_ << QString("<td colspan=%1 class=oikealle>").arg(rivi.leveysSaraketta(i));
+        else
+            out_ << QString("<td colspan=%1>").arg(rivi.leveysSaraketta(i));
+
+        if(linkit_)
+        {
+            if( rivi.linkkityyppi(i) == RaporttiRiviSarake::TOSITE_ID)
+            {
+                // Linkki tositteeseen
+                out_ << QString("<a href=\"%1.html\">").arg( rivi.linkkidata(i) , 8, 10 , QChar('0') );
+            }
+            else if( rivi.linkkityyppi(i) == RaporttiRiviSarake::TILI_NRO)
+            {
+                // Linkki tiliin
+                out_ << QString("<a href=\"paakirja.html#%2\">").arg( rivi.linkkidata(i));
+            }
+            else if( rivi.linkkityyppi(i) == RaporttiRiviSarake::TILI_LINKKI)
+            {
+                // Nimiö dataan
+                out_ << QString("<a name=\"%1\">").arg( rivi.linkkidata(i));
+            }
+        }
+        QString tekstia = rivi.teksti(i);
+        tekstia.replace(' ', "&nbsp;");
+        tekstia.replace('\n', "<br>");
+
+        out_ << tekstia;
+
+        if( linkit_ && rivi.linkkityyppi(i) )
+            out_ << "</a>";
+
+        out_ << "&nbsp;</td>";
+    }
+    out_ << "</tr>\n";
+}
+
+CsvRaporttiVirta::CsvRaporttiVirta(QIODevice *laite) :
+    RaporttiVirta(laite)
+{
+    erotin_ = kp()->settings()->value("CsvErotin", QChar(',')).toChar();
+    despilkku_ = kp()->settings()->value("CsvDesimaali", QChar(',')).toChar();
+    latin1_ = kp()->settings()->value("CsvKoodaus").toString() == "latin1";
+}
+
+void CsvRaporttiVirta::aloita(const RaportinKirjoittaja &raportti)
+{
+    for( const RaporttiRivi& otsikko : raportti.otsakkeet())
+    {
+        if( otsikko.kaytto() == RaporttiRivi::EICSV)
+            continue;
+
+        QStringList otsakkeet;
+        for(int i=0; i < otsikko.sarakkeita(); i++)
+            otsakkeet.append( otsikko.csv(i, despilkku_));
+        kirjoitaTeksti( otsakkeet.join(erotin_));
+    }
+}
+
+void CsvRaporttiVirta::kirjoita(const RaporttiRivi &rivi)
+{
+    kirjoitaRivi(rivi);
+}
+
+void CsvRaporttiVirta::kirjoita(const RaporttiPuskurinRivi &rivi)
+{
+    kirjoitaRivi(rivi);
+}
+
+template <class Rivi>
+void CsvRaporttiVirta::kirjoitaRivi(const Rivi &rivi)
+{
+    if( rivi.kaytto() == RaporttiRivi::EICSV || !rivi.sarakkeita())
+        return;
+
+    QStringList sarakkeet;
+    for( int i=0; i < rivi.sarakkeita(); i++)
+        sarakkeet.append( rivi.csv(i, despilkku_));
+
+    kirjoitaTeksti( "\r\n" + sarakkeet.join(erotin_));
+}
+
+void CsvRaporttiVirta::kirjoitaTeksti(QString teksti)
+{
+    if( latin1_ )
+    {
+        teksti.replace("€","EUR");
+        laite_->write( teksti.toLatin1() );
+    }
+    else
+        laite_->write( teksti.toUtf8() );
+}
+
+PdfRaporttiVirta::PdfRaporttiVirta(QIODevice *laite, bool raidoita, bool kaytaA4) :
+    RaporttiVirta(laite), raidoita_(raidoita), kaytaA4_(kaytaA4)
+{
+
+}
+
+PdfRaporttiVirta::~PdfRaporttiVirta()
+{
+    delete painter_;
+    delete writer_;
+}
+
+void PdfRaporttiVirta::aloita(const RaportinKirjoittaja &raportti)
+{
+    raportti_ = &raportti;
+
+    writer_ = new QPdfWriter( laite_ );
+    writer_->setCreator( QString("Kitupiikki %1").arg( qApp->applicationVersion() ) );
+    writer_->setTitle( raportti.otsikko() );
+
+    if( kaytaA4_ )
+        writer_->setPageSize( QPdfWriter::A4 );
+    else
+        writer_->setPageLayout( kp()->printer()->pageLayout() );
+    writer_->setResolution( kp()->printer()->resolution() );
+
+    painter_ = new QPainter( writer_ );
+
+    int pienennys = raportti.sarakkeita() > 4 && writer_->pageSizeMM().width() < 300 ? 2 : 0;
+    painter_->setFont( QFont("Sans", 10 - pienennys ) );
+    raportti.aloitaAsettelu( painter_, pienennys, asettelu_);
+}
+
+void PdfRaporttiVirta::kirjoita(const RaporttiRivi &rivi)
+{
+    kirjoitaRivi(rivi);
+}
+
+void PdfRaporttiVirta::kirjoita(const RaporttiPuskurinRivi &rivi)
+{
+    kirjoitaRivi(rivi);
+}
+
+void PdfRaporttiVirta::lopeta()
+{
+    painter_->end();
+}
+
+template <class Rivi>
+void PdfRaporttiVirta::kirjoitaRivi(const Rivi &rivi)
+{
+    // Asettelussa pidetään vain tämä rivi
+    asettelu_.rivit.clear();
+    asettelu_.laatikot.clear();
+    asettelu_.liput.clear();
+
+    bool uusiSivu = raportti_->asetteleRivi( painter_, rivi, 0, asettelu_);
+    if( asettelu_.rivit.isEmpty())
+        return;     // Vain csv-rivi
+
+    if( uusiSivu )
+    {
+        if( asettelu_.sivut.count() > 1)
+            writer_->newPage();
+        raportti_->tulostaSivunAlku( painter_, asettelu_.sivut.count(), asettelu_);
+    }
+    raportti_->tulostaRivi( painter_, rivi, asettelu_.rivit.last(), asettelu_, raidoita_);
+}
@@ -0,0 +1,148 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef RAPORTTIVIRTA_H
+#define RAPORTTIVIRTA_H
+
+#include <QIODevice>
+#include <QTextStream>
+
+#include "raportinkirjoittaja.h"
+
+class QPdfWriter;
+class QPainter;
+
+/**
+ * @brief Raportin kirjoittaminen suoraan laitteeseen rivi kerrallaan
+ *
+ * RaportinKirjoittaja antaa virralle otsikkotiedot ennen ensimmäistä riviä,
+ * ja sen jälkeen jokainen lisätty rivi kirjoitetaan heti eteenpäin.
+ * Näin suurenkaan raportin rivejä ei tarvitse pitää muistissa.
+ *
+ * @see RaportinKirjoittaja::asetaVirta()
+ */
+class RaporttiVirta
+{
+public:
+    RaporttiVirta(QIODevice* laite);
+    virtual ~RaporttiVirta();
+
+    /**
+     * @brief Kirjoittaa raportin alun
+     * @param raportti Raportti, jonka otsikko, sarakkeet ja otsakkeet on asetettu
+     */
+    virtual void aloita(const RaportinKirjoittaja& raportti) = 0;
+
+    virtual void kirjoita(const RaporttiRivi& rivi) = 0;
+    virtual void kirjoita(const RaporttiPuskurinRivi& rivi) = 0;
+
+    /**
+     * @brief Kirjoittaa raportin lopun
+     */
+    virtual void lopeta() = 0;
+
+protected:
+    QIODevice* laite_;
+};
+
+/**
+ * @brief Raportti html-muodossa
+ */
+class HtmlRaporttiVirta : public RaporttiVirta
+{
+public:
+    HtmlRaporttiVirta(QIODevice* laite, bool linkit = false);
+
+    /**
+     * @brief Lisää html:ää sivun head-osaan, esim. tyylitiedoston
+     */
+    void lisaaOtsakkeeseen(const QString& html) { otsakkeeseen_ = html; }
+    /**
+     * @brief Lisää html:ää heti body-elementin alkuun, esim. navigointipalkin
+     */
+    void lisaaSivunAlkuun(const QString& html) { sivunAlkuun_ = html; }
+
+    void aloita(const RaportinKirjoittaja& raportti) override;
+    void kirjoita(const RaporttiRivi& rivi) override;
+    void kirjoita(const RaporttiPuskurinRivi& rivi) override;
+    void lopeta() override;
+
+protected:
+    template <class Rivi> void kirjoitaRivi(const Rivi& rivi);
+
+    QTextStream out_;
+    bool linkit_;
+    QString otsakkeeseen_;
+    QString sivunAlkuun_;
+};
+
+/**
+ * @brief Raportti csv-muodossa
+ *
+ * Erotin, desimaalipilkku ja merkistö otetaan asetuksista
+ */
+class CsvRaporttiVirta : public RaporttiVirta
+{
+public:
+    CsvRaporttiVirta(QIODevice* laite);
+
+    void aloita(const RaportinKirjoittaja& raportti) override;
+    void kirjoita(const RaporttiRivi& rivi) override;
+    void kirjoita(const RaporttiPuskurinRivi& rivi) override;
+    void lopeta() override {}
+
+protected:
+    template <class Rivi> void kirjoitaRivi(const Rivi& rivi);
+    void kirjoitaTeksti(QString teksti);
+
+    QChar erotin_;
+    QChar despilkku_;
+    bool latin1_;
+};
+
+/**
+ * @brief Raportti sivutettuna pdf:nä
+ *
+ * Jokainen rivi asetellaan ja piirretään heti, ja valmiit sivut
+ * kirjoitetaan laitteeseen sivu kerrallaan.
+ */
+class PdfRaporttiVirta : public RaporttiVirta
+{
+public:
+    PdfRaporttiVirta(QIODevice* laite, bool raidoita = false, bool kaytaA4 = false);
+    ~PdfRaporttiVirta() override;
+
+    void aloita(const RaportinKirjoittaja& raportti) override;
+    void kirjoita(const RaporttiRivi& rivi) override;
+    void kirjoita(const RaporttiPuskurinRivi& rivi) override;
+    void lopeta() override;
+
+    int sivuja() const { return asettelu_.sivut.count(); }
+
+protected:
+    template <class Rivi> void kirjoitaRivi(const Rivi& rivi);
+
+    bool raidoita_;
+    bool kaytaA4_;
+    const RaportinKirjoittaja* raportti_ = nullptr;
+    QPdfWriter* writer_ = nullptr;
+    QPainter* painter_ = nullptr;
+    RaportinAsettelu asettelu_;
+};
+
+#endif // RAPORTTIVIRTA_H
@@ -21,6 +21,63 @@
 
 #include <QDebug>
 
+namespace {
+
+/**
+ * @brief Tilin id:n mukaan järjestetyn kyselyn läpikäynti
+ *
+ * Tilit käsitellään id-järjestyksessä, joten kunkin tilin rivit saadaan
+ * yhteisestä kyselystä siirtymällä eteenpäin.
+ */
+class TiliKursori
+{
+public:
+    TiliKursori(const QString& kysymys)
+    {
+        kysely_.setForwardOnly(true);
+        onko_ = !kysymys.isEmpty() && kysely_.exec(kysymys) && kysely_.next();
+    }
+
+    /**
+     * @brief Onko nykyinen rivi tämän tilin (ensimmäinen sarake), ohittaa aiempien tilien rivit
+     */
+    bool tilille(int tiliId)
+    {
+        while( onko_ && kysely_.value(0).toInt() < tiliId)
+            onko_ = kysely_.next();
+        return onko_ && kysely_.value(0).toInt() == tiliId;
+    }
+
+    void seuraava() { onko_ = kysely_.next(); }
+    QVariant arvo(const QString& nimi) const { return kysely_.value(nimi); }
+
+private:
+    QSqlQuery kysely_;
+    bool onko_ = false;
+};
+
+/**
+ * @brief Tase-erän tapahtuma erittelyä varten
+ */
+struct EranTapahtuma
+{
+    int tositeId;
+    QString tunniste;
+    QDate pvm;
+    QString selite;
+    qlonglong muutos;
+    bool eranAloitus;
+};
+
+QString tositetunniste(const QVariant& laji, const QVariant& tunniste, const QDate& pvm)
+{
+    return QString("%1%2/%3").arg( kp()->tositelajit()->tositelaji( laji.toInt() ).tunnus() )
+            .arg( tunniste.toInt())
+            .arg( kp()->tilikaudet()->tilikausiPaivalle( pvm ).kausitunnus() );
+}
+
+}
+
 TaseErittely::TaseErittely() :
     Raportti(nullptr)
 {
@@ -85,6 +142,57 @@ RaportinKirjoittaja TaseErittely::kirjoitaRaportti(QDate mista, QDate mihin)
     QList<int> tiliIdt = tiliSet.toList();
     qSort( tiliIdt );
 
+    // Saldot ja tapahtumien määrät haetaan kaikille tileille kerralla
+    Tili tulostili = kp()->tilit()->tiliTyypilla(TiliLaji::KAUDENTULOS);
+    QHash<int,qlonglong> loppusaldot = kp()->tilit()->saldot( mihin, tiliIdt );
+    QHash<int,qlonglong> alkusaldot = kp()->tilit()->saldot( mista.addDays(-1), tiliIdt );
+
+    QHash<int,int> tapahtumia;
+    kysely.exec( QString("SELECT tili, count(id) FROM vienti WHERE pvm BETWEEN '%1' AND '%2' GROUP BY tili")
+                 .arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate)));
+    while( kysely.next())
+        tapahtumia.insert( kysely.value(0).toInt(), kysely.value(1).toInt());
+
+    // Tilien tapahtumat ja tase-erät haetaan kaikille tileille yhteisillä kyselyillä
+    QStringList muutostilit;
+    QStringList eratilit;
+    for( int tiliId : tiliIdt)
+    {
+        Tili tili = kp()->tilit()->tiliIdlla(tiliId);
+        if( tili.taseErittelyTapa() == Tili::TASEERITTELY_MUUTOKSET)
+            muutostilit.append( QString::number(tiliId));
+        else if( tili.taseErittelyTapa() == Tili::TASEERITTELY_TAYSI)
+            eratilit.append( QString::number(tiliId));
+    }
+
+    const QString valilta = QString("BETWEEN '%1' AND '%2'").arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate));
+
+    TiliKursori muutokset( muutostilit.isEmpty() ? QString() :
+        QString("SELECT vienti.tili, tosite.laji, tosite.tunniste, vienti.pvm, vienti.selite, debetsnt, kreditsnt, tosite.id AS tositeId "
+                "FROM vienti, tosite, tositelaji, kohdennus WHERE vienti.tosite=tosite.id AND tosite.laji=tositelaji.id AND "
+                "vienti.kohdennus=kohdennus.id AND vienti.tili IN (%1) AND vienti.pvm %2 "
+                "ORDER BY vienti.tili, vienti.pvm").arg( muutostilit.join(",") ).arg( valilta ));
+
+    // Tase-erien saldot ennen kautta
+    QHash<int,qlonglong> eraAlkusaldot;
+    TiliKursori eraKursori( eratilit.isEmpty() ? QString() :
+        QString("SELECT vienti.tili, vienti.id, debetsnt, kreditsnt, vienti.pvm, selite, laji, tunniste from vienti, tosite "
+                "where tili IN (%1) and vienti.tosite=tosite.id and eraid=vienti.id order by vienti.tili, vienti.pvm")
+                .arg( eratilit.join(",")));
+    TiliKursori eranTapahtumat( eratilit.isEmpty() ? QString() :
+        QString("SELECT era.tili, vienti.eraid, vienti.id, vienti.pvm, vienti.selite, vienti.debetsnt, vienti.kreditsnt, "
+                "tosite.id AS tositeId, tosite.laji, tosite.tunniste FROM vienti, vienti AS era, tosite "
+                "WHERE vienti.eraid=era.id AND vienti.tosite=tosite.id AND era.tili IN (%1) AND vienti.pvm %2 "
+                "ORDER BY era.tili, vienti.eraid, vienti.pvm").arg( eratilit.join(",")).arg(valilta));
+    if( !eratilit.isEmpty())
+    {
+        kysely.exec(QString("SELECT eraid, sum(debetsnt) as debetit, sum(kreditsnt) as kreditit from vienti "
+                            "where tili IN (%1) and eraid is not null and pvm < '%2' group by eraid")
+                    .arg(eratilit.join(",")).arg(mista.toString(Qt::ISODate)));
+        while( kysely.next())
+            eraAlkusaldot.insert( kysely.value("eraid").toInt(), kysely.value("debetit").toLongLong() - kysely.value("kreditit").toLongLong());
+    }
+
     long edYsiluku = 0;
 
     foreach (int tiliId, tiliIdt)
@@ -92,7 +200,7 @@ RaportinKirjoittaja TaseErittely::kirjoitaRaportti(QDate mista, QDate mihin)
         Tili tili = kp()->tilit()->tiliIdlla(tiliId);
 
         // Ohitetaan tyhjät/tapahtumattomat tilit
-        if( !tili.saldoPaivalle(mihin))
+        if( !loppusaldot.value(tiliId))
         {
             if(tili.taseErittelyTapa() == Tili::TASEERITTELY_SALDOT || tili.taseErittelyTapa() == Tili::TASEERITTELY_LISTA )
             {
@@ -101,11 +209,8 @@ RaportinKirjoittaja TaseErittely::kirjoitaRaportti(QDate mista, QDate mihin)
             else
             {
                 // Jos täysi tai muutos-tapahtumaerittely, niin ohitetaan jos ei myöskään tapahtumia
-                QSqlQuery tapahtumakysely( QString("SELECT count(id) from vienti where tili=%1 and pvm between '%2' and '%3")
-                                           .arg(tiliId).arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate)));
-                if( tapahtumakysely.next())
-                    if(!tapahtumakysely.value(0).toInt())
-                        continue;
+                if( !tapahtumia.value(tiliId))
+                    continue;
             }
         }
 
@@ -130,7 +235,7 @@ RaportinKirjoittaja TaseErittely::kirjoitaRaportti(QDate mista, QDate mihin)
             RaporttiRivi rr;
             rr.lisaaLinkilla( RaporttiRiviSarake::TILI_NRO, tili.numero(), QString("%1 %2").arg(tili.numero()).arg(tili.nimi()), 3 );
 
-            rr.lisaa( tili.saldoPaivalle( mihin ), true);
+            rr.lisaa( loppusaldot.value(tiliId), true);
             rr.lihavoi();
             rk.lisaaRivi(rr);
 
@@ -163,21 +268,20 @@ RaportinKirjoittaja TaseErittely::kirjoitaRaportti(QDate mista, QDate mihin)
             {
 
                 // Alkusaldo
-                qlonglong alkusaldo = tili.saldoPaivalle( mista.addDays(-1));
+                qlonglong alkusaldo = alkusaldot.value(tiliId);
                 if( alkusaldo )
                 {
                     RaporttiRivi ekaRivi;
                     ekaRivi.lisaa( "", 2);
                     ekaRivi.lisaa("Alkusaldo");
-                    ekaRivi.lisaa( tili.saldoPaivalle( mista.addDays(-1) ), true);
+                    ekaRivi.lisaa( alkusaldo, true);
                     rk.lisaaRivi( ekaRivi);
                 }
 
                 // #318 Edellisten tilikausien tulokseen tulee tilinavauksen yhteydessä vielä edellisen tilikauden tulos
                 if( tili.onko(TiliLaji::EDELLISTENTULOS))
                 {
-                    Tili tulostili = kp()->tilit()->tiliTyypilla(TiliLaji::KAUDENTULOS);
-                    qlonglong edellinentulos = tulostili.saldoPaivalle( mista.addDays(-1) );
+                    qlonglong edellinentulos = alkusaldot.value( tulostili.id() );
                     if( edellinentulos )
                     {
                         RaporttiRivi edellinenTulosRivi;
@@ -190,22 +294,18 @@ RaportinKirjoittaja TaseErittely::kirjoitaRaportti(QDate mista, QDate mihin)
                 }
 
                 // Muutokset
-                kysely.exec(QString("SELECT tositelaji,tunniste,pvm,selite,debetsnt,kreditsnt,tositeId from vientivw where tilinro=%1 and "
-                            "pvm between \"%2\" and \"%3\" order by pvm")
-                            .arg(tili.numero()).arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate)) );
-
-                while( kysely.next() )
+                for( ; muutokset.tilille(tiliId); muutokset.seuraava())
                 {
+                    QDate pvm = muutokset.arvo("pvm").toDate();
                     RaporttiRivi rr;
-                    rr.lisaaLinkilla(RaporttiRiviSarake::TOSITE_ID, kysely.value("tositeId").toInt(),
-                                     QString("%1%2/%3").arg( kysely.value("tositelaji").toString()).arg(kysely.value("tunniste").toInt())
-                                     .arg( kp()->tilikaudet()->tilikausiPaivalle( kysely.value("pvm").toDate() ).kausitunnus() ) );
-                    rr.lisaa( kysely.value("pvm").toDate());
-                    rr.lisaa(kysely.value("selite").toString());
+                    rr.lisaaLinkilla(RaporttiRiviSarake::TOSITE_ID, muutokset.arvo("tositeId").toInt(),
+                                     tositetunniste( muutokset.arvo("laji"), muutokset.arvo("tunniste"), pvm) );
+                    rr.lisaa( pvm );
+                    rr.lisaa( muutokset.arvo("selite").toString());
                     if( tili.onko(TiliLaji::VASTAAVAA))
-                        rr.lisaa( kysely.value("debetsnt").toLongLong() - kysely.value("kreditsnt").toLongLong());
+                        rr.lisaa( muutokset.arvo("debetsnt").toLongLong() - muutokset.arvo("kreditsnt").toLongLong());
                     else
-                        rr.lisaa( kysely.value("kreditsnt").toLongLong() - kysely.value("debetsnt").toLongLong());
+                        rr.lisaa( muutokset.arvo("kreditsnt").toLongLong() - muutokset.arvo("debetsnt").toLongLong());
                     rk.lisaaRivi(rr);
                 }
 
@@ -236,66 +336,42 @@ RaportinKirjoittaja TaseErittely::kirjoitaRaportti(QDate mista, QDate mihin)
             else if( tili.taseErittelyTapa() == Tili::TASEERITTELY_TAYSI)
             {
                 // Tulostetaan tase-erät, joilla saldoa alkupäivällä tai tapahtumia tilikauden aikana
+                int etumerkki = tili.onko(TiliLaji::VASTATTAVAA) ? -1 : 1;
 
-                // EraId,SaldoSnt
-                QHash<int,qlonglong> alkusaldot;
-
-                // Alkusaldot
-                kysely.exec(QString("SELECT eraid, sum(debetsnt) as debetit, sum(kreditsnt) as kreditit from vienti "
-                                   "where tili=%1 and eraid is not null and pvm < \"%2\" group by eraid")
-                           .arg(tili.id()).arg(mista.toString(Qt::ISODate)));
-
-
-                // Tallennetaan saldotaulukkoon tilien eräsaldot
-                while( kysely.next() )
+                // Kerätään tilin tase-erien kauden tapahtumat erittäin
+                QHash<int, QList<EranTapahtuma>> tapahtumat;
+                for( ; eranTapahtumat.tilille(tiliId); eranTapahtumat.seuraava())
                 {
-                    if( tili.onko(TiliLaji::VASTATTAVAA))
-                         alkusaldot.insert( kysely.value("eraid").toInt(), kysely.value("kreditit").toLongLong() - kysely.value("debetit").toLongLong() );
+                    EranTapahtuma tapahtuma;
+                    tapahtuma.tositeId = eranTapahtumat.arvo("tositeId").toInt();
+                    tapahtuma.pvm = eranTapahtumat.arvo("pvm").toDate();
+                    tapahtuma.tunniste = tositetunniste( eranTapahtumat.arvo("laji"), eranTapahtumat.arvo("tunniste"), tapahtuma.pvm);
+                    tapahtuma.selite = eranTapahtumat.arvo("selite").toString();
+                    tapahtuma.eranAloitus = eranTapahtumat.arvo("id").toInt() == eranTapahtumat.arvo("eraid").toInt();
+                    if( tili.onko(TiliLaji::VASTAAVAA))
+                        tapahtuma.muutos = eranTapahtumat.arvo("debetsnt").toLongLong() - eranTapahtumat.arvo("kreditsnt").toLongLong();
                     else
-                        alkusaldot.insert( kysely.value("eraid").toInt(), kysely.value("debetit").toLongLong() - kysely.value("kreditit").toLongLong() );
+                        tapahtuma.muutos = eranTapahtumat.arvo("kreditsnt").toLongLong() - eranTapahtumat.arvo("debetsnt").toLongLong();
+                    tapahtumat[ eranTapahtumat.arvo("eraid").toInt() ].append(tapahtuma);
                 }
 
-                // Sitten haetaan tase-erän tiedot
-                kysely.exec(QString("SELECT vienti.id, debetsnt, kreditsnt, vienti.pvm, selite, laji, tunniste from vienti, tosite "
-                           "where tili=%1 and vienti.tosite=tosite.id and eraid=vienti.id order by vienti.pvm")
-                           .arg(tili.id()));
-
-                while( kysely.next())
+                for( ; eraKursori.tilille(tiliId); eraKursori.seuraava())
                 {
-                    rk.lisaaRivi();
-
-                    int eraId = kysely.value("id").toInt();
-
-                    qlonglong alkusnt = kysely.value("debetsnt").toLongLong() - kysely.value("kreditsnt").toLongLong();
-                    if( tili.onko(TiliLaji::VASTATTAVAA))
-                        alkusnt = 0 - alkusnt;
+                    int eraId = eraKursori.arvo("id").toInt();
 
+                    qlonglong alkusnt = etumerkki * ( eraKursori.arvo("debetsnt").toLongLong() - eraKursori.arvo("kreditsnt").toLongLong() );
 
-                    // Tarkistetaan, jos tase-erä jäänyt tyhjäksi
-                    qlonglong saldo = alkusaldot.value(eraId);
-
-                    if( !saldo )
-                    {
-                        QSqlQuery takysely;
-                        takysely.exec( QString("SELECT count(id) FROM vienti WHERE eraid=%1 AND pvm BETWEEN '%2' AND '%3'")
-                                       .arg( eraId )
-                                       .arg( mista.toString(Qt::ISODate) )
-                                       .arg( mihin.toString( Qt::ISODate)) );
-                        qDebug() << takysely.lastQuery();
-                        if( takysely.next() && !takysely.value(0).toInt())
-                            continue;
-                    }
+                    // Ohitetaan tase-erä, joka on jäänyt tyhjäksi eikä sillä ole tapahtumia kaudella
+                    qlonglong saldo = etumerkki * eraAlkusaldot.value(eraId);
+                    if( !saldo && !tapahtumat.contains(eraId))
+                        continue;
 
+                    rk.lisaaRivi();
 
                     RaporttiRivi nimirivi;
-                    QString tunniste = QString("%1%2/%3")
-                            .arg( kp()->tositelajit()->tositelaji( kysely.value("laji").toInt() ).tunnus() )
-                            .arg( kysely.value("tunniste").toInt())
-                            .arg( kp()->tilikaudet()->tilikausiPaivalle( kysely.value("vienti.pvm").toDate() ).kausitunnus()  );
-
-                    nimirivi.lisaa(tunniste);
-                    nimirivi.lisaa( kysely.value("pvm").toDate());
-                    nimirivi.lisaa( kysely.value("selite").toString());
+                    nimirivi.lisaa( tositetunniste( eraKursori.arvo("laji"), eraKursori.arvo("tunniste"), eraKursori.arvo("pvm").toDate()) );
+                    nimirivi.lisaa( eraKursori.arvo("pvm").toDate());
+                    nimirivi.lisaa( eraKursori.arvo("selite").toString());
                     nimirivi.lisaa( alkusnt);
                     rk.lisaaRivi(nimirivi);
 
@@ -321,28 +397,18 @@ RaportinKirjoittaja TaseErittely::kirjoitaRaportti(QDate mista, QDate mihin)
                         saldo = alkusnt;
 
                     // Muutokset
-                    QSqlQuery muKysely;
-                    muKysely.exec(QString("SELECT tositelaji,tunniste,pvm,selite,debetsnt,kreditsnt,tositeId from vientivw where eraid=%1 and "
-                                "vientiId<>eraid and  pvm between \"%2\" and \"%3\" order by pvm")
-                                .arg( eraId ).arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate)) );
-
-                    while( muKysely.next() )
+                    for( const EranTapahtuma& tapahtuma : tapahtumat.value(eraId))
                     {
-                        RaporttiRivi rr;
-                        qlonglong muutos = 0;
-                        if( tili.onko(TiliLaji::VASTAAVAA))
-                            muutos =  muKysely.value("debetsnt").toLongLong() - muKysely.value("kreditsnt").toLongLong();
-                        else
-                            muutos =  muKysely.value("kreditsnt").toLongLong() - muKysely.value("debetsnt").toLongLong();
-                        saldo += muutos;
+                        if( tapahtuma.eranAloitus )
+                            continue;
 
-                        rr.lisaaLinkilla(RaporttiRiviSarake::TOSITE_ID, muKysely.value("tositeId").toInt(),
-                                         QString("%1%2/%3").arg( muKysely.value("tositelaji").toString()).arg(muKysely.value("tunniste").toInt())
-                                                            .arg( kp()->tilikaudet()->tilikausiPaivalle( muKysely.value("pvm").toDate() ).kausitunnus() ));
+                        saldo += tapahtuma.muutos;
 
-                        rr.lisaa( muKysely.value("pvm").toDate());
-                        rr.lisaa( muKysely.value("selite").toString());
-                        rr.lisaa( muutos);
+                        RaporttiRivi rr;
+                        rr.lisaaLinkilla(RaporttiRiviSarake::TOSITE_ID, tapahtuma.tositeId, tapahtuma.tunniste);
+                        rr.lisaa( tapahtuma.pvm );
+                        rr.lisaa( tapahtuma.selite );
+                        rr.lisaa( tapahtuma.muutos );
 
                         rk.lisaaRivi(rr);
                     }
@@ -362,7 +428,7 @@ RaportinKirjoittaja TaseErittely::kirjoitaRaportti(QDate mista, QDate mihin)
             RaporttiRivi vikaRivi;
             vikaRivi.lisaa("", 2);
             vikaRivi.lisaa(tr("Tilin %1 loppusaldo").arg(tili.numero()));
-            vikaRivi.lisaa( tili.saldoPaivalle(mihin), true);
+            vikaRivi.lisaa( loppusaldot.value(tiliId), true);
             vikaRivi.lihavoi();
             vikaRivi.viivaYlle();
             rk.lisaaRivi( vikaRivi );
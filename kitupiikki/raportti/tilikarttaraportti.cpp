@@ -141,6 +141,14 @@ RaportinKirjoittaja TilikarttaRaportti::kirjoitaRaportti(TilikarttaRaportti::Kar
 
 
 
+    // Saldot lasketaan kaikille tileille kerralla
+    QHash<int,qlonglong> saldot;
+    if( saldopvm.isValid())
+        saldot = kp()->tilit()->saldot( saldopvm );
+    QHash<int,qlonglong> alkusaldot;
+    if( valinta == KIRJATUT_TILIT )
+        alkusaldot = kp()->tilit()->saldot( tilikaudelta.alkaa() );
+
     for( int i=0; i < kp()->tilit()->rowCount(QModelIndex()); i++)
     {
         RaporttiRivi rr(RaporttiRivi::EICSV);
@@ -159,7 +167,7 @@ RaportinKirjoittaja TilikarttaRaportti::kirjoitaRaportti(TilikarttaRaportti::Kar
             if( tili.onko(TiliLaji::TASE)  )
             {
                 // Tasetili luetellaan myös, jos sillä tilikauden alussa saldoa
-                if( !tiliIdtKaytossa.contains(tili.id()) && !tili.saldoPaivalle( tilikaudelta.alkaa() ))
+                if( !tiliIdtKaytossa.contains(tili.id()) && !alkusaldot.value( tili.id() ))
                     continue;
             }
             else
@@ -216,8 +224,8 @@ RaportinKirjoittaja TilikarttaRaportti::kirjoitaRaportti(TilikarttaRaportti::Kar
             }
             if( saldopvm.isValid())
             {
-                rr.lisaa( tili.saldoPaivalle(saldopvm));
-                csvr.lisaa( tili.saldoPaivalle(saldopvm));
+                rr.lisaa( saldot.value( tili.id() ));
+                csvr.lisaa( saldot.value( tili.id() ));
             }
         }
         if( kirjausohjeet )
@@ -59,6 +59,12 @@ RaportinKirjoittaja TositeluetteloRaportti::raportti()
 RaportinKirjoittaja TositeluetteloRaportti::kirjoitaRaportti(QDate mista, QDate mihin, bool tositejarjestys, bool ryhmittelelajeittain, bool tulostakohdennukset, bool tulostaviennit, bool tulostasummat)
 {
     RaportinKirjoittaja kirjoittaja;
+    kirjoitaRaportti(kirjoittaja, mista, mihin, tositejarjestys, ryhmittelelajeittain, tulostakohdennukset, tulostaviennit, tulostasummat);
+    return kirjoittaja;
+}
+
+void TositeluetteloRaportti::kirjoitaRaportti(RaportinKirjoittaja &kirjoittaja, QDate mista, QDate mihin, bool tositejarjestys, bool ryhmittelelajeittain, bool tulostakohdennukset, bool tulostaviennit, bool tulostasummat)
+{
 
     if( tulostaviennit)
         kirjoittaja.asetaOtsikko("TOSITEPÄIVÄKIRJA");
@@ -102,19 +108,44 @@ RaportinKirjoittaja TositeluetteloRaportti::kirjoitaRaportti(QDate mista, QDate
 
     // Sitten kysellään
 
-    QString jarjestys = "pvm, id";
+    // Järjestys päättyy aina id:hen, jotta tositteet ja viennit ovat samassa järjestyksessä
+    QString jarjestys = "tosite.pvm, tosite.id";
     if( tositejarjestys )
-        jarjestys = "laji, tunniste";
+        jarjestys = "tosite.laji, tosite.tunniste, tosite.id";
     else if( ryhmittelelajeittain )
-        jarjestys = "laji, pvm, id";
+        jarjestys = "tosite.laji, tosite.pvm, tosite.id";
 
-    QString kysymys = QString("SELECT id, pvm, otsikko, tunniste, laji FROM tosite "
-                              "WHERE pvm BETWEEN \"%1\" AND \"%2\" ORDER BY %3")
+    QString tositteet = QString("SELECT id FROM tosite WHERE pvm BETWEEN '%1' AND '%2'")
             .arg(mista.toString(Qt::ISODate))
-            .arg(mihin.toString(Qt::ISODate))
+            .arg(mihin.toString(Qt::ISODate));
+
+    // Tositteiden summat ja liitteiden määrät haetaan samalla kyselyllä
+    QString kysymys = QString("SELECT tosite.id, tosite.pvm, tosite.otsikko, tosite.tunniste, tosite.laji, "
+                              "summat.debetit, summat.kreditit, liitteet.liitteita FROM tosite "
+                              "LEFT OUTER JOIN (SELECT tosite, SUM(debetsnt) AS debetit, SUM(kreditsnt) AS kreditit "
+                              "FROM vienti WHERE tosite IN (%1) GROUP BY tosite) AS summat ON summat.tosite=tosite.id "
+                              "LEFT OUTER JOIN (SELECT tosite, COUNT(liiteno) AS liitteita "
+                              "FROM liite WHERE tosite IN (%1) GROUP BY tosite) AS liitteet ON liitteet.tosite=tosite.id "
+                              "WHERE tosite.id IN (%1) ORDER BY %2")
+            .arg(tositteet)
             .arg(jarjestys);
 
-    QSqlQuery kysely(kysymys);
+    QSqlQuery kysely;
+    kysely.setForwardOnly(true);
+    kysely.exec(kysymys);
+
+    // Viennit käydään läpi samassa järjestyksessä tositteiden kanssa
+    QSqlQuery viennit;
+    bool vientejaJaljella = false;
+    if( tulostaviennit )
+    {
+        viennit.setForwardOnly(true);
+        viennit.exec( QString("SELECT vienti.tosite, vienti.pvm, vienti.tili, vienti.kohdennus, vienti.selite, "
+                              "vienti.debetsnt, vienti.kreditsnt FROM vienti, tosite "
+                              "WHERE vienti.tosite=tosite.id AND tosite.id IN (%1) ORDER BY %2, vienti.id")
+                      .arg(tositteet).arg(jarjestys));
+        vientejaJaljella = viennit.next();
+    }
 
     int edellinenTositelajiId = -1;
     qlonglong debetYht = 0;
@@ -129,7 +160,7 @@ RaportinKirjoittaja TositeluetteloRaportti::kirjoitaRaportti(QDate mista, QDate
         QDate tositePvm = kysely.value("pvm").toDate();
         QString otsikko = kysely.value("otsikko").toString();
         int tunniste = kysely.value("tunniste").toInt();
-        Tositelaji laji = kp()->tositelajit()->tositelaji( kysely.value("laji").toInt());
+        const Tositelaji& laji = kp()->tositelajit()->tositelaji( kysely.value("laji").toInt());
 
         if( ryhmittelelajeittain && edellinenTositelajiId != laji.id())
         {
@@ -158,12 +189,10 @@ RaportinKirjoittaja TositeluetteloRaportti::kirjoitaRaportti(QDate mista, QDate
 
         // Tässä välissä tositelajikohtaisia toimia...
 
-        QSqlQuery lisakysely( QString("SELECT SUM(debetsnt), SUM(kreditsnt) FROM vienti WHERE tosite=%1 ").arg(tositeId));
-        if( lisakysely.next())
         {
             // Tositteen summa: debet ja kredit yleensä yhtä suuret :)
-            debetSumma = lisakysely.value(0).toLongLong();
-            kreditSumma = lisakysely.value(1).toLongLong();
+            debetSumma = kysely.value("debetit").toLongLong();
+            kreditSumma = kysely.value("kreditit").toLongLong();
             if( kreditSumma > debetSumma)
                 summa = kreditSumma;
             else
@@ -185,11 +214,7 @@ RaportinKirjoittaja TositeluetteloRaportti::kirjoitaRaportti(QDate mista, QDate
 
         }
 
-        lisakysely.exec( QString("SELECT COUNT(liiteno) FROM liite WHERE tosite=%1").arg(tositeId));
-        if( lisakysely.next())
-        {
-            liitteita = lisakysely.value(0).toInt();
-        }
+        liitteita = kysely.value("liitteita").toInt();
 
         RaporttiRivi tositerivi;
         tositerivi.lisaaLinkilla( RaporttiRiviSarake::TOSITE_ID, tositeId,
@@ -212,31 +237,28 @@ RaportinKirjoittaja TositeluetteloRaportti::kirjoitaRaportti(QDate mista, QDate
         if( tulostaviennit)
         {
 
-            lisakysely.exec(QString("SELECT pvm, tili, kohdennus, selite, debetsnt, kreditsnt "
-                                    "FROM vienti WHERE tosite=%1 ORDER BY id")
-                            .arg(tositeId));
-            while( lisakysely.next())
+            for( ; vientejaJaljella && viennit.value("tosite").toInt() == tositeId; vientejaJaljella = viennit.next())
             {
-                if( !lisakysely.value("tili").toInt())
+                if( !viennit.value("tili").toInt())
                     continue;   // Ei tulosteta maksuperusteisen laskun lisärivejä
 
                 RaporttiRivi vientirivi;
                 vientirivi.lisaa("");
-                vientirivi.lisaa( lisakysely.value("pvm").toDate() );
-                Tili tili = kp()->tilit()->tiliIdlla( lisakysely.value("tili").toInt());
+                vientirivi.lisaa( viennit.value("pvm").toDate() );
+                Tili tili = kp()->tilit()->tiliIdlla( viennit.value("tili").toInt());
                 vientirivi.lisaaLinkilla(RaporttiRiviSarake::TILI_NRO, tili.numero(), QString("%1 %2").arg(tili.numero()).arg(tili.nimi()));
 
                 if( tulostakohdennukset  )
                 {
-                    if( lisakysely.value("kohdennus").toInt())
-                        vientirivi.lisaa( kp()->kohdennukset()->kohdennus( lisakysely.value("kohdennus").toInt()).nimi() );
+                    if( viennit.value("kohdennus").toInt())
+                        vientirivi.lisaa( kp()->kohdennukset()->kohdennus( viennit.value("kohdennus").toInt()).nimi() );
                     else
                         vientirivi.lisaa(" ");  // Ei kohdennusta
                 }
 
-                vientirivi.lisaa( lisakysely.value("selite").toString());
-                vientirivi.lisaa( lisakysely.value("debetsnt").toLongLong());
-                vientirivi.lisaa( lisakysely.value("kreditsnt").toLongLong());
+                vientirivi.lisaa( viennit.value("selite").toString());
+                vientirivi.lisaa( viennit.value("debetsnt").toLongLong());
+                vientirivi.lisaa( viennit.value("kreditsnt").toLongLong());
                 kirjoittaja.lisaaRivi( vientirivi );
             }
         }
@@ -258,10 +280,6 @@ RaportinKirjoittaja TositeluetteloRaportti::kirjoitaRaportti(QDate mista, QDate
         summarivi.lihavoi();
         kirjoittaja.lisaaRivi( summarivi );
     }
-
-
-    return kirjoittaja;
-
 }
 
 void TositeluetteloRaportti::kirjoitaSummaRivi(RaportinKirjoittaja &rk, qlonglong debet, qlonglong kredit, int sarakeleveys)
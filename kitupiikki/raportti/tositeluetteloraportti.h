@@ -37,6 +37,13 @@ public:
                                                  bool tositejarjestys = true, bool ryhmittelelajeittain=true,
                                                  bool tulostakohdennukset=true, bool tulostaviennit=true,
                                                  bool tulostasummat=false);
+    /**
+     * @brief Kirjoittaa tositeluettelon annettuun kirjoittajaan, jolle voi asettaa virran
+     */
+    static void kirjoitaRaportti( RaportinKirjoittaja& kirjoittaja, QDate mista, QDate mihin,
+                                  bool tositejarjestys = true, bool ryhmittelelajeittain=true,
+                                  bool tulostakohdennukset=true, bool tulostaviennit=true,
+                                  bool tulostasummat=false);
 
 protected:
     static void kirjoitaSummaRivi(RaportinKirjoittaja &rk, qlonglong debet, qlonglong kredit, int sarakeleveys);
@@ -19,6 +19,7 @@
 
 #include <QSqlQuery>
 #include "db/kirjanpito.h"
+#include "db/tositehaku.h"
 
 #include <QDebug>
 
@@ -167,14 +168,30 @@ QVariant SelausModel::data(const QModelIndex &index, int role) const
 }
 
 void SelausModel::lataa(const QDate &alkaa, const QDate &loppuu)
+{
+    lataaKyselylla( QString("vienti.pvm BETWEEN \"%1\" AND \"%2\" ")
+                    .arg( alkaa.toString(Qt::ISODate ) )
+                    .arg( loppuu.toString(Qt::ISODate)) );
+}
+
+void SelausModel::etsi(const QString &haku)
+{
+    QString lauseke = TositeHaku::hakulauseke(haku);
+    if( lauseke.isEmpty())
+        return;     // Tyhjä MATCH-lauseke olisi syntaksivirhe
+    lauseke.replace('\'',"''");
+    lataaKyselylla( QString("vienti.tosite IN (SELECT rowid FROM tositehaku WHERE tositehaku MATCH '%1') ")
+                    .arg(lauseke) );
+}
+
+void SelausModel::lataaKyselylla(const QString &ehto)
 {
     QString kysymys = QString("SELECT vienti.tosite, vienti.pvm, tili, debetsnt, kreditsnt, selite, kohdennus, eraid, "
                               "tosite.laji, tosite.tunniste, vienti.id, liite.id "
                               "FROM vienti, tosite LEFT OUTER JOIN liite ON tosite.id=liite.tosite "
-                              "WHERE vienti.pvm BETWEEN \"%1\" AND \"%2\" "
+                              "WHERE %1"
                               "AND vienti.tosite=tosite.id AND tili is not null ORDER BY vienti.pvm, vienti.id")
-                              .arg( alkaa.toString(Qt::ISODate ) )
-                              .arg( loppuu.toString(Qt::ISODate)) ;
+                              .arg( ehto ) ;
 
     beginResetModel();
     rivit.clear();
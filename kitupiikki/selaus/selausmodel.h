@@ -73,8 +73,15 @@ public:
 
 public slots:
     void lataa(const QDate& alkaa, const QDate& loppuu);
+    /**
+     * @brief Lataa tekstihaulla löytyvien tositteiden viennit kaikilta tilikausilta
+     * @param haku Haettava teksti
+     */
+    void etsi(const QString& haku);
 
 protected:
+    void lataaKyselylla(const QString& ehto);
+
     QList<SelausRivi> rivit;
     QStringList tileilla;
 
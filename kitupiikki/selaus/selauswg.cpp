@@ -58,7 +58,8 @@ SelausWg::SelausWg() :
 
     ui->selausView->sortByColumn(SelausModel::PVM, Qt::AscendingOrder);
 
-    connect( ui->etsiEdit, SIGNAL(textChanged(QString)), etsiProxy, SLOT(setFilterFixedString(QString)));
+    connect( ui->etsiEdit, SIGNAL(textChanged(QString)), this, SLOT(etsi(QString)));
+    connect( ui->kaikkiCheck, &QCheckBox::toggled, this, &SelausWg::kaikkiKaudet);
 
     connect( ui->alkuEdit, SIGNAL(editingFinished()), this, SLOT(paivita()));
     connect( ui->loppuEdit, SIGNAL(editingFinished()), this, SLOT(paivita()));
@@ -105,9 +106,16 @@ void SelausWg::paivita()
     bool lopussa = ui->selausView->verticalScrollBar()->value() >=
             ui->selausView->verticalScrollBar()->maximum() - ui->selausView->verticalScrollBar()->pageStep();
 
+    // Kaikkien kausien haussa tositteet haetaan tekstihakemistosta
+    bool haku = ui->kaikkiCheck->isChecked() && ui->etsiEdit->text().simplified().length() > 2;
+    etsiProxy->setFilterFixedString( ui->kaikkiCheck->isChecked() ? QString() : ui->etsiEdit->text() );
+
     if( ui->valintaTab->currentIndex() == 1 )
     {
-        model->lataa( ui->alkuEdit->date(), ui->loppuEdit->date());
+        if( haku )
+            model->etsi( ui->etsiEdit->text());
+        else
+            model->lataa( ui->alkuEdit->date(), ui->loppuEdit->date());
 
         QString valittu = ui->tiliCombo->currentText();
         ui->tiliCombo->clear();
@@ -118,7 +126,10 @@ void SelausWg::paivita()
     }
     else
     {
-        tositeModel->lataa( ui->alkuEdit->date(), ui->loppuEdit->date());
+        if( haku )
+            tositeModel->etsi( ui->etsiEdit->text());
+        else
+            tositeModel->lataa( ui->alkuEdit->date(), ui->loppuEdit->date());
 
         QString valittu = ui->tiliCombo->currentText();
         ui->tiliCombo->clear();
@@ -189,6 +200,21 @@ void SelausWg::paivitaSummat()
     ui->summaLabel->setText(teksti);
 }
 
+void SelausWg::etsi(const QString &teksti)
+{
+    if( ui->kaikkiCheck->isChecked())
+        paivita();
+    else
+        etsiProxy->setFilterFixedString(teksti);
+}
+
+void SelausWg::kaikkiKaudet(bool kaikki)
+{
+    ui->alkuEdit->setEnabled( !kaikki );
+    ui->loppuEdit->setEnabled( !kaikki );
+    paivita();
+}
+
 void SelausWg::naytaTositeRivilta(QModelIndex index)
 {
     int id = index.data( Qt::UserRole).toInt();
@@ -54,6 +54,16 @@ public slots:
     void paivita();
     void suodata();
     void paivitaSummat();
+
+    /**
+     * @brief Suodattaa näkyviä rivejä tai kaikkien kausien haussa hakee tositteet
+     * @param teksti Haettava teksti
+     */
+    void etsi(const QString& teksti);
+    /**
+     * @brief Ottaa käyttöön tai pois kaikkien tilikausien haun
+     */
+    void kaikkiKaudet(bool kaikki);
     void naytaTositeRivilta(QModelIndex index);
 
     void selaa(int tilinumero, const Tilikausi &tilikausi);
@@ -22,6 +22,7 @@
 
 #include "tositeselausmodel.h"
 #include "db/kirjanpito.h"
+#include "db/tositehaku.h"
 
 TositeSelausModel::TositeSelausModel()
 {
@@ -135,12 +136,28 @@ QVariant TositeSelausModel::data(const QModelIndex &index, int role) const
 
 
 void TositeSelausModel::lataa(const QDate &alkaa, const QDate &loppuu)
+{
+    lataaKyselylla( QString("tosite.pvm BETWEEN \"%1\" AND \"%2\" ")
+                    .arg(alkaa.toString(Qt::ISODate)).arg(loppuu.toString(Qt::ISODate)) );
+}
+
+void TositeSelausModel::etsi(const QString &haku)
+{
+    QString lauseke = TositeHaku::hakulauseke(haku);
+    if( lauseke.isEmpty())
+        return;     // Tyhjä MATCH-lauseke olisi syntaksivirhe
+    lauseke.replace('\'',"''");
+    lataaKyselylla( QString("tosite.id IN (SELECT rowid FROM tositehaku WHERE tositehaku MATCH '%1') ")
+                    .arg(lauseke) );
+}
+
+void TositeSelausModel::lataaKyselylla(const QString &ehto)
 {
     QString kysymys = QString("SELECT tosite.id, tosite.pvm, tosite.otsikko, laji, tunniste, liite.id "
                               "FROM tosite LEFT OUTER JOIN liite ON tosite.id=liite.tosite "
-                              "WHERE tosite.pvm BETWEEN \"%1\" AND \"%2\" "
+                              "WHERE %1"
                               "ORDER BY tosite.pvm, tosite.id ")
-            .arg(alkaa.toString(Qt::ISODate)).arg(loppuu.toString(Qt::ISODate)) ;
+            .arg(ehto) ;
 
     beginResetModel();
 
@@ -68,6 +68,14 @@ public:
 
 public slots:
     void lataa(const QDate& alkaa, const QDate& loppuu);
+    /**
+     * @brief Lataa tekstihaulla löytyvät tositteet kaikilta tilikausilta
+     * @param haku Haettava teksti
+     */
+    void etsi(const QString& haku);
+
+protected:
+    void lataaKyselylla(const QString& ehto);
 
 protected:
     QList<TositeSelausRivi> rivit;
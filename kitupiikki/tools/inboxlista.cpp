@@ -25,15 +25,26 @@
 #include <QApplication>
 #include <QImage>
 #include <QSettings>
+#include <QTimer>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
 #include <poppler/qt5/poppler-qt5.h>
 
 InboxLista::InboxLista()
 {
     vahti_ = new QFileSystemWatcher(this);
+
+    // Skanneri kirjoittaa tiedostoa useammassa osassa, joten muutokset
+    // kootaan yhteen ennen luettelon päivittämistä
+    ajastin_ = new QTimer(this);
+    ajastin_->setSingleShot(true);
+    ajastin_->setInterval(250);
+
     connect( kp(), &Kirjanpito::inboxMuuttui, this, &InboxLista::alusta);
     connect( kp(), &Kirjanpito::tietokantaVaihtui, this, &InboxLista::alusta);
-    connect( vahti_, &QFileSystemWatcher::directoryChanged, this, &InboxLista::paivita);
+    connect( vahti_, &QFileSystemWatcher::directoryChanged, ajastin_, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect( ajastin_, &QTimer::timeout, this, &InboxLista::paivita);
 
     setViewMode(QListWidget::IconMode);
     setIconSize(QSize( 125 , 150));
@@ -48,73 +59,142 @@ void InboxLista::alusta()
     if( !polku_.isEmpty())
         vahti_->addPath(polku_);
 
+    clear();
     paivita();
 }
 
 void InboxLista::paivita()
 {
-    clear();
-
     if( polku_.isEmpty())
     {
+        clear();
         emit nayta(false);
         return;
     }
 
+    // Nykyiset rivit polun mukaan
+    QHash<QString, QListWidgetItem*> rivit;
+    for(int i=0; i < count(); i++)
+        rivit.insert( item(i)->data(Qt::UserRole).toString(), item(i) );
+
+    bool poppler = !kp()->settings()->value("PopplerPois").toBool();
+
     QDir dir( polku_ );
     dir.setFilter(QDir::Files);
-    dir.setSorting(QDir::Name);
     QFileInfoList list = dir.entryInfoList();
     for( const QFileInfo& info : list)
     {
         QString tiedostonimi = info.fileName().toLower();
-        if( tiedostonimi.endsWith(".pdf")  || tiedostonimi.endsWith(".jpg") ||
-            tiedostonimi.endsWith(".jpeg") || tiedostonimi.endsWith(".png"))
+        if( !( tiedostonimi.endsWith(".pdf")  || tiedostonimi.endsWith(".jpg") ||
+               tiedostonimi.endsWith(".jpeg") || tiedostonimi.endsWith(".png")))
+            continue;
+
+        QString polku = info.absoluteFilePath();
+        QString tunnus = tunniste(info);
+        bool pdf = tiedostonimi.endsWith(".pdf");
+
+        QListWidgetItem *item = rivit.take( polku );
+        if( !item )
         {
-            QListWidgetItem *item = new QListWidgetItem( info.fileName(), this );
-            if( tiedostonimi.endsWith(".pdf") && !kp()->settings()->value("PopplerPois").toBool())
-            {
-                QImage kuva;
-                Poppler::Document *pdfDoc = Poppler::Document::load( info.absoluteFilePath());
-                if( pdfDoc )
-                {
-                    Poppler::Page *pdfSivu = pdfDoc->page(0);
-                    if( pdfSivu )
-                    {
-                        kuva = pdfSivu->thumbnail();
-                        if( kuva.isNull())
-                            kuva = pdfSivu->renderToImage(24,24);
-                        delete pdfSivu;
-                    }
-                    delete pdfDoc;
-                }
-                if( kuva.isNull())
-                {
-                    item->setIcon(QIcon(":/pic/pdf.png"));
-                }
-                else
-                {
-                    item->setIcon( QIcon( QPixmap::fromImage(kuva)));
-                }
-            }
-            else
+            item = new QListWidgetItem( info.fileName(), this );
+            item->setData(Qt::UserRole, polku);
+        }
+        else if( item->data(Qt::UserRole + 1).toString() == tunnus )
+            continue;       // Tiedosto ei ole muuttunut
+
+        item->setData(Qt::UserRole + 1, tunnus);
+
+        if( kuvat_.value(polku).first == tunnus )
+        {
+            item->setIcon( kuvat_.value(polku).second );
+            continue;
+        }
+
+        // Kunnes pikkukuva valmistuu, näytetään tiedostotyypin kuvake
+        item->setIcon( QIcon( pdf ? ":/pic/pdf.png" : ":/pic/kuva.png") );
+
+        QString tyo = polku + "\n" + tunnus;
+        if( kesken_.contains(tyo))
+            continue;
+        kesken_.insert(tyo);
+
+        QFutureWatcher<QImage> *vahti = new QFutureWatcher<QImage>(this);
+        connect( vahti, &QFutureWatcher<QImage>::finished, this, [this, vahti, polku, tunnus, tyo] {
+            kesken_.remove(tyo);
+            kuvaValmis( polku, tunnus, vahti->result());
+            vahti->deleteLater();
+        });
+        vahti->setFuture( QtConcurrent::run( &InboxLista::pikkukuva, polku, pdf, poppler, iconSize() ));
+    }
+
+    // Poistetut tiedostot
+    for( QListWidgetItem* poistettu : rivit)
+    {
+        kuvat_.remove( poistettu->data(Qt::UserRole).toString() );
+        delete poistettu;
+    }
+
+    sortItems();
+    emit nayta( count() > 0 );
+
+}
+
+QImage InboxLista::pikkukuva(const QString &polku, bool pdf, bool poppler, const QSize &koko)
+{
+    QImage kuva;
+
+    if( pdf )
+    {
+        if( !poppler )
+            return kuva;
+
+        Poppler::Document *pdfDoc = Poppler::Document::load( polku );
+        if( pdfDoc )
+        {
+            Poppler::Page *pdfSivu = pdfDoc->page(0);
+            if( pdfSivu )
             {
-                QImage kuva( info.absoluteFilePath() );
+                kuva = pdfSivu->thumbnail();
                 if( kuva.isNull())
-                {
-                    item->setIcon(QIcon(":/pic/kuva.png"));
-                }
-                else
-                {
-                    item->setIcon( QIcon( QPixmap::fromImage(kuva) ) );
-                }
+                    kuva = pdfSivu->renderToImage(24,24);
+                delete pdfSivu;
             }
-            item->setData(Qt::UserRole, info.absoluteFilePath());
+            delete pdfDoc;
         }
     }
+    else
+        kuva.load( polku );
 
-    emit nayta( count() > 0 );
+    // Pienennetään jo tässä, jottei täysikokoisia kuvia tarvitse säilyttää
+    if( !kuva.isNull() && ( kuva.width() > koko.width() || kuva.height() > koko.height()))
+        kuva = kuva.scaled( koko, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    return kuva;
+}
 
+void InboxLista::kuvaValmis(const QString &polku, const QString &tunniste, const QImage &kuva)
+{
+    if( kuva.isNull())
+        return;
+
+    QIcon kuvake( QPixmap::fromImage(kuva) );
+    kuvat_.insert( polku, qMakePair(tunniste, kuvake));
+
+    // Tiedosto on voinut muuttua tai poistua kuvaa muodostettaessa
+    for(int i=0; i < count(); i++)
+    {
+        if( item(i)->data(Qt::UserRole).toString() == polku )
+        {
+            if( item(i)->data(Qt::UserRole + 1).toString() == tunniste)
+                item(i)->setIcon( kuvake );
+            return;
+        }
+    }
+}
+
+QString InboxLista::tunniste(const QFileInfo &info)
+{
+    return QString("%1 %2").arg( info.lastModified().toMSecsSinceEpoch() ).arg( info.size() );
 }
 
 void InboxLista::mousePressEvent(QMouseEvent *event)
@@ -18,9 +18,22 @@
 #define INBOXLISTA_H
 
 #include <QListWidget>
+#include <QHash>
+#include <QSet>
+#include <QImage>
+#include <QIcon>
 
 class QFileSystemWatcher;
+class QTimer;
+class QFileInfo;
 
+/**
+ * @brief Kirjattavien kansion tiedostot pikkukuvina
+ *
+ * Kansion muuttuessa luetteloa verrataan edelliseen tilaan, ja vain uusille
+ * tai muuttuneille tiedostoille muodostetaan pikkukuva taustasäikeissä.
+ * Pikkukuvat pidetään muistissa polun, muokkausajan ja koon mukaan.
+ */
 class InboxLista : public QListWidget
 {
     Q_OBJECT
@@ -41,10 +54,25 @@ protected:
 private:
     void aloitaRaahaus();
 
+    /**
+     * @brief Muodostaa pikkukuvan tiedostosta (ajetaan taustasäikeessä)
+     */
+    static QImage pikkukuva(const QString& polku, bool pdf, bool poppler, const QSize& koko);
+
+    void kuvaValmis(const QString& polku, const QString& tunniste, const QImage& kuva);
+
+    static QString tunniste(const QFileInfo& info);
+
 private:
     QString polku_;
     QFileSystemWatcher *vahti_;
+    QTimer *ajastin_;
     QPoint alkuPos_;
+
+    /// Valmiit pikkukuvat polun mukaan, avaimena tunniste (muokkausaika ja koko)
+    QHash<QString, QPair<QString,QIcon>> kuvat_;
+    /// Taustalla muodostettavat kuvat (polku ja tunniste)
+    QSet<QString> kesken_;
 };
 
 #endif // INBOXLISTA_H
@@ -55,6 +55,14 @@ CREATE INDEX tosite_pvm_index ON tosite(pvm);
 CREATE INDEX tosite_tiliote_index on tosite(tiliote);
 CREATE INDEX tosite_laji_index on tosite(laji);
 CREATE INDEX tosite_tunniste_index on tosite(tunniste);
+CREATE INDEX tosite_laji_pvm_tunniste_index ON tosite(laji, pvm, tunniste);
+
+CREATE TABLE tunnistelaskuri (
+    laji     INTEGER,
+    kausi    DATE,
+    suurin   INTEGER,
+    PRIMARY KEY (laji, kausi)
+);
 
 
 CREATE TABLE kohdennus (
@@ -104,6 +112,55 @@ CREATE INDEX vienti_kodennus_index ON vienti(kohdennus);
 CREATE INDEX vienti_taseera_index ON vienti(eraid);
 CREATE INDEX vienti_ibanviite_index ON vienti(iban,viite);
 CREATE INDEX vienti_arkisto_index ON vienti(arkistotunnus);
+CREATE INDEX vienti_asiakas_index ON vienti(asiakas, muokattu);
+CREATE INDEX vienti_muistutus_index ON vienti(json_extract(json,'$.Maksumuistutus'), eraid);
+CREATE INDEX vienti_kirjausperuste_index ON vienti(json_extract(json,'$.Kirjausperuste'));
+CREATE INDEX vienti_muokattu_index ON vienti(muokattu);
+CREATE INDEX vienti_alvkoodi_pvm_index ON vienti(alvkoodi, pvm);
+
+CREATE TABLE alvkooste (
+    kuukausi        DATE,
+    alvkoodi        INTEGER,
+    alvprosentti    INTEGER,
+    tili            INTEGER,
+    debetsnt        BIGINT DEFAULT(0),
+    kreditsnt       BIGINT DEFAULT(0),
+    PRIMARY KEY (kuukausi, alvkoodi, alvprosentti, tili)
+);
+
+CREATE TABLE erasaldo (
+    eraid   INTEGER,
+    tili    INTEGER,
+    saldo   BIGINT DEFAULT(0),
+    PRIMARY KEY (eraid, tili)
+);
+
+CREATE INDEX erasaldo_avoimet_index ON erasaldo(tili) WHERE saldo <> 0;
+
+CREATE TABLE tuotemyynti (
+    tosite          INTEGER,
+    vienti          INTEGER,
+    pvm             DATE,
+    nimike          TEXT,
+    tuote           INTEGER,
+    asiakas         VARCHAR(60),
+    alvprosentti    INTEGER DEFAULT(0),
+    kohdennus       INTEGER DEFAULT(0),
+    maara           REAL,
+    nettosnt        BIGINT,
+    bruttosnt       BIGINT
+);
+
+CREATE INDEX tuotemyynti_pvm_index ON tuotemyynti(pvm, nimike, asiakas, alvprosentti);
+CREATE INDEX tuotemyynti_tosite_index ON tuotemyynti(tosite);
+
+CREATE TABLE budjetti (
+    kausi       DATE,
+    kohdennus   INTEGER,
+    tili        INTEGER,
+    sentit      BIGINT DEFAULT(0),
+    PRIMARY KEY (kausi, kohdennus, tili)
+);
 
 CREATE TABLE liite (
     id       INTEGER      PRIMARY KEY AUTOINCREMENT,
@@ -119,6 +176,8 @@ CREATE TABLE liite (
 
 CREATE INDEX liite_tosite_index ON liite(tosite);
 
+CREATE VIRTUAL TABLE tositehaku USING fts5(otsikko, kommentti, selite, asiakas, tokenize='unicode61 remove_diacritics 0');
+
 CREATE TABLE tuote (
     id              INTEGER     PRIMARY KEY AUTOINCREMENT,
     nimike          TEXT,
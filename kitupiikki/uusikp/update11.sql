@@ -0,0 +1,3 @@
+CREATE INDEX IF NOT EXISTS vienti_asiakas_index ON vienti(asiakas, muokattu);
+CREATE INDEX IF NOT EXISTS vienti_muistutus_index ON vienti(json_extract(json,'$.Maksumuistutus'), eraid);
+CREATE INDEX IF NOT EXISTS vienti_kirjausperuste_index ON vienti(json_extract(json,'$.Kirjausperuste'));
@@ -0,0 +1,3 @@
+CREATE VIRTUAL TABLE IF NOT EXISTS tositehaku USING fts5(otsikko, kommentti, selite, asiakas, tokenize='unicode61 remove_diacritics 0');
+DELETE FROM tositehaku;
+INSERT INTO tositehaku(rowid, otsikko, kommentti, selite, asiakas) SELECT tosite.id, tosite.otsikko, tosite.kommentti, group_concat(vienti.selite, ' '), group_concat(vienti.asiakas, ' ') FROM tosite LEFT OUTER JOIN vienti ON vienti.tosite=tosite.id GROUP BY tosite.id;
@@ -0,0 +1 @@
+CREATE INDEX IF NOT EXISTS vienti_muokattu_index ON vienti(muokattu);
@@ -0,0 +1,3 @@
+CREATE INDEX IF NOT EXISTS tosite_laji_pvm_tunniste_index ON tosite(laji, pvm, tunniste);
+CREATE TABLE IF NOT EXISTS tunnistelaskuri (laji INTEGER, kausi DATE, suurin INTEGER, PRIMARY KEY (laji, kausi));
+INSERT OR REPLACE INTO tunnistelaskuri(laji, kausi, suurin) SELECT tosite.laji, tilikausi.alkaa, MAX(tosite.tunniste) FROM tosite, tilikausi WHERE tosite.pvm BETWEEN tilikausi.alkaa AND tilikausi.loppuu AND tosite.tunniste IS NOT NULL GROUP BY tosite.laji, tilikausi.alkaa;
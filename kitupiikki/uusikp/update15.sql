@@ -0,0 +1,4 @@
+CREATE INDEX IF NOT EXISTS vienti_alvkoodi_pvm_index ON vienti(alvkoodi, pvm);
+CREATE TABLE IF NOT EXISTS alvkooste (kuukausi DATE, alvkoodi INTEGER, alvprosentti INTEGER, tili INTEGER, debetsnt BIGINT DEFAULT(0), kreditsnt BIGINT DEFAULT(0), PRIMARY KEY (kuukausi, alvkoodi, alvprosentti, tili));
+DELETE FROM alvkooste;
+INSERT OR REPLACE INTO alvkooste(kuukausi, alvkoodi, alvprosentti, tili, debetsnt, kreditsnt) SELECT strftime('%Y-%m-01', pvm), alvkoodi, IFNULL(alvprosentti,0), IFNULL(tili,0), SUM(IFNULL(debetsnt,0)), SUM(IFNULL(kreditsnt,0)) FROM vienti WHERE alvkoodi > 0 GROUP BY strftime('%Y-%m-01', pvm), alvkoodi, IFNULL(alvprosentti,0), IFNULL(tili,0);
@@ -0,0 +1,4 @@
+CREATE TABLE IF NOT EXISTS erasaldo (eraid INTEGER, tili INTEGER, saldo BIGINT DEFAULT(0), PRIMARY KEY (eraid, tili));
+CREATE INDEX IF NOT EXISTS erasaldo_avoimet_index ON erasaldo(tili) WHERE saldo <> 0;
+DELETE FROM erasaldo;
+INSERT OR REPLACE INTO erasaldo(eraid, tili, saldo) SELECT eraid, tili, SUM(IFNULL(debetsnt,0)) - SUM(IFNULL(kreditsnt,0)) FROM vienti WHERE eraid IS NOT NULL AND tili IS NOT NULL GROUP BY eraid, tili;
@@ -0,0 +1,5 @@
+CREATE TABLE IF NOT EXISTS tuotemyynti (tosite INTEGER, vienti INTEGER, pvm DATE, nimike TEXT, tuote INTEGER, asiakas VARCHAR(60), alvprosentti INTEGER DEFAULT(0), kohdennus INTEGER DEFAULT(0), maara REAL, nettosnt BIGINT, bruttosnt BIGINT);
+CREATE INDEX IF NOT EXISTS tuotemyynti_pvm_index ON tuotemyynti(pvm, nimike, asiakas, alvprosentti);
+CREATE INDEX IF NOT EXISTS tuotemyynti_tosite_index ON tuotemyynti(tosite);
+DELETE FROM tuotemyynti;
+INSERT INTO tuotemyynti(tosite, vienti, pvm, nimike, tuote, asiakas, alvprosentti, kohdennus, maara, nettosnt, bruttosnt) SELECT vienti.tosite, vienti.id, vienti.pvm, json_extract(rivi.value,'$.Nimike'), json_extract(rivi.value,'$.Tuotekoodi'), vienti.asiakas, IFNULL(json_extract(rivi.value,'$.Alvprosentti'),0), IFNULL(json_extract(rivi.value,'$.Kohdennus'),0), json_extract(rivi.value,'$.Maara'), json_extract(rivi.value,'$.Nettoyht'), json_extract(rivi.value,'$.Yhteensa') FROM vienti, json_each(vienti.json,'$.Laskurivit') AS rivi WHERE vienti.viite IS NOT NULL AND json_type(vienti.json,'$.Laskurivit')='array';
@@ -0,0 +1,3 @@
+CREATE TABLE IF NOT EXISTS budjetti (kausi DATE, kohdennus INTEGER, tili INTEGER, sentit BIGINT DEFAULT(0), PRIMARY KEY (kausi, kohdennus, tili));
+DELETE FROM budjetti;
+INSERT OR REPLACE INTO budjetti(kausi, kohdennus, tili, sentit) SELECT tilikausi.alkaa, CAST(kohdennus.key AS INTEGER), CAST(tili.key AS INTEGER), tili.value FROM tilikausi, json_each(tilikausi.json,'$.Budjetti') AS kohdennus, json_each(kohdennus.value) AS tili WHERE json_type(tilikausi.json,'$.Budjetti')='object';
@@ -0,0 +1,16 @@
+# Kirjanpidon laskennan yksikkötestit
+#
+# Testit ajetaan pienillä aineistoilla, ja tietokannat luodaan ohjelman
+# luo.sql-käskyillä. Ympäristömuuttujalla KITUPIIKKI_TAYSI_KOKO aineistot
+# ovat täysikokoisia. Suuren kirjanpidon mittaukset ovat suorituskykytesteissä.
+
+include(../yhteiset/yhteiset.pri)
+
+TARGET = kirjanpito
+
+# Finvoice-sanomat tarkastetaan skeemaa vasten
+QT += xmlpatterns
+
+SOURCES += tst_kirjanpitotesti.cpp
+
+DISTFILES += finvoice3.xsd
@@ -0,0 +1,1248 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <QtTest>
+#include <QCoreApplication>
+
+#include "kirjageneraattori.h"
+
+#include "arkisto/poistolaskenta.h"
+#include "arkisto/poistaja.h"
+#include "db/kirjanpito.h"
+#include "db/erasaldo.h"
+#include "db/tuotemyynti.h"
+#include "db/budjetti.h"
+#include "kirjaus/maksualvhaku.h"
+#include "laskutus/laskupohja.h"
+#include "laskutus/finvoice.h"
+#include "laskutus/finvoiceaineisto.h"
+#include "raportti/raportoija.h"
+#include "raportti/raporttivirta.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QBuffer>
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QXmlSchema>
+#include <QXmlSchemaValidator>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QPdfWriter>
+#include <QPrinter>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cmath>
+
+/**
+ * @brief Kirjanpidon laskennan yksikkötestit
+ *
+ * Tietokantaa tarvitsevat testit luovat tyhjän kirjanpidon muistiin
+ * ohjelman luo.sql-käskyillä, joten taulut ovat samat kuin ohjelmassa.
+ * Raporttien testeille luodaan pieni kahden tilikauden kirjanpito, joka
+ * avataan kuten ohjelmassa.
+ */
+class KirjanpitoTesti : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void menojaannospoistoTesti();
+    void tasaerapoistoTesti_data();
+    void tasaerapoistoTesti();
+    void avoimetEratTesti();
+    void maksuperusteinenTesti();
+    void laskupohjaTesti();
+    void finvoiceAineistoTesti();
+    void tuotemyyntiTesti_data();
+    void tuotemyyntiTesti();
+    void budjettiTesti();
+    void budjettiSarakeTesti();
+    void trendiTesti_data();
+    void trendiTesti();
+    void raporttiVirtaTesti();
+
+protected:
+    /**
+     * @brief Aineiston koko
+     *
+     * Ympäristömuuttujalla KITUPIIKKI_TAYSI_KOKO testit ajetaan
+     * täysikokoisilla aineistoilla.
+     */
+    static int koko(int pieni, int taysi);
+
+    /**
+     * @brief Luo muistiin tyhjän kirjanpidon ohjelman luontikäskyillä
+     * @param yhteys Tietokantayhteyden nimi
+     */
+    static QSqlDatabase tyhjaKirjanpito(const QString& yhteys);
+
+    QTemporaryDir hakemisto_;
+    Kirjanpito* kirjanpito_ = nullptr;
+};
+
+namespace {
+
+/**
+ * @brief Raportoija, jonka laskemat sarakkeet voi tarkastaa
+ */
+class SarakeRaportoija : public Raportoija
+{
+public:
+    SarakeRaportoija(const QString& raportinNimi) : Raportoija(raportinNimi) {}
+
+    int sarakkeita() const { return sarakeTyypit_.count(); }
+    int sarakeTyyppi(int sarake) const { return sarakeTyypit_.value(sarake); }
+    QDate alkaa(int sarake) const { return alkuPaivat_.value(sarake); }
+    QDate paattyy(int sarake) const { return loppuPaivat_.value(sarake); }
+
+    QMap<int,qlonglong> summat(int sarake) const { return data_.value(sarake); }
+    /**
+     * @brief Muutossarakkeen vertailukauden summat
+     */
+    QMap<int,qlonglong> vertailu(int sarake) const { return budjetti_.value(sarake); }
+};
+
+}
+
+void KirjanpitoTesti::initTestCase()
+{
+    QVERIFY( hakemisto_.isValid() );
+    QString polku = hakemisto_.filePath("raportit.kitupiikki");
+
+    KirjaGeneraattori::Koko pieni;
+    pieni.tilikausia = 2;
+    pieni.tositteitaKaudessa = 800;
+    pieni.kohdennuksia = 3;
+    pieni.asiakkaita = 20;
+    pieni.liiteProsentti = 0;
+
+    KirjaGeneraattori generaattori( 2019, pieni );
+    QVERIFY2( generaattori.luo( polku ), qPrintable( generaattori.virhe() ));
+
+    kirjanpito_ = new Kirjanpito( hakemisto_.path() );
+    Kirjanpito::asetaInstanssi( kirjanpito_ );
+    QVERIFY( kp()->avaaTietokanta( polku ) );
+}
+
+void KirjanpitoTesti::cleanupTestCase()
+{
+    delete kirjanpito_;
+    kirjanpito_ = nullptr;
+    Kirjanpito::asetaInstanssi( nullptr );
+}
+
+void KirjanpitoTesti::menojaannospoistoTesti()
+{
+    QCOMPARE( PoistoLaskenta::menojaannospoisto(100000, 25), 25000LL);
+    QCOMPARE( PoistoLaskenta::menojaannospoisto(333, 25), 83LL);
+    QCOMPARE( PoistoLaskenta::menojaannospoisto(334, 25), 84LL);
+    QCOMPARE( PoistoLaskenta::menojaannospoisto(-1000, 10), -100LL);
+    QCOMPARE( PoistoLaskenta::menojaannospoisto(100000000000LL, 25), 25000000000LL);
+}
+
+void KirjanpitoTesti::tasaerapoistoTesti_data()
+{
+    QTest::addColumn<int>("eria");
+    QTest::newRow("10 000 erää") << 10000;
+}
+
+void KirjanpitoTesti::tasaerapoistoTesti()
+{
+    QFETCH(int, eria);
+    const QDate paattyy(2019,12,31);
+
+    QSqlDatabase db = tyhjaKirjanpito("tasaerapoisto");
+    QVERIFY( db.isOpen() );
+
+    QSqlQuery kysely(db);
+    QVERIFY( kysely.exec("INSERT INTO tili(id, nro, nimi, tyyppi, ysiluku) VALUES "
+                         "(1, 1150, 'Koneet ja kalusto', 'APT', 115000009), "
+                         "(2, 1160, 'Muut aineelliset hyödykkeet', 'APT', 116000009), "
+                         "(3, 1170, 'Rakennukset', 'APM', 117000009), "
+                         "(4, 1180, 'Kalusto', 'APM', 118000009)") );
+    QVERIFY( kysely.exec("INSERT INTO kohdennus(id, nimi, tyyppi) VALUES (1, 'Tuotanto', 1), (2, 'Myynti', 1), (3, 'Hallinto', 1)") );
+    QVERIFY( kysely.exec("INSERT INTO tosite(id, pvm, tunniste) VALUES (1, '2000-01-01', 1)") );
+
+    // Käyttöomaisuuserät muodostetaan toistettavasti lineaarisella kongruenssigeneraattorilla,
+    // ja niistä kirjataan poistot tilikausittain vuoden 2018 loppuun
+    quint32 siemen = 2019;
+    auto satunnainen = [&siemen] (quint32 ylaraja) {
+        siemen = siemen * 1103515245 + 12345;
+        return (siemen >> 8) % ylaraja;
+    };
+
+    db.transaction();
+    QSqlQuery hankinta(db);
+    hankinta.prepare("INSERT INTO vienti(id, tosite, vientirivi, pvm, tili, selite, debetsnt, eraid, json, kohdennus) "
+                     "VALUES (?,1,?,?,?,?,?,?,?,?)");
+    QSqlQuery poistot(db);
+    poistot.prepare("INSERT INTO vienti(tosite, vientirivi, pvm, tili, selite, kreditsnt, eraid, kohdennus) "
+                    "VALUES (1,0,?,?,'Tasaeräpoisto',?,?,?)");
+    for(int i=1; i <= eria; i++)
+    {
+        qlonglong alkuSnt = 100 + satunnainen(1000000);
+        int poistoKk = 1 + satunnainen(240);
+        QDate hankittu( 2000 + satunnainen(20), 1 + satunnainen(12), 1 + satunnainen(28) );
+        int tili = 1 + satunnainen(2);
+        int kohdennus = satunnainen(4);
+
+        JsonKentta json;
+        json.set("Tasaerapoisto", poistoKk);
+
+        hankinta.addBindValue(i);
+        hankinta.addBindValue(i);
+        hankinta.addBindValue(hankittu);
+        hankinta.addBindValue(tili);
+        hankinta.addBindValue(QString("Hankinta %1").arg(i));
+        hankinta.addBindValue(alkuSnt);
+        hankinta.addBindValue(i);
+        hankinta.addBindValue(json.toJson());
+        hankinta.addBindValue(kohdennus);
+        QVERIFY( hankinta.exec() );
+
+        qlonglong saldo = alkuSnt;
+        for( int vuosi = hankittu.year(); vuosi < paattyy.year(); vuosi++)
+        {
+            qlonglong poisto = PoistoLaskenta::tasaerapoisto(alkuSnt, saldo, poistoKk, hankittu, QDate(vuosi, 12, 31));
+            QVERIFY( poisto >= 0 );
+            QVERIFY( poisto <= saldo );
+            if( !poisto )
+                continue;
+            saldo -= poisto;
+
+            poistot.addBindValue(QDate(vuosi, 12, 31));
+            poistot.addBindValue(tili);
+            poistot.addBindValue(poisto);
+            poistot.addBindValue(i);
+            poistot.addBindValue(kohdennus);
+            QVERIFY( poistot.exec() );
+        }
+    }
+
+    // Menojäännöspoistettavien tilien hankinnat ja poistot kohdennuksille
+    QSqlQuery menojaannos(db);
+    menojaannos.prepare("INSERT INTO vienti(tosite, vientirivi, pvm, tili, debetsnt, kreditsnt, kohdennus) VALUES (1,0,?,?,?,?,?)");
+    for(int i=0; i < eria / 10; i++)
+    {
+        menojaannos.addBindValue( QDate(2000,1,1).addDays( satunnainen(7400)) );
+        menojaannos.addBindValue( 3 + satunnainen(2) );
+        menojaannos.addBindValue( i % 3 ? 0 : 1000 + satunnainen(1000000) );
+        menojaannos.addBindValue( i % 3 ? satunnainen(100000) : 0 );
+        menojaannos.addBindValue( satunnainen(4) );
+        QVERIFY( menojaannos.exec() );
+    }
+    QVERIFY( db.commit() );
+
+    // Poistaja hakee erät ja kohdennusten saldot ryhmitellyillä kyselyillä
+    QElapsedTimer ajastin;
+    ajastin.start();
+    QHash<int, QList<Poistaja::PoistoEra>> erat = Poistaja::tasaeraErat( db, QStringList() << "1" << "2", paattyy );
+    QHash<int, QList<QPair<int,qlonglong>>> kohdennusSaldot = Poistaja::kohdennusSaldot( db, QStringList() << "3" << "4", paattyy );
+    qint64 ryhmitellenMs = ajastin.elapsed();
+
+    QMap<int,qlonglong> ehdotetut;
+    for( int tili : erat.keys())
+        for( const Poistaja::PoistoEra& era : erat.value(tili))
+            ehdotetut.insert( era.eraId, PoistoLaskenta::tasaerapoisto( era.alkuSnt, era.saldo, era.poistoKk, era.pvm, paattyy));
+
+    // Vertailukohtana aiempi laskenta, jossa jokainen erä haettiin omilla kyselyillään
+    ajastin.restart();
+    QMap<int,qlonglong> eraKerrallaan;
+    QSqlQuery eraKysely(db);
+    QVERIFY( kysely.exec("SELECT id FROM vienti WHERE tili IN (1,2) AND eraid=id ORDER BY tili, pvm") );
+    while( kysely.next())
+    {
+        int eraId = kysely.value(0).toInt();
+        QVERIFY( eraKysely.exec( QString("SELECT SUM(debetsnt), SUM(kreditsnt) FROM vienti WHERE eraid=%1 AND pvm <= '%2'")
+                                 .arg(eraId).arg(paattyy.toString(Qt::ISODate))) && eraKysely.next() );
+        int eraSaldo = eraKysely.value(0).toInt() - eraKysely.value(1).toInt();
+        if( !eraSaldo )
+            continue;
+
+        QVERIFY( eraKysely.exec( QString("SELECT pvm, debetsnt, kreditsnt, json FROM vienti WHERE id=%1").arg(eraId)) && eraKysely.next() );
+        QDate eranPvm = eraKysely.value("pvm").toDate();
+        int alkuSnt = eraKysely.value("debetsnt").toInt() - eraKysely.value("kreditsnt").toInt();
+        int poistoKk = JsonKentta( eraKysely.value("json").toByteArray() ).luku("Tasaerapoisto");
+
+        int kuukauttaKulunut = paattyy.year() * 12 + paattyy.month() - eranPvm.year() * 12 - eranPvm.month() + 1;
+        int laskennallinenPoisto = alkuSnt * kuukauttaKulunut / poistoKk;
+        if( laskennallinenPoisto > alkuSnt)
+            laskennallinenPoisto = alkuSnt;
+        eraKerrallaan.insert( eraId, laskennallinenPoisto - alkuSnt + eraSaldo );
+    }
+    QMap<int, QList<QPair<int,qlonglong>>> kohdennusKerrallaan;
+    for( int tili : {3, 4})
+    {
+        QVERIFY( kysely.exec( QString("SELECT kohdennus, SUM(debetsnt), SUM(kreditsnt) FROM vienti WHERE "
+                                      "tili=%1 AND pvm < '%2' GROUP BY kohdennus ORDER BY kohdennus")
+                              .arg(tili).arg(paattyy.toString(Qt::ISODate))) );
+        while( kysely.next())
+            kohdennusKerrallaan[tili].append( qMakePair( kysely.value(0).toInt(), kysely.value(1).toLongLong() - kysely.value(2).toLongLong()));
+    }
+    qint64 kerrallaanMs = ajastin.elapsed();
+
+    qInfo("%d erää, %d avoinna: ryhmitellen %lld ms, erä kerrallaan %lld ms",
+          eria, ehdotetut.count(), ryhmitellenMs, kerrallaanMs);
+
+    QVERIFY( ehdotetut.count() > 0 );
+    QVERIFY( ehdotetut.count() < eria );
+    QCOMPARE( ehdotetut, eraKerrallaan );
+
+    QCOMPARE( kohdennusSaldot.count(), 2 );
+    for( int tili : {3, 4})
+    {
+        QCOMPARE( kohdennusSaldot.value(tili), kohdennusKerrallaan.value(tili) );
+        for( const auto& kohdennusSaldo : kohdennusSaldot.value(tili))
+            QCOMPARE( PoistoLaskenta::menojaannospoisto( kohdennusSaldo.second, 25),
+                      qlonglong( std::round( kohdennusSaldo.second * 25 / 100.0 )) );
+    }
+
+    // Poistoajaton erä ei kerrytä poistoja
+    QCOMPARE( PoistoLaskenta::tasaerapoisto(1000, 1000, 0, QDate(2019,1,1), QDate(2019,12,31)), 0LL);
+}
+
+void KirjanpitoTesti::avoimetEratTesti()
+{
+    // Tilillä on paljon eriä, joista 500 on vielä avoinna
+    const int eria = koko(5000, 200000);
+    const int avoimia = 500;
+
+    QSqlDatabase db = tyhjaKirjanpito("erasaldo");
+    QVERIFY( db.isOpen() );
+
+    QSqlQuery kysely(db);
+    QVERIFY( kysely.exec("INSERT INTO tili(id, nro, nimi, tyyppi, ysiluku) VALUES (1, 1701, 'Myyntisaamiset', 'AS', 170100009)") );
+
+    // Tositteella 1 avataan erät ja tositteella 2 suoritetaan kaikki paitsi avoimet
+    db.transaction();
+    QVERIFY( kysely.exec("INSERT INTO tosite(id, pvm, tunniste) VALUES (1, '2000-01-01', 1), (2, '2020-01-01', 2)") );
+    kysely.prepare("INSERT INTO vienti(id, tosite, vientirivi, pvm, tili, selite, debetsnt, kreditsnt, eraid) "
+                   "VALUES (?,?,?,?,1,?,?,?,?)");
+    for(int i=1; i <= eria; i++)
+    {
+        kysely.addBindValue(i);
+        kysely.addBindValue(1);
+        kysely.addBindValue(i);
+        kysely.addBindValue(QDate(2000,1,1).addDays(i % 7000));
+        kysely.addBindValue(QString("Lasku %1").arg(i));
+        kysely.addBindValue(1000 + i % 1000);
+        kysely.addBindValue(QVariant());
+        kysely.addBindValue(i);
+        QVERIFY( kysely.exec() );
+    }
+    for(int i=avoimia + 1; i <= eria; i++)
+    {
+        kysely.addBindValue(eria + i);
+        kysely.addBindValue(2);
+        kysely.addBindValue(i);
+        kysely.addBindValue(QDate(2020,1,1));
+        kysely.addBindValue(QString("Suoritus %1").arg(i));
+        kysely.addBindValue(QVariant());
+        kysely.addBindValue(1000 + i % 1000);
+        kysely.addBindValue(i);
+        QVERIFY( kysely.exec() );
+    }
+    EraSaldo::muuta(&db, 1, 1);
+    EraSaldo::muuta(&db, 2, 1);
+    QVERIFY( db.commit() );
+
+    // Saldotaulun avoimet erät ovat samat kuin tilin historiasta lasketut
+    QVERIFY( kysely.exec("SELECT eraid, SUM(IFNULL(debetsnt,0)) - SUM(IFNULL(kreditsnt,0)) FROM vienti "
+                         "WHERE tili=1 AND eraid IS NOT NULL GROUP BY eraid") );
+    QMap<int,qlonglong> historiasta;
+    while( kysely.next())
+        if( kysely.value(1).toLongLong())
+            historiasta.insert( kysely.value(0).toInt(), kysely.value(1).toLongLong());
+    QCOMPARE( historiasta.count(), avoimia);
+
+    QSqlQuery avoimet(db);
+    QVERIFY( avoimet.exec( EraSaldo::avoimet(1) ) );
+    QMap<int,qlonglong> saldoista;
+    QDate edellinen;
+    while( avoimet.next())
+    {
+        saldoista.insert( avoimet.value("id").toInt(), avoimet.value("saldo").toLongLong());
+        QVERIFY( avoimet.value("pvm").toDate() >= edellinen );
+        edellinen = avoimet.value("pvm").toDate();
+    }
+    QCOMPARE( saldoista, historiasta );
+
+    // Valittuna oleva, jo suoritettu erä otetaan mukaan
+    QVERIFY( avoimet.exec( EraSaldo::avoimet(1, eria) ) );
+    int loytyi = 0;
+    while( avoimet.next())
+        loytyi++;
+    QCOMPARE( loytyi, avoimia + 1);
+
+    // Tositteen poistaminen saldoista avaa sen suorittamat erät uudelleen
+    EraSaldo::muuta(&db, 2, -1);
+    QVERIFY( kysely.exec("SELECT COUNT(*) FROM erasaldo WHERE tili=1 AND saldo <> 0") );
+    QVERIFY( kysely.next() );
+    QCOMPARE( kysely.value(0).toInt(), eria );
+}
+
+void KirjanpitoTesti::maksuperusteinenTesti()
+{
+    QSqlDatabase db = tyhjaKirjanpito("maksualv");
+    QVERIFY( db.isOpen() );
+
+    // Myyntisaatavan tili 1, maksuperusteinen alv-velka 2, myynnit 3
+    QSqlQuery kysely(db);
+    QVERIFY( kysely.exec("INSERT INTO tili(id, nro, nimi, tyyppi, ysiluku) VALUES "
+                         "(1, 1701, 'Myyntisaamiset', 'AS', 170100009), "
+                         "(2, 29391, 'Maksuperusteinen arvonlisäverovelka', 'BLM', 293910009), "
+                         "(3, 3000, 'Myynti', 'C', 300000009)") );
+    QVERIFY( kysely.exec("INSERT INTO tositelaji(id, tunnus, nimi) VALUES (2, 'MY', 'Myyntilaskut')") );
+
+    const int laskuja = 60;
+    db.transaction();
+    kysely.prepare("INSERT INTO tosite(id, pvm, laji, tunniste) VALUES (?,?,2,?)");
+    for(int i=1; i <= 2 * laskuja; i++)
+    {
+        kysely.addBindValue(i);
+        kysely.addBindValue(QDate(2019,1,1).addDays(i));
+        kysely.addBindValue(i);
+        QVERIFY( kysely.exec() );
+    }
+
+    kysely.prepare("INSERT INTO vienti(tosite, vientirivi, pvm, tili, selite, debetsnt, kreditsnt, eraid, alvprosentti) "
+                   "VALUES (?,0,?,?,?,?,?,?,?)");
+    auto vienti = [&kysely] (int tosite, int tili, qlonglong debet, qlonglong kredit, QVariant eraid, int alv) {
+        kysely.addBindValue(tosite);
+        kysely.addBindValue(QDate(2019,1,1).addDays(tosite));
+        kysely.addBindValue(tili);
+        kysely.addBindValue(QString("Lasku %1").arg(tosite));
+        kysely.addBindValue(debet ? QVariant(debet) : QVariant());
+        kysely.addBindValue(kredit ? QVariant(kredit) : QVariant());
+        kysely.addBindValue(eraid);
+        kysely.addBindValue(alv);
+        return kysely.exec() ? kysely.lastInsertId().toInt() : 0;
+    };
+
+    QList<int> erat;
+    for(int i=1; i <= laskuja; i++)
+    {
+        int era = vienti(i, 1, 12400 + 7 * i, 0, QVariant(), 0);
+        QSqlQuery(QString("UPDATE vienti SET eraid=id WHERE id=%1").arg(era), db);
+        vienti(i, 3, 0, 10000, QVariant(), 24);
+        int vero = vienti(i, 2, 0, 2400 + 7 * i, QVariant(), 24);
+        QVERIFY( era && vero );
+        QSqlQuery(QString("UPDATE vienti SET eraid=id WHERE id=%1").arg(vero), db);
+        if( i % 5 == 0)
+        {
+            // Toisen verokannan rivi
+            int vero10 = vienti(i, 2, 0, 1000, QVariant(), 10);
+            QSqlQuery(QString("UPDATE vienti SET eraid=id WHERE id=%1").arg(vero10), db);
+        }
+        if( i % 3 == 0)
+            vienti(laskuja + i, 1, 0, 5000, era, 0);     // Osasuoritus
+        if( i % 7 == 0)
+            vienti(laskuja + i, 2, 2400 + 7 * i, 0, vero, 24);  // Vero jo maksettu
+        erat.append(era);
+    }
+    QVERIFY( db.commit() );
+    erat.append(999999);     // Olematon erä
+
+    MaksuAlvHaku haku(db);
+    haku.hae(erat, QList<int>() << 2);
+
+    for(int eraId : erat)
+    {
+        // Verrataan aiempaan rivi kerrallaan tehtyyn hakuun
+        QSqlQuery ref(db);
+        ref.exec(QString("SELECT sum(debetsnt),sum(kreditsnt) from vienti where eraid=%1").arg(eraId));
+        qlonglong saldo = ref.next() ? ref.value(0).toLongLong() - ref.value(1).toLongLong() : 0;
+        ref.exec(QString("SELECT tosite FROM vienti WHERE id=%1").arg(eraId));
+        int tosite = ref.next() ? ref.value("tosite").toInt() : -1;
+
+        QList<MaksuAlvEra> refVerot;
+        ref.exec(QString("SELECT alvprosentti, debetsnt, kreditsnt, id FROM vienti "
+                         "WHERE tili=%1 AND tosite=%2").arg(2).arg(tosite));
+        while( ref.next())
+        {
+            MaksuAlvEra maksuEra;
+            maksuEra.alvprosentti = ref.value("alvprosentti").toInt();
+            maksuEra.id = ref.value("id").toInt();
+            QSqlQuery veroSaldo(QString("SELECT sum(debetsnt),sum(kreditsnt) from vienti where eraid=%1").arg(maksuEra.id), db);
+            if( veroSaldo.next())
+                maksuEra.sentit = veroSaldo.value(0).toLongLong() - veroSaldo.value(1).toLongLong();
+            if( maksuEra.sentit)
+                refVerot.append(maksuEra);
+        }
+
+        MaksuAlvLasku lasku = haku.lasku(eraId);
+        QList<MaksuAlvEra> verot = haku.verot(eraId, 2);
+        if( tosite < 0)
+        {
+            QVERIFY( verot.isEmpty() );
+            continue;
+        }
+        QCOMPARE( lasku.saldoSnt, saldo);
+        QCOMPARE( lasku.tositeId, tosite);
+        QCOMPARE( verot.count(), refVerot.count());
+
+        // Suoritetaan koko saldo tai osa siitä
+        for(qlonglong suoritus : QList<qlonglong>() << saldo << saldo / 3)
+        {
+            double kerroin = 1.00;
+            if( saldo != suoritus )
+                kerroin = ((double) suoritus) / (double) saldo;
+
+            QList<MaksuAlvEra> jaetut = MaksuAlvHaku::jaa(suoritus, lasku.saldoSnt, verot);
+            QCOMPARE( jaetut.count(), refVerot.count());
+            for(int i=0; i < refVerot.count(); i++)
+            {
+                QCOMPARE( jaetut.at(i).id, refVerot.at(i).id);
+                QCOMPARE( jaetut.at(i).alvprosentti, refVerot.at(i).alvprosentti);
+                qlonglong sentit = kerroin == 1.00 ? refVerot.at(i).sentit :
+                                                     qRound( kerroin * (double) refVerot.at(i).sentit );
+                QCOMPARE( jaetut.at(i).sentit, sentit);
+            }
+        }
+    }
+}
+
+void KirjanpitoTesti::laskupohjaTesti()
+{
+    QFile tiedosto(":/lasku/laskutekstit.txt");
+    QVERIFY( tiedosto.open(QIODevice::ReadOnly) );
+
+    // Kirjanpidon omat tekstit korvaavat oletustekstit
+    LaskuPohja pohja;
+    pohja.tekstit = LaskuPohja::lueTekstit(&tiedosto, QStringList() << "FIlaskuotsikko LASKU");
+    QCOMPARE( pohja.t("laskuotsikko","FI"), QString("LASKU"));
+    QCOMPARE( pohja.t("laskuotsikko","EN"), QString("Invoice"));
+
+    // Kirjanpitoon tallennettu logo on usein suoraan kamerasta tai skannerista
+    QImage logo(3000, 1000, QImage::Format_RGB32);
+    logo.fill( Qt::darkBlue );
+    QCOMPARE( LaskuPohja::skaalaaLogo(logo).height(), 400);
+}
+
+namespace {
+
+struct AineistonLasku
+{
+    explicit AineistonLasku(int numero) : nro(numero) { elossa.ref(); }
+    ~AineistonLasku() { elossa.deref(); }
+
+    int nro;
+    static QAtomicInt elossa;
+};
+
+QAtomicInt AineistonLasku::elossa;
+
+QByteArray aineistonSanoma(AineistonLasku *lasku)
+{
+    QByteArray sanoma("<SOAP-ENV:Envelope xmlns:SOAP-ENV=\"http://schemas.xmlsoap.org/soap/envelope/\">"
+                      "<SOAP-ENV:Header/><SOAP-ENV:Body/></SOAP-ENV:Envelope>\n");
+    QByteArray finvoice;
+    QXmlStreamWriter writer(&finvoice);
+    writer.setCodec("ISO-8859-15");
+    writer.writeStartDocument("1.0");
+    writer.writeStartElement("Finvoice");
+    writer.writeAttribute("Version","3.0");
+    writer.writeStartElement("MessageTransmissionDetails");
+    writer.writeStartElement("MessageDetails");
+    writer.writeTextElement("MessageIdentifier", QString::number(lasku->nro));
+    writer.writeEndElement();
+    writer.writeEndElement();
+    writer.writeTextElement("InvoiceFreeText", QString("Lasku %1 äöå €").arg(lasku->nro));
+    writer.writeEndDocument();
+    return sanoma + finvoice + '\n';
+}
+
+}
+
+void KirjanpitoTesti::finvoiceAineistoTesti()
+{
+    // Kirjanpidon myyntilaskut, sanoman tunniste on laskun numero
+    QSqlQuery kysely( *kp()->tietokanta() );
+    QVERIFY( kysely.exec("SELECT vienti.id, vienti.viite FROM vienti JOIN tili ON vienti.tili=tili.id "
+                         "WHERE tili.nro=1701 AND vienti.eraid=vienti.id AND vienti.viite IS NOT NULL "
+                         "ORDER BY vienti.id") );
+    QList<int> vientiIdt;
+    QStringList tunnisteet;
+    while( kysely.next())
+    {
+        vientiIdt.append( kysely.value(0).toInt() );
+        tunnisteet.append( QString::number( kysely.value(1).toULongLong() ));
+    }
+    QVERIFY( vientiIdt.count() > 100 );
+
+    QString polku = hakemisto_.filePath("finvoice.xml");
+    QVERIFY( Finvoice::muodostaAineisto( vientiIdt, polku ) );
+    QFile tiedosto( polku );
+    QVERIFY( tiedosto.open(QIODevice::ReadOnly) );
+    const QByteArray tiedostonSisalto = tiedosto.readAll();
+    tiedosto.close();
+
+    QXmlSchema skeema;
+    QVERIFY( skeema.load( QUrl::fromLocalFile( QFINDTESTDATA("finvoice3.xsd") )) );
+    QVERIFY( skeema.isValid() );
+    QXmlSchemaValidator validoija( skeema );
+
+    // Jokaisella laskulla on oma SOAP-kehys, jota seuraa kehyksen viittaama sanoma
+    const QByteArray kehyksenAlku("<SOAP-ENV:Envelope");
+    const QByteArray kehyksenLoppu("</SOAP-ENV:Envelope>");
+    QList<int> alut;
+    for(int i = tiedostonSisalto.indexOf(kehyksenAlku); i >= 0; i = tiedostonSisalto.indexOf(kehyksenAlku, i + 1))
+        alut.append(i);
+    QCOMPARE( alut.count(), vientiIdt.count() );
+    QCOMPARE( alut.first(), 0 );
+    alut.append( tiedostonSisalto.size() );
+
+    for(int i=0; i < vientiIdt.count(); i++)
+    {
+        QByteArray sanoma = tiedostonSisalto.mid( alut.at(i), alut.at(i+1) - alut.at(i) );
+        int kehyksenPituus = sanoma.indexOf(kehyksenLoppu) + kehyksenLoppu.length();
+        QVERIFY( kehyksenPituus > kehyksenLoppu.length() );
+
+        QXmlStreamReader kehys( sanoma.left(kehyksenPituus) );
+        QString kehyksenTunniste;
+        QString viittaus;
+        while( !kehys.atEnd())
+        {
+            if( kehys.readNext() != QXmlStreamReader::StartElement )
+                continue;
+            if( kehys.qualifiedName() == "eb:MessageId")
+                kehyksenTunniste = kehys.readElementText();
+            else if( kehys.qualifiedName() == "eb:Reference")
+                viittaus = kehys.attributes().value("http://www.w3.org/1999/xlink", "href").toString();
+        }
+        QVERIFY2( !kehys.hasError(), qPrintable( kehys.errorString() ));
+
+        QByteArray finvoice = sanoma.mid( kehyksenPituus ).trimmed();
+        QXmlStreamReader lukija( finvoice );
+        QString sanomanTunniste;
+        while( !lukija.atEnd())
+        {
+            if( lukija.readNext() == QXmlStreamReader::StartElement && lukija.name() == "MessageIdentifier")
+                sanomanTunniste = lukija.readElementText();
+        }
+        QVERIFY2( !lukija.hasError(), qPrintable( lukija.errorString() ));
+
+        QCOMPARE( sanomanTunniste, tunnisteet.at(i) );
+        QCOMPARE( kehyksenTunniste, sanomanTunniste );
+        QCOMPARE( viittaus, sanomanTunniste );
+        QVERIFY2( validoija.validate( finvoice, QUrl::fromLocalFile(polku) ),
+                  qPrintable( QString("Lasku %1 ei ole Finvoice 3.0 -skeeman mukainen").arg(sanomanTunniste) ));
+    }
+
+    // Muistin käyttö ja keskeytys tarkastetaan keinotekoisilla laskuilla
+    const int laskuja = 1000;
+    const int ikkuna = 16;
+
+    QByteArray aineisto;
+    QBuffer puskuri(&aineisto);
+    QVERIFY( puskuri.open(QIODevice::WriteOnly) );
+
+    FinvoiceAineisto<AineistonLasku> kirjoittaja( [] (int i) { return new AineistonLasku(i + 1); },
+                                                  &aineistonSanoma, ikkuna);
+    QVERIFY( kirjoittaja.kirjoita(&puskuri, laskuja) );
+    puskuri.close();
+
+    // Laskut on vapautettu ja muistissa on ollut enintään kaksi ikkunallista
+    QCOMPARE( int(AineistonLasku::elossa), 0);
+    QVERIFY( kirjoittaja.suurinLadattuna() <= 2 * ikkuna );
+
+    // Jokaisella sanomalla on oma SOAP-kehys ja sanomat ovat laskujen järjestyksessä
+    QList<QByteArray> sanomat = aineisto.split('\n');
+    sanomat.removeAll(QByteArray());
+    int nro = 0;
+    for(int i=0; i + 1 < sanomat.count(); i += 2)
+    {
+        QXmlStreamReader kehys( sanomat.at(i) );
+        QVERIFY( kehys.readNextStartElement() );
+        QCOMPARE( kehys.qualifiedName().toString(), QString("SOAP-ENV:Envelope"));
+        while( !kehys.atEnd())
+            kehys.readNext();
+        QVERIFY( !kehys.hasError() );
+
+        QXmlStreamReader finvoice( sanomat.at(i+1) );
+        QString tunniste;
+        while( !finvoice.atEnd())
+        {
+            if( finvoice.readNext() == QXmlStreamReader::StartElement && finvoice.name() == "MessageIdentifier")
+                tunniste = finvoice.readElementText();
+        }
+        QVERIFY( !finvoice.hasError() );
+        QCOMPARE( tunniste.toInt(), ++nro );
+    }
+    QCOMPARE( nro, laskuja );
+
+    // Latausvirhe keskeyttää aineiston eikä jätä laskuja muistiin
+    QBuffer toinen;
+    toinen.open(QIODevice::WriteOnly);
+    FinvoiceAineisto<AineistonLasku> keskeytyva( [] (int i) { return i == 500 ? nullptr : new AineistonLasku(i + 1); },
+                                                 &aineistonSanoma, ikkuna);
+    QVERIFY( !keskeytyva.kirjoita(&toinen, laskuja) );
+    QCOMPARE( int(AineistonLasku::elossa), 0);
+}
+
+void KirjanpitoTesti::tuotemyyntiTesti_data()
+{
+    QTest::addColumn<int>("ryhmittely");
+    QTest::addColumn<QString>("avain");
+
+    QTest::newRow("tuotteittain") << int(TuoteMyynti::Tuotteittain) << "json_extract(rivi.value,'$.Nimike')";
+    QTest::newRow("asiakkaittain") << int(TuoteMyynti::Asiakkaittain) << "vienti.asiakas";
+    QTest::newRow("kuukausittain") << int(TuoteMyynti::Kuukausittain) << "strftime('%Y-%m',vienti.pvm)";
+    QTest::newRow("kohdennuksittain") << int(TuoteMyynti::Kohdennuksittain) << "IFNULL(json_extract(rivi.value,'$.Kohdennus'),0)";
+}
+
+void KirjanpitoTesti::tuotemyyntiTesti()
+{
+    QFETCH(int, ryhmittely);
+    QFETCH(QString, avain);
+
+    const int laskuja = koko(2000, 100000);
+
+    QSqlDatabase db = QSqlDatabase::database("tuotemyynti", false);
+    if( !db.isValid())
+    {
+        // Aineisto luodaan kerran kaikille ryhmittelyille: laskuja, joilla 1-4 riviä
+        db = tyhjaKirjanpito("tuotemyynti");
+        QVERIFY( db.isOpen() );
+
+        QSqlQuery kysely(db);
+        QSqlQuery tosite(db);
+        tosite.prepare("INSERT INTO tosite(id, pvm, tunniste) VALUES (?,?,?)");
+        db.transaction();
+        kysely.prepare("INSERT INTO vienti(id, tosite, vientirivi, pvm, viite, asiakas, json) VALUES (?,?,0,?,?,?,?)");
+        for(int i=1; i <= laskuja; i++)
+        {
+            QString rivit;
+            for(int r=0; r <= i % 4; r++)
+            {
+                int tuote = (i * 7 + r * 13) % 50;
+                double maara = 1 + (i + r) % 9 * 0.25;
+                qlonglong netto = qRound64( maara * (1000 + tuote * 10) );
+                qlonglong brutto = netto + netto * 24 / 100;
+                rivit.append( QString("%1{\"Nimike\":\"Tuote %2\",\"Tuotekoodi\":%2,\"Alvprosentti\":24,\"Kohdennus\":%3,"
+                                      "\"Maara\":\"%4\",\"Nettoyht\":%5,\"Alv\":%6,\"Yhteensa\":%7}")
+                              .arg( r ? "," : "").arg(tuote).arg(tuote % 3).arg(maara,0,'f',2)
+                              .arg(netto).arg(brutto - netto).arg(brutto));
+            }
+            tosite.addBindValue(i);
+            tosite.addBindValue(QDate(2019,1,1).addDays(i % 365));
+            tosite.addBindValue(i);
+            QVERIFY( tosite.exec() );
+
+            kysely.addBindValue(i);
+            kysely.addBindValue(i);
+            kysely.addBindValue(QDate(2019,1,1).addDays(i % 365));
+            kysely.addBindValue(QString::number(i));
+            kysely.addBindValue(QString("Asiakas %1").arg(i % 200));
+            kysely.addBindValue(QString("{\"Osoite\":\"Testitie\",\"Laskurivit\":[%1]}").arg(rivit));
+            QVERIFY( kysely.exec() );
+            TuoteMyynti::paivita(&db, i);
+        }
+        // Tallentaminen uudelleen ei kahdenna rivejä
+        for(int i=1; i <= 1000; i++)
+            TuoteMyynti::paivita(&db, i);
+        QVERIFY( db.commit() );
+    }
+
+    QDate mista(2019,2,1);
+    QDate mihin(2019,10,31);
+
+    // Vertailukohtana laskurivien purkaminen json-kentästä
+    QSqlQuery json(db);
+    QVERIFY( json.exec(QString("SELECT %1 AS avain, SUM(json_extract(rivi.value,'$.Maara')) AS maara, "
+                               "SUM(json_extract(rivi.value,'$.Nettoyht')) AS netto, "
+                               "SUM(json_extract(rivi.value,'$.Yhteensa')) AS brutto "
+                               "FROM vienti, json_each(vienti.json,'$.Laskurivit') AS rivi "
+                               "WHERE viite IS NOT NULL AND json_type(vienti.json,'$.Laskurivit')='array' "
+                               "AND pvm BETWEEN '%2' AND '%3' GROUP BY avain ORDER BY avain")
+                       .arg(avain).arg(mista.toString(Qt::ISODate)).arg(mihin.toString(Qt::ISODate))) );
+
+    QSqlQuery taulu(db);
+    QVERIFY( taulu.exec( TuoteMyynti::kysely( static_cast<TuoteMyynti::Ryhmittely>(ryhmittely), mista, mihin)) );
+
+    int ryhmia = 0;
+    while( json.next())
+    {
+        QVERIFY( taulu.next() );
+        QCOMPARE( taulu.value("avain").toString(), json.value("avain").toString());
+        QCOMPARE( qRound64( taulu.value("maara").toDouble() * 100), qRound64( json.value("maara").toDouble() * 100));
+        QCOMPARE( taulu.value("netto").toLongLong(), json.value("netto").toLongLong());
+        QCOMPARE( taulu.value("brutto").toLongLong(), json.value("brutto").toLongLong());
+        ryhmia++;
+    }
+    QVERIFY( !taulu.next() );
+    QVERIFY( ryhmia > 0 );
+}
+
+void KirjanpitoTesti::budjettiTesti()
+{
+    // 300 kohdennusta, joilla kullakin 50 tilin budjetti kahdella tilikaudella
+    const int kohdennuksia = 300;
+    const int tileja = 50;
+
+    QSqlDatabase db = tyhjaKirjanpito("budjetti");
+    QVERIFY( db.isOpen() );
+
+    QSqlQuery kysely(db);
+    QVERIFY( kysely.exec("INSERT INTO tilikausi(alkaa, loppuu) VALUES ('2018-01-01','2018-12-31'), ('2019-01-01','2019-12-31')") );
+
+    QHash<int,qlonglong> odotetut;
+    QVariantMap budjetit2019;
+    db.transaction();
+    for(int vuosi = 2018; vuosi <= 2019; vuosi++)
+    {
+        QVariantMap budjetit;
+        for(int k=0; k < kohdennuksia; k++)
+        {
+            QVariantMap tilit;
+            for(int t=0; t < tileja; t++)
+            {
+                qlonglong sentit = (vuosi - 2000) * 1000 + k * tileja + t;
+                tilit.insert( QString::number(3000 + t * 10), sentit);
+                if( vuosi == 2019)
+                    odotetut[k] += sentit;
+            }
+            budjetit.insert( QString::number(k), tilit);
+        }
+        Budjetti::paivita( &db, QDate(vuosi,1,1), budjetit);
+        budjetit2019 = budjetit;
+    }
+    // Uudelleen tallennettaessa vanhat rivit korvautuvat
+    Budjetti::paivita( &db, QDate(2019,1,1), budjetit2019);
+    QVERIFY( db.commit() );
+
+    QHash<int,qlonglong> summat;
+    int riveja = 0;
+    QVERIFY( kysely.exec( Budjetti::kysely( QDate(2019,1,1), QDate(2019,12,31))) );
+    while( kysely.next())
+    {
+        QCOMPARE( kysely.value(0).toDate(), QDate(2019,1,1));
+        QCOMPARE( kysely.value(1).toDate(), QDate(2019,12,31));
+        summat[ kysely.value(2).toInt() ] += kysely.value(4).toLongLong();
+        riveja++;
+    }
+    QCOMPARE( riveja, kohdennuksia * tileja);
+    QCOMPARE( summat, odotetut);
+
+    // Kahteen tilikauteen osuva väli
+    riveja = 0;
+    QVERIFY( kysely.exec( Budjetti::kysely( QDate(2018,7,1), QDate(2019,6,30))) );
+    while( kysely.next())
+        riveja++;
+    QCOMPARE( riveja, 2 * kohdennuksia * tileja);
+}
+
+namespace {
+
+/**
+ * @brief Raportin csv-rivit sarakkeittain
+ *
+ * Erottimena on puolipiste ja lainausmerkit poistetaan.
+ */
+QList<QStringList> csvRivit(const QByteArray& csv)
+{
+    QList<QStringList> rivit;
+    for( const QString& rivi : QString::fromUtf8(csv).split("\r\n"))
+    {
+        QStringList sarakkeet;
+        for( QString sarake : rivi.split(';'))
+        {
+            if( sarake.length() > 1 && sarake.startsWith('"') && sarake.endsWith('"'))
+                sarake = sarake.mid(1, sarake.length() - 2).replace("\"\"", "\"");
+            sarakkeet.append( sarake );
+        }
+        rivit.append( sarakkeet );
+    }
+    return rivit;
+}
+
+/**
+ * @brief Budjetti-, toteuma-, budjettiero- ja toteuma-% -sarakkeiden odotettu csv
+ */
+QStringList budjettiSarakkeet(qlonglong toteuma, qlonglong budjetti)
+{
+    auto euroa = [] (qlonglong sentit) { return QString("%1").arg( sentit / 100.0, 0, 'f', 2); };
+    return QStringList() << ( budjetti ? euroa(budjetti) : QString() )
+                         << euroa(toteuma)
+                         << euroa(toteuma - budjetti)
+                         << ( budjetti ? euroa( 10000 * toteuma / budjetti ) : QString() );
+}
+
+/**
+ * @brief Tulostilien summat ilman tasetilejä
+ */
+QMap<int,qlonglong> tulostilit(QMap<int,qlonglong> summat)
+{
+    QMutableMapIterator<int,qlonglong> iter(summat);
+    while( iter.hasNext())
+    {
+        iter.next();
+        if( iter.key() && iter.key() <= 300000000)
+            iter.remove();
+    }
+    return summat;
+}
+
+}
+
+void KirjanpitoTesti::budjettiSarakeTesti()
+{
+    const QDate alkaa(2017,1,1);
+    const QDate paattyy(2017,12,31);
+
+    // Odotetut budjetit tilikauden tiedoista, joista budjettitaulu on muodostettu
+    QSqlQuery kysely( *kp()->tietokanta() );
+    QHash<int,int> ysiluvut;
+    QVERIFY( kysely.exec("SELECT nro, ysiluku FROM tili WHERE tyyppi NOT LIKE 'H%'") );
+    while( kysely.next())
+        ysiluvut.insert( kysely.value(0).toInt(), kysely.value(1).toInt() );
+
+    QVERIFY( kysely.exec( QString("SELECT json FROM tilikausi WHERE alkaa='%1'").arg( alkaa.toString(Qt::ISODate))) );
+    QVERIFY( kysely.next() );
+    QVariantMap budjetit = QJsonDocument::fromJson( kysely.value(0).toByteArray() ).object().toVariantMap().value("Budjetti").toMap();
+
+    QHash<int, QMap<int,qlonglong> > odotetutBudjetit;     // kohdennusId, -1 kaikki
+    for( auto kohdennus = budjetit.constBegin(); kohdennus != budjetit.constEnd(); ++kohdennus)
+    {
+        const QVariantMap tilit = kohdennus.value().toMap();
+        for( auto tili = tilit.constBegin(); tili != tilit.constEnd(); ++tili)
+        {
+            QVERIFY( ysiluvut.contains( tili.key().toInt() ));
+            for( int kohdennusId : { kohdennus.key().toInt(), -1 })
+            {
+                odotetutBudjetit[kohdennusId][ ysiluvut.value( tili.key().toInt() ) ] += tili.value().toLongLong();
+                odotetutBudjetit[kohdennusId][0] += tili.value().toLongLong();
+            }
+        }
+    }
+    QVERIFY( odotetutBudjetit.count() > 2 );
+
+    // Odotetut toteumat vienneistä yksitellen, merkkaukset merkkaustaulusta
+    QHash<int,bool> merkkaukset;
+    auto onkoMerkkaus = [&merkkaukset] (int kohdennusId) {
+        if( !merkkaukset.contains(kohdennusId))
+            merkkaukset.insert( kohdennusId, kp()->kohdennukset()->kohdennus(kohdennusId).tyyppi() == Kohdennus::MERKKAUS );
+        return merkkaukset.value(kohdennusId);
+    };
+
+    QMap<int,qlonglong> odotettuTulos;
+    odotettuTulos.insert(0, 0);
+    QHash<int, QMap<int,qlonglong> > odotetutKohdennukset;
+    QVERIFY( kysely.exec( QString("SELECT vienti.kohdennus, tili.ysiluku, vienti.debetsnt, vienti.kreditsnt "
+                                  "FROM vienti JOIN tili ON vienti.tili=tili.id WHERE vienti.pvm BETWEEN '%1' AND '%2'")
+                          .arg( alkaa.toString(Qt::ISODate)).arg( paattyy.toString(Qt::ISODate))) );
+    while( kysely.next())
+    {
+        int ysiluku = kysely.value(1).toInt();
+        if( ysiluku <= 300000000)
+            continue;
+        qlonglong summa = kysely.value(3).toLongLong() - kysely.value(2).toLongLong();
+        odotettuTulos[ysiluku] += summa;
+        odotettuTulos[0] += summa;
+
+        int kohdennusId = kysely.value(0).toInt();
+        if( onkoMerkkaus(kohdennusId))
+            continue;
+        odotetutKohdennukset[kohdennusId][ysiluku] += summa;
+        odotetutKohdennukset[kohdennusId][0] += summa;
+    }
+    QVERIFY( kysely.exec( QString("SELECT merkkaus.kohdennus, tili.ysiluku, vienti.debetsnt, vienti.kreditsnt "
+                                  "FROM merkkaus JOIN vienti ON merkkaus.vienti=vienti.id JOIN tili ON vienti.tili=tili.id "
+                                  "WHERE vienti.pvm BETWEEN '%1' AND '%2'")
+                          .arg( alkaa.toString(Qt::ISODate)).arg( paattyy.toString(Qt::ISODate))) );
+    while( kysely.next())
+    {
+        int kohdennusId = kysely.value(0).toInt();
+        int ysiluku = kysely.value(1).toInt();
+        if( ysiluku <= 300000000 || !onkoMerkkaus(kohdennusId))
+            continue;
+        qlonglong summa = kysely.value(3).toLongLong() - kysely.value(2).toLongLong();
+        odotetutKohdennukset[kohdennusId][ysiluku] += summa;
+        odotetutKohdennukset[kohdennusId][0] += summa;
+    }
+    QVERIFY( odotetutKohdennukset.count() > 2 );
+
+    // Budjettisarake ensin, jolloin toteuma ja johdetut sarakkeet saavat
+    // saman kauden summat ja budjetit aiemmista sarakkeista
+    auto lisaaSarakkeet = [alkaa, paattyy] (Raportoija& raportoija) {
+        raportoija.lisaaKausi( alkaa, paattyy, Raportoija::BUDJETTI);
+        raportoija.lisaaKausi( alkaa, paattyy, Raportoija::TOTEUTUNUT);
+        raportoija.lisaaKausi( alkaa, paattyy, Raportoija::BUDJETTIERO);
+        raportoija.lisaaKausi( alkaa, paattyy, Raportoija::TOTEUMAPROSENTTI);
+    };
+
+    kp()->settings()->setValue("CsvErotin", QChar(';'));
+    kp()->settings()->setValue("CsvDesimaali", QChar('.'));
+
+    // Kaikki kohdennukset yhteensä
+    SarakeRaportoija kaikki("Tuloslaskelma/Yleinen");
+    lisaaSarakkeet(kaikki);
+    QList<QStringList> rivit = csvRivit( kaikki.raportti(false).csv() );
+
+    QVERIFY( kaikki.summat(0).isEmpty() );
+    QVERIFY( kaikki.vertailu(1).isEmpty() );
+    for( int sarake : { 1, 2, 3 })
+        QCOMPARE( kaikki.summat(sarake), odotettuTulos );
+    for( int sarake : { 0, 2, 3 })
+        QCOMPARE( kaikki.vertailu(sarake), odotetutBudjetit.value(-1) );
+
+    QStringList tulosrivi;
+    for( const QStringList& rivi : rivit)
+        if( rivi.value(0) == "Tilikauden voitto / tappio")
+            tulosrivi = rivi;
+    QCOMPARE( tulosrivi.mid(1), budjettiSarakkeet( odotettuTulos.value(0), odotetutBudjetit.value(-1).value(0) ));
+
+    // Kohdennuksittain
+    QSet<int> kohdennukset = odotetutKohdennukset.keys().toSet() + odotetutBudjetit.keys().toSet();
+    kohdennukset.remove(-1);
+    for( int kohdennusId : kohdennukset)
+    {
+        SarakeRaportoija yksi("Tuloslaskelma/Yleinen");
+        lisaaSarakkeet(yksi);
+        yksi.lisaaKohdennus( kohdennusId );
+        yksi.raportti(false);
+
+        QMap<int,qlonglong> budjetti = odotetutBudjetit.value(kohdennusId);
+        if( budjetti.isEmpty())
+            budjetti.insert(0, 0);
+        for( int sarake : { 1, 2, 3 })
+            QCOMPARE( tulostilit( yksi.summat(sarake) ), odotetutKohdennukset.value(kohdennusId) );
+        for( int sarake : { 0, 2, 3 })
+            QCOMPARE( yksi.vertailu(sarake), budjetti );
+    }
+
+    // Kohdennuslaskelmassa jokaisen kohdennuksen tulosrivi
+    QHash<QString,int> nimella;
+    for( const Kohdennus& kohdennus : kp()->kohdennukset()->kohdennukset())
+        nimella.insert( kohdennus.nimi().toUpper(), kohdennus.id() );
+
+    SarakeRaportoija kohdennuslaskelma("Kohdennukset");
+    lisaaSarakkeet(kohdennuslaskelma);
+    kohdennuslaskelma.etsiKohdennukset();
+    rivit = csvRivit( kohdennuslaskelma.raportti(false).csv() );
+
+    QSet<int> tarkastetut;
+    for( int i = 0; i < rivit.count(); i++)
+    {
+        if( rivit.at(i).count() != 1 || !nimella.contains( rivit.at(i).first() ))
+            continue;
+        int kohdennusId = nimella.value( rivit.at(i).first() );
+        qlonglong toteuma = odotetutKohdennukset.value(kohdennusId).value(0);
+        qlonglong budjetti = odotetutBudjetit.value(kohdennusId).value(0);
+
+        // Nollarivi jätetään tulostamatta
+        QStringList tulos;
+        for( int j = i + 1; j < rivit.count() && tulos.isEmpty() && rivit.at(j).count() > 1; j++)
+            if( rivit.at(j).first() == "Tulos")
+                tulos = rivit.at(j);
+        if( toteuma || budjetti )
+            QCOMPARE( tulos.mid(1), budjettiSarakkeet( toteuma, budjetti ));
+        else
+            QVERIFY( tulos.isEmpty() );
+        tarkastetut.insert( kohdennusId );
+    }
+    QVERIFY( tarkastetut.count() > 2 );
+    for( int kohdennusId : odotetutBudjetit.keys())
+        QVERIFY( kohdennusId < 0 || tarkastetut.contains(kohdennusId) );
+
+    kp()->settings()->remove("CsvErotin");
+    kp()->settings()->remove("CsvDesimaali");
+}
+
+void KirjanpitoTesti::trendiTesti_data()
+{
+    QTest::addColumn<QString>("raportti");
+    QTest::addColumn<int>("jaksotus");
+
+    QTest::newRow("tuloslaskelma kuukausittain") << "Tuloslaskelma/Yleinen" << int(Raportoija::KUUKAUSITTAIN);
+    QTest::newRow("tuloslaskelma neljännesvuosittain") << "Tuloslaskelma/Yleinen" << int(Raportoija::NELJANNESVUOSITTAIN);
+    QTest::newRow("tuloslaskelma liukuva 12 kk") << "Tuloslaskelma/Yleinen" << int(Raportoija::LIUKUVA12KK);
+    QTest::newRow("tase kuukausittain") << "Tase/Yleinen" << int(Raportoija::KUUKAUSITTAIN);
+}
+
+void KirjanpitoTesti::trendiTesti()
+{
+    QFETCH(QString, raportti);
+    QFETCH(int, jaksotus);
+
+    // Jälkimmäinen tilikausi, jolloin liukuvaan ja taseeseen tulee myös edellisen kauden vientejä
+    const QDate alkaa(2017,1,1);
+    const QDate paattyy(2017,12,31);
+
+    SarakeRaportoija trendi(raportti);
+    int kausia = trendi.lisaaKaudet( alkaa, paattyy, static_cast<Raportoija::Jaksotus>(jaksotus), true, true);
+    QCOMPARE( trendi.sarakkeita(), 2 * kausia );
+    QVERIFY( !trendi.raportti().html().isEmpty() );
+
+    // Kuukausisummista lasketut sarakkeet ovat samat kuin yksin lasketut
+    QList< QMap<int,qlonglong> > yksinaan;
+    QMap<int,qlonglong> yhteensa;
+    for(int i=0; i < trendi.sarakkeita(); i++)
+    {
+        if( trendi.sarakeTyyppi(i) != Raportoija::TOTEUTUNUT)
+            continue;
+
+        SarakeRaportoija yksi(raportti);
+        if( yksi.onkoTaseraportti())
+            yksi.lisaaTasepaiva( trendi.paattyy(i) );
+        else
+            yksi.lisaaKausi( trendi.alkaa(i), trendi.paattyy(i) );
+        yksi.raportti();
+
+        QVERIFY( !yksi.summat(0).isEmpty() );
+        QCOMPARE( trendi.summat(i), yksi.summat(0) );
+
+        yksinaan.append( yksi.summat(0) );
+        for( auto iter = yksi.summat(0).constBegin(); iter != yksi.summat(0).constEnd(); ++iter)
+            yhteensa[iter.key()] += iter.value();
+    }
+    QCOMPARE( yksinaan.count(), kausia );
+
+    // Muutossarake vertaa edeltävää kautta sitä edeltävään
+    int toteuma = -1;
+    for(int i=0; i < trendi.sarakkeita(); i++)
+    {
+        if( trendi.sarakeTyyppi(i) == Raportoija::TOTEUTUNUT)
+            toteuma++;
+        else if( trendi.sarakeTyyppi(i) == Raportoija::MUUTOSPROSENTTI)
+        {
+            QVERIFY( toteuma > 0 );
+            QCOMPARE( trendi.summat(i), yksinaan.at(toteuma) );
+            QCOMPARE( trendi.vertailu(i), yksinaan.at(toteuma - 1) );
+        }
+    }
+
+    // Viimeisenä kaikkien kausien keskiarvo
+    const int keskiarvo = trendi.sarakkeita() - 1;
+    QCOMPARE( trendi.sarakeTyyppi(keskiarvo), int(Raportoija::KESKIARVO) );
+    QMap<int,qlonglong> odotettu;
+    for( auto iter = yhteensa.constBegin(); iter != yhteensa.constEnd(); ++iter)
+        odotettu.insert( iter.key(), iter.value() / kausia );
+    QCOMPARE( trendi.summat(keskiarvo), odotettu );
+
+    if( jaksotus == Raportoija::KUUKAUSITTAIN && !trendi.onkoTaseraportti())
+    {
+        // Kuukausien keskiarvo on koko vuoden tuloksesta kahdestoista osa
+        SarakeRaportoija vuosi(raportti);
+        vuosi.lisaaKausi( alkaa, paattyy );
+        vuosi.raportti();
+        QCOMPARE( vuosi.summat(0).value(0) / 12, trendi.summat(keskiarvo).value(0) );
+    }
+}
+
+void KirjanpitoTesti::raporttiVirtaTesti()
+{
+    const int riveja = 2000;
+
+    auto alusta = [] (RaportinKirjoittaja& kirjoittaja) {
+        kirjoittaja.asetaOtsikko("VIRTATESTI");
+        kirjoittaja.asetaKausiteksti("1.1.2017 - 31.12.2017");
+        kirjoittaja.lisaaPvmSarake();
+        kirjoittaja.lisaaVenyvaSarake();
+        kirjoittaja.lisaaEurosarake();
+        RaporttiRivi otsake;
+        otsake.lisaa("Pvm");
+        otsake.lisaa("Selite");
+        otsake.lisaa("Euroa", 1, true);
+        kirjoittaja.lisaaOtsake(otsake);
+    };
+    auto rivi = [] (int i) {
+        RaporttiRivi raporttiRivi;
+        raporttiRivi.lisaa( QDate(2017,1,1).addDays(i % 365));
+        raporttiRivi.lisaa( QString("Rivi %1 äöå").arg(i));
+        raporttiRivi.lisaa( qlonglong(i * 137 - 50000));
+        return raporttiRivi;
+    };
+
+    // Vertailukohtana rivit talteen kirjoittava raportti
+    RaportinKirjoittaja talletettu;
+    alusta(talletettu);
+    for(int i=0; i < riveja; i++)
+        talletettu.lisaaRivi( rivi(i) );
+
+    QByteArray html;
+    QByteArray csv;
+    QByteArray pdf;
+    QBuffer htmlPuskuri(&html);
+    QBuffer csvPuskuri(&csv);
+    QBuffer pdfPuskuri(&pdf);
+    QVERIFY( htmlPuskuri.open(QIODevice::WriteOnly) && csvPuskuri.open(QIODevice::WriteOnly) &&
+             pdfPuskuri.open(QIODevice::WriteOnly) );
+
+    HtmlRaporttiVirta htmlVirta(&htmlPuskuri);
+    CsvRaporttiVirta csvVirta(&csvPuskuri);
+    PdfRaporttiVirta pdfVirta(&pdfPuskuri, false, true);
+    for( RaporttiVirta* virta : QList<RaporttiVirta*>() << &htmlVirta << &csvVirta << &pdfVirta)
+    {
+        RaportinKirjoittaja virtaan;
+        alusta(virtaan);
+        virtaan.asetaVirta(virta);
+        for(int i=0; i < riveja; i++)
+            virtaan.lisaaRivi( rivi(i) );
+        virtaan.lopetaVirta();
+
+        // Virtaan kirjoitettuja rivejä ei talleteta
+        QVERIFY( !virtaan.html().contains("Rivi 1 ") );
+    }
+
+    QCOMPARE( QString::fromUtf8(html), talletettu.html() );
+    QCOMPARE( csv, talletettu.csv() );
+
+    // Pdf sivutetaan samoin kuin tulostettaessa
+    QVERIFY( pdf.startsWith("%PDF") );
+    QVERIFY( talletettu.pdf(false, true).startsWith("%PDF") );
+
+    QByteArray tuloste;
+    QBuffer tulostePuskuri(&tuloste);
+    QVERIFY( tulostePuskuri.open(QIODevice::WriteOnly) );
+    QPdfWriter writer(&tulostePuskuri);
+    writer.setPageSize( QPdfWriter::A4 );
+    writer.setResolution( kp()->printer()->resolution() );
+    QPainter painter(&writer);
+    int sivuja = talletettu.tulosta(&writer, &painter);
+    painter.end();
+
+    QVERIFY( sivuja > 1 );
+    QCOMPARE( pdfVirta.sivuja(), sivuja );
+}
+
+int KirjanpitoTesti::koko(int pieni, int taysi)
+{
+    return qEnvironmentVariableIsSet("KITUPIIKKI_TAYSI_KOKO") ? taysi : pieni;
+}
+
+QSqlDatabase KirjanpitoTesti::tyhjaKirjanpito(const QString &yhteys)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", yhteys);
+    db.setDatabaseName(":memory:");
+    QString virhe;
+    if( db.open() && !KirjaGeneraattori::luoTaulut(db, &virhe))
+    {
+        qWarning("%s", qPrintable(virhe));
+        db.close();
+    }
+    return db;
+}
+
+QTEST_MAIN(KirjanpitoTesti)
+
+#include "tst_kirjanpitotesti.moc"
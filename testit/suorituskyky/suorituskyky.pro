@@ -0,0 +1,13 @@
+# Suorituskykytestit suurella keksityllä kirjanpidolla
+#
+# Kirjanpidon koon ja siemenen voi antaa ympäristömuuttujilla
+# KITUPIIKKI_SIEMEN ja KITUPIIKKI_TOSITTEITA. Tulokset saa vertailtavaan
+# muotoon QtTestin tulostusvalitsimilla, esimerkiksi
+#   ./suorituskyky -o tulokset.xml,xml
+#   ./suorituskyky -csv -o tulokset.csv,csv
+
+include(../yhteiset/yhteiset.pri)
+
+TARGET = suorituskyky
+
+SOURCES += tst_suorituskyky.cpp
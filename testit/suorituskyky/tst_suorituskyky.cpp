@@ -0,0 +1,831 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <QtTest>
+#include <QCoreApplication>
+
+#include "kirjageneraattori.h"
+
+#include "db/kirjanpito.h"
+#include "db/tositemodel.h"
+#include "db/eranvalintamodel.h"
+#include "db/erasaldo.h"
+#include "selaus/selausmodel.h"
+#include "selaus/tositeselausmodel.h"
+#include "raportti/raportoija.h"
+#include "raportti/alverittely.h"
+#include "raportti/laskuraportti.h"
+#include "raportti/myyntiraportti.h"
+#include "raportti/paakirjaraportti.h"
+#include "raportti/paivakirjaraportti.h"
+#include "raportti/raporttivirta.h"
+#include "arkistoija/arkistoija.h"
+#include "arkistoija/arkistonkohde.h"
+#include "kirjaus/kirjauswg.h"
+#include "laskutus/laskumodel.h"
+#include "laskutus/laskuntulostaja.h"
+#include "tuonti/tuonti.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QCryptographicHash>
+#include <QScopedPointer>
+#include <QtConcurrent>
+#include <QPdfWriter>
+#include <QPrinter>
+#include <QPainter>
+#include <QBuffer>
+
+namespace {
+
+/**
+ * @brief Kerää virtaan kirjoitetut raportin rivit talteen
+ */
+class RivienKeraaja : public RaporttiVirta
+{
+public:
+    RivienKeraaja() : RaporttiVirta(nullptr) {}
+
+    void aloita(const RaportinKirjoittaja& /* raportti */) override {}
+    void kirjoita(const RaporttiRivi& rivi) override { rivit.append(rivi); }
+    void kirjoita(const RaporttiPuskurinRivi& /* rivi */) override {}
+    void lopeta() override {}
+
+    QList<RaporttiRivi> rivit;
+};
+
+}
+
+/**
+ * @brief Suorituskykytestit suurella keksityllä kirjanpidolla
+ *
+ * Kirjanpito luodaan KirjaGeneraattorilla testien alussa ja avataan
+ * Kirjanpito::avaaTietokanta:lla kuten ohjelmassa. Mittaukset käyttävät
+ * ohjelman omia malleja, raportteja, arkistoijaa ja tiliotteen tuontia.
+ */
+class SuorituskykyTesti : public QObject
+{
+    Q_OBJECT
+
+public:
+    SuorituskykyTesti();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void generaattoriTesti();
+    void avaaminenBenchmark();
+    void selausBenchmark_data();
+    void selausBenchmark();
+    void kirjausBenchmark();
+    void avoimetEratBenchmark_data();
+    void avoimetEratBenchmark();
+    void eraHistoriaBenchmark_data();
+    void eraHistoriaBenchmark();
+    void raportitBenchmark_data();
+    void raportitBenchmark();
+    void paivakirjanSivutusBenchmark_data();
+    void paivakirjanSivutusBenchmark();
+    void trendiBenchmark_data();
+    void trendiBenchmark();
+    void laskuBenchmark_data();
+    void laskuBenchmark();
+    void arkistointiBenchmark();
+    void tuontiBenchmark();
+
+protected:
+    Tili tili(int numero) const { return kp()->tilit()->tiliNumerolla(numero); }
+    int tositelaji(const QString& tunnus) const;
+
+    /**
+     * @brief Viimeisen tilikauden alkupäivä
+     */
+    QDate viimeinenKausi() const { return QDate( koko_.ensimmainenVuosi + koko_.tilikausia - 1, 1, 1); }
+
+    /**
+     * @brief Tiiviste kirjanpidon sisällöstä vertailua varten
+     */
+    static QByteArray sisallonTiiviste(const QString& polku);
+
+    /**
+     * @brief Konekielisen TITO-tiliotteen tietue
+     * @param kentat Kenttien alkukohdat ja sisällöt
+     */
+    static QString titoTietue(const QString& tunnus, int pituus, const QMap<int,QString>& kentat);
+
+    /**
+     * @brief Tulostaa raportin A4-pdf:ksi esikatselun tarkkuudella
+     * @return sivujen määrä
+     */
+    static int tulostaA4(const RaportinKirjoittaja& raportti);
+
+    QTemporaryDir hakemisto_;
+    QString polku_;
+    quint32 siemen_ = 2019;
+    KirjaGeneraattori::Koko koko_;
+    Kirjanpito* kirjanpito_ = nullptr;
+
+    RaportinKirjoittaja paivakirja_;
+    int paivakirjanSivuja_ = 0;
+};
+
+SuorituskykyTesti::SuorituskykyTesti()
+{
+    if( qEnvironmentVariableIsSet("KITUPIIKKI_SIEMEN"))
+        siemen_ = qEnvironmentVariable("KITUPIIKKI_SIEMEN").toUInt();
+    if( qEnvironmentVariableIsSet("KITUPIIKKI_TOSITTEITA"))
+        koko_.tositteitaKaudessa = qEnvironmentVariableIntValue("KITUPIIKKI_TOSITTEITA");
+}
+
+void SuorituskykyTesti::initTestCase()
+{
+    QVERIFY( hakemisto_.isValid() );
+    polku_ = hakemisto_.filePath("suorituskyky.kitupiikki");
+
+    QElapsedTimer ajastin;
+    ajastin.start();
+
+    KirjaGeneraattori generaattori( siemen_, koko_);
+    QVERIFY2( generaattori.luo( polku_ ), qPrintable( generaattori.virhe() ));
+
+    qInfo("Kirjanpito: siemen %u, %d tilikautta, %d tositetta/kausi, %lld ms, %lld kt",
+          siemen_, koko_.tilikausia, koko_.tositteitaKaudessa,
+          ajastin.elapsed(), QFileInfo(polku_).size() / 1024);
+
+    // Asetukset tilapäishakemistoon kuten asentamattomassa versiossa
+    kirjanpito_ = new Kirjanpito( hakemisto_.path() );
+    Kirjanpito::asetaInstanssi( kirjanpito_ );
+    QVERIFY( kp()->avaaTietokanta( polku_ ) );
+}
+
+void SuorituskykyTesti::cleanupTestCase()
+{
+    delete kirjanpito_;
+    kirjanpito_ = nullptr;
+    Kirjanpito::asetaInstanssi( nullptr );
+}
+
+void SuorituskykyTesti::generaattoriTesti()
+{
+    KirjaGeneraattori::Koko pieni;
+    pieni.tilikausia = 2;
+    pieni.tositteitaKaudessa = 500;
+
+    QString eka = hakemisto_.filePath("eka.kitupiikki");
+    QString toka = hakemisto_.filePath("toka.kitupiikki");
+    QString muu = hakemisto_.filePath("muu.kitupiikki");
+
+    KirjaGeneraattori ekaGeneraattori(42, pieni);
+    QVERIFY2( ekaGeneraattori.luo( eka ), qPrintable( ekaGeneraattori.virhe() ));
+    KirjaGeneraattori tokaGeneraattori(42, pieni);
+    QVERIFY2( tokaGeneraattori.luo( toka ), qPrintable( tokaGeneraattori.virhe() ));
+    KirjaGeneraattori muuGeneraattori(43, pieni);
+    QVERIFY2( muuGeneraattori.luo( muu ), qPrintable( muuGeneraattori.virhe() ));
+
+    // Sama siemen tuottaa saman kirjanpidon
+    QCOMPARE( sisallonTiiviste(eka), sisallonTiiviste(toka) );
+    QVERIFY( sisallonTiiviste(eka) != sisallonTiiviste(muu) );
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "generaattori");
+        db.setDatabaseName(eka);
+        QVERIFY( db.open() );
+        QSqlQuery kysely(db);
+
+        const int versio = Kirjanpito::TIETOKANTAVERSIO;
+        QVERIFY( kysely.exec("SELECT arvo FROM asetus WHERE avain='KpVersio'") && kysely.next() );
+        QCOMPARE( kysely.value(0).toInt(), versio);
+
+        // Tositelajien puuttuva json on NULL kuten luontivelhossa
+        QVERIFY( kysely.exec("SELECT COUNT(*) FROM tositelaji WHERE json=''") && kysely.next() );
+        QCOMPARE( kysely.value(0).toInt(), 0);
+
+        // Tositteet ovat tasapainossa
+        QVERIFY( kysely.exec("SELECT tosite FROM vienti GROUP BY tosite "
+                             "HAVING SUM(IFNULL(debetsnt,0)) <> SUM(IFNULL(kreditsnt,0))") );
+        QVERIFY( !kysely.next() );
+
+        // Erät viittaavat olemassa oleviin vienteihin ja osa on maksettu
+        QVERIFY( kysely.exec("SELECT COUNT(*) FROM vienti WHERE eraid IS NOT NULL AND eraid NOT IN (SELECT id FROM vienti)") && kysely.next() );
+        QCOMPARE( kysely.value(0).toInt(), 0);
+        QVERIFY( kysely.exec("SELECT SUM(saldo = 0), SUM(saldo <> 0) FROM erasaldo") && kysely.next() );
+        QVERIFY( kysely.value(0).toInt() > 0 );
+        QVERIFY( kysely.value(1).toInt() > 0 );
+
+        // Koostetaulut on täytetty
+        for( const QString& taulu : { "alvkooste", "tuotemyynti", "budjetti", "tunnistelaskuri", "merkkaus", "liite", "tositehaku"})
+        {
+            QVERIFY( kysely.exec( QString("SELECT COUNT(*) FROM %1").arg(taulu)) && kysely.next() );
+            QVERIFY2( kysely.value(0).toInt() > 0, qPrintable(taulu) );
+        }
+        QVERIFY( kysely.exec("SELECT COUNT(*) FROM tosite") && kysely.next() );
+        QCOMPARE( kysely.value(0).toInt(), pieni.tilikausia * pieni.tositteitaKaudessa );
+
+        db.close();
+    }
+    QSqlDatabase::removeDatabase("generaattori");
+}
+
+void SuorituskykyTesti::avaaminenBenchmark()
+{
+    // Asetusten, tilien, tositelajien, tilikausien ja kohdennusten lataus
+    QBENCHMARK
+    {
+        QVERIFY( kp()->avaaTietokanta( polku_ ) );
+    }
+    const int versio = Kirjanpito::TIETOKANTAVERSIO;
+    QCOMPARE( kp()->asetukset()->luku("KpVersio"), versio );
+    QCOMPARE( kp()->tilikaudet()->rowCount(QModelIndex()), koko_.tilikausia );
+}
+
+void SuorituskykyTesti::selausBenchmark_data()
+{
+    QTest::addColumn<bool>("tositteet");
+    QTest::addColumn<int>("kuukausia");
+
+    QTest::newRow("viennit kuukausi") << false << 1;
+    QTest::newRow("viennit tilikausi") << false << 12;
+    QTest::newRow("tositteet kuukausi") << true << 1;
+    QTest::newRow("tositteet tilikausi") << true << 12;
+}
+
+void SuorituskykyTesti::selausBenchmark()
+{
+    QFETCH(bool, tositteet);
+    QFETCH(int, kuukausia);
+
+    QDate loppuu = viimeinenKausi().addYears(1).addDays(-1);
+    QDate alkaa = loppuu.addDays(1).addMonths( -kuukausia );
+    int riveja = 0;
+
+    QBENCHMARK
+    {
+        if( tositteet )
+        {
+            TositeSelausModel malli;
+            malli.lataa( alkaa, loppuu );
+            riveja = malli.rowCount(QModelIndex());
+        }
+        else
+        {
+            SelausModel malli;
+            malli.lataa( alkaa, loppuu );
+            riveja = malli.rowCount(QModelIndex());
+        }
+    }
+    QVERIFY( riveja > 0);
+}
+
+void SuorituskykyTesti::kirjausBenchmark()
+{
+    QDate pvm = viimeinenKausi().addMonths(11).addDays(14);
+
+    QVariantMap laskurivi;
+    laskurivi.insert("Nimike", "Benchmark");
+    laskurivi.insert("Alvprosentti", 24);
+    laskurivi.insert("Maara", "1.00");
+    laskurivi.insert("Nettoyht", 10000);
+    laskurivi.insert("Yhteensa", 12400);
+
+    VientiRivi netto;
+    netto.pvm = pvm;
+    netto.tili = tili(3000);
+    netto.kreditSnt = 10000;
+    netto.alvkoodi = 11;
+    netto.alvprosentti = 24;
+    netto.selite = "Benchmark";
+
+    VientiRivi vero;
+    vero.pvm = pvm;
+    vero.tili = tili(2939);
+    vero.kreditSnt = 2400;
+    vero.alvkoodi = 111;
+    vero.alvprosentti = 24;
+    vero.selite = "Benchmark ALV 24 %";
+
+    VientiRivi saatava;
+    saatava.pvm = pvm;
+    saatava.tili = tili(1701);
+    saatava.debetSnt = 12400;
+    saatava.selite = "Benchmark";
+    saatava.eraId = TaseEra::UUSIERA;
+    saatava.viite = "99992";
+    saatava.asiakas = "Benchmark";
+    saatava.json.setVar("Laskurivit", QVariantList() << laskurivi);
+
+    // Tallennus perutaan, jotta jokainen kierros kirjaa saman
+    // tositteen samaan kirjanpitoon
+    QBENCHMARK
+    {
+        TositeModel tosite( kp()->tietokanta() );
+        tosite.asetaPvm( pvm );
+        tosite.asetaOtsikko( "Benchmark" );
+        tosite.asetaTositelaji( tositelaji("ML") );
+        tosite.asetaTunniste( tosite.seuraavaTunnistenumero() );
+        tosite.vientiModel()->lisaaVienti( netto );
+        tosite.vientiModel()->lisaaVienti( vero );
+        tosite.vientiModel()->lisaaVienti( saatava );
+
+        kp()->tietokanta()->transaction();
+        bool tallennettu = tosite.tallenna( false );
+        kp()->tietokanta()->rollback();
+        QVERIFY( tallennettu );
+    }
+}
+
+void SuorituskykyTesti::avoimetEratBenchmark_data()
+{
+    QTest::addColumn<int>("tili");
+    QTest::addColumn<bool>("historiasta");
+
+    QTest::newRow("myyntisaamiset, saldotaulusta") << 1701 << false;
+    QTest::newRow("myyntisaamiset, historiasta") << 1701 << true;
+    QTest::newRow("ostovelat, saldotaulusta") << 2871 << false;
+    QTest::newRow("ostovelat, historiasta") << 2871 << true;
+}
+
+void SuorituskykyTesti::avoimetEratBenchmark()
+{
+    QFETCH(int, tili);
+    QFETCH(bool, historiasta);
+
+    // Päivämäärän kanssa erät lasketaan tilin koko historiasta
+    QDate paivalle = historiasta ? viimeinenKausi().addYears(1) : QDate();
+    EranValintaModel erat;
+    QBENCHMARK
+    {
+        erat.lataa( this->tili(tili), false, paivalle );
+    }
+    qInfo("%s: %d avointa erää", QTest::currentDataTag(), erat.rowCount(QModelIndex()) - 2);
+    QVERIFY( erat.rowCount(QModelIndex()) > 2 );
+}
+
+void SuorituskykyTesti::eraHistoriaBenchmark_data()
+{
+    QTest::addColumn<bool>("historiasta");
+
+    QTest::newRow("200 000 erää, 500 avoinna, historiasta") << true;
+    QTest::newRow("200 000 erää, 500 avoinna, saldotaulusta") << false;
+}
+
+void SuorituskykyTesti::eraHistoriaBenchmark()
+{
+    QFETCH(bool, historiasta);
+
+    // Sama aineisto kuin KirjanpitoTesti::avoimetEratTesti:ssä täysikokoisena:
+    // uudella tilillä on 200 000 erää, joista kaikki paitsi 500 on suoritettu.
+    // Aineisto lisätään transaktiossa, joka perutaan lopuksi.
+    const int eria = 200000;
+    const int avoimia = 500;
+
+    QSqlDatabase* db = kp()->tietokanta();
+    QVERIFY( db->transaction() );
+    QSqlQuery kysely( *db );
+
+    QVERIFY( kysely.exec("SELECT MAX(id) + 1 FROM tili") && kysely.next() );
+    int tiliId = kysely.value(0).toInt();
+    QVERIFY( kysely.exec( QString("INSERT INTO tili(id, nro, nimi, tyyppi, ysiluku) VALUES (%1, 1799, 'Erät', 'AS', 179900009)").arg(tiliId)) );
+
+    QVERIFY( kysely.exec("INSERT INTO tosite(pvm, otsikko) VALUES ('2000-01-01', 'Erät')") );
+    int avaus = kysely.lastInsertId().toInt();
+    QVERIFY( kysely.exec("INSERT INTO tosite(pvm, otsikko) VALUES ('2020-01-01', 'Suoritukset')") );
+    int suoritus = kysely.lastInsertId().toInt();
+
+    QVERIFY( kysely.exec("SELECT MAX(id) FROM vienti") && kysely.next() );
+    int alku = kysely.value(0).toInt();
+
+    kysely.prepare("INSERT INTO vienti(id, tosite, vientirivi, pvm, tili, selite, debetsnt, kreditsnt, eraid) "
+                   "VALUES (?,?,?,?,?,?,?,?,?)");
+    for(int i=1; i <= eria; i++)
+    {
+        kysely.addBindValue(alku + i);
+        kysely.addBindValue(avaus);
+        kysely.addBindValue(i);
+        kysely.addBindValue(QDate(2000,1,1).addDays(i % 7000));
+        kysely.addBindValue(tiliId);
+        kysely.addBindValue(QString("Lasku %1").arg(i));
+        kysely.addBindValue(1000 + i % 1000);
+        kysely.addBindValue(QVariant());
+        kysely.addBindValue(alku + i);
+        QVERIFY( kysely.exec() );
+    }
+    for(int i=avoimia + 1; i <= eria; i++)
+    {
+        kysely.addBindValue(alku + eria + i);
+        kysely.addBindValue(suoritus);
+        kysely.addBindValue(i);
+        kysely.addBindValue(QDate(2020,1,1));
+        kysely.addBindValue(tiliId);
+        kysely.addBindValue(QString("Suoritus %1").arg(i));
+        kysely.addBindValue(QVariant());
+        kysely.addBindValue(1000 + i % 1000);
+        kysely.addBindValue(alku + i);
+        QVERIFY( kysely.exec() );
+    }
+    EraSaldo::muuta(db, avaus, 1);
+    EraSaldo::muuta(db, suoritus, 1);
+
+    Tili tili( tiliId, 1799, "Erät", "AS", 0);
+    EranValintaModel erat;
+    QBENCHMARK
+    {
+        if( historiasta )
+            erat.lataa( tili, false, QDate(2020,12,31) );
+        else
+            erat.lataaAvoimet( tili );
+    }
+    int avoinna = erat.rowCount(QModelIndex()) - 2;
+
+    db->rollback();
+    QCOMPARE( avoinna, avoimia );
+}
+
+void SuorituskykyTesti::raportitBenchmark_data()
+{
+    QTest::addColumn<QString>("raportti");
+
+    QTest::newRow("tuloslaskelma") << "tuloslaskelma";
+    QTest::newRow("tuloslaskelma kuukausittain") << "kuukausittain";
+    QTest::newRow("tase") << "tase";
+    QTest::newRow("alv-laskelma") << "alv";
+    QTest::newRow("avoimet erät") << "avoimet";
+    QTest::newRow("myynnit") << "myynnit";
+    QTest::newRow("budjetti") << "budjetti";
+    QTest::newRow("pääkirja") << "paakirja";
+}
+
+void SuorituskykyTesti::raportitBenchmark()
+{
+    QFETCH(QString, raportti);
+
+    QDate alkaa = viimeinenKausi();
+    QDate loppuu = alkaa.addYears(1).addDays(-1);
+    RaportinKirjoittaja kirjoittaja;
+
+    QBENCHMARK
+    {
+        if( raportti == "tuloslaskelma" || raportti == "kuukausittain" || raportti == "budjetti")
+        {
+            Raportoija raportoija("Tuloslaskelma/Yleinen");
+            QCOMPARE( raportoija.tyyppi(), Raportoija::TULOSLASKELMA );
+            if( raportti == "kuukausittain")
+                raportoija.lisaaKaudet( alkaa, loppuu, Raportoija::KUUKAUSITTAIN );
+            else if( raportti == "budjetti")
+            {
+                // Sarakkeet kuten Budjettivertailussa
+                raportoija.lisaaKausi( alkaa, loppuu, Raportoija::TOTEUTUNUT );
+                raportoija.lisaaKausi( alkaa, loppuu, Raportoija::BUDJETTI );
+                raportoija.lisaaKausi( alkaa, loppuu, Raportoija::BUDJETTIERO );
+                raportoija.lisaaKausi( alkaa, loppuu, Raportoija::TOTEUMAPROSENTTI );
+            }
+            else
+                raportoija.lisaaKausi( alkaa, loppuu );
+            kirjoittaja = raportoija.raportti();
+        }
+        else if( raportti == "tase")
+        {
+            Raportoija raportoija("Tase/Yleinen");
+            QCOMPARE( raportoija.tyyppi(), Raportoija::TASE );
+            raportoija.lisaaTasepaiva( loppuu );
+            raportoija.lisaaTasepaiva( alkaa.addDays(-1) );
+            kirjoittaja = raportoija.raportti();
+        }
+        else if( raportti == "alv")
+            kirjoittaja = AlvErittely::kirjoitaRaporti( alkaa.addMonths(9), loppuu );
+        else if( raportti == "avoimet")
+            kirjoittaja = LaskuRaportti::kirjoitaRaportti( loppuu, true, true );
+        else if( raportti == "myynnit")
+            kirjoittaja = MyyntiRaportti::kirjoitaRaportti( alkaa, loppuu );
+        else if( raportti == "paakirja")
+            kirjoittaja = PaakirjaRaportti::kirjoitaRaportti( alkaa, loppuu );
+    }
+    QVERIFY( kirjoittaja.html().contains("<td") );
+}
+
+void SuorituskykyTesti::paivakirjanSivutusBenchmark_data()
+{
+    QTest::addColumn<QString>("vaihe");
+
+    QTest::newRow("asettelu ja tulostus") << "asettelu";
+    QTest::newRow("esikatselun päivitys") << "esikatselu";
+    QTest::newRow("pdf") << "pdf";
+}
+
+void SuorituskykyTesti::paivakirjanSivutusBenchmark()
+{
+    QFETCH(QString, vaihe);
+
+    if( !paivakirjanSivuja_ )
+    {
+        // Koko kirjanpidon päiväkirjaa monistetaan, kunnes sivuja on vähintään 5000
+        QDate alkaa( koko_.ensimmainenVuosi, 1, 1);
+        QDate paattyy = viimeinenKausi().addYears(1).addDays(-1);
+
+        RivienKeraaja keraaja;
+        paivakirja_.asetaVirta( &keraaja );
+        PaivakirjaRaportti::kirjoitaRaportti( paivakirja_, alkaa, paattyy );
+        paivakirja_.lopetaVirta();
+
+        for( const RaporttiRivi& rivi : keraaja.rivit)
+            paivakirja_.lisaaRivi( rivi );
+        int kopioita = 5000 / tulostaA4( paivakirja_ ) + 1;
+        for( int kopio = 1; kopio < kopioita; kopio++)
+            for( const RaporttiRivi& rivi : keraaja.rivit)
+                paivakirja_.lisaaRivi( rivi );
+
+        paivakirjanSivuja_ = tulostaA4( paivakirja_ );
+        qInfo("Päiväkirja: %d riviä, %d sivua", keraaja.rivit.count() * kopioita, paivakirjanSivuja_);
+    }
+    QVERIFY( paivakirjanSivuja_ >= 5000 );
+
+    QElapsedTimer ajastin;
+    ajastin.start();
+
+    QBENCHMARK
+    {
+        if( vaihe == "asettelu")
+        {
+            // Kopiossa ei ole valmista asettelua, joten sivutus lasketaan alusta
+            RaportinKirjoittaja kopio = paivakirja_;
+            kopio.asetaOtsikko( kopio.otsikko() );
+            QCOMPARE( tulostaA4( kopio ), paivakirjanSivuja_ );
+        }
+        else if( vaihe == "esikatselu")
+            QCOMPARE( tulostaA4( paivakirja_ ), paivakirjanSivuja_ );
+        else
+            QVERIFY( !paivakirja_.pdf(false, true).isEmpty() );
+    }
+    qInfo("%s: %lld ms", QTest::currentDataTag(), ajastin.elapsed());
+}
+
+void SuorituskykyTesti::trendiBenchmark_data()
+{
+    QTest::addColumn<QString>("raportti");
+    QTest::addColumn<bool>("kuukausittain");
+
+    QTest::newRow("tuloslaskelma, sarake kerrallaan") << "Tuloslaskelma/Yleinen" << false;
+    QTest::newRow("tuloslaskelma, kuukausisummista") << "Tuloslaskelma/Yleinen" << true;
+    QTest::newRow("tase, sarake kerrallaan") << "Tase/Yleinen" << false;
+    QTest::newRow("tase, kuukausisummista") << "Tase/Yleinen" << true;
+}
+
+void SuorituskykyTesti::trendiBenchmark()
+{
+    QFETCH(QString, raportti);
+    QFETCH(bool, kuukausittain);
+
+    // Kuukausittainen trendi kaikilta tilikausilta
+    QDate alkaa( koko_.ensimmainenVuosi, 1, 1);
+    QDate paattyy = viimeinenKausi().addYears(1).addDays(-1);
+    int sarakkeita = 0;
+
+    QBENCHMARK
+    {
+        if( kuukausittain )
+        {
+            Raportoija raportoija(raportti);
+            sarakkeita = raportoija.lisaaKaudet( alkaa, paattyy, Raportoija::KUUKAUSITTAIN );
+            QVERIFY( raportoija.raportti().html().contains("<td") );
+        }
+        else
+        {
+            // Vertailukohtana jokainen kuukausi omana raporttinaan omalla kyselyllään
+            sarakkeita = 0;
+            for( QDate kuukausi = alkaa; kuukausi < paattyy; kuukausi = kuukausi.addMonths(1))
+            {
+                Raportoija raportoija(raportti);
+                if( raportoija.onkoTaseraportti())
+                    raportoija.lisaaTasepaiva( kuukausi.addMonths(1).addDays(-1) );
+                else
+                    raportoija.lisaaKausi( kuukausi, kuukausi.addMonths(1).addDays(-1) );
+                raportoija.raportti();
+                sarakkeita++;
+            }
+        }
+    }
+    QCOMPARE( sarakkeita, 12 * koko_.tilikausia );
+}
+
+void SuorituskykyTesti::laskuBenchmark_data()
+{
+    QTest::addColumn<int>("laskuja");
+    QTest::addColumn<bool>("valimuisti");
+
+    // Ilman välimuistia pohja kootaan joka laskulle kuten ennen LaskuPohjaa
+    QTest::newRow("yksittäinen, ilman pohjaa") << 1 << false;
+    QTest::newRow("yksittäinen") << 1 << true;
+    QTest::newRow("ryhmä 50, ilman pohjaa") << 50 << false;
+    QTest::newRow("ryhmä 50") << 50 << true;
+}
+
+void SuorituskykyTesti::laskuBenchmark()
+{
+    QFETCH(int, laskuja);
+    QFETCH(bool, valimuisti);
+
+    // Tulostetaan kirjanpidon viimeisimmät myyntilaskut
+    QSqlQuery kysely( *kp()->tietokanta() );
+    QVERIFY( kysely.exec( QString("SELECT vienti.id FROM vienti JOIN tili ON vienti.tili=tili.id "
+                                  "WHERE tili.nro=1701 AND vienti.eraid=vienti.id AND vienti.viite IS NOT NULL "
+                                  "ORDER BY vienti.id DESC LIMIT %1").arg(laskuja)) );
+    QList<QSharedPointer<LaskuModel>> laskut;
+    while( kysely.next())
+        laskut.append( QSharedPointer<LaskuModel>( LaskuModel::haeLasku( kysely.value(0).toInt() )) );
+    QCOMPARE( laskut.count(), laskuja );
+    QVERIFY( laskut.first()->rowCount(QModelIndex()) > 0 );
+
+    QElapsedTimer ajastin;
+    ajastin.start();
+    int tulostettu = 0;
+
+    QBENCHMARK
+    {
+        QString iban = LaskunTulostaja::laskunIban();
+        QDate paivamaara = kp()->paivamaara();
+
+        if( laskuja == 1)
+        {
+            if( valimuisti )
+                QVERIFY( !LaskunTulostaja( laskut.first().data() ).pdf().isEmpty() );
+            else
+                QVERIFY( !LaskunTulostaja( laskut.first().data(), LaskunTulostaja::koostaPohja(),
+                                           iban, paivamaara ).pdf().isEmpty() );
+        }
+        else
+        {
+            // Ryhmälaskut tulostetaan rinnakkain kuten LaskuModel::tallennaRyhma.
+            // Pohjat kootaan pääsäikeessä, koska kokoaminen lukee asetuksia.
+            QList<QPair<LaskuModel*, QSharedPointer<const LaskuPohja>>> tulostettavat;
+            QSharedPointer<const LaskuPohja> pohja = LaskunTulostaja::pohja();
+            for( const QSharedPointer<LaskuModel>& lasku : laskut)
+                tulostettavat.append( qMakePair( lasku.data(),
+                                                 valimuisti ? pohja : LaskunTulostaja::koostaPohja() ));
+
+            QtConcurrent::blockingMap( tulostettavat, [iban, paivamaara] (QPair<LaskuModel*, QSharedPointer<const LaskuPohja>>& tulostettava)
+                { LaskunTulostaja( tulostettava.first, tulostettava.second, iban, paivamaara ).pdf(); });
+        }
+        tulostettu += laskuja;
+    }
+
+    qInfo("%s: %.1f laskua sekunnissa", QTest::currentDataTag(),
+          tulostettu * 1000.0 / qMax<qint64>(1, ajastin.elapsed()));
+}
+
+void SuorituskykyTesti::arkistointiBenchmark()
+{
+    Tilikausi kausi = kp()->tilikausiPaivalle( viimeinenKausi() );
+    int kierros = 0;
+
+    // Tilikauden tositteet, liitteet ja raportit tiivisteineen
+    QBENCHMARK
+    {
+        HakemistoKohde kohde( hakemisto_.filePath( QString("arkisto%1").arg(kierros++)));
+        QVERIFY( !Arkistoija::arkistoi( kausi, &kohde ).isEmpty() );
+        QVERIFY( kohde.valmis() );
+    }
+}
+
+void SuorituskykyTesti::tuontiBenchmark()
+{
+    QDate pvm = viimeinenKausi().addYears(1).addDays(-1);
+    const QString otepvm = pvm.toString("yyMMdd");
+
+    // Tiliotteeksi avoimien myynti- ja ostolaskujen suoritukset
+    QStringList tiliote;
+    tiliote.append( titoTietue("T00322100", 310, { {26, otepvm}, {32, otepvm},
+                                                   {292, KirjaGeneraattori::pankkitilinIban()} }));
+    QSqlQuery kysely( *kp()->tietokanta() );
+    kysely.exec( QString("SELECT vienti.viite, vienti.iban, erasaldo.saldo FROM erasaldo, vienti "
+                         "WHERE erasaldo.eraid=vienti.id AND erasaldo.tili=vienti.tili AND erasaldo.saldo <> 0 "
+                         "AND vienti.viite IS NOT NULL ORDER BY vienti.id LIMIT 2000"));
+    int suorituksia = 0;
+    while( kysely.next())
+    {
+        qlonglong saldo = kysely.value(2).toLongLong();
+        tiliote.append( titoTietue("T10188", 188, { {12, QString("SUORITUS%1").arg(++suorituksia, 10, 10, QChar('0'))},
+                                                    {30, otepvm},
+                                                    {87, saldo > 0 ? "+" : "-"},
+                                                    {88, QString("%1").arg( qAbs(saldo), 18, 10, QChar('0'))},
+                                                    {108, "Suoritus"},
+                                                    {159, kysely.value(0).toString().rightJustified(20, '0')} }));
+        // Ostolaskun saajan tilinumero täydentävässä tietueessa
+        if( !kysely.value(1).toString().isEmpty())
+            tiliote.append( titoTietue("T11078", 78, { {6, "11"}, {43, kysely.value(1).toString()} }));
+    }
+    tiliote.append( titoTietue("T40050", 50, {}));
+    QVERIFY( suorituksia > 0);
+
+    QFile tiedosto( hakemisto_.filePath("tiliote.tito"));
+    QVERIFY( tiedosto.open(QIODevice::WriteOnly) );
+    tiedosto.write( tiliote.join("\r\n").toLatin1() );
+    tiedosto.close();
+
+    // Tuonti etsii viitteellä maksettavan erän ja kirjaa suoritukset tiliotteelle,
+    // joka perutaan, jotta jokainen kierros tuo samat rivit
+    int kohdistettu = 0;
+    QBENCHMARK
+    {
+        QScopedPointer<TositeModel> tosite( kp()->tositemodel() );
+        KirjausWg kirjaus( tosite.data() );
+        Tuonti::tuo( tiedosto.fileName(), &kirjaus );
+
+        kohdistettu = 0;
+        VientiModel* viennit = tosite->vientiModel();
+        for( int i = 0; i < viennit->rowCount(QModelIndex()); i++)
+            if( viennit->index(i, 0).data(VientiModel::EraIdRooli).toInt() > 0)
+                kohdistettu++;
+
+        kp()->tietokanta()->transaction();
+        bool tallennettu = tosite->tallenna( false );
+        kp()->tietokanta()->rollback();
+        QVERIFY( tallennettu );
+    }
+    QCOMPARE( kohdistettu, suorituksia );
+}
+
+int SuorituskykyTesti::tositelaji(const QString &tunnus) const
+{
+    TositelajiModel* lajit = kp()->tositelajit();
+    for( int i = 0; i < lajit->rowCount(QModelIndex()); i++)
+    {
+        QModelIndex indeksi = lajit->index(i, 0);
+        if( indeksi.data(TositelajiModel::TunnusRooli).toString() == tunnus)
+            return indeksi.data(TositelajiModel::IdRooli).toInt();
+    }
+    return 1;
+}
+
+QByteArray SuorituskykyTesti::sisallonTiiviste(const QString &polku)
+{
+    QCryptographicHash tiiviste( QCryptographicHash::Sha256);
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "tiiviste");
+        db.setDatabaseName(polku);
+        db.open();
+        QSqlQuery kysely(db);
+        for( const QString& taulu : { "SELECT * FROM tili ORDER BY id",
+                                      "SELECT * FROM kohdennus ORDER BY id",
+                                      "SELECT * FROM tilikausi ORDER BY alkaa",
+                                      "SELECT * FROM tosite ORDER BY id",
+                                      "SELECT * FROM vienti ORDER BY id",
+                                      "SELECT * FROM merkkaus ORDER BY id",
+                                      "SELECT id, tosite, sha FROM liite ORDER BY id"})
+        {
+            kysely.exec(taulu);
+            while( kysely.next())
+            {
+                for( int i = 0; i < kysely.record().count(); i++)
+                    tiiviste.addData( kysely.value(i).toString().toUtf8() + '\t');
+                tiiviste.addData("\n");
+            }
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase("tiiviste");
+    return tiiviste.result().toHex();
+}
+
+QString SuorituskykyTesti::titoTietue(const QString &tunnus, int pituus, const QMap<int, QString> &kentat)
+{
+    QString tietue = tunnus.leftJustified( pituus, ' ');
+    for( auto iter = kentat.constBegin(); iter != kentat.constEnd(); ++iter)
+        tietue.replace( iter.key(), iter.value().length(), iter.value());
+    return tietue;
+}
+
+int SuorituskykyTesti::tulostaA4(const RaportinKirjoittaja &raportti)
+{
+    QByteArray data;
+    QBuffer puskuri(&data);
+    puskuri.open(QIODevice::WriteOnly);
+
+    QPdfWriter writer(&puskuri);
+    writer.setPageSize( QPdfWriter::A4 );
+    writer.setResolution( kp()->printer()->resolution() );
+    QPainter painter(&writer);
+    int sivuja = raportti.tulosta( &writer, &painter );
+    painter.end();
+    return sivuja;
+}
+
+QTEST_MAIN(SuorituskykyTesti)
+
+#include "tst_suorituskyky.moc"
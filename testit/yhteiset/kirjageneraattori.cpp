@@ -0,0 +1,648 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <QFile>
+#include <QTextStream>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QRegularExpression>
+#include <QJsonDocument>
+#include <QCryptographicHash>
+#include <QVariant>
+#include <QDateTime>
+
+#include "kirjageneraattori.h"
+#include "db/kirjanpito.h"
+
+KirjaGeneraattori::KirjaGeneraattori(quint32 siemen, const Koko &koko) :
+    satunnainen_( siemen ),
+    koko_( koko )
+{
+
+}
+
+bool KirjaGeneraattori::luo(const QString &polku)
+{
+    QMap<QString,QStringList> kartta = lueTilikartta(":/tilikartat/tilitin.kpk");
+    if( kartta.value("tilit").isEmpty())
+    {
+        virhe_ = "Tilikarttaa tilitin.kpk ei voitu lukea";
+        return false;
+    }
+
+    bool onnistui = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "kirjageneraattori");
+        db.setDatabaseName( polku );
+        if( db.open())
+        {
+            QSqlQuery( "PRAGMA SYNCHRONOUS = OFF", db);
+
+            // Sama luontijärjestys kuin luontivelhossa, koostetaulut
+            // lopuksi samoilla käskyillä kuin vanhaa kirjanpitoa päivitettäessä
+            onnistui = luoTaulut(db, &virhe_) &&
+                    db.transaction() &&
+                    kirjoitaAsetukset(db, kartta) &&
+                    kirjoitaTilit(db, kartta) &&
+                    kirjoitaKohdennukset(db) &&
+                    kirjoitaTositteet(db) &&
+                    db.commit();
+            for( int versio = 11; onnistui && versio <= Kirjanpito::TIETOKANTAVERSIO; versio++)
+                onnistui = suoritaSql(db, QString(":/sql/update%1.sql").arg(versio), " ", &virhe_);
+        }
+        else
+            virhe_ = db.lastError().text();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase("kirjageneraattori");
+    return onnistui;
+}
+
+bool KirjaGeneraattori::luoTaulut(QSqlDatabase &db, QString *virhe)
+{
+    return suoritaSql(db, ":/sql/luo.sql", "", virhe);
+}
+
+QMap<QString, QStringList> KirjaGeneraattori::lueTilikartta(const QString &polku)
+{
+    QMap<QString,QStringList> kartta;
+    QFile tiedosto( polku );
+    if( !tiedosto.open(QIODevice::ReadOnly | QIODevice::Text))
+        return kartta;
+
+    QTextStream in(&tiedosto);
+    in.setCodec("UTF-8");
+    QString osio;
+    while( !in.atEnd())
+    {
+        QString rivi = in.readLine();
+        if( rivi.startsWith("//"))
+            continue;
+        else if( rivi.startsWith('[') && rivi.endsWith(']'))
+            osio = rivi.mid(1, rivi.length() - 2);
+        else if( !osio.isEmpty())
+            kartta[osio].append(rivi);
+    }
+    return kartta;
+}
+
+bool KirjaGeneraattori::suoritaSql(QSqlDatabase &db, const QString &polku, const QString &rivinvaihto, QString *virhe)
+{
+    QFile sqltiedosto( polku );
+    if( !sqltiedosto.open(QIODevice::ReadOnly))
+    {
+        if( virhe )
+            *virhe = QString("Tiedostoa %1 ei voitu lukea").arg(polku);
+        return false;
+    }
+    QTextStream in(&sqltiedosto);
+    in.setCodec("UTF-8");
+    QString sql = in.readAll();
+    sql.replace("\n", rivinvaihto);
+
+    QSqlQuery kysely(db);
+    for( const QString& kasky : sql.split(";"))
+    {
+        if( kasky.trimmed().isEmpty())
+            continue;
+        if( !kysely.exec(kasky))
+        {
+            if( virhe )
+                *virhe = QString("%1 (%2)").arg( kysely.lastError().text() ).arg( kasky );
+            return false;
+        }
+    }
+    return true;
+}
+
+bool KirjaGeneraattori::kirjoitaAsetukset(QSqlDatabase &db, const QMap<QString, QStringList> &kartta)
+{
+    QMap<QString,QString> asetukset;
+
+    // Tilikartan tiedot, jotka alkavat [Isolla kirjaimella]
+    for( auto iter = kartta.constBegin(); iter != kartta.constEnd(); ++iter)
+        if( !iter.key().isEmpty() && iter.key().at(0).isUpper())
+            asetukset.insert( iter.key(), iter.value().join('\n'));
+
+    asetukset.insert("Nimi", "Suorituskykytesti Oy");
+    asetukset.insert("Ytunnus", "1234567-8");
+    asetukset.insert("Osoite", "Testikatu 1\n00100 HELSINKI");
+    asetukset.insert("Sahkoposti", "laskutus@suorituskykytesti.fi");
+    asetukset.insert("LaskuTili", "1910");
+    asetukset.insert("VerkkolaskuOsoite", "003712345678");
+    asetukset.insert("VerkkolaskuValittaja", "NDEAFIHH");
+    asetukset.insert("Harjoitus", "ON");
+    asetukset.insert("Luotu", alkaa().toString(Qt::ISODate));
+    asetukset.insert("LuotuVersiolla", "kirjageneraattori");
+    asetukset.insert("KpVersio", QString::number(Kirjanpito::TIETOKANTAVERSIO));
+    asetukset.insert("Tilinavaus", "0");
+    asetukset.insert("TilitPaatetty", alkaa().addDays(-1).toString(Qt::ISODate));
+    asetukset.insert("AlvIlmoitus", alkaa().addDays(-1).toString(Qt::ISODate));
+    asetukset.insert("AlvKausi", "1");
+    asetukset.insert("LaskuSeuraavaId", "1009");
+
+    QSqlQuery kysely(db);
+    kysely.prepare("INSERT INTO asetus(avain, arvo) VALUES (?,?)");
+    for( auto iter = asetukset.constBegin(); iter != asetukset.constEnd(); ++iter)
+    {
+        kysely.addBindValue( iter.key());
+        kysely.addBindValue( iter.value());
+        if( !kysely.exec())
+        {
+            virhe_ = kysely.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool KirjaGeneraattori::kirjoitaTilit(QSqlDatabase &db, const QMap<QString, QStringList> &kartta)
+{
+    QRegularExpression tiliRe("^(?<tyyppi>\\w{1,5})(?<tila>[\\*\\-]?)\\s+(?<nro>\\d{1,8})(\\.\\.(?<asti>\\d{1,8}))?"
+                              "\\s*(?<json>\\{.*\\})?\\s(?<nimi>.+)$");
+    QSqlQuery kysely(db);
+    kysely.prepare("INSERT INTO tili(nro, nimi, tyyppi, tila, ysiluku, json) VALUES (?,?,?,?,?,?)");
+
+    for( const QString& rivi : kartta.value("tilit"))
+    {
+        QRegularExpressionMatch mats = tiliRe.match(rivi);
+        if( !mats.hasMatch())
+            continue;
+
+        QString tyyppi = mats.captured("tyyppi");
+        int nro = mats.captured("nro").toInt();
+        int tila = mats.captured("tila") == "*" ? 2 : ( mats.captured("tila") == "-" ? 0 : 1);
+
+        QVariantMap json = QJsonDocument::fromJson( mats.captured("json").toUtf8() ).toVariant().toMap();
+        if( !mats.captured("asti").isEmpty())
+            json.insert("Asti", mats.captured("asti").toInt());
+        // Tiliotteet tuodaan pankkitilille IBAN-numeron perusteella
+        if( nro == 1910 )
+            json.insert("IBAN", pankkitilinIban());
+
+        // Ysiluvussa otsikon taso tai tilin 9 numeron perässä (Tili::ysiluku)
+        int ysiluku = nro;
+        while( ysiluku <= 99999999)
+            ysiluku *= 10;
+        ysiluku += tyyppi.startsWith('H') ? tyyppi.mid(1).toInt() - 1 : 9;
+
+        kysely.addBindValue( nro );
+        kysely.addBindValue( mats.captured("nimi"));
+        kysely.addBindValue( tyyppi );
+        kysely.addBindValue( tila );
+        kysely.addBindValue( ysiluku );
+        kysely.addBindValue( json.isEmpty() ? QVariant() : QVariant(QJsonDocument::fromVariant(json).toJson(QJsonDocument::Compact)));
+        if( !kysely.exec())
+        {
+            virhe_ = kysely.lastError().text();
+            return false;
+        }
+
+        int id = kysely.lastInsertId().toInt();
+        if( !tyyppi.startsWith('H'))
+        {
+            tilit_.insert( nro, id);
+            // Käytössä olevat tulos- ja menotilit kirjauksia varten
+            if( tila && tyyppi.startsWith('D'))
+                menotilit_.append(id);
+            else if( tila && tyyppi.startsWith('C'))
+                tulotilit_.append(id);
+            // Budjetoidaan joka kymmenes tulostili
+            if( tila && ( tyyppi.startsWith('C') || tyyppi.startsWith('D')) &&
+                    ( tulotilit_.count() + menotilit_.count()) % 10 == 1 )
+                budjettitilit_.append(nro);
+        }
+    }
+
+    QRegularExpression lajiRe("^(?<tunnus>\\w{1,5})\\s(?<json>\\{.*\\})?\\s(?<nimi>.+)$");
+    kysely.prepare("INSERT INTO tositelaji(tunnus, nimi, json) VALUES (?,?,?)");
+    for( const QString& rivi : kartta.value("tositelajit"))
+    {
+        QRegularExpressionMatch mats = lajiRe.match(rivi);
+        if( !mats.hasMatch())
+            continue;
+        kysely.addBindValue( mats.captured("tunnus"));
+        kysely.addBindValue( mats.captured("nimi"));
+        kysely.addBindValue( mats.captured("json").isEmpty() ? QVariant() : QVariant(mats.captured("json")));
+        if( !kysely.exec())
+        {
+            virhe_ = kysely.lastError().text();
+            return false;
+        }
+        lajit_.insert( mats.captured("tunnus"), kysely.lastInsertId().toInt());
+    }
+
+    for( int numero : {1701, 1763, 1910, 2871, 2939, 3000, 4000})
+    {
+        if( !tilit_.contains(numero))
+        {
+            virhe_ = QString("Tilikartasta puuttuu tili %1").arg(numero);
+            return false;
+        }
+    }
+    if( menotilit_.isEmpty() || tulotilit_.isEmpty() || !lajit_.contains("ML") || !lajit_.contains("OL") || !lajit_.contains("TILI"))
+    {
+        virhe_ = "Tilikartasta puuttuu tositelajeja tai tulostilejä";
+        return false;
+    }
+    return true;
+}
+
+bool KirjaGeneraattori::kirjoitaKohdennukset(QSqlDatabase &db)
+{
+    QSqlQuery kysely(db);
+    kysely.prepare("INSERT INTO kohdennus(nimi, alkaa, loppuu, tyyppi) VALUES (?,?,?,?)");
+
+    for( int i = 0; i < koko_.kohdennuksia; i++)
+    {
+        // Joka neljäs on merkkaus, joka kolmas projekti ja muut kustannuspaikkoja
+        int tyyppi = i % 4 == 3 ? 3 : ( i % 3 == 2 ? 2 : 1);
+        kysely.addBindValue( QString("%1 %2").arg( tyyppi == 3 ? "Merkkaus" : (tyyppi == 2 ? "Projekti" : "Kustannuspaikka")).arg(i + 1));
+        kysely.addBindValue( tyyppi == 2 ? QVariant(alkaa()) : QVariant());
+        kysely.addBindValue( tyyppi == 2 ? QVariant(paattyy()) : QVariant());
+        kysely.addBindValue( tyyppi );
+        if( !kysely.exec())
+        {
+            virhe_ = kysely.lastError().text();
+            return false;
+        }
+        if( tyyppi == 3)
+            merkkaukset_.append( kysely.lastInsertId().toInt());
+        else
+            kustannuspaikat_.append( kysely.lastInsertId().toInt());
+    }
+    return true;
+}
+
+bool KirjaGeneraattori::kirjoitaTositteet(QSqlDatabase &db)
+{
+    QSqlQuery kysely(db);
+    kysely.prepare("INSERT INTO tilikausi(alkaa, loppuu, json) VALUES (?,?,?)");
+
+    for( int kausi = 0; kausi < koko_.tilikausia; kausi++)
+    {
+        QDate kaudenAlku( koko_.ensimmainenVuosi + kausi, 1, 1);
+
+        // Budjetti on tilikauden json-kentässä muodossa kohdennus: { tilinumero: sentit }
+        QVariantMap budjetit;
+        for( int kohdennus : QList<int>() << 0 << kustannuspaikat_)
+        {
+            QVariantMap tilit;
+            for( int numero : budjettitilit_)
+                tilit.insert( QString::number(numero), 1000 * ( 100 + satunnainen_.bounded(10000)));
+            budjetit.insert( QString::number(kohdennus), tilit);
+        }
+        QVariantMap json;
+        json.insert("Budjetti", budjetit);
+
+        kysely.addBindValue( kaudenAlku );
+        kysely.addBindValue( QDate(kaudenAlku.year(), 12, 31));
+        kysely.addBindValue( QJsonDocument::fromVariant(json).toJson(QJsonDocument::Compact) );
+        if( !kysely.exec())
+        {
+            virhe_ = kysely.lastError().text();
+            return false;
+        }
+
+        tunnisteet_.clear();
+        int paivia = kaudenAlku.daysInYear();
+
+        // Tositteet kirjataan päivämääräjärjestyksessä tasaisesti kauden päiville
+        for( int i = 0; i < koko_.tositteitaKaudessa; i++)
+        {
+            QDate pvm = kaudenAlku.addDays( static_cast<qint64>(i) * paivia / koko_.tositteitaKaudessa );
+            int arpa = satunnainen_.bounded(100);
+            if( arpa < 35)
+                myyntilasku(db, pvm);
+            else if( arpa < 55)
+                ostolasku(db, pvm);
+            else if( arpa < 80)
+                maksu(db, pvm);
+            else
+                muuKirjaus(db, pvm);
+
+            if( !virhe_.isEmpty())
+                return false;
+        }
+    }
+    return true;
+}
+
+QList<int> KirjaGeneraattori::kirjoitaTosite(QSqlDatabase &db, const QDate &pvm, int laji, const QString &otsikko, const QList<KirjaGeneraattori::Vienti> &viennit)
+{
+    QList<int> idt;
+    QDateTime aika( pvm, QTime(12,0));
+    int tunniste = ++tunnisteet_[laji];
+
+    QSqlQuery kysely(db);
+    kysely.prepare("INSERT INTO tosite(pvm, otsikko, tunniste, laji, luotu, muokattu) VALUES (?,?,?,?,?,?)");
+    kysely.addBindValue( pvm );
+    kysely.addBindValue( otsikko );
+    kysely.addBindValue( tunniste );
+    kysely.addBindValue( laji );
+    kysely.addBindValue( aika );
+    kysely.addBindValue( aika );
+    if( !kysely.exec())
+    {
+        virhe_ = kysely.lastError().text();
+        return idt;
+    }
+    int tositeId = kysely.lastInsertId().toInt();
+
+    QSqlQuery vienti(db);
+    vienti.prepare("INSERT INTO vienti(tosite, vientirivi, pvm, tili, debetsnt, kreditsnt, selite, alvkoodi, alvprosentti, "
+                   "kohdennus, viite, iban, laskupvm, erapvm, asiakas, json, luotu, muokattu) "
+                   "VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)");
+    QSqlQuery era(db);
+    era.prepare("UPDATE vienti SET eraid=? WHERE id=?");
+    QSqlQuery merkkaus(db);
+    merkkaus.prepare("INSERT INTO merkkaus(vienti, kohdennus) VALUES (?,?)");
+
+    for( int i = 0; i < viennit.count(); i++)
+    {
+        const Vienti& v = viennit.at(i);
+        vienti.addBindValue( tositeId );
+        vienti.addBindValue( i + 1 );
+        vienti.addBindValue( pvm );
+        vienti.addBindValue( v.tili );
+        vienti.addBindValue( v.debet ? QVariant(v.debet) : QVariant() );
+        vienti.addBindValue( v.kredit ? QVariant(v.kredit) : QVariant() );
+        vienti.addBindValue( v.selite );
+        vienti.addBindValue( v.alvkoodi );
+        vienti.addBindValue( v.alvprosentti );
+        vienti.addBindValue( v.kohdennus );
+        vienti.addBindValue( v.viite.isEmpty() ? QVariant() : QVariant(v.viite));
+        vienti.addBindValue( v.iban.isEmpty() ? QVariant() : QVariant(v.iban));
+        vienti.addBindValue( v.erapvm.isValid() ? QVariant(pvm) : QVariant());
+        vienti.addBindValue( v.erapvm.isValid() ? QVariant(v.erapvm) : QVariant());
+        vienti.addBindValue( v.asiakas.isEmpty() ? QVariant() : QVariant(v.asiakas));
+        vienti.addBindValue( v.json.isEmpty() ? QVariant() : QVariant(v.json));
+        vienti.addBindValue( aika );
+        vienti.addBindValue( aika );
+        if( !vienti.exec())
+        {
+            virhe_ = vienti.lastError().text();
+            return idt;
+        }
+        int vientiId = vienti.lastInsertId().toInt();
+        idt.append(vientiId);
+
+        if( v.eraid )
+        {
+            era.addBindValue( v.eraid < 0 ? vientiId : v.eraid );
+            era.addBindValue( vientiId );
+            era.exec();
+        }
+        for( int kohdennus : v.merkkaukset)
+        {
+            merkkaus.addBindValue( vientiId );
+            merkkaus.addBindValue( kohdennus );
+            merkkaus.exec();
+        }
+    }
+
+    if( satunnainen_.bounded(100) < koko_.liiteProsentti)
+    {
+        // Liitteeksi pdf:n alkuinen satunnainen sisältö
+        QByteArray data("%PDF-1.4\n");
+        int pituus = 2048 + satunnainen_.bounded(6144);
+        data.reserve( pituus );
+        while( data.length() < pituus)
+            data.append( static_cast<char>( satunnainen_.bounded(256)));
+
+        QSqlQuery liite(db);
+        liite.prepare("INSERT INTO liite(liiteno, tosite, otsikko, sha, data, liitetty) VALUES (?,?,?,?,?,?)");
+        liite.addBindValue( 1 );
+        liite.addBindValue( tositeId );
+        liite.addBindValue( otsikko );
+        liite.addBindValue( QString( QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex()) );
+        liite.addBindValue( data );
+        liite.addBindValue( aika );
+        if( !liite.exec())
+            virhe_ = liite.lastError().text();
+    }
+
+    return idt;
+}
+
+void KirjaGeneraattori::myyntilasku(QSqlDatabase &db, const QDate &pvm)
+{
+    int laskunumero = ++laskunumero_;
+    int asiakasnro = satunnainen_.bounded( koko_.asiakkaita ) + 1;
+    QString asiakas = QString("Asiakas %1").arg( asiakasnro );
+    QString viite = viitenumero( laskunumero );
+    int kohdennus = arvoKohdennus();
+
+    QList<Vienti> viennit;
+    QVariantList laskurivit;
+    qlonglong netto = 0;
+    qlonglong vero = 0;
+
+    int riveja = 1 + satunnainen_.bounded(5);
+    for( int r = 0; r < riveja; r++)
+    {
+        int tuote = 1 + satunnainen_.bounded(50);
+        int maara = 1 + satunnainen_.bounded(10);
+        qlonglong rivinetto = static_cast<qlonglong>(maara) * ( tuote * 250 + 990 );
+        qlonglong riviVero = rivinetto * 24 / 100;
+
+        QVariantMap rivi;
+        rivi.insert("Nimike", QString("Tuote %1").arg(tuote));
+        rivi.insert("Tuotekoodi", tuote);
+        rivi.insert("Tili", 3000);
+        rivi.insert("Alvkoodi", 11);
+        rivi.insert("Alvprosentti", 24);
+        rivi.insert("Maara", QString("%1.00").arg(maara));
+        rivi.insert("Yksikko", "kpl");
+        rivi.insert("YksikkohintaSnt", tuote * 250 + 990);
+        rivi.insert("Kohdennus", kohdennus);
+        rivi.insert("Nettoyht", rivinetto);
+        rivi.insert("Alv", riviVero);
+        rivi.insert("Yhteensa", rivinetto + riviVero);
+        laskurivit.append(rivi);
+
+        netto += rivinetto;
+        vero += riviVero;
+    }
+
+    Vienti myynti;
+    myynti.tili = tili(3000);
+    myynti.kredit = netto;
+    myynti.selite = QString("%1 [%2]").arg(asiakas).arg(laskunumero);
+    myynti.alvkoodi = 11;
+    myynti.alvprosentti = 24;
+    myynti.kohdennus = kohdennus;
+    viennit.append(myynti);
+
+    Vienti alv;
+    alv.tili = tili(2939);
+    alv.kredit = vero;
+    alv.selite = QString("%1 [%2] ALV 24 %").arg(asiakas).arg(laskunumero);
+    alv.alvkoodi = 111;
+    alv.alvprosentti = 24;
+    viennit.append(alv);
+
+    QVariantMap json;
+    json.insert("Laskurivit", laskurivit);
+    json.insert("Kirjausperuste", 0);
+    // Asiakkaat ovat verkkolaskuttajia, jotta laskuista voi muodostaa Finvoice-sanomat
+    json.insert("Osoite", QString("%1\nAsiakaskatu %2\n%3 TAMPERE").arg(asiakas).arg(asiakasnro).arg(33100 + asiakasnro % 100));
+    json.insert("Toimituspvm", pvm.toString(Qt::ISODate));
+    json.insert("VerkkolaskuOsoite", QString("0037%1").arg(20000000 + asiakasnro));
+    json.insert("VerkkolaskuValittaja", "OKOYFIHH");
+
+    Vienti saatava;
+    saatava.tili = tili(1701);
+    saatava.debet = netto + vero;
+    saatava.selite = myynti.selite;
+    saatava.eraid = -1;
+    saatava.viite = viite;
+    saatava.erapvm = pvm.addDays(14);
+    saatava.asiakas = asiakas;
+    saatava.json = QJsonDocument::fromVariant(json).toJson(QJsonDocument::Compact);
+    viennit.append(saatava);
+
+    QList<int> idt = kirjoitaTosite(db, pvm, lajit_.value("ML"), QString("Lasku %1 %2").arg(laskunumero).arg(asiakas), viennit);
+    if( idt.count() == 3)
+        avoimetMyynnit_.append( AvoinEra{ idt.last(), saatava.tili, saatava.debet, viite, QString(), asiakas } );
+}
+
+void KirjaGeneraattori::ostolasku(QSqlDatabase &db, const QDate &pvm)
+{
+    int toimittaja = satunnainen_.bounded( qMax(1, koko_.asiakkaita / 5)) + 1;
+    QString nimi = QString("Toimittaja %1").arg(toimittaja);
+    QString iban = QString("FI%1%2").arg( toimittaja % 89 + 10).arg( 10000000000000LL + toimittaja * 7919LL);
+    QString viite = viitenumero( 100000 + satunnainen_.bounded(900000) );
+
+    qlonglong netto = 500 + satunnainen_.bounded(200000);
+    qlonglong vero = netto * 24 / 100;
+    int kohdennus = arvoKohdennus();
+
+    QList<Vienti> viennit;
+    Vienti meno;
+    meno.tili = satunnainen_.bounded(4) ? tili(4000) : menotilit_.at( satunnainen_.bounded( menotilit_.count()));
+    meno.debet = netto;
+    meno.selite = nimi;
+    meno.alvkoodi = 21;
+    meno.alvprosentti = 24;
+    meno.kohdennus = kohdennus;
+    viennit.append(meno);
+
+    Vienti alv;
+    alv.tili = tili(1763);
+    alv.debet = vero;
+    alv.selite = QString("%1 ALV 24 %").arg(nimi);
+    alv.alvkoodi = 221;
+    alv.alvprosentti = 24;
+    viennit.append(alv);
+
+    Vienti velka;
+    velka.tili = tili(2871);
+    velka.kredit = netto + vero;
+    velka.selite = nimi;
+    velka.eraid = -1;
+    velka.viite = viite;
+    velka.iban = iban;
+    velka.erapvm = pvm.addDays(21);
+    velka.asiakas = nimi;
+    viennit.append(velka);
+
+    QList<int> idt = kirjoitaTosite(db, pvm, lajit_.value("OL"), nimi, viennit);
+    if( idt.count() == 3)
+        avoimetOstot_.append( AvoinEra{ idt.last(), velka.tili, -velka.kredit, viite, iban, nimi } );
+}
+
+void KirjaGeneraattori::maksu(QSqlDatabase &db, const QDate &pvm)
+{
+    // Maksetaan vanhimpien joukosta arvottu lasku, joten noin viidennes jää avoimeksi
+    bool myynti = satunnainen_.bounded(100) < 60;
+    QList<AvoinEra>& avoimet = myynti ? avoimetMyynnit_ : avoimetOstot_;
+    if( avoimet.count() < 5 )
+    {
+        muuKirjaus(db, pvm);
+        return;
+    }
+    AvoinEra era = avoimet.takeAt( satunnainen_.bounded( avoimet.count() / 2 ));
+
+    Vienti pankki;
+    pankki.tili = tili(1910);
+    pankki.selite = era.asiakas;
+    if( era.saldo > 0)
+        pankki.debet = era.saldo;
+    else
+        pankki.kredit = -era.saldo;
+
+    Vienti suoritus;
+    suoritus.tili = era.tili;
+    suoritus.selite = era.asiakas;
+    suoritus.eraid = era.eraid;
+    suoritus.debet = pankki.kredit;
+    suoritus.kredit = pankki.debet;
+
+    kirjoitaTosite(db, pvm, lajit_.value("TILI"), QString("Tiliote %1").arg(pvm.toString("MM/yyyy")),
+                   QList<Vienti>() << pankki << suoritus);
+}
+
+void KirjaGeneraattori::muuKirjaus(QSqlDatabase &db, const QDate &pvm)
+{
+    bool tulo = satunnainen_.bounded(100) < 30;
+    qlonglong summa = 100 + satunnainen_.bounded(50000);
+
+    Vienti tulos;
+    tulos.tili = tulo ? tulotilit_.at( satunnainen_.bounded(tulotilit_.count()))
+                      : menotilit_.at( satunnainen_.bounded(menotilit_.count()));
+    tulos.selite = QString("Kirjaus %1").arg( satunnainen_.bounded(10000));
+    tulos.kohdennus = arvoKohdennus();
+    if( tulo )
+        tulos.kredit = summa;
+    else
+        tulos.debet = summa;
+    if( !merkkaukset_.isEmpty() && satunnainen_.bounded(100) < 40)
+    {
+        tulos.merkkaukset.append( merkkaukset_.at( satunnainen_.bounded( merkkaukset_.count())));
+        if( merkkaukset_.count() > 1 && satunnainen_.bounded(2))
+            tulos.merkkaukset.append( merkkaukset_.at( satunnainen_.bounded( merkkaukset_.count())));
+    }
+
+    Vienti pankki;
+    pankki.tili = tili(1910);
+    pankki.selite = tulos.selite;
+    pankki.debet = tulos.kredit;
+    pankki.kredit = tulos.debet;
+
+    kirjoitaTosite(db, pvm, 1, tulos.selite, QList<Vienti>() << tulos << pankki);
+}
+
+int KirjaGeneraattori::arvoKohdennus()
+{
+    // Puolet kirjauksista kohdennetaan
+    if( kustannuspaikat_.isEmpty() || satunnainen_.bounded(2))
+        return 0;
+    return kustannuspaikat_.at( satunnainen_.bounded( kustannuspaikat_.count()));
+}
+
+QString KirjaGeneraattori::viitenumero(int perusosa) const
+{
+    // Suomalaisen viitenumeron tarkiste painoilla 7, 3, 1
+    QString numero = QString::number(perusosa);
+    const int painot[] = {7, 3, 1};
+    int summa = 0;
+    for( int i = 0; i < numero.length(); i++)
+        summa += numero.at( numero.length() - 1 - i).digitValue() * painot[i % 3];
+    return numero + QString::number( (10 - summa % 10) % 10 );
+}
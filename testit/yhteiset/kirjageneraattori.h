@@ -0,0 +1,167 @@
+/*
+   Copyright (C) 2026 Arto Hyvättinen
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KIRJAGENERAATTORI_H
+#define KIRJAGENERAATTORI_H
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QHash>
+#include <QList>
+#include <QDate>
+#include <QSqlDatabase>
+#include <QRandomGenerator>
+
+/**
+ * @brief Luo suorituskykytestejä varten suuren keksityn kirjanpidon
+ *
+ * Kirjanpito luodaan ohjelman resursseissa olevilla luontikäskyillä ja
+ * tilikartalla kuten luontivelhossa, joten tiedosto avataan testeissä
+ * Kirjanpito::avaaTietokanta:lla. Kaikki sisältö arvotaan siemenestä,
+ * joten samalla siemenellä ja koolla syntyy aina sama kirjanpito ja
+ * mittaukset ovat vertailukelpoisia versioiden välillä.
+ *
+ * Tilikausittain luodaan myyntilaskuja laskuriveineen ja alv-vienteineen,
+ * ostolaskuja, laskujen maksuja tiliotteilla sekä muita kirjauksia
+ * kohdennuksineen ja merkkauksineen. Osaan tositteista liitetään
+ * pdf-liite, ja jokaiselle tilikaudelle tehdään kohdennuksittainen
+ * budjetti. Koostetaulut täytetään lopuksi päivityskäskyillä.
+ */
+class KirjaGeneraattori
+{
+public:
+    struct Koko
+    {
+        int tilikausia = 5;
+        int tositteitaKaudessa = 12000;
+        int kohdennuksia = 20;
+        int asiakkaita = 500;
+        int liiteProsentti = 30;
+        int ensimmainenVuosi = 2016;
+    };
+
+    /**
+     * @param siemen Satunnaislukujen siemen
+     * @param koko Kirjanpidon koko
+     */
+    KirjaGeneraattori(quint32 siemen, const Koko& koko = Koko());
+
+    /**
+     * @brief Luo kirjanpidon
+     * @param polku Luotava tiedosto, joka ei saa olla olemassa
+     * @return tosi, jos onnistui
+     */
+    bool luo(const QString& polku);
+
+    QString virhe() const { return virhe_; }
+
+    QDate alkaa() const { return QDate(koko_.ensimmainenVuosi, 1, 1); }
+    QDate paattyy() const { return QDate(koko_.ensimmainenVuosi + koko_.tilikausia - 1, 12, 31); }
+
+    /**
+     * @brief Lukee kpk-tilikarttatiedoston osiot
+     */
+    static QMap<QString,QStringList> lueTilikartta(const QString& polku);
+
+    /**
+     * @brief Luo tyhjät taulut luontikäskyillä luo.sql
+     *
+     * Testiaineistoja varten, joihin rivit lisätään itse.
+     */
+    static bool luoTaulut(QSqlDatabase& db, QString* virhe = nullptr);
+
+    /**
+     * @brief Pankkitilin 1910 IBAN-numero tiliotteiden tuontia varten
+     */
+    static QString pankkitilinIban() { return QStringLiteral("FI2112345600000785"); }
+
+    /**
+     * @brief Suorittaa tiedoston sql-käskyt
+     * @param rivinvaihto Merkkijono, jolla rivinvaihdot korvataan
+     */
+    static bool suoritaSql(QSqlDatabase& db, const QString& polku, const QString& rivinvaihto, QString* virhe = nullptr);
+
+protected:
+    struct Vienti
+    {
+        int tili = 0;
+        qlonglong debet = 0;
+        qlonglong kredit = 0;
+        QString selite;
+        int alvkoodi = 0;
+        int alvprosentti = 0;
+        int kohdennus = 0;
+        int eraid = 0;          // -1 = vienti itse on erän alku
+        QString viite;
+        QString iban;
+        QDate erapvm;
+        QString asiakas;
+        QByteArray json;
+        QList<int> merkkaukset;
+    };
+
+    bool kirjoitaAsetukset(QSqlDatabase& db, const QMap<QString,QStringList>& kartta);
+    bool kirjoitaTilit(QSqlDatabase& db, const QMap<QString,QStringList>& kartta);
+    bool kirjoitaKohdennukset(QSqlDatabase& db);
+    bool kirjoitaTositteet(QSqlDatabase& db);
+
+    /**
+     * @brief Kirjoittaa tositteen vienteineen
+     * @return Vientien id:t
+     */
+    QList<int> kirjoitaTosite(QSqlDatabase& db, const QDate& pvm, int laji, const QString& otsikko,
+                              const QList<Vienti>& viennit);
+
+    void myyntilasku(QSqlDatabase& db, const QDate& pvm);
+    void ostolasku(QSqlDatabase& db, const QDate& pvm);
+    void maksu(QSqlDatabase& db, const QDate& pvm);
+    void muuKirjaus(QSqlDatabase& db, const QDate& pvm);
+
+    int tili(int numero) const { return tilit_.value(numero); }
+    int arvoKohdennus();
+    QString viitenumero(int perusosa) const;
+
+    QRandomGenerator satunnainen_;
+    Koko koko_;
+    QString virhe_;
+
+    QHash<int,int> tilit_;          // numero, id
+    QList<int> menotilit_;          // id:t
+    QList<int> tulotilit_;
+    QList<int> budjettitilit_;     // numerot
+    QList<int> kustannuspaikat_;
+    QList<int> merkkaukset_;
+    QHash<QString,int> lajit_;      // tunnus, id
+    QHash<int,int> tunnisteet_;     // laji, kauden suurin tunniste
+
+    struct AvoinEra
+    {
+        int eraid;
+        int tili;
+        qlonglong saldo;
+        QString viite;
+        QString iban;
+        QString asiakas;
+    };
+    QList<AvoinEra> avoimetMyynnit_;
+    QList<AvoinEra> avoimetOstot_;
+
+    int laskunumero_ = 1000;
+};
+
+#endif // KIRJAGENERAATTORI_H
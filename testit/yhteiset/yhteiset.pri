@@ -0,0 +1,21 @@
+# Testien yhteiset osat
+#
+# Testit käännetään Kitupiikin omalla lähdekoodilla, ja testikirjanpidot
+# luodaan ohjelman resursseissa olevilla luontikäskyillä. Testit tarvitsevat
+# QApplicationin, joten ilman näyttöä ne ajetaan esimerkiksi
+#   QT_QPA_PLATFORM=offscreen ./kirjanpito
+
+include(../../kitupiikki/kitupiikki.pri)
+
+QT += testlib
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD
+
+HEADERS += $$PWD/kirjageneraattori.h
+
+SOURCES += $$PWD/kirjageneraattori.cpp